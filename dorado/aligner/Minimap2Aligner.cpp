@@ -140,21 +140,28 @@ namespace dorado::alignment {
 const std::string UNMAPPED_SAM_LINE_STRIPPED{"\t4\t*\t0\t0\t*\t*\t0\t0\n"};
 
 std::tuple<mm_reg1_t*, int> Minimap2Aligner::get_mapping(bam1_t* irecord, mm_tbuf_t* buf) {
+    const std::string qname(bam_get_qname(irecord));
+
+    // get the sequence to map from the record
+    const std::string seq = utils::extract_sequence(irecord);
+
+    return get_mapping(qname, seq, buf);
+}
+
+std::tuple<mm_reg1_t*, int> Minimap2Aligner::get_mapping(const std::string& qname,
+                                                         const std::string& seq,
+                                                         mm_tbuf_t* buf) {
     if (m_minimap_index->num_loaded_index_blocks() != 1) {
         throw std::logic_error(
                 "Minimap2Aligner::get_mapping() called on fully-loaded split index.");
     }
-    std::string_view qname(bam_get_qname(irecord));
-
-    // get the sequence to map from the record
-    std::string seq = utils::extract_sequence(irecord);
 
     // do the mapping
     int hits = 0;
     auto mm_index = m_minimap_index->index();
     const auto& mm_map_opts = m_minimap_index->mapping_options();
     mm_reg1_t* reg = mm_map(mm_index, static_cast<int>(seq.length()), seq.c_str(), &hits, buf,
-                            &mm_map_opts, qname.data());
+                            &mm_map_opts, qname.c_str());
     return {reg, hits};
 }
 
@@ -34,6 +34,9 @@ public:
      *  contain only a single entry in m_minimap_indexes.
      */
     std::tuple<mm_reg1_t*, int> get_mapping(bam1_t* record, mm_tbuf_t* buf);
+    std::tuple<mm_reg1_t*, int> get_mapping(const std::string& qname,
+                                            const std::string& seq,
+                                            mm_tbuf_t* buf);
 
     /// This will combine the sequence records from all blocks of a split-index.
     utils::HeaderSQRecords get_sequence_records_for_header() const;
@@ -14,7 +14,7 @@ bool BedFileAccess::load_bedfile(const std::string& bedfile) {
     return true;
 }
 
-std::shared_ptr<BedFile> BedFileAccess::get_bedfile(const std::string& bedfile) {
+std::shared_ptr<const BedFile> BedFileAccess::get_bedfile(const std::string& bedfile) {
     std::lock_guard guard(m_mutex);
     auto iter = m_bedfile_lut.find(bedfile);
     if (iter == m_bedfile_lut.end()) {
@@ -1,5 +1,6 @@
 #include "alignment/Minimap2Index.h"
 
+#include "alignment/Minimap2MappedIndex.h"
 #include "alignment/minimap2_wrappers.h"
 #include "hts_utils/FastxRandomReader.h"
 #include "hts_utils/fai_utils.h"
@@ -56,14 +57,26 @@ const mm_idx_t* Minimap2Index::index(size_t n) const {
 
 std::pair<std::shared_ptr<mm_idx_t>, IndexLoadResult> Minimap2Index::load_initial_index(
         const std::string& index_file,
-        int num_threads) {
-    m_index_reader = create_index_reader(index_file, m_options.index_options->get());
-    if (!m_index_reader.inner) {
-        // Reason could be not having permissions to open the file
-        return {nullptr, IndexLoadResult::file_open_error};
+        int num_threads,
+        bool mapped) {
+    std::shared_ptr<mm_idx_t> index;
+    if (mapped) {
+        // The whole index is a single block, so there's no reader to load further chunks from.
+        m_index_reader = IndexReader{nullptr, index_file};
+        try {
+            index = load_mapped_index(index_file);
+        } catch (const std::exception& e) {
+            spdlog::error("Failed to map index '{}': {}", index_file, e.what());
+            return {nullptr, IndexLoadResult::file_open_error};
+        }
+    } else {
+        m_index_reader = create_index_reader(index_file, m_options.index_options->get());
+        if (!m_index_reader.inner) {
+            // Reason could be not having permissions to open the file
+            return {nullptr, IndexLoadResult::file_open_error};
+        }
+        index.reset(mm_idx_reader_read(m_index_reader.inner.get(), num_threads), IndexDeleter());
     }
-    std::shared_ptr<mm_idx_t> index(mm_idx_reader_read(m_index_reader.inner.get(), num_threads),
-                                    IndexDeleter());
 
     if (!index) {
         m_index_reader.inner.reset();
@@ -94,16 +107,34 @@ std::pair<std::shared_ptr<mm_idx_t>, IndexLoadResult> Minimap2Index::load_initia
     return {index, IndexLoadResult::success};
 }
 
+void Minimap2Index::prefetch_next_chunk(int num_threads) {
+    if (m_prefetched_chunk || !m_index_reader.inner) {
+        return;
+    }
+    m_prefetched_chunk = std::shared_ptr<const mm_idx_t>(
+            mm_idx_reader_read(m_index_reader.inner.get(), num_threads), IndexDeleter());
+}
+
+bool Minimap2Index::has_next_chunk() const {
+    if (m_prefetched_chunk) {
+        return *m_prefetched_chunk != nullptr;
+    }
+    return m_index_reader.inner && !mm_idx_reader_eof(m_index_reader.inner.get());
+}
+
 IndexLoadResult Minimap2Index::load_next_chunk(int num_threads) {
-    if (!m_index_reader.inner) {
-        if (m_indexes.empty()) {
-            return IndexLoadResult::no_index_loaded;
+    if (!m_prefetched_chunk) {
+        if (!m_index_reader.inner) {
+            if (m_indexes.empty()) {
+                return IndexLoadResult::no_index_loaded;
+            }
+            return IndexLoadResult::end_of_index;
         }
-        return IndexLoadResult::end_of_index;
+        prefetch_next_chunk(num_threads);
     }
 
-    std::shared_ptr<const mm_idx_t> next_idx(
-            mm_idx_reader_read(m_index_reader.inner.get(), num_threads), IndexDeleter());
+    auto next_idx = std::move(*m_prefetched_chunk);
+    m_prefetched_chunk.reset();
     if (!next_idx) {
         m_index_reader.inner.reset();
         return IndexLoadResult::end_of_index;
@@ -142,7 +173,14 @@ IndexLoadResult Minimap2Index::load(const std::string& index_file,
         return IndexLoadResult::reference_file_not_found;
     }
 
-    auto [index, result] = load_initial_index(index_file, num_threads);
+    const bool mapped = is_mapped_index_file(index_file);
+    if (mapped && !m_options.junc_bed.empty()) {
+        // Junctions would be added to the index itself, which is read-only once mapped.
+        spdlog::error("Junction BED files can't be used with a mapped index.");
+        return IndexLoadResult::validation_error;
+    }
+
+    auto [index, result] = load_initial_index(index_file, num_threads, mapped);
     if (result != IndexLoadResult::success) {
         return result;
     }
@@ -166,6 +204,10 @@ IndexLoadResult Minimap2Index::load(const std::string& index_file,
     return IndexLoadResult::success;
 }
 
+void Minimap2Index::save_mapped_index(const std::filesystem::path& path) const {
+    write_mapped_index(*index(), path);
+}
+
 std::shared_ptr<Minimap2Index> Minimap2Index::create_compatible_index(
         const Minimap2Options& options) const {
     assert(static_cast<const Minimap2IndexOptions&>(m_options) == options &&
@@ -0,0 +1,325 @@
+#include "alignment/Minimap2MappedIndex.h"
+
+#include "utils/MappedFile.h"
+
+#include <spdlog/spdlog.h>
+
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+namespace {
+
+// Mirrors of the structures minimap2 (v2.28) keeps private to index.c.  The minimizer lookup
+// tables are khash_t(idx) tables of uint64_t keys and values, and the lazily built name lookup a
+// khash_t(str) table; both share this header layout.
+struct MirrorHash {
+    uint32_t n_buckets, size, n_occupied, upper_bound;
+    uint32_t* flags;
+    void* keys;
+    void* vals;
+};
+
+// mm_idx_bucket_t.
+struct MirrorBucket {
+    mm128_v a;
+    int32_t n;
+    uint64_t* p;
+    void* h;
+};
+
+// khash packs two flag bits per slot into 32-bit words.
+uint64_t hash_flag_words(uint32_t n_buckets) { return n_buckets < 16 ? 1 : n_buckets >> 4; }
+
+constexpr std::array<char, 8> MAGIC{'D', 'O', 'R', 'M', 'M', 'I', 'D', 'X'};
+constexpr uint32_t LAYOUT_VERSION = 1;
+constexpr uint64_t SECTION_ALIGNMENT = 64;
+constexpr uint64_t NO_NAME = UINT64_MAX;
+
+struct FileHeader {
+    std::array<char, 8> magic{};
+    uint32_t version{0};
+    uint32_t pointer_size{0};
+    int32_t b{0}, w{0}, k{0}, flag{0};
+    uint32_t n_seq{0};
+    uint32_t reserved{0};
+    uint64_t names_offset{0};
+    uint64_t names_bytes{0};
+    uint64_t seqs_offset{0};
+    uint64_t buckets_offset{0};
+    uint64_t seq_data_offset{0};
+    uint64_t seq_data_words{0};
+    uint64_t file_size{0};
+};
+
+struct SeqRecord {
+    // Relative to FileHeader::names_offset, or NO_NAME.
+    uint64_t name_offset{0};
+    uint64_t offset{0};
+    uint32_t len{0};
+    uint32_t is_alt{0};
+};
+
+struct BucketRecord {
+    uint64_t p_offset{0};
+    uint64_t flags_offset{0};
+    uint64_t keys_offset{0};
+    uint64_t vals_offset{0};
+    int32_t n{0};
+    uint32_t has_hash{0};
+    uint32_t n_buckets{0}, size{0}, n_occupied{0}, upper_bound{0};
+};
+
+// Writes sections at aligned offsets, so they can be used in place once mapped.
+class LayoutWriter {
+public:
+    explicit LayoutWriter(const std::filesystem::path& path)
+            : m_path(path), m_out(path, std::ios::binary | std::ios::trunc) {
+        if (!m_out) {
+            throw std::runtime_error("Failed to create mapped index file " + m_path.string());
+        }
+    }
+
+    // Returns the offset |bytes| were written at.
+    uint64_t append(const void* data, uint64_t bytes) {
+        const uint64_t padding =
+                (SECTION_ALIGNMENT - m_pos % SECTION_ALIGNMENT) % SECTION_ALIGNMENT;
+        static constexpr std::array<char, SECTION_ALIGNMENT> zeros{};
+        write(zeros.data(), padding);
+        const uint64_t offset = m_pos;
+        write(data, bytes);
+        return offset;
+    }
+
+    void overwrite(uint64_t offset, const void* data, uint64_t bytes) {
+        m_out.seekp(std::streamoff(offset));
+        m_out.write(static_cast<const char*>(data), std::streamsize(bytes));
+        m_out.seekp(std::streamoff(m_pos));
+        check();
+    }
+
+    uint64_t size() const { return m_pos; }
+
+    void close() {
+        m_out.close();
+        check();
+    }
+
+private:
+    void write(const void* data, uint64_t bytes) {
+        m_out.write(static_cast<const char*>(data), std::streamsize(bytes));
+        m_pos += bytes;
+        check();
+    }
+
+    void check() const {
+        if (!m_out) {
+            throw std::runtime_error("Failed to write mapped index file " + m_path.string());
+        }
+    }
+
+    const std::filesystem::path m_path;
+    std::ofstream m_out;
+    uint64_t m_pos{0};
+};
+
+// Owns everything behind an mm_idx_t that refers into a mapped file.  The hash tables and the
+// arrays they refer to live in the mapping, and only their headers are allocated here.
+struct MappedIndex {
+    explicit MappedIndex(const std::filesystem::path& path) : file(path) {}
+
+    ~MappedIndex() {
+        // minimap2 builds the name lookup on demand, with malloc.
+        if (auto* names = static_cast<MirrorHash*>(index.h)) {
+            std::free(names->keys);
+            std::free(names->flags);
+            std::free(names->vals);
+            std::free(names);
+        }
+    }
+
+    dorado::utils::MappedFile file;
+    mm_idx_t index{};
+    std::vector<mm_idx_seq_t> seqs;
+    std::vector<MirrorBucket> buckets;
+    std::vector<MirrorHash> hashes;
+};
+
+}  // namespace
+
+namespace dorado::alignment {
+
+bool is_mapped_index_file(const std::filesystem::path& path) {
+    std::ifstream in(path, std::ios::binary);
+    std::array<char, MAGIC.size()> magic{};
+    in.read(magic.data(), magic.size());
+    return in && magic == MAGIC;
+}
+
+void write_mapped_index(const mm_idx_t& index, const std::filesystem::path& path) {
+    // Write to a temporary file first, so that other processes never map a partial index.
+    auto tmp_path = path;
+    tmp_path += ".tmp";
+    LayoutWriter writer(tmp_path);
+
+    FileHeader header;
+    writer.append(&header, sizeof(header));
+
+    std::string names;
+    std::vector<SeqRecord> seqs(index.n_seq);
+    for (uint32_t i = 0; i < index.n_seq; ++i) {
+        const auto& seq = index.seq[i];
+        seqs[i].name_offset = NO_NAME;
+        if (seq.name) {
+            seqs[i].name_offset = names.size();
+            names.append(seq.name).push_back('\0');
+        }
+        seqs[i].offset = seq.offset;
+        seqs[i].len = seq.len;
+        seqs[i].is_alt = seq.is_alt;
+    }
+    header.names_offset = writer.append(names.data(), names.size());
+    header.names_bytes = names.size();
+    header.seqs_offset = writer.append(seqs.data(), seqs.size() * sizeof(SeqRecord));
+
+    const size_t num_buckets = size_t{1} << index.b;
+    std::vector<BucketRecord> buckets(num_buckets);
+    header.buckets_offset = writer.append(buckets.data(), buckets.size() * sizeof(BucketRecord));
+    const auto* index_buckets = reinterpret_cast<const MirrorBucket*>(index.B);
+    for (size_t i = 0; i < num_buckets; ++i) {
+        const auto& bucket = index_buckets[i];
+        if (bucket.a.n != 0) {
+            throw std::runtime_error("Can't write an index which is still being built");
+        }
+        auto& record = buckets[i];
+        record.n = bucket.n;
+        record.p_offset = writer.append(bucket.p, uint64_t(bucket.n) * sizeof(uint64_t));
+        if (const auto* hash = static_cast<const MirrorHash*>(bucket.h)) {
+            record.has_hash = 1;
+            record.n_buckets = hash->n_buckets;
+            record.size = hash->size;
+            record.n_occupied = hash->n_occupied;
+            record.upper_bound = hash->upper_bound;
+            record.flags_offset = writer.append(
+                    hash->flags, hash_flag_words(hash->n_buckets) * sizeof(uint32_t));
+            record.keys_offset = writer.append(hash->keys, hash->n_buckets * sizeof(uint64_t));
+            record.vals_offset = writer.append(hash->vals, hash->n_buckets * sizeof(uint64_t));
+        }
+    }
+    writer.overwrite(header.buckets_offset, buckets.data(), buckets.size() * sizeof(BucketRecord));
+
+    if (index.n_seq > 0 && index.S && !(index.flag & MM_I_NO_SEQ)) {
+        const auto& last = index.seq[index.n_seq - 1];
+        header.seq_data_words = (last.offset + last.len + 7) / 8;
+        header.seq_data_offset = writer.append(index.S, header.seq_data_words * sizeof(uint32_t));
+    }
+
+    header.magic = MAGIC;
+    header.version = LAYOUT_VERSION;
+    header.pointer_size = sizeof(void*);
+    header.b = index.b;
+    header.w = index.w;
+    header.k = index.k;
+    header.flag = index.flag;
+    header.n_seq = index.n_seq;
+    header.file_size = writer.size();
+    writer.overwrite(0, &header, sizeof(header));
+    writer.close();
+
+    std::error_code ec;
+    std::filesystem::rename(tmp_path, path, ec);
+    if (ec) {
+        std::filesystem::remove(tmp_path, ec);
+        throw std::runtime_error("Failed to write mapped index file " + path.string());
+    }
+    spdlog::debug("Wrote mapped index '{}' ({} bytes)", path.string(), header.file_size);
+}
+
+std::shared_ptr<mm_idx_t> load_mapped_index(const std::filesystem::path& path) {
+    auto mapped = std::make_shared<MappedIndex>(path);
+    const auto& file = mapped->file;
+
+    const auto& header = *file.section<FileHeader>(0, 1);
+    if (header.magic != MAGIC) {
+        throw std::runtime_error("Not a mapped index file: " + path.string());
+    }
+    if (header.version != LAYOUT_VERSION || header.pointer_size != sizeof(void*)) {
+        throw std::runtime_error("Mapped index " + path.string() +
+                                 " was written by an incompatible version of dorado");
+    }
+    if (header.b < 0 || header.b > 30) {
+        throw std::runtime_error("Mapped index is truncated or corrupt");
+    }
+    file.section<uint8_t>(0, header.file_size);
+
+    auto& index = mapped->index;
+    index.b = header.b;
+    index.w = header.w;
+    index.k = header.k;
+    index.flag = header.flag;
+    index.n_seq = header.n_seq;
+
+    const auto* names = file.section<char>(header.names_offset, header.names_bytes);
+    const auto* seqs = file.section<SeqRecord>(header.seqs_offset, header.n_seq);
+    mapped->seqs.resize(header.n_seq);
+    for (uint32_t i = 0; i < header.n_seq; ++i) {
+        auto& seq = mapped->seqs[i];
+        if (seqs[i].name_offset != NO_NAME) {
+            if (seqs[i].name_offset >= header.names_bytes ||
+                !std::memchr(names + seqs[i].name_offset, '\0',
+                             header.names_bytes - seqs[i].name_offset)) {
+                throw std::runtime_error("Mapped index is truncated or corrupt");
+            }
+            seq.name = const_cast<char*>(names + seqs[i].name_offset);
+        }
+        seq.offset = seqs[i].offset;
+        seq.len = seqs[i].len;
+        seq.is_alt = seqs[i].is_alt;
+        index.n_alt += seq.is_alt ? 1 : 0;
+    }
+    index.seq = mapped->seqs.data();
+
+    const size_t num_buckets = size_t{1} << header.b;
+    const auto* buckets = file.section<BucketRecord>(header.buckets_offset, num_buckets);
+    mapped->buckets.resize(num_buckets);
+    mapped->hashes.resize(num_buckets);
+    for (size_t i = 0; i < num_buckets; ++i) {
+        const auto& record = buckets[i];
+        auto& bucket = mapped->buckets[i];
+        bucket.a = {};
+        bucket.n = record.n;
+        bucket.p = const_cast<uint64_t*>(file.section<uint64_t>(record.p_offset, record.n));
+        bucket.h = nullptr;
+        if (record.has_hash) {
+            auto& hash = mapped->hashes[i];
+            hash.n_buckets = record.n_buckets;
+            hash.size = record.size;
+            hash.n_occupied = record.n_occupied;
+            hash.upper_bound = record.upper_bound;
+            hash.flags = const_cast<uint32_t*>(file.section<uint32_t>(
+                    record.flags_offset, hash_flag_words(record.n_buckets)));
+            hash.keys = const_cast<uint64_t*>(
+                    file.section<uint64_t>(record.keys_offset, record.n_buckets));
+            hash.vals = const_cast<uint64_t*>(
+                    file.section<uint64_t>(record.vals_offset, record.n_buckets));
+            bucket.h = &hash;
+        }
+    }
+    index.B = reinterpret_cast<mm_idx_bucket_s*>(mapped->buckets.data());
+
+    if (header.seq_data_words > 0) {
+        index.S = const_cast<uint32_t*>(
+                file.section<uint32_t>(header.seq_data_offset, header.seq_data_words));
+    }
+
+    // The returned pointer keeps the whole mapping alive.
+    return std::shared_ptr<mm_idx_t>(mapped, &mapped->index);
+}
+
+}  // namespace dorado::alignment
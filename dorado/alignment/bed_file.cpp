@@ -5,6 +5,8 @@
 
 #include <spdlog/spdlog.h>
 
+#include <algorithm>
+#include <array>
 #include <fstream>
 #include <iomanip>
 #include <optional>
@@ -235,7 +237,11 @@ bool BedFile::load(std::istream& input_stream) {
         if (parser.ignore_line()) {
             continue;
         }
-        m_genomes[parser.genome()].push_back(std::move(parser.entry()));
+        m_genomes[parser.genome()].entries.push_back(std::move(parser.entry()));
+    }
+
+    for (auto& [name, genome] : m_genomes) {
+        build_index(genome);
     }
 
     if (!parser.is_valid()) {
@@ -249,7 +255,124 @@ bool BedFile::load(std::istream& input_stream) {
 
 const BedFile::Entries& BedFile::entries(const std::string& genome) const {
     auto it = m_genomes.find(genome);
-    return it != m_genomes.end() ? it->second : NO_ENTRIES;
+    return it != m_genomes.end() ? it->second.entries : NO_ENTRIES;
+}
+
+void BedFile::build_index(Genome& genome) {
+    auto& index = genome.index;
+    index.clear();
+    index.reserve(genome.entries.size());
+    for (size_t i = 0; i < genome.entries.size(); ++i) {
+        const Entry& entry = genome.entries[i];
+        const auto start = static_cast<int64_t>(entry.start);
+        const auto end = static_cast<int64_t>(entry.end);
+        index.push_back({start, end, end, i, entry.strand});
+    }
+    std::stable_sort(std::begin(index), std::end(index),
+                     [](const IndexNode& a, const IndexNode& b) { return a.start < b.start; });
+
+    genome.root_level = -1;
+    const auto n = static_cast<int64_t>(index.size());
+    if (n == 0) {
+        return;
+    }
+
+    // Leaves are at the even indices. |last| tracks the max_end of the rightmost subtree, which
+    // stands in for the right children missing from the end of the array.
+    int64_t last_i = 0;
+    int64_t last = 0;
+    for (int64_t i = 0; i < n; i += 2) {
+        last_i = i;
+        last = index[i].end;
+    }
+    int level = 1;
+    for (; (int64_t{1} << level) <= n; ++level) {
+        const int64_t half = int64_t{1} << (level - 1);
+        for (int64_t i = (half << 1) - 1; i < n; i += half << 2) {
+            const int64_t left_max_end = index[i - half].max_end;
+            const int64_t right_max_end = (i + half < n) ? index[i + half].max_end : last;
+            index[i].max_end = std::max({index[i].end, left_max_end, right_max_end});
+        }
+        last_i = ((last_i >> level) & 1) ? last_i - half : last_i + half;
+        if ((last_i < n) && (index[last_i].max_end > last)) {
+            last = index[last_i].max_end;
+        }
+    }
+    genome.root_level = level - 1;
+}
+
+template <typename Visitor>
+void BedFile::visit_overlaps(const std::string& genome,
+                             const int64_t start,
+                             const int64_t end,
+                             const char strand,
+                             Visitor&& visitor) const {
+    const auto it = m_genomes.find(genome);
+    if ((it == m_genomes.end()) || (it->second.root_level < 0)) {
+        return;
+    }
+    const auto& index = it->second.index;
+    const auto n = static_cast<int64_t>(index.size());
+
+    const auto visit = [&](const IndexNode& node) {
+        if ((node.end > start) && ((node.strand == strand) || (node.strand == '.'))) {
+            visitor(node.entry);
+        }
+    };
+
+    // Top-down traversal, visiting the nodes in index order.
+    struct StackItem {
+        int level;
+        int64_t node;
+        bool left_done;
+    };
+    std::array<StackItem, 128> stack;
+    size_t top = 0;
+    const int root_level = it->second.root_level;
+    stack[top++] = {root_level, (int64_t{1} << root_level) - 1, false};
+    while (top > 0) {
+        const StackItem item = stack[--top];
+        if (item.level <= 3) {
+            // Small subtree, scan it.
+            const int64_t first = item.node >> item.level << item.level;
+            const int64_t last = std::min(n, first + (int64_t{1} << (item.level + 1)) - 1);
+            for (int64_t i = first; (i < last) && (index[i].start < end); ++i) {
+                visit(index[i]);
+            }
+        } else if (!item.left_done) {
+            // The left child can be past the end of the array, in which case its subtree may
+            // still hold nodes.
+            const int64_t left = item.node - (int64_t{1} << (item.level - 1));
+            stack[top++] = {item.level, item.node, true};
+            if ((left >= n) || (index[left].max_end > start)) {
+                stack[top++] = {item.level - 1, left, false};
+            }
+        } else if ((item.node < n) && (index[item.node].start < end)) {
+            visit(index[item.node]);
+            stack[top++] = {item.level - 1, item.node + (int64_t{1} << (item.level - 1)), false};
+        }
+    }
+}
+
+size_t BedFile::count_overlaps(const std::string& genome,
+                               const int64_t start,
+                               const int64_t end,
+                               const char strand) const {
+    size_t num_hits = 0;
+    visit_overlaps(genome, start, end, strand, [&num_hits](size_t) { ++num_hits; });
+    return num_hits;
+}
+
+size_t BedFile::find_overlaps(const std::string& genome,
+                              const int64_t start,
+                              const int64_t end,
+                              const char strand,
+                              std::vector<size_t>& hits) const {
+    hits.clear();
+    visit_overlaps(genome, start, end, strand,
+                   [&hits](const size_t entry) { hits.push_back(entry); });
+    std::sort(std::begin(hits), std::end(hits));
+    return hits.size();
 }
 
 }  // namespace dorado::alignment
@@ -11,13 +11,14 @@ namespace dorado::alignment {
 
 class BedFileAccess {
     mutable std::mutex m_mutex{};
-    std::map<std::string, std::shared_ptr<BedFile>> m_bedfile_lut;
+    std::map<std::string, std::shared_ptr<const BedFile>> m_bedfile_lut;
 
 public:
     bool load_bedfile(const std::string& bedfile);
 
-    // Returns the bed-file if already loaded. Empty pointer otherwise.
-    std::shared_ptr<BedFile> get_bedfile(const std::string& bedfile);
+    // Returns the bed-file if already loaded. Empty pointer otherwise. The bed-file, including its
+    // overlap index, is read-only once loaded, so it can be queried from any number of threads.
+    std::shared_ptr<const BedFile> get_bedfile(const std::string& bedfile);
 
     // Remove a bedfile entry.
     void remove_bedfile(const std::string& bedfile);
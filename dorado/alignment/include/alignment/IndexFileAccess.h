@@ -42,6 +42,9 @@ class IndexFileAccess {
                                                                 const Minimap2Options& options);
 
 public:
+    // |index_file| may be a FASTA/FASTQ reference, a minimap2 .mmi index, or a mapped index
+    // written by Minimap2Index::save_mapped_index.  Mapped indexes are mapped read-only rather
+    // than read, so they load almost instantly and their memory is shared between processes.
     IndexLoadResult load_index(const std::string& index_file,
                                const Minimap2Options& options,
                                int num_threads);
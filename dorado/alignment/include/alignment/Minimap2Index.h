@@ -6,6 +6,7 @@
 
 #include <minimap.h>
 
+#include <filesystem>
 #include <memory>
 #include <optional>
 #include <string>
@@ -29,21 +30,42 @@ class Minimap2Index {
     utils::HeaderSQRecords m_header_records_cache;
     IndexReader m_index_reader;
     bool m_incremental_load{false};
+    // The next chunk, if prefetch_next_chunk() has read it.  Holds nullptr if the end of the
+    // index was reached instead.
+    std::optional<std::shared_ptr<const mm_idx_t>> m_prefetched_chunk;
 
     void set_index(std::shared_ptr<const mm_idx_t> index);
     void add_index(std::shared_ptr<const mm_idx_t> index);
     void cache_header_records(const mm_idx_t& index);
 
     // Returns nullptr if loading failed, and the load-result, as a pair.
+    // If |mapped| the file is a mapped index (see Minimap2MappedIndex.h), and is mapped rather
+    // than read.
     std::pair<std::shared_ptr<mm_idx_t>, IndexLoadResult> load_initial_index(
             const std::string& index_file,
-            int num_threads);
+            int num_threads,
+            bool mapped);
 
 public:
     bool initialise(Minimap2Options options);
     IndexLoadResult load(const std::string& index_file, int num_threads, bool incremental_load);
     IndexLoadResult load_next_chunk(int num_threads);
 
+    /** Reads the next chunk of the index without making it current, so it can be built while the
+     * current chunk is in use; the next load_next_chunk() then just swaps it in.
+     * May run concurrently with use of the current chunk, but not with load/load_next_chunk.
+     */
+    void prefetch_next_chunk(int num_threads);
+
+    /// True unless the whole index has been loaded.
+    bool has_next_chunk() const;
+
+    /** Writes the loaded index in dorado's mapped index layout, which later loads map read-only
+     * rather than reading, and which is shared between processes mapping the same file.
+     * Throws if the index is split or can't be written.
+     */
+    void save_mapped_index(const std::filesystem::path& path) const;
+
     /** Returns a shallow copy of this MinimapIndex with the given mapping options applied.
      * By contract the given indexing options must be identical to those held in this instance
      * and the underlying index must be loaded.
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <minimap.h>
+
+#include <filesystem>
+#include <memory>
+
+namespace dorado::alignment {
+
+// Dorado's memory-mappable layout for a prebuilt minimap2 index.
+//
+// A .mmi file only holds the minimizer hits, so loading one rebuilds every hash table into
+// private heap memory.  This layout instead stores the index exactly as minimap2 holds it in
+// memory, so it can be mapped read-only: loading it is near instant and the pages are shared,
+// through the page cache, by every process mapping the same file.
+//
+// The layout mirrors internal minimap2 structures, so files are only readable by builds using
+// the same minimap2 version, and on the same platform, as the build that wrote them.
+
+// Conventional extension for mapped index files.
+inline constexpr const char* MAPPED_INDEX_EXTENSION = ".dmmi";
+
+// True if |path| is a file starting with the mapped index header.
+bool is_mapped_index_file(const std::filesystem::path& path);
+
+// Writes |index| to |path|.  Throws on failure.
+void write_mapped_index(const mm_idx_t& index, const std::filesystem::path& path);
+
+// Maps the index at |path|, which stays mapped until the returned pointer is released.  Throws if
+// the file can't be mapped or isn't a valid mapped index.
+std::shared_ptr<mm_idx_t> load_mapped_index(const std::filesystem::path& path);
+
+}  // namespace dorado::alignment
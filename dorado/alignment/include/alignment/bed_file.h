@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <istream>
 #include <map>
 #include <string>
@@ -29,10 +31,48 @@ public:
 
     const Entries& entries(const std::string& genome) const;
 
+    // Number of entries which overlap the half-open region [start, end) of the genome on the
+    // given strand. Entries with strand '.' match both strands.
+    size_t count_overlaps(const std::string& genome, int64_t start, int64_t end, char strand) const;
+
+    // As count_overlaps(), but also fills |hits| with the indices into entries(genome) of the
+    // overlapping entries, in file order.
+    size_t find_overlaps(const std::string& genome,
+                         int64_t start,
+                         int64_t end,
+                         char strand,
+                         std::vector<size_t>& hits) const;
+
     const std::string& filename() const;
 
 private:
-    std::map<std::string, Entries> m_genomes;
+    // Entries sorted by start and laid out as an implicit augmented interval tree: the node at
+    // index i is at level k, where k is the number of trailing 1 bits of i, and holds the largest
+    // end of its subtree in max_end.
+    struct IndexNode {
+        int64_t start;
+        int64_t end;
+        int64_t max_end;
+        size_t entry;
+        char strand;
+    };
+
+    struct Genome {
+        Entries entries;
+        std::vector<IndexNode> index;
+        int root_level{-1};
+    };
+
+    void build_index(Genome& genome);
+
+    template <typename Visitor>
+    void visit_overlaps(const std::string& genome,
+                        int64_t start,
+                        int64_t end,
+                        char strand,
+                        Visitor&& visitor) const;
+
+    std::map<std::string, Genome> m_genomes;
     std::string m_file_name{"<stream>"};
     static const Entries NO_ENTRIES;
 };
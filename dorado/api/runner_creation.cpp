@@ -58,9 +58,13 @@ std::pair<std::vector<basecall::RunnerPtr>, size_t> create_basecall_runners(
                                                                    params.memory_limit_fraction);
         }
         spdlog::debug("- CPU calling: set num_cpu_runners to {}", num_cpu_runners);
+        // Share the hardware threads between the runners' decode pools.
+        const size_t num_decode_threads =
+                std::max(size_t(1), std::thread::hardware_concurrency() / num_cpu_runners);
+        spdlog::debug("- CPU calling: set num_decode_threads to {}", num_decode_threads);
         for (size_t i = 0; i < num_cpu_runners; i++) {
-            runners.push_back(
-                    std::make_unique<basecall::ModelRunner>(params.model_config, params.device));
+            runners.push_back(std::make_unique<basecall::ModelRunner>(
+                    params.model_config, params.device, num_decode_threads));
         }
         if (runners.back()->batch_size() != (size_t)params.model_config.basecaller.batch_size()) {
             spdlog::debug("- CPU calling: set batch_size to {}", runners.back()->batch_size());
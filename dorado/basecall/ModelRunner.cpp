@@ -6,9 +6,11 @@
 
 namespace dorado::basecall {
 
-ModelRunner::ModelRunner(const config::BasecallModelConfig &model_config, const std::string &device)
+ModelRunner::ModelRunner(const config::BasecallModelConfig &model_config,
+                         const std::string &device,
+                         std::size_t num_decode_threads)
         : m_config(model_config),
-          m_decoder(decode::create_decoder(device, model_config)),
+          m_decoder(decode::create_decoder(device, model_config, num_decode_threads)),
           // TODO: m_options.dtype() depends on the device as TxModel uses kHalf in cuda which is not supported on CPU
           m_options(at::TensorOptions().dtype(m_decoder->dtype()).device(device)),
           m_module(load_crf_model(model_config, m_options)) {
@@ -53,6 +55,9 @@ stats::NamedStats ModelRunner::sample_stats() const {
     stats["batches_called"] = double(m_num_batches_called);
     stats["model_ms"] = double(m_model_ms);
     stats["decode_ms"] = double(m_decode_ms);
+    for (const auto &[name, value] : m_decoder->sample_stats()) {
+        stats[name] = value;
+    }
     return stats;
 }
 
@@ -1,7 +1,8 @@
 #include "CPUDecoder.h"
 
 #include "beam_search.h"
-#include "utils/thread_utils.h"
+#include "crf_forward_backward.h"
+#include "utils/concurrency/synchronisation.h"
 
 #include <ATen/Functions.h>
 #include <ATen/TensorIndexing.h>
@@ -9,6 +10,12 @@
 #include <math.h>
 #include <spdlog/spdlog.h>
 
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <string>
 #include <vector>
 
 namespace {
@@ -95,65 +102,101 @@ at::Tensor backward_scores(const at::Tensor& scores_TNC, const float fixed_stay_
 
 namespace dorado::basecall::decode {
 
+CPUDecoder::CPUDecoder(std::size_t num_threads)
+        : m_num_threads(num_threads),
+          m_thread_pool(std::make_unique<utils::concurrency::MultiQueueThreadPool>(
+                  num_threads,
+                  "cpu_beam_search")),
+          m_task_queue(&m_thread_pool->create_task_queue(utils::concurrency::TaskPriority::normal)),
+          // The pool has room to expand to twice its nominal size, so any of those threads may
+          // end up running a chunk.
+          m_worker_busy_us(2 * num_threads) {}
+
 DecodeData CPUDecoder::beam_search_part_1(DecodeData data) const { return data; }
 
+std::size_t CPUDecoder::get_worker_index() const {
+    // Each pool thread belongs to exactly one decoder, so a thread_local is enough to identify it.
+    thread_local std::optional<std::size_t> worker_index;
+    if (!worker_index) {
+        worker_index = std::min(m_num_workers_seen++, m_worker_busy_us.size() - 1);
+    }
+    return *worker_index;
+}
+
 std::vector<DecodedChunk> CPUDecoder::beam_search_part_2(const DecodeData& data) const {
     // Expects data.data(TNC)
-    const auto scores_cpu = data.data.to(at::kCPU);
+    const auto scores_cpu = data.data.to(at::kCPU).contiguous();
     const auto num_chunks = data.num_chunks;
     const auto& options = data.options;
-    int num_threads = std::min(num_chunks, 4);
-    int chunks_per_thread = num_chunks / num_threads;
-    int num_threads_with_one_more_chunk = num_chunks % num_threads;
+
+    const int num_blocks = int(scores_cpu.size(0));
+    const int num_trans_states = int(scores_cpu.size(2));
+    const int num_states = num_trans_states / 4;
+    const size_t scores_block_stride = size_t(scores_cpu.size(1)) * num_trans_states;
+    const float* const scores_ptr = scores_cpu.data_ptr<float>();
 
     std::vector<DecodedChunk> chunk_results(num_chunks);
 
-    std::vector<std::thread> threads;
-    threads.reserve(num_threads);
-    for (int i = 0; i < num_threads; ++i) {
-        threads.emplace_back([&, i]() {
-            utils::set_thread_name("cpu_beam_search");
-            at::InferenceMode inference_mode_guard;
-
-            int t_first_chunk =
-                    i * chunks_per_thread + std::min(i, num_threads_with_one_more_chunk);
-            int t_num_chunks = chunks_per_thread + int(i < num_threads_with_one_more_chunk);
-
-            // Slice TNC -> TnC
-            using Slice = at::indexing::Slice;
-            auto t_scores =
-                    scores_cpu.index({Slice(), Slice(t_first_chunk, t_first_chunk + t_num_chunks)});
-
-            at::Tensor fwd = inner::forward_scores(t_scores, options.blank_score);
-            at::Tensor bwd = inner::backward_scores(t_scores, options.blank_score);
-
-            at::Tensor posts = at::softmax(fwd + bwd, -1);
-
-            // Transpose TnC to nTC
-            t_scores = t_scores.transpose(0, 1);
-            bwd = bwd.transpose(0, 1).contiguous();
-            posts = posts.transpose(0, 1).contiguous();
-
-            // Iter over n in nTC, passing TC tensors to beam_search_decode
-            for (int chunk_idx = 0; chunk_idx < t_num_chunks; chunk_idx++) {
-                auto decode_result = beam_search_decode(t_scores[chunk_idx], bwd[chunk_idx],
-                                                        posts[chunk_idx], options.beam_width,
-                                                        options.beam_cut, options.blank_score,
-                                                        options.q_shift, options.q_scale, 1.0f);
-                chunk_results[t_first_chunk + chunk_idx] = DecodedChunk{
-                        std::get<0>(decode_result),
-                        std::get<1>(decode_result),
-                        std::get<2>(decode_result),
-                };
+    // Work is handed out a chunk at a time so that the pool balances itself regardless of how
+    // long each chunk takes to decode.
+    utils::concurrency::Latch chunks_remaining(num_chunks);
+    std::mutex error_mutex;
+    std::exception_ptr error;
+    for (int chunk_idx = 0; chunk_idx < num_chunks; ++chunk_idx) {
+        m_task_queue->push([&, chunk_idx] {
+            const auto start_time = std::chrono::steady_clock::now();
+            try {
+                at::InferenceMode inference_mode_guard;
+
+                // Reused for every chunk this thread decodes.
+                thread_local ForwardBackwardWorkspace fwd_bwd_workspace;
+                thread_local BeamSearchWorkspace beam_search_workspace;
+
+                // Runs directly on the TNC scores, producing TC guides and posts for this chunk.
+                forward_backward(scores_ptr + size_t(chunk_idx) * num_trans_states,
+                                 scores_block_stride, num_blocks, num_states, options.blank_score,
+                                 fwd_bwd_workspace);
+                const auto bwd =
+                        at::from_blob(fwd_bwd_workspace.bwd(), {num_blocks + 1, num_states});
+                const auto posts =
+                        at::from_blob(fwd_bwd_workspace.posts(), {num_blocks + 1, num_states});
+
+                using Slice = at::indexing::Slice;
+                beam_search_decode(scores_cpu.index({Slice(), chunk_idx}), bwd, posts,
+                                   options.beam_width, options.beam_cut, options.blank_score,
+                                   options.q_shift, options.q_scale, 1.0f, beam_search_workspace,
+                                   chunk_results[chunk_idx]);
+            } catch (...) {
+                std::lock_guard lock(error_mutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
             }
+            m_worker_busy_us[get_worker_index()] +=
+                    std::chrono::duration_cast<std::chrono::microseconds>(
+                            std::chrono::steady_clock::now() - start_time)
+                            .count();
+            ++m_num_chunks_decoded;
+            chunks_remaining.count_down();
         });
     }
+    chunks_remaining.wait();
 
-    for (auto& thread : threads) {
-        thread.join();
+    if (error) {
+        std::rethrow_exception(error);
     }
-
     return chunk_results;
 }
 
+stats::NamedStats CPUDecoder::sample_stats() const {
+    stats::NamedStats stats;
+    stats["decode_threads"] = double(m_num_threads);
+    stats["chunks_decoded"] = double(m_num_chunks_decoded);
+    const auto num_workers = std::min(m_num_workers_seen.load(), m_worker_busy_us.size());
+    for (std::size_t i = 0; i < num_workers; ++i) {
+        stats["decode_worker_" + std::to_string(i) + "_busy_ms"] = m_worker_busy_us[i] / 1000.0;
+    }
+    return stats;
+}
+
 }  // namespace dorado::basecall::decode
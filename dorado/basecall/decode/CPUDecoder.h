@@ -1,13 +1,22 @@
 #pragma once
 
 #include "Decoder.h"
+#include "utils/concurrency/multi_queue_thread_pool.h"
 
 #include <ATen/core/TensorBody.h>
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
 namespace dorado::basecall::decode {
 
 namespace inner {
 
+// Reference ATen implementations of the CRF forward/backward passes.
+// CPUDecoder uses the fused forward_backward() kernel instead.
 at::Tensor forward_scores(const at::Tensor& scores_TNC, float fixed_stay_score);
 at::Tensor backward_scores(const at::Tensor& scores_TNC, float fixed_stay_score);
 
@@ -15,10 +24,27 @@ at::Tensor backward_scores(const at::Tensor& scores_TNC, float fixed_stay_score)
 
 class CPUDecoder final : public Decoder {
 public:
+    // Chunks are decoded on a pool of |num_threads| workers that lives as long as the decoder.
+    explicit CPUDecoder(std::size_t num_threads);
+
     DecodeData beam_search_part_1(DecodeData data) const override;
     std::vector<DecodedChunk> beam_search_part_2(const DecodeData& data) const override;
 
     at::ScalarType dtype() const override { return at::ScalarType::Float; }
+    stats::NamedStats sample_stats() const override;
+
+private:
+    std::size_t get_worker_index() const;
+
+    const std::size_t m_num_threads;
+    std::unique_ptr<utils::concurrency::MultiQueueThreadPool> m_thread_pool;
+    utils::concurrency::MultiQueueThreadPool::ThreadPoolQueue* m_task_queue;
+
+    // Performance monitoring stats.
+    // Busy time is tracked for each pool thread, in the order they first picked up a chunk.
+    mutable std::vector<std::atomic<int64_t>> m_worker_busy_us;
+    mutable std::atomic<std::size_t> m_num_workers_seen{0};
+    mutable std::atomic<int64_t> m_num_chunks_decoded{0};
 };
 
 }  // namespace dorado::basecall::decode
@@ -10,10 +10,14 @@
 
 #include <c10/core/Device.h>
 
+#include <algorithm>
+#include <thread>
+
 namespace dorado::basecall::decode {
 
 std::unique_ptr<Decoder> create_decoder(c10::Device device,
-                                        const config::BasecallModelConfig& config) {
+                                        const config::BasecallModelConfig& config,
+                                        std::size_t num_cpu_threads) {
 #if DORADO_CUDA_BUILD
     if (device.is_cuda()) {
         return std::make_unique<decode::CUDADecoder>(config.clamp ? 5.f : 0.f);
@@ -22,7 +26,10 @@ std::unique_ptr<Decoder> create_decoder(c10::Device device,
     (void)config;  // unused in other build types
 #endif
     if (device.is_cpu()) {
-        return std::make_unique<decode::CPUDecoder>();
+        if (num_cpu_threads == 0) {
+            num_cpu_threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        return std::make_unique<decode::CPUDecoder>(num_cpu_threads);
     }
 
     throw std::runtime_error("Unsupported device type for decoder creation: " + device.str());
@@ -2,9 +2,11 @@
 
 #include "basecall/DecodedChunk.h"
 #include "nn/AuxiliaryData.h"
+#include "utils/stats.h"
 
 #include <ATen/core/TensorBody.h>
 
+#include <cstddef>
 #include <memory>
 #include <vector>
 
@@ -28,9 +30,13 @@ public:
     virtual std::vector<DecodedChunk> beam_search_part_2(const DecodeData &data) const = 0;
     // Returns the torch::TensorOptions::dtype to use for input data to models that use this decoder
     virtual at::ScalarType dtype() const = 0;
+    virtual stats::NamedStats sample_stats() const { return {}; }
 };
 
+// |num_cpu_threads| is the size of the worker pool used when decoding on the CPU, with 0 meaning
+// one thread per hardware thread. It is ignored for other devices.
 std::unique_ptr<Decoder> create_decoder(c10::Device device,
-                                        const config::BasecallModelConfig &config);
+                                        const config::BasecallModelConfig &config,
+                                        std::size_t num_cpu_threads = 0);
 
 }  // namespace dorado::basecall::decode
@@ -10,35 +10,17 @@
 #include <algorithm>
 #include <array>
 #include <bitset>
-#include <cstring>
 #include <iostream>
 #include <limits>
 #include <numeric>
 
 namespace {
 
-// 16 bit state supports 7-mers with 4 bases.
-typedef uint16_t state_t;
+using state_t = dorado::basecall::decode::BeamSearchWorkspace::state_t;
 
 constexpr int NUM_BASE_BITS = 2;
 constexpr int NUM_BASES = 1 << NUM_BASE_BITS;
 
-// This is the data we need to retain for the whole beam
-struct BeamElement {
-    state_t state;
-    uint8_t prev_element_index;
-    bool stay;
-};
-
-// This is the data we need to retain for only the previous timestep (block) in the beam
-// (and what we construct for the new timestep)
-struct BeamFrontElement {
-    uint32_t hash;
-    state_t state;
-    uint8_t prev_element_index;
-    bool stay;
-};
-
 float log_sum_exp(float x, float y) {
     float abs_diff = std::abs(x - y);
     return std::max(x, y) + ((abs_diff < 17.0f) ? (std::log1p(std::exp(-abs_diff))) : 0.0f);
@@ -51,19 +33,25 @@ int get_num_states(size_t num_trans_states) {
     return int(num_trans_states / NUM_BASES);
 }
 
-std::tuple<std::string, std::string> generate_sequence(const std::vector<uint8_t>& moves,
-                                                       const std::vector<int32_t>& states,
-                                                       const std::vector<float>& qual_data,
-                                                       float shift,
-                                                       float scale) {
+void generate_sequence(const std::vector<uint8_t>& moves,
+                       const std::vector<int32_t>& states,
+                       const std::vector<float>& qual_data,
+                       float shift,
+                       float scale,
+                       std::vector<float>& baseProbs,
+                       std::vector<float>& totalProbs,
+                       std::string& sequence,
+                       std::string& qstring) {
     size_t seqPos = 0;
     size_t num_blocks = moves.size();
     size_t seqLen = accumulate(moves.begin(), moves.end(), 0);
 
-    std::string sequence(seqLen, 'N');
-    std::string qstring(seqLen, '!');
+    sequence.assign(seqLen, 'N');
+    qstring.assign(seqLen, '!');
     std::array<char, 4> alphabet = {'A', 'C', 'G', 'T'};
-    std::vector<float> baseProbs(seqLen), totalProbs(seqLen);
+    // These may be larger than seqLen, since the workspace is sized for the longest possible path.
+    std::fill_n(baseProbs.begin(), seqLen, 0.0f);
+    std::fill_n(totalProbs.begin(), seqLen, 0.0f);
 
     for (size_t blk = 0; blk < num_blocks; ++blk) {
         int state = states[blk];
@@ -97,8 +85,6 @@ std::tuple<std::string, std::string> generate_sequence(const std::vector<uint8_t
         qscore = std::clamp(qscore, 1.0f, 50.0f);
         qstring[i] = static_cast<char>(33.5f + qscore);
     }
-
-    return make_tuple(std::move(sequence), std::move(qstring));
 }
 
 // Incorporates NUM_NEW_BITS into a Castagnoli CRC32, aka CRC32C
@@ -132,9 +118,8 @@ float beam_search(const T* const scores,
                   size_t max_beam_width,
                   float beam_cut,
                   float fixed_stay_score,
-                  std::vector<int32_t>& states,
+                  BeamSearchWorkspace& workspace,
                   std::vector<uint8_t>& moves,
-                  std::vector<float>& qual_data,
                   float score_scale,
                   float posts_scale) {
     const size_t num_states = 1ull << num_state_bits;
@@ -149,30 +134,33 @@ float beam_search(const T* const scores,
     const float log_beam_cut =
             (beam_cut > 0.0f) ? logf(beam_cut) : std::numeric_limits<float>::max();
 
-    // Create the beam.  We need to keep beam_width elements for each block, plus the initial state
-    std::vector<BeamElement> beam_vector(max_beam_width * (num_blocks + 1));
+    workspace.reserve(num_blocks, num_states, max_beam_width);
 
-    // Create the previous and current beam fronts
+    // The beam.  We need to keep beam_width elements for each block, plus the initial state
+    auto& beam_vector = workspace.beam_vector;
+
+    // The previous and current beam fronts
     // Each existing element can be extended by one of NUM_BASES, or be a stay.
-    size_t max_beam_candidates = (NUM_BASES + 1) * max_beam_width;
+    auto& current_beam_front = workspace.current_beam_front;
+    auto& prev_beam_front = workspace.prev_beam_front;
 
-    std::vector<BeamFrontElement> current_beam_front(max_beam_candidates);
-    std::vector<BeamFrontElement> prev_beam_front(max_beam_candidates);
+    auto& current_scores = workspace.current_scores;
+    auto& prev_scores = workspace.prev_scores;
 
-    std::vector<float> current_scores(max_beam_candidates);
-    std::vector<float> prev_scores(max_beam_candidates);
+    auto& states = workspace.states;
+    auto& qual_data = workspace.qual_data;
 
     // Find the score an initial element needs in order to make it into the beam
-    T beam_init_threshold = std::numeric_limits<T>::lowest();
+    float beam_init_threshold = std::numeric_limits<float>::lowest();
     if (max_beam_width < num_states) {
         // Copy the first set of back guides and sort to extract max_beam_width highest elements
-        std::vector<T> sorted_back_guides(num_states);
-        std::memcpy(sorted_back_guides.data(), back_guide, num_states * sizeof(T));
+        auto& sorted_back_guides = workspace.sorted_back_guides;
+        std::copy_n(back_guide, num_states, sorted_back_guides.begin());
 
         // Note we don't need a full sort here to get the max_beam_width highest values
         std::nth_element(sorted_back_guides.begin(),
-                         sorted_back_guides.begin() + max_beam_width - 1, sorted_back_guides.end(),
-                         std::greater<T>());
+                         sorted_back_guides.begin() + max_beam_width - 1,
+                         sorted_back_guides.begin() + num_states, std::greater<float>());
         beam_init_threshold = sorted_back_guides[max_beam_width - 1];
     }
 
@@ -442,7 +430,6 @@ float beam_search(const T* const scores,
 
     // Write out sequence bases and move table
     moves.resize(num_blocks);
-    states.resize(num_blocks);
 
     // Note that we don't emit the seed state at the front of the beam, hence the -1 offset when copying the path
     uint8_t element_index = 0;
@@ -519,16 +506,43 @@ float beam_search(const T* const scores,
     return final_score;
 }
 
-std::tuple<std::string, std::string, std::vector<uint8_t>> beam_search_decode(
-        const at::Tensor& scores_t,
-        const at::Tensor& back_guides_t,
-        const at::Tensor& posts_t,
-        size_t max_beam_width,
-        float beam_cut,
-        float fixed_stay_score,
-        float q_shift,
-        float q_scale,
-        float byte_score_scale) {
+void BeamSearchWorkspace::reserve(size_t num_blocks, size_t num_states, size_t max_beam_width) {
+    const auto grow = [](auto& buffer, size_t size) {
+        if (buffer.size() < size) {
+            buffer.resize(size);
+        }
+    };
+
+    // We need to keep beam_width elements for each block, plus the initial state.
+    grow(beam_vector, max_beam_width * (num_blocks + 1));
+
+    // Each existing element can be extended by one of NUM_BASES, or be a stay.
+    const size_t max_beam_candidates = (NUM_BASES + 1) * max_beam_width;
+    grow(current_beam_front, max_beam_candidates);
+    grow(prev_beam_front, max_beam_candidates);
+    grow(current_scores, max_beam_candidates);
+    grow(prev_scores, max_beam_candidates);
+
+    grow(sorted_back_guides, num_states);
+    grow(states, num_blocks);
+    grow(qual_data, num_blocks * NUM_BASES);
+
+    // A path can't contain more bases than there are blocks.
+    grow(base_probs, num_blocks);
+    grow(total_probs, num_blocks);
+}
+
+void beam_search_decode(const at::Tensor& scores_t,
+                        const at::Tensor& back_guides_t,
+                        const at::Tensor& posts_t,
+                        size_t max_beam_width,
+                        float beam_cut,
+                        float fixed_stay_score,
+                        float q_shift,
+                        float q_scale,
+                        float byte_score_scale,
+                        BeamSearchWorkspace& workspace,
+                        DecodedChunk& result) {
     const int num_blocks = int(scores_t.size(0));
     const int num_states = get_num_states(scores_t.size(1));
     const int num_state_bits = static_cast<int>(std::log2(num_states));
@@ -547,9 +561,7 @@ std::tuple<std::string, std::string, std::vector<uint8_t>> beam_search_decode(
     // scores_t may come from a tensor with chunks interleaved, but make sure the last dimension is contiguous
     auto scores_block_contig = (scores_t.stride(1) == 1) ? scores_t : scores_t.contiguous();
 
-    std::vector<int32_t> states(num_blocks);
-    std::vector<uint8_t> moves(num_blocks);
-    std::vector<float> qual_data(num_blocks * NUM_BASES);
+    auto& moves = result.moves;
 
     const size_t scores_block_stride = scores_block_contig.stride(0);
     if (scores_t.dtype() == at::ScalarType::Float) {
@@ -564,8 +576,8 @@ std::tuple<std::string, std::string, std::vector<uint8_t>> beam_search_decode(
         const auto posts = posts_contig->data_ptr<float>();
 
         beam_search<float, float>(scores, scores_block_stride, back_guides, posts, num_state_bits,
-                                  num_blocks, max_beam_width, beam_cut, fixed_stay_score, states,
-                                  moves, qual_data, 1.0f, 1.0f);
+                                  num_blocks, max_beam_width, beam_cut, fixed_stay_score,
+                                  workspace, moves, 1.0f, 1.0f);
     } else if (scores_t.dtype() == at::kChar) {
         // If the scores are 8 bit, the posterior probabilities must be 16 bit (Apple path).
         if (posts_t.dtype() != at::ScalarType::Short) {
@@ -579,7 +591,7 @@ std::tuple<std::string, std::string, std::vector<uint8_t>> beam_search_decode(
         const float posts_scale = static_cast<float>(1.0 / 32767.0);
         beam_search<int8_t, int16_t>(scores, scores_block_stride, back_guides, posts,
                                      num_state_bits, num_blocks, max_beam_width, beam_cut,
-                                     fixed_stay_score, states, moves, qual_data, byte_score_scale,
+                                     fixed_stay_score, workspace, moves, byte_score_scale,
                                      posts_scale);
 
     } else if (scores_t.dtype() == at::kHalf) {
@@ -593,16 +605,33 @@ std::tuple<std::string, std::string, std::vector<uint8_t>> beam_search_decode(
         const auto posts = posts_contig->data_ptr<float>();
         beam_search<c10::Half, float>(scores, scores_block_stride, back_guides, posts,
                                       num_state_bits, num_blocks, max_beam_width, beam_cut,
-                                      fixed_stay_score, states, moves, qual_data, 1.0f, 1.0f);
+                                      fixed_stay_score, workspace, moves, 1.0f, 1.0f);
 
     } else {
         throw std::runtime_error(std::string("beam_search_decode: unsupported tensor type ") +
                                  std::string(scores_t.dtype().name()));
     }
 
-    auto [sequence, qstring] = generate_sequence(moves, states, qual_data, q_shift, q_scale);
+    generate_sequence(moves, workspace.states, workspace.qual_data, q_shift, q_scale,
+                      workspace.base_probs, workspace.total_probs, result.sequence,
+                      result.qstring);
+}
 
-    return {std::move(sequence), std::move(qstring), std::move(moves)};
+std::tuple<std::string, std::string, std::vector<uint8_t>> beam_search_decode(
+        const at::Tensor& scores_t,
+        const at::Tensor& back_guides_t,
+        const at::Tensor& posts_t,
+        size_t max_beam_width,
+        float beam_cut,
+        float fixed_stay_score,
+        float q_shift,
+        float q_scale,
+        float byte_score_scale) {
+    thread_local BeamSearchWorkspace workspace;
+    DecodedChunk result;
+    beam_search_decode(scores_t, back_guides_t, posts_t, max_beam_width, beam_cut,
+                       fixed_stay_score, q_shift, q_scale, byte_score_scale, workspace, result);
+    return {std::move(result.sequence), std::move(result.qstring), std::move(result.moves)};
 }
 
 }  // namespace dorado::basecall::decode
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "basecall/DecodedChunk.h"
+
 #include <ATen/core/TensorBody.h>
 
 #include <cstddef>
@@ -9,6 +11,62 @@
 #include <vector>
 
 namespace dorado::basecall::decode {
+
+// Scratch space for beam_search_decode().
+// A workspace is intended to be owned by a single decode thread and reused for every chunk it
+// decodes. Buffers only ever grow, so once it has seen the largest chunk for a given model no
+// further allocations are made.
+class BeamSearchWorkspace {
+public:
+    // 16 bit state supports 7-mers with 4 bases.
+    using state_t = uint16_t;
+
+    // This is the data we need to retain for the whole beam
+    struct BeamElement {
+        state_t state;
+        uint8_t prev_element_index;
+        bool stay;
+    };
+
+    // This is the data we need to retain for only the previous timestep (block) in the beam
+    // (and what we construct for the new timestep)
+    struct BeamFrontElement {
+        uint32_t hash;
+        state_t state;
+        uint8_t prev_element_index;
+        bool stay;
+    };
+
+    // Grow the buffers (if necessary) to fit a chunk of |num_blocks| timesteps.
+    void reserve(size_t num_blocks, size_t num_states, size_t max_beam_width);
+
+    std::vector<BeamElement> beam_vector;
+    std::vector<BeamFrontElement> current_beam_front;
+    std::vector<BeamFrontElement> prev_beam_front;
+    std::vector<float> current_scores;
+    std::vector<float> prev_scores;
+    std::vector<float> sorted_back_guides;
+    std::vector<int32_t> states;
+    std::vector<float> qual_data;
+    std::vector<float> base_probs;
+    std::vector<float> total_probs;
+};
+
+// Decodes a single chunk into |result|, reusing the storage already held by |result| and
+// |workspace| where possible.
+void beam_search_decode(const at::Tensor& scores_t,
+                        const at::Tensor& back_guides_t,
+                        const at::Tensor& posts_t,
+                        size_t max_beam_width,
+                        float beam_cut,
+                        float fixed_stay_score,
+                        float q_shift,
+                        float q_scale,
+                        float byte_score_scale,
+                        BeamSearchWorkspace& workspace,
+                        DecodedChunk& result);
+
+// Convenience overload that decodes using a workspace owned by the calling thread.
 std::tuple<std::string, std::string, std::vector<uint8_t>> beam_search_decode(
         const at::Tensor& scores_t,
         const at::Tensor& back_guides_t,
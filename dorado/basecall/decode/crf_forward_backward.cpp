@@ -0,0 +1,532 @@
+#include "crf_forward_backward.h"
+
+#include "utils/simd.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+// Each state can be entered from 4 predecessor states via a step, or from itself via a stay.
+constexpr size_t NUM_BASES = 4;
+
+/*  Notation used below, for num_states S and Q = S / 4:
+ *  - The transition score for entering state s from predecessor s / 4 + k * Q lives at
+ *    scores[s * 4 + k], which is the layout the CRF models emit.
+ *  - The successors of state p are 4 * (p % Q) + j, entered with base j, and the transition score
+ *    used is scores[(4 * (p % Q) + j) * 4 + p / Q].
+ */
+
+float log_sum_exp_5(const float (&vals)[NUM_BASES + 1]) {
+    float max_val = vals[0];
+    for (size_t i = 1; i < NUM_BASES + 1; ++i) {
+        max_val = std::max(max_val, vals[i]);
+    }
+    float sum = 0.0f;
+    for (size_t i = 0; i < NUM_BASES + 1; ++i) {
+        sum += std::exp(vals[i] - max_val);
+    }
+    return max_val + std::log(sum);
+}
+
+void backward_step_scalar(const float* const block_scores,
+                          const float* const beta_next,
+                          float* const beta,
+                          size_t num_states,
+                          float fixed_stay_score) {
+    const size_t Q = num_states / NUM_BASES;
+    float vals[NUM_BASES + 1];
+    for (size_t p = 0; p < num_states; ++p) {
+        const size_t base_state = NUM_BASES * (p % Q);
+        const size_t top_base = p / Q;
+        vals[0] = beta_next[p] + fixed_stay_score;
+        for (size_t j = 0; j < NUM_BASES; ++j) {
+            const size_t succ = base_state + j;
+            vals[j + 1] = beta_next[succ] + block_scores[succ * NUM_BASES + top_base];
+        }
+        beta[p] = log_sum_exp_5(vals);
+    }
+}
+
+void forward_step_scalar(const float* const block_scores,
+                         const float* const alpha,
+                         float* const alpha_next,
+                         size_t num_states,
+                         float fixed_stay_score) {
+    const size_t Q = num_states / NUM_BASES;
+    float vals[NUM_BASES + 1];
+    for (size_t s = 0; s < num_states; ++s) {
+        vals[0] = alpha[s] + fixed_stay_score;
+        for (size_t k = 0; k < NUM_BASES; ++k) {
+            vals[k + 1] = alpha[s / NUM_BASES + k * Q] + block_scores[s * NUM_BASES + k];
+        }
+        alpha_next[s] = log_sum_exp_5(vals);
+    }
+}
+
+void posts_step_scalar(const float* const alpha,
+                       const float* const beta,
+                       float* const posts,
+                       size_t num_states) {
+    float max_val = std::numeric_limits<float>::lowest();
+    for (size_t s = 0; s < num_states; ++s) {
+        posts[s] = alpha[s] + beta[s];
+        max_val = std::max(max_val, posts[s]);
+    }
+    float sum = 0.0f;
+    for (size_t s = 0; s < num_states; ++s) {
+        posts[s] = std::exp(posts[s] - max_val);
+        sum += posts[s];
+    }
+    const float inv_sum = 1.0f / sum;
+    for (size_t s = 0; s < num_states; ++s) {
+        posts[s] *= inv_sum;
+    }
+}
+
+void forward_backward_scalar(const float* const scores,
+                             size_t scores_block_stride,
+                             size_t num_blocks,
+                             size_t num_states,
+                             float fixed_stay_score,
+                             dorado::basecall::decode::ForwardBackwardWorkspace& workspace) {
+    float* const bwd = workspace.bwd();
+    float* const posts = workspace.posts();
+    float* alpha = workspace.alpha();
+    float* alpha_next = alpha + num_states;
+
+    std::fill_n(bwd + num_blocks * num_states, num_states, 0.0f);
+    for (size_t block_idx = num_blocks; block_idx != 0; --block_idx) {
+        backward_step_scalar(scores + (block_idx - 1) * scores_block_stride,
+                             bwd + block_idx * num_states, bwd + (block_idx - 1) * num_states,
+                             num_states, fixed_stay_score);
+    }
+
+    std::fill_n(alpha, num_states, 0.0f);
+    posts_step_scalar(alpha, bwd, posts, num_states);
+    for (size_t block_idx = 0; block_idx < num_blocks; ++block_idx) {
+        forward_step_scalar(scores + block_idx * scores_block_stride, alpha, alpha_next,
+                            num_states, fixed_stay_score);
+        std::swap(alpha, alpha_next);
+        posts_step_scalar(alpha, bwd + (block_idx + 1) * num_states,
+                          posts + (block_idx + 1) * num_states, num_states);
+    }
+}
+
+#if !ENABLE_NEON_IMPL  // We only need the SIMD implementation when we have Neon support.
+#if ENABLE_AVX2_IMPL
+[[maybe_unused]] __attribute__((target("default")))
+#endif
+void forward_backward_impl(const float* const scores,
+                           size_t scores_block_stride,
+                           size_t num_blocks,
+                           size_t num_states,
+                           float fixed_stay_score,
+                           dorado::basecall::decode::ForwardBackwardWorkspace& workspace) {
+    forward_backward_scalar(scores, scores_block_stride, num_blocks, num_states, fixed_stay_score,
+                            workspace);
+}
+#endif  // ENABLE_NEON_IMPL
+
+#if ENABLE_AVX2_IMPL || ENABLE_NEON_IMPL
+
+namespace simd = dorado::utils::simd;
+
+// Helpers called from the vectorised kernel need the same target as the kernel itself in order
+// to be inlined.
+#if ENABLE_AVX2_IMPL
+#define KERNEL_TARGET __attribute__((target("avx2,fma")))
+#else
+#define KERNEL_TARGET
+#endif
+
+#if ENABLE_AVX2_IMPL
+
+// Loads 8 rows of 4 floats, |row_stride| floats apart, such that out[k][i] = ptr[i * row_stride + k].
+KERNEL_TARGET inline void load_transposed(const float* const ptr,
+                                          size_t row_stride,
+                                          simd::FloatRegister (&out)[NUM_BASES]) {
+    // Pair up row i with row i + 4 so that a 4x4 transpose within each 128 bit lane finishes the job.
+    const __m256 a0 = _mm256_loadu2_m128(ptr + 4 * row_stride, ptr);
+    const __m256 a1 = _mm256_loadu2_m128(ptr + 5 * row_stride, ptr + row_stride);
+    const __m256 a2 = _mm256_loadu2_m128(ptr + 6 * row_stride, ptr + 2 * row_stride);
+    const __m256 a3 = _mm256_loadu2_m128(ptr + 7 * row_stride, ptr + 3 * row_stride);
+    const __m256 t0 = _mm256_unpacklo_ps(a0, a1);
+    const __m256 t1 = _mm256_unpacklo_ps(a2, a3);
+    const __m256 t2 = _mm256_unpackhi_ps(a0, a1);
+    const __m256 t3 = _mm256_unpackhi_ps(a2, a3);
+    out[0] = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(1, 0, 1, 0));
+    out[1] = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(3, 2, 3, 2));
+    out[2] = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(1, 0, 1, 0));
+    out[3] = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(3, 2, 3, 2));
+}
+
+// Inverse of load_transposed(): ptr[i * row_stride + k] = in[k][i].
+KERNEL_TARGET inline void store_transposed(float* const ptr,
+                                           size_t row_stride,
+                                           const simd::FloatRegister (&in)[NUM_BASES]) {
+    const __m256 t0 = _mm256_unpacklo_ps(in[0], in[1]);
+    const __m256 t1 = _mm256_unpacklo_ps(in[2], in[3]);
+    const __m256 t2 = _mm256_unpackhi_ps(in[0], in[1]);
+    const __m256 t3 = _mm256_unpackhi_ps(in[2], in[3]);
+    _mm256_storeu2_m128(ptr + 4 * row_stride, ptr, _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(1, 0, 1, 0)));
+    _mm256_storeu2_m128(ptr + 5 * row_stride, ptr + row_stride,
+                        _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(3, 2, 3, 2)));
+    _mm256_storeu2_m128(ptr + 6 * row_stride, ptr + 2 * row_stride,
+                        _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(1, 0, 1, 0)));
+    _mm256_storeu2_m128(ptr + 7 * row_stride, ptr + 3 * row_stride,
+                        _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(3, 2, 3, 2)));
+}
+
+KERNEL_TARGET inline float horizontal_max(simd::FloatRegister reg) {
+    __m128 x = _mm_max_ps(_mm256_castps256_ps128(reg), _mm256_extractf128_ps(reg, 1));
+    x = _mm_max_ps(x, _mm_movehl_ps(x, x));
+    x = _mm_max_ss(x, _mm_shuffle_ps(x, x, _MM_SHUFFLE(1, 1, 1, 1)));
+    return _mm_cvtss_f32(x);
+}
+
+KERNEL_TARGET inline float horizontal_sum(simd::FloatRegister reg) {
+    __m128 x = _mm_add_ps(_mm256_castps256_ps128(reg), _mm256_extractf128_ps(reg, 1));
+    x = _mm_add_ps(x, _mm_movehl_ps(x, x));
+    x = _mm_add_ss(x, _mm_shuffle_ps(x, x, _MM_SHUFFLE(1, 1, 1, 1)));
+    return _mm_cvtss_f32(x);
+}
+
+// Cephes style exp(), accurate to ~1 ulp over the range we care about.
+KERNEL_TARGET inline simd::FloatRegister simd_exp(simd::FloatRegister x) {
+    x = _mm256_min_ps(x, _mm256_set1_ps(88.3762626647949f));
+    x = _mm256_max_ps(x, _mm256_set1_ps(-88.3762626647949f));
+
+    // exp(x) = 2^n * exp(r), with r = x - n * ln(2).
+    const __m256 n = _mm256_floor_ps(_mm256_fmadd_ps(x, _mm256_set1_ps(1.44269504088896341f),
+                                                     _mm256_set1_ps(0.5f)));
+    x = _mm256_fnmadd_ps(n, _mm256_set1_ps(0.693359375f), x);
+    x = _mm256_fnmadd_ps(n, _mm256_set1_ps(-2.12194440e-4f), x);
+
+    __m256 y = _mm256_set1_ps(1.9875691500e-4f);
+    y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(1.3981999507e-3f));
+    y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(8.3334519073e-3f));
+    y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(4.1665795894e-2f));
+    y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(1.6666665459e-1f));
+    y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(5.0000001201e-1f));
+    y = _mm256_fmadd_ps(y, _mm256_mul_ps(x, x), _mm256_add_ps(x, _mm256_set1_ps(1.0f)));
+
+    const __m256i pow2n = _mm256_slli_epi32(
+            _mm256_add_epi32(_mm256_cvttps_epi32(n), _mm256_set1_epi32(0x7f)), 23);
+    return _mm256_mul_ps(y, _mm256_castsi256_ps(pow2n));
+}
+
+// Cephes style log() for positive normal inputs.
+KERNEL_TARGET inline simd::FloatRegister simd_log(simd::FloatRegister x) {
+    const __m256i bits = _mm256_castps_si256(x);
+    // Split into exponent and a mantissa in [0.5, 1).
+    __m256 e = _mm256_cvtepi32_ps(
+            _mm256_sub_epi32(_mm256_srli_epi32(bits, 23), _mm256_set1_epi32(0x7e)));
+    x = _mm256_or_ps(_mm256_and_ps(x, _mm256_castsi256_ps(_mm256_set1_epi32(~0x7f800000))),
+                     _mm256_set1_ps(0.5f));
+
+    // Shift the mantissa into [sqrt(0.5), sqrt(2)).
+    const __m256 mask = _mm256_cmp_ps(x, _mm256_set1_ps(0.707106781186547524f), _CMP_LT_OS);
+    e = _mm256_sub_ps(e, _mm256_and_ps(_mm256_set1_ps(1.0f), mask));
+    x = _mm256_add_ps(_mm256_sub_ps(x, _mm256_set1_ps(1.0f)), _mm256_and_ps(x, mask));
+
+    const __m256 z = _mm256_mul_ps(x, x);
+    __m256 y = _mm256_set1_ps(7.0376836292e-2f);
+    y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(-1.1514610310e-1f));
+    y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(1.1676998740e-1f));
+    y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(-1.2420140846e-1f));
+    y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(1.4249322787e-1f));
+    y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(-1.6668057665e-1f));
+    y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(2.0000714765e-1f));
+    y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(-2.4999993993e-1f));
+    y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(3.3333331174e-1f));
+    y = _mm256_mul_ps(_mm256_mul_ps(y, x), z);
+    y = _mm256_fmadd_ps(e, _mm256_set1_ps(-2.12194440e-4f), y);
+    y = _mm256_fnmadd_ps(z, _mm256_set1_ps(0.5f), y);
+    x = _mm256_add_ps(x, y);
+    return _mm256_fmadd_ps(e, _mm256_set1_ps(0.693359375f), x);
+}
+
+#else  // ENABLE_NEON_IMPL
+
+// Loads 4 rows of 4 floats, |row_stride| floats apart, such that out[k][i] = ptr[i * row_stride + k].
+inline void load_transposed(const float* const ptr,
+                            size_t row_stride,
+                            simd::FloatRegister (&out)[NUM_BASES]) {
+    const float32x4x2_t t01 = vtrnq_f32(vld1q_f32(ptr), vld1q_f32(ptr + row_stride));
+    const float32x4x2_t t23 =
+            vtrnq_f32(vld1q_f32(ptr + 2 * row_stride), vld1q_f32(ptr + 3 * row_stride));
+    out[0] = vcombine_f32(vget_low_f32(t01.val[0]), vget_low_f32(t23.val[0]));
+    out[1] = vcombine_f32(vget_low_f32(t01.val[1]), vget_low_f32(t23.val[1]));
+    out[2] = vcombine_f32(vget_high_f32(t01.val[0]), vget_high_f32(t23.val[0]));
+    out[3] = vcombine_f32(vget_high_f32(t01.val[1]), vget_high_f32(t23.val[1]));
+}
+
+// Inverse of load_transposed(): ptr[i * row_stride + k] = in[k][i].
+inline void store_transposed(float* const ptr,
+                             size_t row_stride,
+                             const simd::FloatRegister (&in)[NUM_BASES]) {
+    const float32x4x2_t t01 = vtrnq_f32(in[0], in[1]);
+    const float32x4x2_t t23 = vtrnq_f32(in[2], in[3]);
+    vst1q_f32(ptr, vcombine_f32(vget_low_f32(t01.val[0]), vget_low_f32(t23.val[0])));
+    vst1q_f32(ptr + row_stride, vcombine_f32(vget_low_f32(t01.val[1]), vget_low_f32(t23.val[1])));
+    vst1q_f32(ptr + 2 * row_stride,
+              vcombine_f32(vget_high_f32(t01.val[0]), vget_high_f32(t23.val[0])));
+    vst1q_f32(ptr + 3 * row_stride,
+              vcombine_f32(vget_high_f32(t01.val[1]), vget_high_f32(t23.val[1])));
+}
+
+inline float horizontal_max(simd::FloatRegister reg) { return vmaxvq_f32(reg); }
+
+inline float horizontal_sum(simd::FloatRegister reg) { return vaddvq_f32(reg); }
+
+// Cephes style exp(), accurate to ~1 ulp over the range we care about.
+inline simd::FloatRegister simd_exp(simd::FloatRegister x) {
+    x = vminq_f32(x, vdupq_n_f32(88.3762626647949f));
+    x = vmaxq_f32(x, vdupq_n_f32(-88.3762626647949f));
+
+    // exp(x) = 2^n * exp(r), with r = x - n * ln(2).
+    const float32x4_t n =
+            vrndmq_f32(vfmaq_f32(vdupq_n_f32(0.5f), x, vdupq_n_f32(1.44269504088896341f)));
+    x = vfmsq_f32(x, n, vdupq_n_f32(0.693359375f));
+    x = vfmsq_f32(x, n, vdupq_n_f32(-2.12194440e-4f));
+
+    float32x4_t y = vdupq_n_f32(1.9875691500e-4f);
+    y = vfmaq_f32(vdupq_n_f32(1.3981999507e-3f), y, x);
+    y = vfmaq_f32(vdupq_n_f32(8.3334519073e-3f), y, x);
+    y = vfmaq_f32(vdupq_n_f32(4.1665795894e-2f), y, x);
+    y = vfmaq_f32(vdupq_n_f32(1.6666665459e-1f), y, x);
+    y = vfmaq_f32(vdupq_n_f32(5.0000001201e-1f), y, x);
+    y = vfmaq_f32(vaddq_f32(x, vdupq_n_f32(1.0f)), y, vmulq_f32(x, x));
+
+    const int32x4_t pow2n = vshlq_n_s32(vaddq_s32(vcvtq_s32_f32(n), vdupq_n_s32(0x7f)), 23);
+    return vmulq_f32(y, vreinterpretq_f32_s32(pow2n));
+}
+
+// Cephes style log() for positive normal inputs.
+inline simd::FloatRegister simd_log(simd::FloatRegister x) {
+    const uint32x4_t bits = vreinterpretq_u32_f32(x);
+    // Split into exponent and a mantissa in [0.5, 1).
+    float32x4_t e = vcvtq_f32_s32(
+            vsubq_s32(vreinterpretq_s32_u32(vshrq_n_u32(bits, 23)), vdupq_n_s32(0x7e)));
+    x = vreinterpretq_f32_u32(vorrq_u32(vandq_u32(bits, vdupq_n_u32(~0x7f800000u)),
+                                        vreinterpretq_u32_f32(vdupq_n_f32(0.5f))));
+
+    // Shift the mantissa into [sqrt(0.5), sqrt(2)).
+    const uint32x4_t mask = vcltq_f32(x, vdupq_n_f32(0.707106781186547524f));
+    e = vsubq_f32(e, vreinterpretq_f32_u32(
+                             vandq_u32(vreinterpretq_u32_f32(vdupq_n_f32(1.0f)), mask)));
+    x = vaddq_f32(vsubq_f32(x, vdupq_n_f32(1.0f)),
+                  vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(x), mask)));
+
+    const float32x4_t z = vmulq_f32(x, x);
+    float32x4_t y = vdupq_n_f32(7.0376836292e-2f);
+    y = vfmaq_f32(vdupq_n_f32(-1.1514610310e-1f), y, x);
+    y = vfmaq_f32(vdupq_n_f32(1.1676998740e-1f), y, x);
+    y = vfmaq_f32(vdupq_n_f32(-1.2420140846e-1f), y, x);
+    y = vfmaq_f32(vdupq_n_f32(1.4249322787e-1f), y, x);
+    y = vfmaq_f32(vdupq_n_f32(-1.6668057665e-1f), y, x);
+    y = vfmaq_f32(vdupq_n_f32(2.0000714765e-1f), y, x);
+    y = vfmaq_f32(vdupq_n_f32(-2.4999993993e-1f), y, x);
+    y = vfmaq_f32(vdupq_n_f32(3.3333331174e-1f), y, x);
+    y = vmulq_f32(vmulq_f32(y, x), z);
+    y = vfmaq_f32(y, e, vdupq_n_f32(-2.12194440e-4f));
+    y = vfmsq_f32(y, z, vdupq_n_f32(0.5f));
+    x = vaddq_f32(x, y);
+    return vfmaq_f32(x, e, vdupq_n_f32(0.693359375f));
+}
+
+#endif  // ENABLE_AVX2_IMPL
+
+// log(exp(stay) + sum_k exp(steps[k])), evaluated lane-wise.
+KERNEL_TARGET inline simd::FloatRegister log_sum_exp_5(simd::FloatRegister stay,
+                                                       const simd::FloatRegister (&steps)[NUM_BASES]) {
+    simd::FloatRegister max_val = stay;
+    for (size_t k = 0; k < NUM_BASES; ++k) {
+        max_val = simd_max_f32(max_val, steps[k]);
+    }
+    simd::FloatRegister sum = simd_exp(stay - max_val);
+    for (size_t k = 0; k < NUM_BASES; ++k) {
+        sum = sum + simd_exp(steps[k] - max_val);
+    }
+    return max_val + simd_log(sum);
+}
+
+KERNEL_TARGET void backward_step_simd(const float* const block_scores,
+                                      const float* const beta_next,
+                                      float* const beta,
+                                      size_t num_states,
+                                      float fixed_stay_score) {
+    const size_t Q = num_states / NUM_BASES;
+    const simd::FloatRegister stay_score = simd_load1_f32(&fixed_stay_score);
+
+    // Each iteration handles a register's worth of p % Q, for all 4 values of p / Q, since they
+    // share the same successors.
+    for (size_t q0 = 0; q0 < Q; q0 += simd::kFloatsPerRegister) {
+        // succ_beta[j][i] = beta_next[4 * (q0 + i) + j]
+        simd::FloatRegister succ_beta[NUM_BASES];
+        load_transposed(beta_next + NUM_BASES * q0, NUM_BASES, succ_beta);
+
+        // succ_scores[j][k][i] = block_scores[(4 * (q0 + i) + j) * 4 + k]
+        simd::FloatRegister succ_scores[NUM_BASES][NUM_BASES];
+        for (size_t j = 0; j < NUM_BASES; ++j) {
+            load_transposed(block_scores + (NUM_BASES * q0 + j) * NUM_BASES,
+                            NUM_BASES * NUM_BASES, succ_scores[j]);
+        }
+
+        for (size_t top_base = 0; top_base < NUM_BASES; ++top_base) {
+            const size_t p0 = q0 + top_base * Q;
+            simd::FloatRegister steps[NUM_BASES];
+            for (size_t j = 0; j < NUM_BASES; ++j) {
+                steps[j] = succ_beta[j] + succ_scores[j][top_base];
+            }
+            const simd::FloatRegister stay = simd_load_f32(beta_next + p0) + stay_score;
+            simd_store_f32(beta + p0, log_sum_exp_5(stay, steps));
+        }
+    }
+}
+
+KERNEL_TARGET void forward_step_simd(const float* const block_scores,
+                                     const float* const alpha,
+                                     float* const alpha_next,
+                                     size_t num_states,
+                                     float fixed_stay_score) {
+    const size_t Q = num_states / NUM_BASES;
+    const simd::FloatRegister stay_score = simd_load1_f32(&fixed_stay_score);
+
+    // Each iteration handles a register's worth of s / 4, for all 4 values of s % 4, since they
+    // share the same predecessors.
+    for (size_t q0 = 0; q0 < Q; q0 += simd::kFloatsPerRegister) {
+        // pred_alpha[k][i] = alpha[q0 + i + k * Q]
+        simd::FloatRegister pred_alpha[NUM_BASES];
+        for (size_t k = 0; k < NUM_BASES; ++k) {
+            pred_alpha[k] = simd_load_f32(alpha + q0 + k * Q);
+        }
+
+        // stay[j][i] = alpha[4 * (q0 + i) + j]
+        simd::FloatRegister stay[NUM_BASES];
+        load_transposed(alpha + NUM_BASES * q0, NUM_BASES, stay);
+
+        simd::FloatRegister result[NUM_BASES];
+        for (size_t j = 0; j < NUM_BASES; ++j) {
+            // steps[k][i] = block_scores[(4 * (q0 + i) + j) * 4 + k]
+            simd::FloatRegister steps[NUM_BASES];
+            load_transposed(block_scores + (NUM_BASES * q0 + j) * NUM_BASES,
+                            NUM_BASES * NUM_BASES, steps);
+            for (size_t k = 0; k < NUM_BASES; ++k) {
+                steps[k] = steps[k] + pred_alpha[k];
+            }
+            result[j] = log_sum_exp_5(stay[j] + stay_score, steps);
+        }
+        store_transposed(alpha_next + NUM_BASES * q0, NUM_BASES, result);
+    }
+}
+
+KERNEL_TARGET void posts_step_simd(const float* const alpha,
+                                   const float* const beta,
+                                   float* const posts,
+                                   size_t num_states) {
+    const float lowest = std::numeric_limits<float>::lowest();
+    simd::FloatRegister max_reg = simd_load1_f32(&lowest);
+    for (size_t s = 0; s < num_states; s += simd::kFloatsPerRegister) {
+        const simd::FloatRegister total = simd_load_f32(alpha + s) + simd_load_f32(beta + s);
+        max_reg = simd_max_f32(max_reg, total);
+        simd_store_f32(posts + s, total);
+    }
+    const float max_val = horizontal_max(max_reg);
+    const simd::FloatRegister max_val_reg = simd_load1_f32(&max_val);
+
+    const float zero = 0.0f;
+    simd::FloatRegister sum_reg = simd_load1_f32(&zero);
+    for (size_t s = 0; s < num_states; s += simd::kFloatsPerRegister) {
+        const simd::FloatRegister p = simd_exp(simd_load_f32(posts + s) - max_val_reg);
+        sum_reg = sum_reg + p;
+        simd_store_f32(posts + s, p);
+    }
+    const float inv_sum = 1.0f / horizontal_sum(sum_reg);
+    const simd::FloatRegister inv_sum_reg = simd_load1_f32(&inv_sum);
+    for (size_t s = 0; s < num_states; s += simd::kFloatsPerRegister) {
+        simd_store_f32(posts + s, simd_load_f32(posts + s) * inv_sum_reg);
+    }
+}
+
+#if ENABLE_AVX2_IMPL
+[[maybe_unused]] __attribute__((target("avx2,fma")))
+#endif
+void forward_backward_impl(const float* const scores,
+                           size_t scores_block_stride,
+                           size_t num_blocks,
+                           size_t num_states,
+                           float fixed_stay_score,
+                           dorado::basecall::decode::ForwardBackwardWorkspace& workspace) {
+    // The vectorised steps work on a register's worth of states / 4 at a time.
+    if (num_states % (NUM_BASES * simd::kFloatsPerRegister) != 0) {
+        forward_backward_scalar(scores, scores_block_stride, num_blocks, num_states,
+                                fixed_stay_score, workspace);
+        return;
+    }
+
+    float* const bwd = workspace.bwd();
+    float* const posts = workspace.posts();
+    float* alpha = workspace.alpha();
+    float* alpha_next = alpha + num_states;
+
+    std::fill_n(bwd + num_blocks * num_states, num_states, 0.0f);
+    for (size_t block_idx = num_blocks; block_idx != 0; --block_idx) {
+        backward_step_simd(scores + (block_idx - 1) * scores_block_stride,
+                           bwd + block_idx * num_states, bwd + (block_idx - 1) * num_states,
+                           num_states, fixed_stay_score);
+    }
+
+    // Posteriors only need the forward scores for the current timestep, so we never hold more
+    // than two timesteps of them.
+    std::fill_n(alpha, num_states, 0.0f);
+    posts_step_simd(alpha, bwd, posts, num_states);
+    for (size_t block_idx = 0; block_idx < num_blocks; ++block_idx) {
+        forward_step_simd(scores + block_idx * scores_block_stride, alpha, alpha_next, num_states,
+                          fixed_stay_score);
+        std::swap(alpha, alpha_next);
+        posts_step_simd(alpha, bwd + (block_idx + 1) * num_states,
+                        posts + (block_idx + 1) * num_states, num_states);
+    }
+}
+
+#undef KERNEL_TARGET
+
+#endif  // ENABLE_AVX2_IMPL || ENABLE_NEON_IMPL
+
+}  // namespace
+
+namespace dorado::basecall::decode {
+
+void ForwardBackwardWorkspace::reserve(size_t num_blocks, size_t num_states) {
+    const size_t guide_size = (num_blocks + 1) * num_states;
+    if (m_bwd.size() < guide_size) {
+        m_bwd.resize(guide_size);
+        m_posts.resize(guide_size);
+    }
+    if (m_alpha.size() < 2 * num_states) {
+        m_alpha.resize(2 * num_states);
+    }
+}
+
+void forward_backward(const float* scores,
+                      size_t scores_block_stride,
+                      size_t num_blocks,
+                      size_t num_states,
+                      float fixed_stay_score,
+                      ForwardBackwardWorkspace& workspace) {
+    if (num_states < NUM_BASES || num_states % NUM_BASES != 0) {
+        throw std::runtime_error("forward_backward: unexpected number of states " +
+                                 std::to_string(num_states));
+    }
+    workspace.reserve(num_blocks, num_states);
+    forward_backward_impl(scores, scores_block_stride, num_blocks, num_states, fixed_stay_score,
+                          workspace);
+}
+
+}  // namespace dorado::basecall::decode
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace dorado::basecall::decode {
+
+// Scratch space for the fused forward-backward kernel.
+// A workspace is intended to be owned by a single decode thread and reused for every chunk that
+// it decodes, so that the buffers are only allocated once for a given model and chunk size.
+class ForwardBackwardWorkspace {
+public:
+    // Grow the buffers (if necessary) to fit a chunk of |num_blocks| timesteps.
+    void reserve(size_t num_blocks, size_t num_states);
+
+    // Backward guides, laid out as [num_blocks + 1, num_states].
+    float* bwd() { return m_bwd.data(); }
+    // Posterior state probabilities, laid out as [num_blocks + 1, num_states].
+    float* posts() { return m_posts.data(); }
+    // Forward scores for the current and next timestep, laid out as [2, num_states].
+    float* alpha() { return m_alpha.data(); }
+
+private:
+    std::vector<float> m_bwd;
+    std::vector<float> m_posts;
+    std::vector<float> m_alpha;
+};
+
+// Computes the backward guides and posterior probabilities of a single chunk of CRF transition
+// scores in one pass, writing the results into |workspace|.
+// |scores| points to the first block of the chunk, with consecutive blocks |scores_block_stride|
+// floats apart, so that a chunk can be read directly out of a TNC buffer. Each block holds
+// num_states * 4 transition scores.
+// Results match inner::forward_scores()/backward_scores() followed by a softmax over the
+// summed scores.
+void forward_backward(const float* scores,
+                      size_t scores_block_stride,
+                      size_t num_blocks,
+                      size_t num_states,
+                      float fixed_stay_score,
+                      ForwardBackwardWorkspace& workspace);
+
+}  // namespace dorado::basecall::decode
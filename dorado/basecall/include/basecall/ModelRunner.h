@@ -7,6 +7,7 @@
 #include <torch/nn.h>
 
 #include <atomic>
+#include <cstddef>
 #include <string>
 
 namespace dorado::basecall::decode {
@@ -17,7 +18,11 @@ namespace dorado::basecall {
 
 class ModelRunner final : public ModelRunnerBase {
 public:
-    ModelRunner(const config::BasecallModelConfig &model_config, const std::string &device);
+    // |num_decode_threads| sets the size of the CPU decoder's worker pool, with 0 meaning one
+    // thread per hardware thread.
+    ModelRunner(const config::BasecallModelConfig &model_config,
+                const std::string &device,
+                std::size_t num_decode_threads);
     ~ModelRunner();
 
     void accept_chunk(int chunk_idx, const at::Tensor &chunk) final;
@@ -10,6 +10,7 @@
 #include "read_pipeline/base/HtsReader.h"
 #include "read_pipeline/base/ReadPipeline.h"
 #include "utils/alignment_utils.h"
+#include "utils/memory_utils.h"
 #include "utils/sequence_utils.h"
 #include "utils/thread_utils.h"
 
@@ -18,6 +19,19 @@
 #include <minimap.h>
 #include <spdlog/spdlog.h>
 
+#include <filesystem>
+#include <system_error>
+
+namespace {
+
+// Rough memory used by an index block per reference base with the overlap presets: the packed
+// sequence plus the minimizer hash tables.
+constexpr double INDEX_BYTES_PER_BASE = 4.0;
+// Only build the next block in the background if this much more memory than it needs is free.
+constexpr double PREFETCH_MEMORY_HEADROOM = 1.25;
+
+}  // namespace
+
 namespace dorado {
 
 void CorrectionMapper::extract_alignments(const mm_reg1_t* reg,
@@ -107,15 +121,16 @@ void CorrectionMapper::extract_alignments(const mm_reg1_t* reg,
 
 void CorrectionMapper::input_thread_fn() {
     utils::set_thread_name("errcorr_node");
-    BamPtr read;
+    std::shared_ptr<const CachedRead> read;
+    std::string read_seq;
     MmTbufPtr tbuf(mm_tbuf_init());
     while (m_reads_queue.try_pop(read) != utils::AsyncQueueStatus::Terminate) {
-        const std::string read_name = bam_get_qname(read.get());
-        const std::string read_seq = utils::extract_sequence(read.get());
-        std::tuple<mm_reg1_t*, int> mapping = m_aligner->get_mapping(read.get(), tbuf.get());
+        read->seq.unpack(read_seq);
+        std::tuple<mm_reg1_t*, int> mapping =
+                m_aligner->get_mapping(read->name, read_seq, tbuf.get());
         mm_reg1_t* reg = std::get<0>(mapping);
         int hits = std::get<1>(mapping);
-        extract_alignments(reg, hits, read_seq, read_name);
+        extract_alignments(reg, hits, read_seq, read->name);
         m_alignments_processed++;
         // TODO: Remove and move to ProgressTracker
         if (m_alignments_processed.load() % 10000 == 0) {
@@ -135,17 +150,70 @@ void CorrectionMapper::input_thread_fn() {
     }
 }
 
-void CorrectionMapper::load_read_fn() {
+void CorrectionMapper::load_read_fn(bool cache_reads) {
     utils::set_thread_name("errcorr_load");
+    if (m_read_cache_complete) {
+        for (const auto& read : m_read_cache) {
+            m_reads_queue.try_push(read);
+            m_reads_read++;
+        }
+        return;
+    }
+
     HtsReader reader(m_index_file, {});
     while (reader.read()) {
-        m_reads_queue.try_push(BamPtr(bam_dup1(reader.record.get())));
+        auto read = std::make_shared<CachedRead>();
+        read->name = bam_get_qname(reader.record.get());
+        read->seq = utils::PackedSequence(utils::extract_sequence(reader.record.get()));
+        if (cache_reads) {
+            m_read_cache_bytes += read->name.capacity() + read->seq.memory_bytes();
+            m_read_cache.push_back(read);
+        }
+        m_reads_queue.try_push(std::move(read));
         m_reads_read++;
         // TODO: Remove and move to ProgressTracker
         if (m_reads_read.load() % 10000 == 0) {
             spdlog::debug("Read {} reads", m_reads_read.load());
         }
     }
+    if (cache_reads) {
+        m_read_cache_complete = true;
+        spdlog::debug("Cached {} input reads in {} MB", m_read_cache.size(),
+                      m_read_cache_bytes.load() / (1024 * 1024));
+    }
+}
+
+bool CorrectionMapper::should_prefetch_next_block() const {
+    // A selected block is aligned on its own.
+    if (m_run_block_id >= 0 || !m_index->has_next_chunk()) {
+        return false;
+    }
+
+    // Expect the next block to be about the size of this one.
+    const mm_idx_t* index = m_index->index();
+    uint64_t num_bases = 0;
+    for (uint32_t i = 0; i < index->n_seq; ++i) {
+        num_bases += index->seq[i].len;
+    }
+    double required_GB = static_cast<double>(num_bases) * INDEX_BYTES_PER_BASE *
+                         PREFETCH_MEMORY_HEADROOM / utils::BYTES_PER_GB;
+    if (!m_read_cache_complete) {
+        // The read cache is also filled while the first block is aligned against.  Packed sequences
+        // take about an eighth of the size of an uncompressed FASTQ.
+        std::error_code ec;
+        const auto input_size = std::filesystem::file_size(m_index_file, ec);
+        if (!ec) {
+            required_GB += static_cast<double>(input_size) / 8 / utils::BYTES_PER_GB;
+        }
+    }
+
+    const double available_GB = utils::available_host_memory_GB();
+    if (available_GB < required_GB) {
+        spdlog::debug("Not prefetching index block {}: {:.1f} GB needed, {:.1f} GB available",
+                      m_current_index + 1, required_GB, available_GB);
+        return false;
+    }
+    return true;
 }
 
 void CorrectionMapper::send_data_fn(Pipeline& pipeline) {
@@ -244,15 +312,29 @@ void CorrectionMapper::process(Pipeline& pipeline) {
         m_alignments_processed.store(0);
         m_reads_queue.restart();
 
+        // Decide before the reader thread starts filling the read cache.
+        const bool prefetch_next_block = should_prefetch_next_block();
+        const bool cache_reads = m_run_block_id < 0 && m_index->has_next_chunk();
+
         // Create aligner.
         m_aligner = std::make_unique<alignment::Minimap2Aligner>(m_index);
         // 1. Start thread for generating reads.
-        reader_thread = std::thread(&CorrectionMapper::load_read_fn, this);
+        reader_thread = std::thread(&CorrectionMapper::load_read_fn, this, cache_reads);
         // 2. Start threads for aligning reads.
         for (int i = 0; i < m_num_threads; i++) {
             aligner_threads.push_back(std::thread(&CorrectionMapper::input_thread_fn, this));
         }
-        // 3. Wait for alignments to finish and all reads to be read
+        // 3. Build the next index block in the background, if there's room for it.
+        std::thread prefetch_thread;
+        if (prefetch_next_block) {
+            spdlog::debug("Prefetching index block {}", m_current_index + 1);
+            prefetch_thread = std::thread([this] {
+                utils::set_thread_name("errcorr_index");
+                m_index->prefetch_next_chunk(m_num_threads);
+            });
+            ++m_prefetched_blocks;
+        }
+        // 4. Wait for alignments to finish and all reads to be read
         if (reader_thread.joinable()) {
             reader_thread.join();
         }
@@ -263,6 +345,9 @@ void CorrectionMapper::process(Pipeline& pipeline) {
             }
         }
         aligner_threads.clear();
+        if (prefetch_thread.joinable()) {
+            prefetch_thread.join();
+        }
         {
             // Only copy when the thread sending alignments to downstream pipeline
             // is done.
@@ -274,10 +359,13 @@ void CorrectionMapper::process(Pipeline& pipeline) {
         m_correction_records = {};
         m_read_mutex.clear();
         m_processed_queries_per_target.clear();
-        // 4. Load next index and loop
+        // 5. Load next index and loop
         m_current_index++;
     } while (m_index->load_next_chunk(m_num_threads) != alignment::IndexLoadResult::end_of_index);
 
+    m_read_cache = {};
+    m_read_cache_bytes.store(0);
+
     m_copy_terminate.store(true);
     m_copy_cv.notify_all();
     if (copy_thread.joinable()) {
@@ -366,6 +454,8 @@ stats::NamedStats CorrectionMapper::sample_stats() const {
     stats["num_reads_to_infer"] = static_cast<double>(m_reads_to_infer.load());
     stats["index_seqs"] = m_index_seqs;
     stats["current_idx"] = m_current_index;
+    stats["index_blocks_prefetched"] = m_prefetched_blocks.load();
+    stats["read_cache_mb"] = static_cast<double>(m_read_cache_bytes.load()) / (1024 * 1024);
     return stats;
 }
 
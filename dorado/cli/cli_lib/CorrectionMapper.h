@@ -5,6 +5,7 @@
 #include "alignment/Minimap2Index.h"
 #include "alignment/Minimap2IndexSupportTypes.h"
 #include "utils/AsyncQueue.h"
+#include "utils/PackedSequence.h"
 #include "utils/stats.h"
 #include "utils/types.h"
 
@@ -57,17 +58,32 @@ private:
     std::unique_ptr<alignment::Minimap2Aligner> m_aligner;
     std::shared_ptr<alignment::Minimap2Index> m_index;
 
+    // An input read, with its sequence packed at two bits per base.
+    struct CachedRead {
+        std::string name;
+        utils::PackedSequence seq;
+    };
+
     void input_thread_fn();
-    void load_read_fn();
+    void load_read_fn(bool cache_reads);
     void send_data_fn(Pipeline& pipeline);
 
+    // True if the next index block should be built while the current one is aligned against.
+    bool should_prefetch_next_block() const;
+
     void extract_alignments(const mm_reg1_t* reg,
                             int hits,
                             const std::string& qread,
                             const std::string& qname);
 
     // Queue for reads being aligned.
-    utils::AsyncQueue<BamPtr> m_reads_queue;
+    utils::AsyncQueue<std::shared_ptr<const CachedRead>> m_reads_queue;
+
+    // If more than one index block is aligned against, the input reads are parsed once, while
+    // aligning against the first block, and then reused for every later block.
+    std::vector<std::shared_ptr<const CachedRead>> m_read_cache;
+    bool m_read_cache_complete{false};
+    std::atomic<size_t> m_read_cache_bytes{0};
 
     // Map to collects alignments by target id.
     std::mutex m_correction_mtx;
@@ -83,6 +99,7 @@ private:
 
     int m_index_seqs{0};
     int m_current_index{0};
+    std::atomic<int> m_prefetched_blocks{0};
     std::atomic<int> m_reads_read{0};
     std::atomic<int> m_alignments_processed{0};
     std::atomic<size_t> m_reads_to_infer{0};
@@ -0,0 +1,50 @@
+#include "CorrectionOverlapStoreReader.h"
+
+#include "correct/overlap_store.h"
+#include "read_pipeline/base/ReadPipeline.h"
+#include "utils/timer_high_res.h"
+
+#include <spdlog/spdlog.h>
+
+#include <memory>
+
+namespace dorado {
+
+void CorrectionOverlapStoreReader::process(Pipeline& pipeline) {
+    timer::TimerHighRes timer;
+
+    const correction::OverlapStoreReader store(m_store_file);
+    spdlog::debug("Overlap store {} holds {} overlaps of {} targets", m_store_file,
+                  store.num_overlaps(), store.num_piles());
+
+    for (size_t pile = 0; pile < store.num_piles(); ++pile) {
+        // Skip all blacklisted targets.
+        if (!m_skip_set.empty() && m_skip_set.count(std::string(store.target_name(pile))) > 0) {
+            continue;
+        }
+
+        auto alignments = std::make_unique<CorrectionAlignments>();
+        store.load(pile, *alignments);
+        ++m_reads_to_infer;
+        spdlog::trace(
+                "Pushed {} alignments for correction for "
+                "target {}. Number of alignment piles pushed until now: {}.",
+                std::size(alignments->qnames), alignments->read_name, m_reads_to_infer);
+        pipeline.push_message(std::move(alignments));
+    }
+
+    spdlog::debug("Overlap store reading done in: {:.2f} s",
+                  timer.GetElapsedMilliseconds() / 1000.0f);
+}
+
+CorrectionOverlapStoreReader::CorrectionOverlapStoreReader(const std::string_view store_file,
+                                                           std::unordered_set<std::string> skip_set)
+        : m_store_file(store_file), m_skip_set{std::move(skip_set)} {}
+
+stats::NamedStats CorrectionOverlapStoreReader::sample_stats() const {
+    stats::NamedStats stats;
+    stats["num_reads_to_infer"] = static_cast<double>(m_reads_to_infer);
+    return stats;
+}
+
+}  // namespace dorado
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "CorrectionAligner.h"
+#include "utils/stats.h"
+
+#include <string>
+#include <string_view>
+#include <unordered_set>
+
+namespace dorado {
+
+class Pipeline;
+
+// Sends the overlaps in an overlap store (see correct/overlap_store.h) for correction, one target
+// at a time in order of target name.
+class CorrectionOverlapStoreReader : public CorrectionAligner {
+public:
+    CorrectionOverlapStoreReader(std::string_view store_file,
+                                 std::unordered_set<std::string> skip_set);
+    ~CorrectionOverlapStoreReader() = default;
+    std::string get_name() const override { return "CorrectionOverlapStoreReader"; }
+    stats::NamedStats sample_stats() const override;
+
+    // Main driver function.
+    void process(Pipeline& pipeline) override;
+
+private:
+    std::string m_store_file;
+    size_t m_reads_to_infer{0};
+    std::unordered_set<std::string> m_skip_set;
+};
+
+}  // namespace dorado
@@ -1,4 +1,6 @@
 #include "ProgressTracker.h"
+#include "alignment/IndexFileAccess.h"
+#include "alignment/Minimap2Index.h"
 #include "alignment/alignment_info.h"
 #include "alignment/minimap2_args.h"
 #include "basecall_output_args.h"
@@ -97,7 +99,7 @@ int aligner(int argc, char* argv[]) {
             "NOTE: Not all arguments from minimap2 are currently available. Additionally, "
             "parameter names are not finalized and may change.");
 
-    parser.add_argument("index").help("reference in (fastq/fasta/mmi).");
+    parser.add_argument("index").help("reference in (fastq/fasta/mmi/dmmi).");
     parser.add_argument("reads")
             .help("An input file or the folder containing input file(s) (any HTS format).")
             .nargs(argparse::nargs_pattern::optional)
@@ -150,6 +152,10 @@ int aligner(int argc, char* argv[]) {
             .help("Frequency in seconds in which to report progress statistics")
             .default_value(0)
             .scan<'i', int>();
+    parser.add_argument("--write-mapped-index")
+            .hidden()
+            .help("Write the index to this path in dorado's memory-mapped layout (.dmmi) and "
+                  "exit. Mapped indexes load almost instantly and are shared between processes.");
 
     std::vector<std::string> args_excluding_mm2_opts{};
     auto mm2_option_string = alignment::mm2::extract_options_string_arg({argv, argv + argc},
@@ -200,6 +206,22 @@ int aligner(int argc, char* argv[]) {
     }
     align_info->minimap_options = std::move(*minimap_options);
 
+    if (const auto mapped_index_path = parser.present<std::string>("--write-mapped-index")) {
+        try {
+            const int index_threads =
+                    threads == 0 ? static_cast<int>(std::thread::hardware_concurrency()) : threads;
+            const auto index_file_access = load_index(
+                    align_info->reference_file, align_info->minimap_options, index_threads);
+            index_file_access->get_index(align_info->reference_file, align_info->minimap_options)
+                    ->save_mapped_index(*mapped_index_path);
+        } catch (const std::exception& e) {
+            spdlog::error("Writing mapped index failed: {}", e.what());
+            return EXIT_FAILURE;
+        }
+        spdlog::info("> wrote mapped index {}", *mapped_index_path);
+        return EXIT_SUCCESS;
+    }
+
     // Only allow `reads` to be empty if we're accepting input from a pipe
     if (reads.empty() && utils::is_fd_tty(stdin)) {
         std::cout << parser << '\n';
@@ -35,6 +35,7 @@
 #include "read_pipeline/nodes/WriterNode.h"
 #include "resume_loader/ResumeLoader.h"
 #include "torch_utils/torch_utils.h"
+#include "utils/ReadIdSet.h"
 #include "utils/SampleSheet.h"
 #include "utils/barcode_kits.h"
 #include "utils/basecaller_utils.h"
@@ -332,6 +333,7 @@ void setup(const std::vector<std::string>& args,
            const alignment::Minimap2Options& aligner_options,
            const std::string& dump_stats_file,
            const std::string& dump_stats_filter,
+           bool profile_pipeline,
            bool run_batchsize_benchmarks,
            bool emit_batchsize_benchmarks,
            const std::string& resume_from_file,
@@ -599,6 +601,7 @@ void setup(const std::vector<std::string>& args,
         spdlog::error("Failed to create pipeline");
         std::exit(EXIT_FAILURE);
     }
+    pipeline->set_profiling_enabled(profile_pipeline);
 
     auto modify_hdr = utils::HeaderMapper::Modifier([&args, &device](sam_hdr_t* hdr) {
         utils::add_hd_header_line(hdr);
@@ -633,7 +636,7 @@ void setup(const std::vector<std::string>& args,
         }
     }
 
-    std::unordered_set<std::string> reads_already_processed;
+    utils::ReadIdSet reads_already_processed;
     if (!resume_from_file.empty()) {
         if (output_dir.has_value()) {
             spdlog::error("--resume-from cannot be used with --output-dir.");
@@ -695,6 +698,13 @@ void setup(const std::vector<std::string>& args,
     tracker.reset_initialization_time();
     tracker.set_description("Basecalling");
 
+    DataLoader loader(*pipeline, "cpu", thread_allocations.loader_threads, max_reads, read_list,
+                      std::move(reads_already_processed));
+
+    auto func = [client_info](ReadCommon& read) { read.client_info = client_info; };
+    loader.add_read_initialiser(func);
+    stats_reporters.push_back(dorado::stats::make_stats_reporter(loader));
+
     std::vector<dorado::stats::StatsCallable> stats_callables;
     stats_callables.push_back(
             [&tracker](const stats::NamedStats& stats) { tracker.update_progress_bar(stats); });
@@ -715,12 +725,6 @@ void setup(const std::vector<std::string>& args,
                 std::make_unique<BenchmarkTimer>(run_for_arg * 1000, std::move(shutdown_callback));
     }
 
-    DataLoader loader(*pipeline, "cpu", thread_allocations.loader_threads, max_reads, read_list,
-                      reads_already_processed);
-
-    auto func = [client_info](ReadCommon& read) { read.client_info = client_info; };
-    loader.add_read_initialiser(func);
-
     // This is blocking on all reads
     loader.load_reads(pod5_folder_info.files(), ReadOrder::UNRESTRICTED);
 
@@ -743,7 +747,8 @@ void setup(const std::vector<std::string>& args,
         stats_sampler->dump_stats(stats_file,
                                   dump_stats_filter.empty()
                                           ? std::nullopt
-                                          : std::optional<std::regex>(dump_stats_filter));
+                                          : std::optional<std::regex>(dump_stats_filter),
+                                  cli::get_stats_dump_format(dump_stats_file));
     }
 }
 
@@ -926,7 +931,8 @@ int basecaller(int argc, char* argv[]) {
               parser.get<int>("--max-reads"), parser.get<int>("--min-qscore"),
               parser.get<std::string>("--read-ids"), *minimap_options,
               parser.get<std::string>("--dump_stats_file"),
-              parser.get<std::string>("--dump_stats_filter"), run_batchsize_benchmarks,
+              parser.get<std::string>("--dump_stats_filter"),
+              parser.get<bool>("--profile-pipeline"), run_batchsize_benchmarks,
               parser.get<bool>("--emit-batchsize-benchmarks"),
               parser.get<std::string>("--resume-from"),
               !parser.get<bool>("--disable-read-splitting"),
@@ -1,13 +1,16 @@
 #include "CorrectionMapper.h"
+#include "CorrectionOverlapStoreReader.h"
 #include "CorrectionPafReader.h"
 #include "CorrectionProgressTracker.h"
 #include "cli/cli.h"
 #include "cli/utils/cli_utils.h"
+#include "correct/overlap_store.h"
 #include "dorado_version.h"
 #include "hts_utils/fai_utils.h"
 #include "model_downloader/model_downloader.h"
 #include "read_pipeline/base/ReadPipeline.h"
 #include "read_pipeline/nodes/CorrectionInferenceNode.h"
+#include "read_pipeline/nodes/CorrectionOverlapStoreWriterNode.h"
 #include "read_pipeline/nodes/CorrectionPafWriterNode.h"
 #include "read_pipeline/nodes/HtsWriterNode.h"
 #include "torch_utils/auto_detect_device.h"
@@ -57,6 +60,7 @@ struct Options {
     int batch_size = 0;
     uint64_t index_size = 0;
     bool to_paf = false;
+    std::string out_overlap_store_fn;
     std::string in_paf_fn;
     std::string model_path;
     std::string resume_path_fn;
@@ -106,8 +110,12 @@ void add_arguments(argparse::ArgumentParser& parser, int& verbosity) {
         parser.add_group("Input/output arguments");
         parser.add_argument("-m", "--model-path").help("Path to correction model folder.");
         parser.add_argument("-p", "--from-paf")
-                .help("Path to a PAF file with alignments. Skips alignment computation.");
+                .help("Path to a PAF file or an overlap store with alignments. Skips alignment "
+                      "computation.");
         parser.add_argument("--to-paf").help("Generate PAF alignments and skip consensus.").flag();
+        parser.add_argument("--to-overlap-store")
+                .help("Write alignments to a compact binary overlap store at this path, for use "
+                      "with --from-paf, and skip consensus.");
         parser.add_argument("--resume-from")
                 .help("Resume a previously interrupted run. Requires a path to a file where "
                       "sequence headers are stored in the first column (whitespace delimited), one "
@@ -191,6 +199,9 @@ Options set_options(const argparse::ArgumentParser& parser, const int verbosity)
     opt.index_size = std::max<int64_t>(0, utils::arg_parse::parse_string_to_size<int64_t>(
                                                   parser.get<std::string>("index-size")));
     opt.to_paf = parser.get<bool>("to-paf");
+    opt.out_overlap_store_fn = (parser.is_used("--to-overlap-store"))
+                                       ? parser.get<std::string>("to-overlap-store")
+                                       : "";
     opt.in_paf_fn = (parser.is_used("--from-paf")) ? parser.get<std::string>("from-paf") : "";
     opt.resume_path_fn = parser.get<std::string>("resume-from");
     opt.model_path = (parser.is_used("--model-path")) ? parser.get<std::string>("model-path") : "";
@@ -349,6 +360,10 @@ void validate_options(const Options& opt) {
         spdlog::error("Input PAF path {} does not exist!", opt.in_paf_fn);
         std::exit(EXIT_FAILURE);
     }
+    if (opt.to_paf && !std::empty(opt.out_overlap_store_fn)) {
+        spdlog::error("The --to-paf and --to-overlap-store options cannot be used together.");
+        std::exit(EXIT_FAILURE);
+    }
     if (!std::empty(opt.model_path) && !std::filesystem::exists(opt.model_path)) {
         spdlog::error("Input model directory {} does not exist!", opt.model_path);
         std::exit(EXIT_FAILURE);
@@ -420,11 +435,14 @@ int correct(int argc, char* argv[]) {
     spdlog::debug("Aligner threads {}, corrector threads {}, writer threads {}", aligner_threads,
                   correct_threads, correct_writer_threads);
 
+    // Only write out the alignments, without running consensus.
+    const bool alignments_only = opt.to_paf || !std::empty(opt.out_overlap_store_fn);
+
     // If model dir is not specified, download the model.
-    const auto [model_dir, remove_tmp_dir] = [&opt]() {
+    const auto [model_dir, remove_tmp_dir] = [&opt, alignments_only]() {
         std::filesystem::path ret_model_dir = opt.model_path;
         bool ret_remove_tmp_dir = false;
-        if (!opt.to_paf && std::empty(ret_model_dir)) {
+        if (!alignments_only && std::empty(ret_model_dir)) {
             ret_model_dir = download_model("herro-v1");
             ret_remove_tmp_dir = true;
         }
@@ -481,7 +499,7 @@ int correct(int argc, char* argv[]) {
         PipelineDescriptor pipeline_desc;
 
         // Add the writer node and (optionally) the correction node.
-        if (!opt.to_paf) {
+        if (!alignments_only) {
             // Setup output file.
             hts_file = std::unique_ptr<utils::HtsFile, HtsFileDeleter>(
                     new utils::HtsFile("-", OutputMode::FASTA, correct_writer_threads, false));
@@ -493,8 +511,10 @@ int correct(int argc, char* argv[]) {
             pipeline_desc.add_node<CorrectionInferenceNode>(
                     {hts_writer}, in_reads_fn, correct_threads, opt.device, opt.infer_threads,
                     opt.batch_size, model_dir, opt.legacy_windowing, opt.debug_tnames);
-        } else {
+        } else if (opt.to_paf) {
             pipeline_desc.add_node<CorrectionPafWriterNode>({});
+        } else {
+            pipeline_desc.add_node<CorrectionOverlapStoreWriterNode>({}, opt.out_overlap_store_fn);
         }
 
         // Create the Pipeline from our description.
@@ -509,7 +529,10 @@ int correct(int argc, char* argv[]) {
         // Aligner stats need to be passed separately since the aligner node
         // is not part of the pipeline, so the stats are not automatically gathered.
         std::unique_ptr<CorrectionAligner> aligner;
-        if (!std::empty(opt.in_paf_fn)) {
+        if (!std::empty(opt.in_paf_fn) && correction::is_overlap_store_file(opt.in_paf_fn)) {
+            aligner = std::make_unique<CorrectionOverlapStoreReader>(opt.in_paf_fn,
+                                                                     std::move(skip_set));
+        } else if (!std::empty(opt.in_paf_fn)) {
             aligner = std::make_unique<CorrectionPafReader>(opt.in_paf_fn, std::move(skip_set));
         } else {
             // 1. Alignment node that generates alignments per read to be corrected.
@@ -99,6 +99,20 @@ ModBaseBatchParams validate_modbase_params(const std::vector<std::filesystem::pa
     return params;
 }
 
+PairingSignalStorage parse_pairing_signal_storage(const std::string& storage) {
+    if (storage == "resident") {
+        return PairingSignalStorage::RESIDENT;
+    }
+    if (storage == "compressed") {
+        return PairingSignalStorage::COMPRESSED;
+    }
+    if (storage == "spill") {
+        return PairingSignalStorage::SPILL;
+    }
+    throw std::runtime_error(
+            "--pairing-signal-storage must be one of resident, compressed or spill.");
+}
+
 DuplexModels load_duplex_models(const argparse::ArgumentParser& parser,
                                 const DataLoader::InputFiles& input_pod5_files,
                                 const std::string& context) {
@@ -255,6 +269,16 @@ int duplex(int argc, char* argv[]) {
             .hidden()
             .help("Path to stereo model")
             .default_value(std::string(""));
+    parser.add_argument("--pairing-signal-storage")
+            .hidden()
+            .help("Where the signal of reads waiting to be paired is held: resident, compressed "
+                  "(in memory) or spill (to files in --pairing-spill-dir).")
+            .default_value(std::string("resident"));
+    parser.add_argument("--pairing-spill-dir")
+            .hidden()
+            .help("Directory for pairing signal spill files. Defaults to the system temp "
+                  "directory.")
+            .default_value(std::string(""));
 
     std::vector<std::string> args_excluding_mm2_opts{};
     auto mm2_option_string = alignment::mm2::extract_options_string_arg({argv, argv + argc},
@@ -304,6 +328,7 @@ int duplex(int argc, char* argv[]) {
 
         const std::string dump_stats_file = parser.get<std::string>("--dump_stats_file");
         const std::string dump_stats_filter = parser.get<std::string>("--dump_stats_filter");
+        const bool profile_pipeline = parser.get<bool>("--profile-pipeline");
         const size_t max_stats_records = static_cast<size_t>(dump_stats_file.empty() ? 0 : 100000);
 
         const bool recursive_file_loading = parser.get<bool>("--recursive");
@@ -460,6 +485,7 @@ int duplex(int argc, char* argv[]) {
                 spdlog::error("Failed to create pipeline");
                 return EXIT_FAILURE;
             }
+            pipeline->set_profiling_enabled(profile_pipeline);
 
             // Write header as no read group info is needed.
             const auto& hts_writer_ref = pipeline->get_node_ref<WriterNode>(hts_writer);
@@ -594,8 +620,15 @@ int duplex(int argc, char* argv[]) {
 
             PairingParameters pairing_parameters;
             if (template_complement_map.empty()) {
-                pairing_parameters =
-                        DuplexPairingParameters{ReadOrder::BY_CHANNEL, DEFAULT_DUPLEX_CACHE_DEPTH};
+                // The loader emits reads in start time order, so each channel's neighbours
+                // arrive close together and the cache only needs a few reads per channel.
+                DuplexPairingParameters duplex_pairing_parameters{
+                        ReadOrder::BY_TIME, DEFAULT_DUPLEX_READS_PER_CHANNEL};
+                duplex_pairing_parameters.signal_storage = parse_pairing_signal_storage(
+                        parser.get<std::string>("--pairing-signal-storage"));
+                duplex_pairing_parameters.spill_dir =
+                        parser.get<std::string>("--pairing-spill-dir");
+                pairing_parameters = std::move(duplex_pairing_parameters);
             } else {
                 pairing_parameters = std::move(template_complement_map);
             }
@@ -614,6 +647,7 @@ int duplex(int argc, char* argv[]) {
                 spdlog::error("Failed to create pipeline");
                 return EXIT_FAILURE;
             }
+            pipeline->set_profiling_enabled(profile_pipeline);
 
             // Set modbase threshold now that we have the params.
             pipeline->get_node_ref<ReadToBamTypeNode>(read_converter)
@@ -638,7 +672,7 @@ int duplex(int argc, char* argv[]) {
 
             // Run pipeline.
             tracker.reset_initialization_time();
-            loader.load_reads(input_pod5_files, ReadOrder::BY_CHANNEL);
+            loader.load_reads(input_pod5_files, ReadOrder::BY_TIME);
         }
 
         // Wait for the pipeline to complete.  When it does, we collect
@@ -655,7 +689,8 @@ int duplex(int argc, char* argv[]) {
             stats_sampler->dump_stats(stats_file,
                                       dump_stats_filter.empty()
                                               ? std::nullopt
-                                              : std::optional<std::regex>(dump_stats_filter));
+                                              : std::optional<std::regex>(dump_stats_filter),
+                                      cli::get_stats_dump_format(dump_stats_file));
         }
     } catch (const std::exception& e) {
         spdlog::error(e.what());
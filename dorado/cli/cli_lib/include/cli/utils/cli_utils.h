@@ -13,6 +13,7 @@
 
 #include "utils/dev_utils.h"
 #include "utils/fs_utils.h"
+#include "utils/stats.h"
 
 #include <argparse/argparse.hpp>
 #include <htslib/sam.h>
@@ -89,6 +90,13 @@ inline void add_pg_hdr(sam_hdr_t* hdr,
                    nullptr);
 }
 
+// Stats are dumped as JSON if the file has a .json extension, and as CSV otherwise.
+inline stats::StatsSampler::DumpFormat get_stats_dump_format(const std::string& dump_stats_file) {
+    return std::filesystem::path(dump_stats_file).extension() == ".json"
+                   ? stats::StatsSampler::DumpFormat::JSON
+                   : stats::StatsSampler::DumpFormat::CSV;
+}
+
 inline void add_internal_arguments(argparse::ArgumentParser& parser) {
     parser.add_argument("--skip-model-compatibility-check")
             .hidden()
@@ -102,6 +110,12 @@ inline void add_internal_arguments(argparse::ArgumentParser& parser) {
             .hidden()
             .help("Internal processing stats. name filter regex.")
             .default_value(std::string(""));
+    parser.add_argument("--profile-pipeline")
+            .hidden()
+            .help("Record queue depths, wait times and thread utilisation for each pipeline node. "
+                  "A summary is logged on completion, and the timeline is included in "
+                  "--dump_stats_file.")
+            .flag();
     parser.add_argument("--run-batchsize-benchmarks")
             .hidden()
             .help("run auto batchsize selection benchmarking instead of using cached benchmark "
@@ -7,6 +7,7 @@
 #include "model_resolver/ModelResolver.h"
 #include "models/models.h"
 #include "polish/polish_impl.h"
+#include "polish/task_scheduler.h"
 #include "polish_progress_tracker.h"
 #include "secondary/architectures/model_config.h"
 #include "secondary/common/bam_info.h"
@@ -39,6 +40,7 @@
 #include <cstdint>
 #include <filesystem>
 #include <fstream>
+#include <future>
 #include <memory>
 #include <numeric>
 #include <optional>
@@ -988,6 +990,109 @@ void run_polishing(const Options& opt,
     int64_t total_batch_bases = 0;
     std::atomic<bool> worker_terminate{false};
 
+    // All CPU stages share one pool of opt.threads threads.
+    polisher::TaskScheduler scheduler(opt.threads);
+
+    // Writes the consensus and calls variants for a batch of drafts. Runs in the background while
+    // the next batch is encoded and inferred. Only one batch is finished at a time, in order.
+    const auto finish_batch = [&](const secondary::Interval batch_interval,
+                                  const size_t num_regions, const int64_t batch_bases,
+                                  const std::vector<std::vector<secondary::ConsensusResult>>
+                                          all_results_cons,
+                                  const std::vector<secondary::VariantCallingSample>
+                                          vc_input_data) {
+        at::InferenceMode finish_infer_guard;
+
+        // Write the consensus. If a sequence has no inferred samples, it can be
+        // written verbatim to the output.
+        // If this fails, stop execution.
+        try {
+            utils::ScopedProfileRange spr1("run-construct_consensus_and_write", 1);
+
+            // Round the counter, in case some samples were dropped.
+            total_batch_bases += batch_bases;
+            stats.set("processed", static_cast<double>(total_batch_bases));
+
+            spdlog::debug(
+                    "[run_polishing] Stitching sequences: {}-{}/{} (number: {}, total "
+                    "length: {:.2f} Mbp), parts: {}",
+                    batch_interval.start, batch_interval.end, std::size(input_regions),
+                    num_regions, batch_bases / (1000.0 * 1000.0),
+                    std::size(all_results_cons));
+
+            spdlog::debug("Data for variant calling: num elements = {}, num consensus results = {}",
+                          std::size(vc_input_data), std::size(all_results_cons));
+
+            // Construct the consensus sequences, only if they will be written.
+            if (opt.write_consensus) {
+                utils::ScopedProfileRange spr2("run-construct_seqs_and_write", 2);
+
+                // Dimensions: [draft_id x part_id x haplotype_id].
+                const std::vector<std::vector<std::vector<secondary::ConsensusResult>>>
+                        consensus_seqs = polisher::construct_consensus_seqs(
+                                batch_interval, all_results_cons, draft_lens, opt.fill_gaps,
+                                opt.fill_char, *draft_readers.front());
+
+                // Write the consensus file.
+                for (const auto& consensus : consensus_seqs) {
+                    write_consensus_results(*ofs_consensus, consensus, opt.fill_gaps,
+                                            (opt.out_format == OutputFormat::FASTQ));
+                }
+            }
+        } catch (const std::exception& e) {
+            if (!opt.continue_on_error) {
+                throw;
+            } else {
+                spdlog::warn(
+                        "Exception caught when writing consensus sequences on interval of drafts: "
+                        "[{}, {}). Skipping this batch. Original exception: \"{}\"",
+                        batch_interval.start, batch_interval.end, e.what());
+                return;
+            }
+        }
+
+        // Variant calling.
+        try {
+            utils::ScopedProfileRange spr1("run-variant_calling", 1);
+
+            // Run variant calling, optionally.
+            if (opt.run_variant_calling) {
+                std::vector<secondary::Variant> variants = polisher::call_variants(
+                        scheduler, worker_terminate, stats, batch_interval, vc_input_data,
+                        draft_readers, draft_lens, *resources.decoder, opt.pass_min_qual,
+                        opt.ambig_ref, opt.vc_type == VariantCallingEnum::GVCF, opt.threads,
+                        opt.continue_on_error);
+
+                std::sort(std::begin(variants), std::end(variants),
+                          [](const auto& a, const auto& b) {
+                              return std::tie(a.seq_id, a.pos) < std::tie(b.seq_id, b.pos);
+                          });
+
+                // Write the VCF file.
+                for (const auto& variant : variants) {
+                    vcf_writer->write_variant(variant);
+                }
+
+                // We approximate the progress by expecting 2x bases to be processed
+                // when doing variant calling.
+                total_batch_bases += batch_bases;
+                stats.set("processed", static_cast<double>(total_batch_bases));
+            }
+        } catch (const std::exception& e) {
+            if (!opt.continue_on_error) {
+                throw;
+            } else {
+                spdlog::warn(
+                        "Exception caught when calling variants in the batch interval of drafts: "
+                        "[{}, {}). Not producing variant calls for this batch of drafts. Original "
+                        "exception: \"{}\"",
+                        batch_interval.start, batch_interval.end, e.what());
+            }
+        }
+    };
+
+    std::future<void> pending_batch;
+
     // Process the draft sequences in batches of user-specified size.
     for (const auto& batch_interval : region_batches) {
         // Get the regions for this interval.
@@ -1049,11 +1154,12 @@ void run_polishing(const Options& opt,
                 // Create a thread for the sample producer.
                 polisher::WorkerReturnStatus wrs_sample_producer;
                 auto thread_sample_producer =
-                        utils::jthread([&resources, &bam_regions, &draft_lens, &opt, &usable_mem,
-                                        &batch_queue, &worker_terminate, &wrs_sample_producer] {
+                        utils::jthread([&scheduler, &resources, &bam_regions, &draft_lens, &opt,
+                                        &usable_mem, &batch_queue, &worker_terminate,
+                                        &wrs_sample_producer] {
                             utils::set_thread_name("polish_produce");
                             polisher::sample_producer(
-                                    resources, bam_regions, draft_lens, {}, std::nullopt,
+                                    scheduler, resources, bam_regions, draft_lens, {}, std::nullopt,
                                     opt.threads, opt.batch_size, opt.encoding_batch_size,
                                     opt.window_len, opt.window_overlap, 0, opt.bam_subchunk,
                                     usable_mem, opt.continue_on_error, false, false, 0, 0, 0.25,
@@ -1063,11 +1169,12 @@ void run_polishing(const Options& opt,
                 // Create a thread for the sample decoder.
                 polisher::WorkerReturnStatus wrs_decoder;
                 auto thread_sample_decoder =
-                        utils::jthread([&all_results_cons, &vc_input_data, &decode_queue, &stats,
-                                        &resources, &opt, &worker_terminate, &wrs_decoder] {
+                        utils::jthread([&scheduler, &all_results_cons, &vc_input_data,
+                                        &decode_queue, &stats, &resources, &opt, &worker_terminate,
+                                        &wrs_decoder] {
                             utils::set_thread_name("polish_decode");
                             polisher::decode_samples_in_parallel(
-                                    all_results_cons, vc_input_data, decode_queue, stats,
+                                    scheduler, all_results_cons, vc_input_data, decode_queue, stats,
                                     worker_terminate, wrs_decoder, *resources.decoder, opt.threads,
                                     opt.min_depth, opt.run_variant_calling, opt.continue_on_error);
                         });
@@ -1102,92 +1209,18 @@ void run_polishing(const Options& opt,
             }
         }
 
-        // Write the consensus. If a sequence has no inferred samples, it can be
-        // written verbatim to the output.
-        // If this fails, stop execution.
-        try {
-            utils::ScopedProfileRange spr1("run-construct_consensus_and_write", 1);
-
-            // Round the counter, in case some samples were dropped.
-            total_batch_bases += batch_bases;
-            stats.set("processed", static_cast<double>(total_batch_bases));
-
-            spdlog::debug(
-                    "[run_polishing] Stitching sequences: {}-{}/{} (number: {}, total "
-                    "length: {:.2f} Mbp), parts: {}",
-                    batch_interval.start, batch_interval.end, std::size(input_regions),
-                    std::size(region_batch), batch_bases / (1000.0 * 1000.0),
-                    std::size(all_results_cons));
-
-            spdlog::debug("Data for variant calling: num elements = {}, num consensus results = {}",
-                          std::size(vc_input_data), std::size(all_results_cons));
-
-            // Construct the consensus sequences, only if they will be written.
-            if (opt.write_consensus) {
-                utils::ScopedProfileRange spr2("run-construct_seqs_and_write", 2);
-
-                // Dimensions: [draft_id x part_id x haplotype_id].
-                const std::vector<std::vector<std::vector<secondary::ConsensusResult>>>
-                        consensus_seqs = polisher::construct_consensus_seqs(
-                                batch_interval, all_results_cons, draft_lens, opt.fill_gaps,
-                                opt.fill_char, *draft_readers.front());
-
-                // Write the consensus file.
-                for (const auto& consensus : consensus_seqs) {
-                    write_consensus_results(*ofs_consensus, consensus, opt.fill_gaps,
-                                            (opt.out_format == OutputFormat::FASTQ));
-                }
-            }
-        } catch (const std::exception& e) {
-            if (!opt.continue_on_error) {
-                throw;
-            } else {
-                spdlog::warn(
-                        "Exception caught when writing consensus sequences on interval of drafts: "
-                        "[{}, {}). Skipping this batch. Original exception: \"{}\"",
-                        batch_interval.start, batch_interval.end, e.what());
-                continue;
-            }
+        // Write the consensus and call variants in the background. Wait for the previous batch
+        // first, so that its outputs are written in order and its errors are propagated.
+        if (pending_batch.valid()) {
+            pending_batch.get();
         }
+        pending_batch = std::async(std::launch::async, finish_batch, batch_interval,
+                                   std::size(region_batch), batch_bases,
+                                   std::move(all_results_cons), std::move(vc_input_data));
+    }
 
-        // Variant calling.
-        try {
-            utils::ScopedProfileRange spr1("run-variant_calling", 1);
-
-            // Run variant calling, optionally.
-            if (opt.run_variant_calling) {
-                std::vector<secondary::Variant> variants = polisher::call_variants(
-                        worker_terminate, stats, batch_interval, vc_input_data, draft_readers,
-                        draft_lens, *resources.decoder, opt.pass_min_qual, opt.ambig_ref,
-                        opt.vc_type == VariantCallingEnum::GVCF, opt.threads,
-                        opt.continue_on_error);
-
-                std::sort(std::begin(variants), std::end(variants),
-                          [](const auto& a, const auto& b) {
-                              return std::tie(a.seq_id, a.pos) < std::tie(b.seq_id, b.pos);
-                          });
-
-                // Write the VCF file.
-                for (const auto& variant : variants) {
-                    vcf_writer->write_variant(variant);
-                }
-
-                // We approximate the progress by expecting 2x bases to be processed
-                // when doing variant calling.
-                total_batch_bases += batch_bases;
-                stats.set("processed", static_cast<double>(total_batch_bases));
-            }
-        } catch (const std::exception& e) {
-            if (!opt.continue_on_error) {
-                throw;
-            } else {
-                spdlog::warn(
-                        "Exception caught when calling variants in the batch interval of drafts: "
-                        "[{}, {}). Not producing variant calls for this batch of drafts. Original "
-                        "exception: \"{}\"",
-                        batch_interval.start, batch_interval.end, e.what());
-            }
-        }
+    if (pending_batch.valid()) {
+        pending_batch.get();
     }
 }
 
@@ -6,6 +6,7 @@
 #include "model_downloader/model_downloader.h"
 #include "models/models.h"
 #include "polish/polish_impl.h"
+#include "polish/task_scheduler.h"
 #include "secondary/architectures/model_config.h"
 #include "secondary/common/bam_info.h"
 #include "secondary/common/batching.h"
@@ -1118,6 +1119,9 @@ void run_variant_calling(const Options& opt,
     int64_t total_batch_bases = 0;
     std::atomic<bool> worker_terminate{false};
 
+    // All CPU stages share one pool of opt.threads threads.
+    polisher::TaskScheduler scheduler(opt.threads);
+
     const int32_t ploidy = secondary::label_scheme_type_to_ploidy(
             secondary::parse_label_scheme_type(model_config.label_scheme_type));
 
@@ -1177,7 +1181,7 @@ void run_variant_calling(const Options& opt,
                 }
 
                 haplotag_results = polisher::haplotag_regions_in_parallel(
-                        resources.encoders, bam_regions, draft_lens, opt.threads, ploidy,
+                        scheduler, resources.encoders, bam_regions, draft_lens, opt.threads, ploidy,
                         opt.pass_min_qual);
 
                 // Candidate variants, if needed.
@@ -1200,11 +1204,12 @@ void run_variant_calling(const Options& opt,
                 // Create a thread for the sample producer.
                 polisher::WorkerReturnStatus wrs_sample_producer;
                 auto thread_sample_producer = utils::jthread(
-                        [&resources, &bam_regions, &draft_lens, &candidate_trees, &opt, &usable_mem,
-                         &batch_queue, &worker_terminate, &wrs_sample_producer, &haplotag_results] {
+                        [&scheduler, &resources, &bam_regions, &draft_lens, &candidate_trees, &opt,
+                         &usable_mem, &batch_queue, &worker_terminate, &wrs_sample_producer,
+                         &haplotag_results] {
                             utils::set_thread_name("variant_produce");
                             polisher::sample_producer(
-                                    resources, bam_regions, draft_lens,
+                                    scheduler, resources, bam_regions, draft_lens,
                                     haplotag_results.region_haplotags, candidate_trees, opt.threads,
                                     opt.batch_size, opt.encoding_batch_size, opt.window_len,
                                     opt.window_overlap, opt.variant_flanking_bases,
@@ -1217,11 +1222,12 @@ void run_variant_calling(const Options& opt,
                 // Create a thread for the sample decoder.
                 polisher::WorkerReturnStatus wrs_decoder;
                 auto thread_sample_decoder =
-                        utils::jthread([&all_results_cons, &vc_input_data, &decode_queue, &stats,
-                                        &resources, &opt, &worker_terminate, &wrs_decoder] {
+                        utils::jthread([&scheduler, &all_results_cons, &vc_input_data,
+                                        &decode_queue, &stats, &resources, &opt, &worker_terminate,
+                                        &wrs_decoder] {
                             utils::set_thread_name("variant_decode");
                             polisher::decode_samples_in_parallel(
-                                    all_results_cons, vc_input_data, decode_queue, stats,
+                                    scheduler, all_results_cons, vc_input_data, decode_queue, stats,
                                     worker_terminate, wrs_decoder, *resources.decoder, opt.threads,
                                     opt.min_depth,
                                     /*collect_vc_data=*/true, opt.continue_on_error);
@@ -1261,9 +1267,9 @@ void run_variant_calling(const Options& opt,
             utils::ScopedProfileRange spr1("run-variant_calling", 1);
 
             std::vector<secondary::Variant> variants = polisher::call_variants(
-                    worker_terminate, stats, batch_interval, vc_input_data, draft_readers,
-                    draft_lens, *resources.decoder, opt.pass_min_qual, opt.ambig_ref,
-                    opt.out_format == VariantCallingFormatEnum::GVCF, opt.threads,
+                    scheduler, worker_terminate, stats, batch_interval, vc_input_data,
+                    draft_readers, draft_lens, *resources.decoder, opt.pass_min_qual,
+                    opt.ambig_ref, opt.out_format == VariantCallingFormatEnum::GVCF, opt.threads,
                     opt.continue_on_error);
 
             spdlog::debug("Inference variants: {}, Kadayashi confident variants: {}",
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "utils/MappedFile.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace dorado {
+struct CorrectionAlignments;
+}
+
+namespace dorado::correction {
+
+// A compact binary store of the overlaps found for correction, for running the mapping and
+// inference stages separately.
+//
+// Each pile of overlaps (all the overlaps of one target read) is appended as it's produced, with
+// read names replaced by integer ids and the coordinates and CIGAR operations varint encoded.  A
+// name table and an index of the piles, sorted by target name, are written last.  Readers map the
+// file, so piles are decoded on demand and can be looked up by target.
+
+// Conventional extension for overlap stores.
+inline constexpr const char* OVERLAP_STORE_EXTENSION = ".dovl";
+
+// Index entry for one pile of overlaps.
+struct OverlapStorePile {
+    uint64_t offset{0};
+    uint64_t bytes{0};
+    uint32_t target_id{0};
+    uint32_t num_overlaps{0};
+};
+
+// True if |path| is a file starting with the overlap store header.
+bool is_overlap_store_file(const std::filesystem::path& path);
+
+class OverlapStoreWriter {
+public:
+    // Piles are written to a temporary file, which is only moved to |path| by finalise().
+    explicit OverlapStoreWriter(std::filesystem::path path);
+    // Removes the temporary file if finalise() wasn't called.
+    ~OverlapStoreWriter();
+
+    OverlapStoreWriter(const OverlapStoreWriter&) = delete;
+    OverlapStoreWriter& operator=(const OverlapStoreWriter&) = delete;
+
+    // Appends the overlaps of |alignments|.  Each target should only be added once.
+    void add(const CorrectionAlignments& alignments);
+
+    // Writes the name table and pile index.  Throws on failure.
+    void finalise();
+
+    uint64_t num_overlaps() const { return m_num_overlaps; }
+
+private:
+    uint32_t name_id(const std::string& name);
+    void write(const void* data, uint64_t bytes);
+    void pad();
+
+    const std::filesystem::path m_path;
+    std::filesystem::path m_tmp_path;
+    std::ofstream m_out;
+    uint64_t m_pos{0};
+    bool m_finalised{false};
+
+    std::unordered_map<std::string, uint32_t> m_name_ids;
+    // Keys of m_name_ids, by id.
+    std::vector<const std::string*> m_names;
+    std::vector<OverlapStorePile> m_piles;
+    std::vector<uint8_t> m_buffer;
+    uint64_t m_num_overlaps{0};
+};
+
+class OverlapStoreReader {
+public:
+    // Throws if |path| can't be mapped or isn't a valid overlap store.
+    explicit OverlapStoreReader(const std::filesystem::path& path);
+
+    // Piles are numbered in order of target name.
+    size_t num_piles() const { return m_num_piles; }
+    uint64_t num_overlaps() const { return m_num_overlaps; }
+
+    std::string_view target_name(size_t pile) const;
+    std::optional<size_t> find_target(std::string_view target_name) const;
+
+    // Fills in the read name, query names, overlaps and CIGARs of |alignments|.  Throws if the
+    // pile is corrupt.
+    void load(size_t pile, CorrectionAlignments& alignments) const;
+
+private:
+    std::string_view name(uint32_t id) const;
+
+    utils::MappedFile m_file;
+    uint64_t m_num_names{0};
+    const uint64_t* m_name_offsets{nullptr};
+    const char* m_name_chars{nullptr};
+    uint64_t m_name_chars_bytes{0};
+    size_t m_num_piles{0};
+    const OverlapStorePile* m_piles{nullptr};
+    uint64_t m_num_overlaps{0};
+};
+
+}  // namespace dorado::correction
@@ -0,0 +1,326 @@
+#include "correct/overlap_store.h"
+
+#include "read_pipeline/base/messages.h"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+#include <system_error>
+
+namespace {
+
+constexpr std::array<char, 8> MAGIC{'D', 'O', 'R', 'O', 'V', 'L', 'P', 'S'};
+constexpr uint32_t LAYOUT_VERSION = 1;
+// Alignment of the tables following the piles.
+constexpr uint64_t TABLE_ALIGNMENT = 8;
+
+struct FileHeader {
+    std::array<char, 8> magic{};
+    uint32_t version{0};
+    uint32_t reserved{0};
+    // uint64_t[num_names + 1] offsets into the name characters.
+    uint64_t num_names{0};
+    uint64_t name_offsets_offset{0};
+    uint64_t name_chars_offset{0};
+    uint64_t name_chars_bytes{0};
+    // OverlapStorePile[num_piles], sorted by target name.
+    uint64_t num_piles{0};
+    uint64_t piles_offset{0};
+    uint64_t num_overlaps{0};
+    uint64_t file_size{0};
+};
+
+// CIGAR operations are packed with their length, in the bits above the operation.
+constexpr uint32_t CIGAR_OP_BITS = 4;
+
+void put_varint(std::vector<uint8_t>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+// Coordinates are never negative, but are stored as their bit pattern so that any int round
+// trips.
+void put_int(std::vector<uint8_t>& out, int value) {
+    put_varint(out, static_cast<uint32_t>(value));
+}
+
+// Decodes a pile, throwing rather than reading past its end.
+class PileDecoder {
+public:
+    PileDecoder(const uint8_t* data, uint64_t bytes) : m_pos(data), m_end(data + bytes) {}
+
+    uint64_t varint() {
+        uint64_t value = 0;
+        for (uint32_t shift = 0; shift < 64; shift += 7) {
+            const uint8_t byte = next();
+            value |= uint64_t(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) {
+                return value;
+            }
+        }
+        throw std::runtime_error("Overlap store is corrupt");
+    }
+
+    int integer() { return static_cast<int>(static_cast<uint32_t>(varint())); }
+
+    uint8_t next() {
+        if (m_pos == m_end) {
+            throw std::runtime_error("Overlap store is truncated or corrupt");
+        }
+        return *m_pos++;
+    }
+
+    bool done() const { return m_pos == m_end; }
+
+private:
+    const uint8_t* m_pos;
+    const uint8_t* const m_end;
+};
+
+}  // namespace
+
+namespace dorado::correction {
+
+bool is_overlap_store_file(const std::filesystem::path& path) {
+    std::ifstream in(path, std::ios::binary);
+    std::array<char, MAGIC.size()> magic{};
+    in.read(magic.data(), magic.size());
+    return in && magic == MAGIC;
+}
+
+OverlapStoreWriter::OverlapStoreWriter(std::filesystem::path path) : m_path(std::move(path)) {
+    m_tmp_path = m_path;
+    m_tmp_path += ".tmp";
+    m_out.open(m_tmp_path, std::ios::binary | std::ios::trunc);
+    if (!m_out) {
+        throw std::runtime_error("Failed to create overlap store " + m_tmp_path.string());
+    }
+    // Filled in by finalise().
+    const FileHeader header;
+    write(&header, sizeof(header));
+}
+
+OverlapStoreWriter::~OverlapStoreWriter() {
+    if (!m_finalised) {
+        m_out.close();
+        std::error_code ec;
+        std::filesystem::remove(m_tmp_path, ec);
+    }
+}
+
+uint32_t OverlapStoreWriter::name_id(const std::string& name) {
+    const auto [it, inserted] = m_name_ids.emplace(name, static_cast<uint32_t>(m_names.size()));
+    if (inserted) {
+        if (m_names.size() == UINT32_MAX) {
+            throw std::runtime_error("Too many reads for the overlap store");
+        }
+        m_names.push_back(&it->first);
+    }
+    return it->second;
+}
+
+void OverlapStoreWriter::write(const void* data, uint64_t bytes) {
+    m_out.write(static_cast<const char*>(data), std::streamsize(bytes));
+    if (!m_out) {
+        throw std::runtime_error("Failed to write overlap store " + m_tmp_path.string());
+    }
+    m_pos += bytes;
+}
+
+void OverlapStoreWriter::pad() {
+    static constexpr std::array<char, TABLE_ALIGNMENT> zeros{};
+    write(zeros.data(), (TABLE_ALIGNMENT - m_pos % TABLE_ALIGNMENT) % TABLE_ALIGNMENT);
+}
+
+void OverlapStoreWriter::add(const CorrectionAlignments& alignments) {
+    if (m_finalised) {
+        throw std::logic_error("OverlapStoreWriter::add() called after finalise()");
+    }
+    if (alignments.qnames.size() > UINT32_MAX) {
+        throw std::runtime_error("Too many overlaps for target " + alignments.read_name);
+    }
+
+    OverlapStorePile pile;
+    pile.target_id = name_id(alignments.read_name);
+    pile.num_overlaps = static_cast<uint32_t>(alignments.qnames.size());
+    pile.offset = m_pos;
+
+    m_buffer.clear();
+    for (size_t i = 0; i < alignments.qnames.size(); ++i) {
+        const auto& overlap = alignments.overlaps[i];
+        put_varint(m_buffer, name_id(alignments.qnames[i]));
+        put_int(m_buffer, overlap.qstart);
+        put_int(m_buffer, overlap.qend);
+        put_int(m_buffer, overlap.qlen);
+        put_int(m_buffer, overlap.tstart);
+        put_int(m_buffer, overlap.tend);
+        put_int(m_buffer, overlap.tlen);
+        m_buffer.push_back(overlap.fwd ? 1 : 0);
+
+        const auto& cigar = alignments.cigars[i];
+        put_varint(m_buffer, cigar.size());
+        for (const auto& op : cigar) {
+            put_varint(m_buffer, (uint64_t(op.len) << CIGAR_OP_BITS) | uint64_t(op.op));
+        }
+    }
+    write(m_buffer.data(), m_buffer.size());
+
+    pile.bytes = m_buffer.size();
+    m_piles.push_back(pile);
+    m_num_overlaps += pile.num_overlaps;
+}
+
+void OverlapStoreWriter::finalise() {
+    if (m_finalised) {
+        return;
+    }
+
+    FileHeader header;
+    header.magic = MAGIC;
+    header.version = LAYOUT_VERSION;
+    header.num_overlaps = m_num_overlaps;
+
+    std::vector<uint64_t> name_offsets;
+    name_offsets.reserve(m_names.size() + 1);
+    uint64_t name_chars_bytes = 0;
+    for (const auto* name : m_names) {
+        name_offsets.push_back(name_chars_bytes);
+        name_chars_bytes += name->size();
+    }
+    name_offsets.push_back(name_chars_bytes);
+
+    pad();
+    header.num_names = m_names.size();
+    header.name_offsets_offset = m_pos;
+    write(name_offsets.data(), name_offsets.size() * sizeof(uint64_t));
+    header.name_chars_offset = m_pos;
+    header.name_chars_bytes = name_chars_bytes;
+    for (const auto* name : m_names) {
+        write(name->data(), name->size());
+    }
+
+    std::stable_sort(m_piles.begin(), m_piles.end(),
+                     [this](const OverlapStorePile& lhs, const OverlapStorePile& rhs) {
+                         return *m_names[lhs.target_id] < *m_names[rhs.target_id];
+                     });
+    pad();
+    header.num_piles = m_piles.size();
+    header.piles_offset = m_pos;
+    write(m_piles.data(), m_piles.size() * sizeof(OverlapStorePile));
+
+    header.file_size = m_pos;
+    m_out.seekp(0);
+    m_out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    m_out.close();
+    if (!m_out) {
+        throw std::runtime_error("Failed to write overlap store " + m_tmp_path.string());
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(m_tmp_path, m_path, ec);
+    if (ec) {
+        throw std::runtime_error("Failed to write overlap store " + m_path.string() + ": " +
+                                 ec.message());
+    }
+    m_finalised = true;
+    spdlog::debug("Wrote {} overlaps of {} targets to overlap store '{}' ({} bytes)",
+                  m_num_overlaps, m_piles.size(), m_path.string(), header.file_size);
+}
+
+OverlapStoreReader::OverlapStoreReader(const std::filesystem::path& path) : m_file(path) {
+    const auto& header = *m_file.section<FileHeader>(0, 1);
+    if (header.magic != MAGIC) {
+        throw std::runtime_error("Not an overlap store: " + path.string());
+    }
+    if (header.version != LAYOUT_VERSION) {
+        throw std::runtime_error("Overlap store " + path.string() +
+                                 " was written by an incompatible version of dorado");
+    }
+    m_file.section<uint8_t>(0, header.file_size);
+
+    m_num_names = header.num_names;
+    m_name_offsets = m_file.section<uint64_t>(header.name_offsets_offset, m_num_names + 1);
+    m_name_chars = m_file.section<char>(header.name_chars_offset, header.name_chars_bytes);
+    m_name_chars_bytes = header.name_chars_bytes;
+    m_num_piles = header.num_piles;
+    m_piles = m_file.section<OverlapStorePile>(header.piles_offset, m_num_piles);
+    m_num_overlaps = header.num_overlaps;
+
+    for (size_t i = 0; i < m_num_piles; ++i) {
+        m_file.section<uint8_t>(m_piles[i].offset, m_piles[i].bytes);
+        if (m_piles[i].target_id >= m_num_names) {
+            throw std::runtime_error("Overlap store " + path.string() + " is corrupt");
+        }
+    }
+}
+
+std::string_view OverlapStoreReader::name(uint32_t id) const {
+    if (id >= m_num_names) {
+        throw std::runtime_error("Overlap store is corrupt");
+    }
+    const uint64_t begin = m_name_offsets[id];
+    const uint64_t end = m_name_offsets[id + 1];
+    if (begin > end || end > m_name_chars_bytes) {
+        throw std::runtime_error("Overlap store is corrupt");
+    }
+    return {m_name_chars + begin, size_t(end - begin)};
+}
+
+std::string_view OverlapStoreReader::target_name(size_t pile) const {
+    return name(m_piles[pile].target_id);
+}
+
+std::optional<size_t> OverlapStoreReader::find_target(std::string_view target_name) const {
+    const auto* end = m_piles + m_num_piles;
+    const auto* it = std::lower_bound(m_piles, end, target_name,
+                                      [this](const OverlapStorePile& pile, std::string_view key) {
+                                          return name(pile.target_id) < key;
+                                      });
+    if (it == end || name(it->target_id) != target_name) {
+        return std::nullopt;
+    }
+    return static_cast<size_t>(it - m_piles);
+}
+
+void OverlapStoreReader::load(size_t pile, CorrectionAlignments& alignments) const {
+    const auto& record = m_piles[pile];
+    alignments.read_name = name(record.target_id);
+    alignments.qnames.resize(record.num_overlaps);
+    alignments.overlaps.resize(record.num_overlaps);
+    alignments.cigars.resize(record.num_overlaps);
+
+    PileDecoder decoder(m_file.data() + record.offset, record.bytes);
+    for (uint32_t i = 0; i < record.num_overlaps; ++i) {
+        alignments.qnames[i] = name(static_cast<uint32_t>(decoder.varint()));
+        auto& overlap = alignments.overlaps[i];
+        overlap.qstart = decoder.integer();
+        overlap.qend = decoder.integer();
+        overlap.qlen = decoder.integer();
+        overlap.tstart = decoder.integer();
+        overlap.tend = decoder.integer();
+        overlap.tlen = decoder.integer();
+        overlap.fwd = decoder.next() != 0;
+
+        const uint64_t num_ops = decoder.varint();
+        if (num_ops > record.bytes) {
+            throw std::runtime_error("Overlap store is corrupt");
+        }
+        auto& cigar = alignments.cigars[i];
+        cigar.resize(num_ops);
+        for (auto& op : cigar) {
+            const uint64_t packed = decoder.varint();
+            op.op = static_cast<CigarOpType>(packed & ((1 << CIGAR_OP_BITS) - 1));
+            op.len = static_cast<uint32_t>(packed >> CIGAR_OP_BITS);
+        }
+    }
+    if (!decoder.done()) {
+        throw std::runtime_error("Overlap store is corrupt");
+    }
+}
+
+}  // namespace dorado::correction
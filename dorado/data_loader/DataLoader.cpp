@@ -14,13 +14,21 @@
 #include <spdlog/spdlog.h>
 
 #include <algorithm>
-#include <cctype>
+#include <chrono>
+#include <condition_variable>
 #include <cstddef>
 #include <ctime>
+#include <exception>
 #include <filesystem>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
 #include <optional>
+#include <queue>
 #include <stdexcept>
 #include <string_view>
+#include <tuple>
 #include <vector>
 
 namespace dorado {
@@ -97,18 +105,22 @@ bool should_process_pod5_row(const ReadBatchRowInfo_t& read_data,
                              size_t batch_index,
                              size_t row,
                              const std::optional<std::unordered_set<std::string>>& allowed_read_ids,
-                             const std::unordered_set<std::string>& ignored_read_ids) {
+                             const utils::ReadIdSet& ignored_read_ids) {
+    // The ignore list can hold every read of a resumed run, so it's checked on the binary id.
+    if (ignored_read_ids.contains(read_data.read_id)) {
+        return false;
+    }
+    if (!allowed_read_ids) {
+        return true;
+    }
+
     char read_id_tmp[POD5_READ_ID_LEN]{};
     if (pod5_format_read_id(read_data.read_id, read_id_tmp) != POD5_OK) {
         issue_pod5_error("Failed to format read id", filename, batch_index, row);
         return false;
     }
 
-    std::string read_id_str(read_id_tmp);
-    bool read_in_ignore_list = ignored_read_ids.find(read_id_str) != ignored_read_ids.end();
-    bool read_in_read_list =
-            !allowed_read_ids || (allowed_read_ids->find(read_id_str) != allowed_read_ids->end());
-    return read_in_read_list && !read_in_ignore_list;
+    return allowed_read_ids->find(read_id_tmp) != allowed_read_ids->end();
 }
 
 SimplexReadPtr process_pod5_thread_fn(
@@ -120,7 +132,7 @@ SimplexReadPtr process_pod5_thread_fn(
         const std::unordered_map<int, std::vector<DataLoader::ReadSortInfo>>& reads_by_channel,
         const std::unordered_map<std::string, size_t>& read_id_to_index,
         const std::optional<std::unordered_set<std::string>>& allowed_read_ids,
-        const std::unordered_set<std::string>& ignored_read_ids) {
+        const utils::ReadIdSet& ignored_read_ids) {
     uint16_t read_table_version = 0;
 
     const std::string filename = std::filesystem::path(path).filename().string();
@@ -258,6 +270,281 @@ SimplexReadPtr process_pod5_thread_fn(
     return new_read;
 }
 
+uint64_t elapsed_us(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() -
+                                                                 start)
+            .count();
+}
+
+// An open POD5 file, closed once the cursor and every batch read from it have released it.
+class Pod5File {
+public:
+    Pod5File(std::string path, Pod5FileReader_t* reader)
+            : m_path(std::move(path)), m_reader(reader) {}
+    ~Pod5File() {
+        if (pod5_close_and_free_reader(m_reader) != POD5_OK) {
+            issue_pod5_error("Failed to close and free POD5 reader", m_path);
+        }
+    }
+    Pod5File(const Pod5File&) = delete;
+    Pod5File& operator=(const Pod5File&) = delete;
+
+    const std::string& path() const { return m_path; }
+    Pod5FileReader_t* reader() const { return m_reader; }
+
+private:
+    const std::string m_path;
+    Pod5FileReader_t* const m_reader;
+};
+
+// A record batch, which keeps its file open until it is released.
+class Pod5Batch {
+public:
+    Pod5Batch(std::shared_ptr<Pod5File> file,
+              Pod5ReadRecordBatch_t* batch,
+              size_t batch_index,
+              size_t row_count)
+            : m_file(std::move(file)),
+              m_batch(batch),
+              m_batch_index(batch_index),
+              m_row_count(row_count) {}
+    ~Pod5Batch() {
+        if (pod5_free_read_batch(m_batch) != POD5_OK) {
+            issue_pod5_error("Failed to release batch", m_file->path(), m_batch_index, 0);
+        }
+    }
+    Pod5Batch(const Pod5Batch&) = delete;
+    Pod5Batch& operator=(const Pod5Batch&) = delete;
+
+    const Pod5File& file() const { return *m_file; }
+    const Pod5ReadRecordBatch_t* batch() const { return m_batch; }
+    size_t batch_index() const { return m_batch_index; }
+    size_t row_count() const { return m_row_count; }
+
+private:
+    const std::shared_ptr<Pod5File> m_file;
+    Pod5ReadRecordBatch_t* const m_batch;
+    const size_t m_batch_index;
+    const size_t m_row_count;
+};
+
+// Walks the record batches of a list of files in order, opening each file as it is reached.
+// Files and batches that can't be read are logged and skipped.
+class Pod5BatchCursor {
+public:
+    explicit Pod5BatchCursor(const std::vector<std::filesystem::directory_entry>& files)
+            : m_files(files) {}
+
+    // Returns the next batch, or nullptr once every file has been walked.
+    std::unique_ptr<Pod5Batch> next() {
+        while (true) {
+            if (!m_current_file || m_next_batch_index == m_batch_count) {
+                if (!open_next_file()) {
+                    return nullptr;
+                }
+                continue;
+            }
+
+            const auto batch_index = m_next_batch_index++;
+            const auto& path = m_current_file->path();
+            Pod5ReadRecordBatch_t* batch = nullptr;
+            if (pod5_get_read_batch(&batch, m_current_file->reader(), batch_index) != POD5_OK) {
+                issue_pod5_error("Failed to get batch", path, batch_index, 0);
+                continue;
+            }
+            std::size_t row_count = 0;
+            if (pod5_get_read_batch_row_count(&row_count, batch) != POD5_OK) {
+                issue_pod5_error("Failed to get batch row count", path, batch_index, 0);
+                if (pod5_free_read_batch(batch) != POD5_OK) {
+                    issue_pod5_error("Failed to release batch", path, batch_index, 0);
+                }
+                continue;
+            }
+            return std::make_unique<Pod5Batch>(m_current_file, batch, batch_index, row_count);
+        }
+    }
+
+private:
+    bool open_next_file() {
+        m_current_file.reset();
+        while (m_next_file_index < m_files.size()) {
+            const auto& entry = m_files[m_next_file_index++];
+            if (!utils::has_pod5_extension(entry)) {
+                continue;
+            }
+            auto path = entry.path().string();
+            spdlog::debug("Load reads from file {}", path);
+            Pod5FileReader_t* reader = pod5_open_file(path.c_str());
+            if (!reader) {
+                issue_pod5_error("Failed to open file", path);
+                continue;
+            }
+            auto file = std::make_shared<Pod5File>(std::move(path), reader);
+            std::size_t batch_count = 0;
+            if (pod5_get_read_batch_count(&batch_count, file->reader()) != POD5_OK) {
+                issue_pod5_error("Failed to query batch count", file->path());
+                continue;
+            }
+            m_current_file = std::move(file);
+            m_batch_count = batch_count;
+            m_next_batch_index = 0;
+            return true;
+        }
+        return false;
+    }
+
+    const std::vector<std::filesystem::directory_entry>& m_files;
+    size_t m_next_file_index{0};
+    std::shared_ptr<Pod5File> m_current_file;
+    size_t m_batch_count{0};
+    size_t m_next_batch_index{0};
+};
+
+// A row decoded by a worker, waiting to be pushed into the pipeline.
+struct DecodedRow {
+    size_t batch_id;
+    SimplexReadPtr read;
+    std::exception_ptr error;
+};
+
+std::shared_ptr<Pod5File> open_pod5_file(const std::string& path) {
+    Pod5FileReader_t* reader = pod5_open_file(path.c_str());
+    if (!reader) {
+        issue_pod5_error("Failed to open file", path);
+        return nullptr;
+    }
+    return std::make_shared<Pod5File>(path, reader);
+}
+
+std::shared_ptr<Pod5Batch> get_pod5_batch(const std::shared_ptr<Pod5File>& file,
+                                          size_t batch_index) {
+    Pod5ReadRecordBatch_t* batch = nullptr;
+    if (pod5_get_read_batch(&batch, file->reader(), batch_index) != POD5_OK) {
+        issue_pod5_error("Failed to get batch", file->path(), batch_index, 0);
+        return nullptr;
+    }
+    return std::make_shared<Pod5Batch>(file, batch, batch_index, 0);
+}
+
+// Where to find a read, and when and on which channel it started.
+struct TimeIndexEntry {
+    uint64_t start_time_ms;
+    uint32_t batch_index;
+    uint32_t row;
+    ReadID read_id;
+    uint16_t channel;
+};
+
+// Builds an index of the reads in a file, sorted by start time. Unreadable rows are skipped.
+std::vector<TimeIndexEntry> build_time_index(const std::string& path) {
+    std::vector<TimeIndexEntry> index;
+    auto file = open_pod5_file(path);
+    if (!file) {
+        return index;
+    }
+
+    std::size_t batch_count = 0;
+    if (pod5_get_read_batch_count(&batch_count, file->reader()) != POD5_OK) {
+        issue_pod5_error("Failed to query batch count", path);
+        return index;
+    }
+
+    for (std::size_t batch_index = 0; batch_index < batch_count; ++batch_index) {
+        auto batch = get_pod5_batch(file, batch_index);
+        if (!batch) {
+            continue;
+        }
+        std::size_t row_count = 0;
+        if (pod5_get_read_batch_row_count(&row_count, batch->batch()) != POD5_OK) {
+            issue_pod5_error("Failed to get batch row count", path, batch_index, 0);
+            continue;
+        }
+
+        // Acquisition start time and sample rate, by run info index. Batches typically only
+        // reference a handful of runs, and fetching run info is expensive.
+        std::unordered_map<int16_t, std::pair<int64_t, uint64_t>> run_timing;
+        for (std::size_t row = 0; row < row_count; ++row) {
+            uint16_t read_table_version = 0;
+            ReadBatchRowInfo_t read_data{};
+            if (pod5_get_read_batch_row_info_data(batch->batch(), row, READ_BATCH_ROW_INFO_VERSION,
+                                                  &read_data, &read_table_version) != POD5_OK) {
+                issue_pod5_error("Failed to get read", path, batch_index, row);
+                continue;
+            }
+
+            auto timing_it = run_timing.find(read_data.run_info);
+            if (timing_it == run_timing.end()) {
+                RunInfoDictData_t* run_info_data = nullptr;
+                if (pod5_get_run_info(batch->batch(), read_data.run_info, &run_info_data) !=
+                    POD5_OK) {
+                    issue_pod5_error("Failed to get Run Info", path, batch_index, row);
+                    continue;
+                }
+                const std::pair<int64_t, uint64_t> timing{run_info_data->acquisition_start_time_ms,
+                                                          run_info_data->sample_rate};
+                if (pod5_free_run_info(run_info_data) != POD5_OK) {
+                    issue_pod5_error("Failed to free Run Info", path, batch_index, row);
+                }
+                timing_it = run_timing.emplace(read_data.run_info, timing).first;
+            }
+
+            const auto [acquisition_start_time_ms, sample_rate] = timing_it->second;
+            uint64_t start_time_ms = acquisition_start_time_ms;
+            if (sample_rate != 0) {
+                start_time_ms += (read_data.start_sample * 1000) / sample_rate;
+            }
+            auto& entry = index.emplace_back();
+            entry.start_time_ms = start_time_ms;
+            entry.batch_index = static_cast<uint32_t>(batch_index);
+            entry.row = static_cast<uint32_t>(row);
+            std::memcpy(entry.read_id.data(), read_data.read_id, POD5_READ_ID_SIZE);
+            entry.channel = read_data.channel;
+        }
+    }
+
+    std::stable_sort(index.begin(), index.end(), [](const auto& a, const auto& b) {
+        return a.start_time_ms < b.start_time_ms;
+    });
+    return index;
+}
+
+// Least recently used cache of open record batches.
+class Pod5BatchCache {
+public:
+    explicit Pod5BatchCache(size_t capacity) : m_capacity(std::max<size_t>(capacity, 1)) {}
+
+    // Returns the batch, opening it (and evicting the least recently used batch if the cache is
+    // full) if necessary. Returns nullptr if the batch can't be read.
+    std::shared_ptr<Pod5Batch> get(size_t file_idx,
+                                   const std::shared_ptr<Pod5File>& file,
+                                   size_t batch_index) {
+        const auto key = std::make_pair(file_idx, batch_index);
+        auto it = std::find_if(m_batches.begin(), m_batches.end(),
+                               [&key](const auto& entry) { return entry.first == key; });
+        if (it != m_batches.end()) {
+            m_batches.splice(m_batches.begin(), m_batches, it);
+            return m_batches.front().second;
+        }
+
+        auto batch = get_pod5_batch(file, batch_index);
+        if (!batch) {
+            return nullptr;
+        }
+        if (m_batches.size() == m_capacity) {
+            m_batches.pop_back();
+        }
+        m_batches.emplace_front(key, batch);
+        return batch;
+    }
+
+    size_t capacity() const { return m_capacity; }
+
+private:
+    const size_t m_capacity;
+    // Most recently used first. The cache is small, so a linear search is fine.
+    std::list<std::pair<std::pair<size_t, size_t>, std::shared_ptr<Pod5Batch>>> m_batches;
+};
+
 }  // namespace
 
 void DataLoader::load_reads_by_channel(const std::vector<std::filesystem::directory_entry>& files) {
@@ -316,18 +603,285 @@ void DataLoader::load_reads_by_channel(const std::vector<std::filesystem::direct
 
 void DataLoader::load_reads_unrestricted(
         const std::vector<std::filesystem::directory_entry>& files) {
+    // Batches are fetched on this thread and their rows decoded by the worker pool. Up to
+    // m_max_batches_in_flight batches are kept in flight, so fetching and decoding the next batch
+    // overlaps with pushing the reads of the current one, and reads are pushed in the order that
+    // they finish decoding.
+    struct InFlightBatch {
+        std::unique_ptr<Pod5Batch> batch;
+        size_t rows_pending;
+    };
+    std::unordered_map<size_t, InFlightBatch> in_flight_batches;
+    size_t next_batch_id = 0;
+    size_t rows_in_flight = 0;
+
+    std::mutex decoded_mutex;
+    std::condition_variable decoded_cv;
+    std::vector<DecodedRow> decoded_rows;
+    std::vector<DecodedRow> rows_to_push;
+    size_t next_row_to_push = 0;
+    std::exception_ptr first_error;
+
+    // Consumes decoded rows, blocking until at least one is available. Rows left over from a
+    // previous call that threw are consumed first.
+    auto process_decoded_rows = [&](bool push_reads) {
+        if (next_row_to_push == rows_to_push.size()) {
+            rows_to_push.clear();
+            next_row_to_push = 0;
+            std::unique_lock lock(decoded_mutex);
+            decoded_cv.wait(lock, [&decoded_rows] { return !decoded_rows.empty(); });
+            std::swap(rows_to_push, decoded_rows);
+        }
+        while (next_row_to_push < rows_to_push.size()) {
+            auto& row = rows_to_push[next_row_to_push++];
+            --rows_in_flight;
+            auto batch_it = in_flight_batches.find(row.batch_id);
+            if (--batch_it->second.rows_pending == 0) {
+                in_flight_batches.erase(batch_it);
+                --m_batches_in_flight;
+            }
+            if (row.read) {
+                m_signal_bytes_in_flight -= row.read->read_common.raw_data.nbytes();
+            }
+            if (row.error) {
+                if (!first_error) {
+                    first_error = row.error;
+                }
+                m_stop_loading.store(true, std::memory_order_relaxed);
+            } else if (push_reads) {
+                push_read(std::move(row.read));
+            }
+        }
+    };
+
+    // Workers reference the state above, so they must all finish before we leave, even on error.
+    auto drain_workers = utils::PostCondition([&] {
+        while (rows_in_flight > 0) {
+            process_decoded_rows(false);
+        }
+    });
+
+    Pod5BatchCursor cursor(files);
+    bool all_batches_fetched = false;
+    while (true) {
+        while (!all_batches_fetched && !m_stop_loading.load(std::memory_order_relaxed) &&
+               m_loaded_read_count + rows_in_flight < m_max_reads &&
+               in_flight_batches.size() < m_max_batches_in_flight &&
+               m_signal_bytes_in_flight.load() < m_max_signal_bytes_in_flight) {
+            const auto fetch_start = std::chrono::steady_clock::now();
+            auto batch = cursor.next();
+            m_batch_read_time_us += elapsed_us(fetch_start);
+            if (!batch) {
+                all_batches_fetched = true;
+                break;
+            }
+
+            const size_t num_rows = std::min(batch->row_count(),
+                                             m_max_reads - m_loaded_read_count - rows_in_flight);
+            if (num_rows == 0) {
+                continue;
+            }
+            const auto batch_id = next_batch_id++;
+            const Pod5Batch* const batch_ptr = batch.get();
+            in_flight_batches.emplace(batch_id, InFlightBatch{std::move(batch), num_rows});
+            ++m_batches_in_flight;
+            rows_in_flight += num_rows;
+
+            for (std::size_t row = 0; row < num_rows; ++row) {
+                m_thread_pool.push([row, batch_id, batch_ptr, &decoded_mutex, &decoded_cv,
+                                    &decoded_rows, this] {
+                    DecodedRow decoded{batch_id, nullptr, nullptr};
+                    const auto decode_start = std::chrono::steady_clock::now();
+                    try {
+                        decoded.read = process_pod5_thread_fn(
+                                row, batch_ptr->batch_index(), batch_ptr->batch(),
+                                batch_ptr->file().reader(), batch_ptr->file().path(),
+                                m_reads_by_channel, m_read_id_to_index, m_allowed_read_ids,
+                                m_ignored_read_ids);
+                    } catch (...) {
+                        decoded.error = std::current_exception();
+                    }
+                    m_decode_time_us += elapsed_us(decode_start);
+                    if (decoded.read) {
+                        m_signal_bytes_in_flight += decoded.read->read_common.raw_data.nbytes();
+                    }
+                    // Notify under the lock, since the loader may return as soon as it sees
+                    // the last row.
+                    std::lock_guard lock(decoded_mutex);
+                    decoded_rows.push_back(std::move(decoded));
+                    decoded_cv.notify_one();
+                });
+            }
+        }
+
+        if (rows_in_flight == 0) {
+            // Either everything has been loaded, or loading was stopped early.
+            break;
+        }
+        process_decoded_rows(true);
+    }
+
+    if (first_error) {
+        std::rethrow_exception(first_error);
+    }
+}
+
+void DataLoader::load_reads_by_time(const std::vector<std::filesystem::directory_entry>& files) {
+    // 1. Build a small (start time, batch, row) index for each file, sorted by start time.
+    std::vector<std::string> paths;
     for (const auto& entry : files) {
-        if (m_loaded_read_count == m_max_reads || m_stop_loading.load(std::memory_order_relaxed)) {
+        if (utils::has_pod5_extension(entry)) {
+            paths.push_back(entry.path().string());
+        }
+    }
+    spdlog::info("> Indexing read start times");
+    std::vector<std::future<std::vector<TimeIndexEntry>>> index_futures;
+    index_futures.reserve(paths.size());
+    for (const auto& path : paths) {
+        index_futures.push_back(m_thread_pool.push([&path] { return build_time_index(path); }));
+    }
+    std::vector<std::vector<TimeIndexEntry>> indices;
+    indices.reserve(paths.size());
+    for (auto& index_future : index_futures) {
+        indices.push_back(index_future.get());
+    }
+    spdlog::info("> Indexed read start times");
+
+    // 2. K-way merge the per-file indices. Each read is held back until the next read on its
+    // channel has been seen, so that its neighbours are known, and then decoded in chunks that
+    // only reference the batches held open by the cache.
+    using MergeHead = std::pair<uint64_t, size_t>;  // (start time, file index)
+    std::priority_queue<MergeHead, std::vector<MergeHead>, std::greater<>> merge_heads;
+    std::vector<size_t> next_entry(paths.size(), 0);
+    std::vector<std::shared_ptr<Pod5File>> open_files(paths.size());
+    for (size_t file_idx = 0; file_idx < indices.size(); ++file_idx) {
+        if (!indices[file_idx].empty()) {
+            merge_heads.emplace(indices[file_idx].front().start_time_ms, file_idx);
+        }
+    }
+
+    struct PendingRead {
+        std::shared_ptr<Pod5File> file;
+        size_t file_idx;
+        uint64_t start_time_ms;
+        uint32_t batch_index;
+        uint32_t row;
+        std::string read_id;
+        std::string prev_read;
+    };
+    std::unordered_map<uint16_t, PendingRead> pending_by_channel;
+
+    struct ChunkRow {
+        std::shared_ptr<Pod5Batch> batch;
+        uint32_t row;
+        std::string prev_read;
+        std::string next_read;
+    };
+    constexpr size_t kMaxRowsPerChunk = 1000;
+    Pod5BatchCache batch_cache(m_max_open_batches);
+    std::vector<ChunkRow> chunk;
+    std::unordered_set<const Pod5Batch*> chunk_batches;
+
+    auto flush_chunk = [&] {
+        std::vector<std::future<SimplexReadPtr>> futures;
+        futures.reserve(chunk.size());
+        for (auto& chunk_row : chunk) {
+            futures.push_back(m_thread_pool.push([&chunk_row, this] {
+                const auto& batch = *chunk_row.batch;
+                auto read = process_pod5_thread_fn(
+                        chunk_row.row, batch.batch_index(), batch.batch(), batch.file().reader(),
+                        batch.file().path(), m_reads_by_channel, m_read_id_to_index,
+                        m_allowed_read_ids, m_ignored_read_ids);
+                if (read) {
+                    read->prev_read = std::move(chunk_row.prev_read);
+                    read->next_read = std::move(chunk_row.next_read);
+                }
+                return read;
+            }));
+        }
+        wait_and_process_futures(std::move(futures));
+        chunk.clear();
+        chunk_batches.clear();
+    };
+
+    auto release_read = [&](PendingRead& pending, std::string next_read) {
+        // Every batch referenced by a chunk must stay in the cache until the chunk is decoded,
+        // so flush before a new batch could evict one of them.
+        if (chunk.size() == kMaxRowsPerChunk || chunk_batches.size() == batch_cache.capacity()) {
+            flush_chunk();
+        }
+        auto batch = batch_cache.get(pending.file_idx, pending.file, pending.batch_index);
+        if (batch) {
+            chunk_batches.insert(batch.get());
+            chunk.push_back({std::move(batch), pending.row, std::move(pending.prev_read),
+                             std::move(next_read)});
+        }
+    };
+
+    while (!merge_heads.empty()) {
+        if (m_loaded_read_count + chunk.size() >= m_max_reads ||
+            m_stop_loading.load(std::memory_order_relaxed)) {
             break;
         }
-        spdlog::debug("Load reads from file {}", entry.path().string());
-        std::string ext = std::filesystem::path(entry).extension().string();
-        std::transform(ext.begin(), ext.end(), ext.begin(),
-                       [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
-        if (ext == ".pod5") {
-            load_pod5_reads_from_file(entry.path().string());
+
+        const auto file_idx = merge_heads.top().second;
+        merge_heads.pop();
+        const auto& entry = indices[file_idx][next_entry[file_idx]++];
+        if (next_entry[file_idx] < indices[file_idx].size()) {
+            merge_heads.emplace(indices[file_idx][next_entry[file_idx]].start_time_ms, file_idx);
         }
+
+        auto& file = open_files[file_idx];
+        if (!file) {
+            file = open_pod5_file(paths[file_idx]);
+            if (!file) {
+                continue;
+            }
+        }
+
+        PendingRead read{file, file_idx, entry.start_time_ms, entry.batch_index, entry.row, {}, {}};
+        char read_id_tmp[POD5_READ_ID_LEN]{};
+        if (pod5_format_read_id(entry.read_id.data(), read_id_tmp) != POD5_OK) {
+            issue_pod5_error("Failed to format read id", paths[file_idx], entry.batch_index,
+                             entry.row);
+        }
+        read.read_id = read_id_tmp;
+
+        auto pending_it = pending_by_channel.find(entry.channel);
+        if (pending_it != pending_by_channel.end()) {
+            read.prev_read = pending_it->second.read_id;
+            release_read(pending_it->second, read.read_id);
+            pending_it->second = std::move(read);
+        } else {
+            pending_by_channel.emplace(entry.channel, std::move(read));
+        }
+
+        if (next_entry[file_idx] == indices[file_idx].size()) {
+            // Pending reads and cached batches keep the file open until they're done with it.
+            file.reset();
+            indices[file_idx] = {};
+        }
+    }
+
+    // The last read on each channel has no successor. Release them in start time order, so the
+    // tail of the output stays time ordered too.
+    std::vector<PendingRead*> last_reads;
+    last_reads.reserve(pending_by_channel.size());
+    for (auto& [channel, pending] : pending_by_channel) {
+        last_reads.push_back(&pending);
     }
+    std::sort(last_reads.begin(), last_reads.end(), [](const auto* lhs, const auto* rhs) {
+        return std::tie(lhs->start_time_ms, lhs->file_idx, lhs->batch_index, lhs->row) <
+               std::tie(rhs->start_time_ms, rhs->file_idx, rhs->batch_index, rhs->row);
+    });
+    for (auto* pending : last_reads) {
+        if (m_loaded_read_count + chunk.size() >= m_max_reads ||
+            m_stop_loading.load(std::memory_order_relaxed)) {
+            break;
+        }
+        release_read(*pending, {});
+    }
+    flush_chunk();
 }
 
 void DataLoader::load_reads(const InputFiles& input_files, ReadOrder traversal_order) {
@@ -346,6 +900,9 @@ void DataLoader::load_reads(const InputFiles& input_files, ReadOrder traversal_o
     case ReadOrder::UNRESTRICTED:
         load_reads_unrestricted(input_files.get());
         break;
+    case ReadOrder::BY_TIME:
+        load_reads_by_time(input_files.get());
+        break;
     default:
         throw std::runtime_error("Unsupported traversal order detected: " +
                                  dorado::to_string(traversal_order));
@@ -355,10 +912,7 @@ void DataLoader::load_reads(const InputFiles& input_files, ReadOrder traversal_o
 void DataLoader::load_read_channels(const std::vector<std::filesystem::directory_entry>& files) {
     for (const auto& entry : files) {
         auto file_path = std::filesystem::path(entry);
-        std::string ext = file_path.extension().string();
-        std::transform(ext.begin(), ext.end(), ext.begin(),
-                       [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
-        if (ext != ".pod5") {
+        if (!utils::has_pod5_extension(file_path)) {
             continue;
         }
 
@@ -514,81 +1068,31 @@ void DataLoader::load_pod5_reads_from_file_by_read_ids(const std::string& path,
     }
 }
 
-void DataLoader::load_pod5_reads_from_file(const std::string& path) {
-    // Open the file ready for walking:
-    Pod5FileReader_t* file = pod5_open_file(path.c_str());
-    if (!file) {
-        issue_pod5_error("Failed to open file", path);
-        return;
+void DataLoader::wait_and_process_futures(std::vector<std::future<SimplexReadPtr>> futures) {
+    for (auto& v : futures) {
+        push_read(v.get());
     }
-    auto file_cleanup = utils::PostCondition([&file, &path] {
-        if (pod5_close_and_free_reader(file) != POD5_OK) {
-            issue_pod5_error("Failed to close and free POD5 reader", path);
-        }
-    });
+}
 
-    std::size_t batch_count = 0;
-    if (pod5_get_read_batch_count(&batch_count, file) != POD5_OK) {
-        issue_pod5_error("Failed to query batch count", path);
+void DataLoader::push_read(SimplexReadPtr read) {
+    if (!read) {
+        // This was either a POD5 error, in which case the worker logged
+        // an error, or a filtered read.
         return;
     }
-
-    for (std::size_t batch_index = 0; batch_index < batch_count; ++batch_index) {
-        if (m_loaded_read_count == m_max_reads || m_stop_loading.load(std::memory_order_relaxed)) {
-            break;
-        }
-        Pod5ReadRecordBatch_t* batch = nullptr;
-        if (pod5_get_read_batch(&batch, file, batch_index) != POD5_OK) {
-            issue_pod5_error("Failed to get batch", path, batch_index, 0);
-            continue;
-        }
-        auto cleanup_batch = utils::PostCondition([&batch, &path, batch_index] {
-            if (pod5_free_read_batch(batch) != POD5_OK) {
-                issue_pod5_error("Failed to release batch", path, batch_index, 0);
-            }
-        });
-
-        std::size_t batch_row_count = 0;
-        if (pod5_get_read_batch_row_count(&batch_row_count, batch) != POD5_OK) {
-            issue_pod5_error("Failed to get batch row count", path, batch_index, 0);
-            continue;
-        }
-        batch_row_count = std::min(batch_row_count, m_max_reads - m_loaded_read_count);
-
-        std::vector<std::future<SimplexReadPtr>> futures;
-
-        futures.reserve(batch_row_count);
-        for (std::size_t row = 0; row < batch_row_count; ++row) {
-            futures.push_back(m_thread_pool.push([row, batch_index, batch, file, &path, this] {
-                return process_pod5_thread_fn(row, batch_index, batch, file, path,
-                                              m_reads_by_channel, m_read_id_to_index,
-                                              m_allowed_read_ids, m_ignored_read_ids);
-            }));
-        }
-
-        wait_and_process_futures(std::move(futures));
-    }
-}
-
-void DataLoader::wait_and_process_futures(std::vector<std::future<SimplexReadPtr>> futures) {
-    for (auto& v : futures) {
-        auto read = v.get();
-        if (!read) {
-            // This was either a POD5 error, in which case the worker logged
-            // an error, or a filtered read.
-            continue;
-        }
-        if (!m_pipeline.is_running()) {
-            // If the pipeline has finished early (--run-for) then stop processing
-            // reads, but don't bail since we need to wait for all futures to finish.
-            m_stop_loading.store(true, std::memory_order_relaxed);
-            continue;
-        }
-        initialise_read(read->read_common);
-        check_read(read);
-        m_pipeline.push_message(std::move(read));
-        m_loaded_read_count++;
+    if (!m_pipeline.is_running()) {
+        // If the pipeline has finished early (--run-for) then stop processing
+        // reads, but don't bail since we need to wait for all outstanding work to finish.
+        m_stop_loading.store(true, std::memory_order_relaxed);
+        return;
     }
+    initialise_read(read->read_common);
+    check_read(read);
+    const auto push_start = std::chrono::steady_clock::now();
+    m_pipeline.push_message(std::move(read));
+    m_push_time_us += elapsed_us(push_start);
+    m_loaded_read_count++;
+    m_reads_pushed++;
 }
 
 void DataLoader::initialise_read(ReadCommon& read_common) const {
@@ -616,7 +1120,7 @@ DataLoader::DataLoader(Pipeline& pipeline,
                        size_t num_worker_threads,
                        size_t max_reads,
                        std::optional<std::unordered_set<std::string>> read_list,
-                       std::unordered_set<std::string> read_ignore_list)
+                       utils::ReadIdSet read_ignore_list)
         : m_pipeline(pipeline),
           m_device(device),
           m_thread_pool(num_worker_threads, on_worker_start),
@@ -626,6 +1130,27 @@ DataLoader::DataLoader(Pipeline& pipeline,
     assert(m_thread_pool.n_threads() > 0);
 }
 
+void DataLoader::set_prefetch_limits(size_t max_batches_in_flight,
+                                     size_t max_signal_bytes_in_flight) {
+    m_max_batches_in_flight = std::max<size_t>(max_batches_in_flight, 1);
+    m_max_signal_bytes_in_flight = max_signal_bytes_in_flight;
+}
+
+void DataLoader::set_max_open_batches(size_t max_open_batches) {
+    m_max_open_batches = std::max<size_t>(max_open_batches, 1);
+}
+
+stats::NamedStats DataLoader::sample_stats() const {
+    stats::NamedStats stats;
+    stats["batch_read_ms"] = m_batch_read_time_us.load() / 1000.0;
+    stats["decode_ms"] = m_decode_time_us.load() / 1000.0;
+    stats["push_ms"] = m_push_time_us.load() / 1000.0;
+    stats["batches_in_flight"] = static_cast<double>(m_batches_in_flight.load());
+    stats["signal_bytes_in_flight"] = static_cast<double>(m_signal_bytes_in_flight.load());
+    stats["reads_pushed"] = static_cast<double>(m_reads_pushed.load());
+    return stats;
+}
+
 DataLoader::InputFiles DataLoader::InputFiles::search_pod5s(const std::filesystem::path& path,
                                                             bool recursive) {
     auto entries = collect_pod5_dataset(utils::fetch_directory_entries(path, recursive));
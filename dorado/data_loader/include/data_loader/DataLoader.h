@@ -1,10 +1,13 @@
 #pragma once
 
+#include "utils/ReadIdSet.h"
+#include "utils/stats.h"
 #include "utils/types.h"
 
 #include <cxxpool.h>
 
 #include <array>
+#include <atomic>
 #include <filesystem>
 #include <functional>
 #include <map>
@@ -33,7 +36,7 @@ public:
                size_t num_worker_threads,
                size_t max_reads,
                std::optional<std::unordered_set<std::string>> read_list,
-               std::unordered_set<std::string> read_ignore_list);
+               utils::ReadIdSet read_ignore_list);
     ~DataLoader() = default;
 
     // Holds the directory entries for the pod5 files from the input path.
@@ -58,15 +61,28 @@ public:
         m_read_initialisers.push_back(std::move(func));
     }
 
+    // Bounds how far ahead of the pipeline an unrestricted load reads: at most
+    // |max_batches_in_flight| POD5 record batches (possibly spanning several files) are decoded
+    // concurrently, and no further batches are fetched while the decoded signal waiting to be
+    // pushed exceeds |max_signal_bytes_in_flight|.
+    void set_prefetch_limits(size_t max_batches_in_flight, size_t max_signal_bytes_in_flight);
+
+    // Bounds how many POD5 record batches a BY_TIME load keeps open at once.
+    void set_max_open_batches(size_t max_open_batches);
+
+    std::string get_name() const { return "DataLoader"; }
+    stats::NamedStats sample_stats() const;
+
 private:
-    void load_pod5_reads_from_file(const std::string& path);
     void load_pod5_reads_from_file_by_read_ids(const std::string& path,
                                                const std::vector<ReadID>& read_ids);
     void load_read_channels(const std::vector<std::filesystem::directory_entry>& files);
 
     void load_reads_by_channel(const std::vector<std::filesystem::directory_entry>& files);
     void load_reads_unrestricted(const std::vector<std::filesystem::directory_entry>& files);
+    void load_reads_by_time(const std::vector<std::filesystem::directory_entry>& files);
     void wait_and_process_futures(std::vector<std::future<SimplexReadPtr>> futures);
+    void push_read(SimplexReadPtr read);
 
     void initialise_read(ReadCommon& read) const;
 
@@ -76,13 +92,25 @@ private:
     cxxpool::thread_pool m_thread_pool;
     size_t m_max_reads{0};
     std::optional<std::unordered_set<std::string>> m_allowed_read_ids;
-    std::unordered_set<std::string> m_ignored_read_ids;
+    utils::ReadIdSet m_ignored_read_ids;
 
     std::unordered_map<std::string, channel_to_read_id_t> m_file_channel_read_order_map;
     std::unordered_map<int, std::vector<ReadSortInfo>> m_reads_by_channel;
     std::unordered_map<std::string, size_t> m_read_id_to_index;
     int m_max_channel{0};
 
+    size_t m_max_batches_in_flight{4};
+    size_t m_max_signal_bytes_in_flight{size_t{1} << 30};
+    size_t m_max_open_batches{64};
+
+    // Stats, in microseconds where applicable.
+    std::atomic<uint64_t> m_batch_read_time_us{0};
+    std::atomic<uint64_t> m_decode_time_us{0};
+    std::atomic<uint64_t> m_push_time_us{0};
+    std::atomic<size_t> m_batches_in_flight{0};
+    std::atomic<size_t> m_signal_bytes_in_flight{0};
+    std::atomic<size_t> m_reads_pushed{0};
+
     std::vector<ReadInitialiserF> m_read_initialisers;
     std::atomic<bool> m_stop_loading{false};
     // Issue warnings if read is potentially problematic
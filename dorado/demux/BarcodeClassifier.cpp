@@ -1,5 +1,6 @@
 #include "demux/BarcodeClassifier.h"
 
+#include "BarcodeMaskScorer.h"
 #include "demux/barcoding_info.h"
 #include "utils/alignment_utils.h"
 #include "utils/barcode_kits.h"
@@ -12,6 +13,8 @@
 #include <spdlog/spdlog.h>
 
 #include <algorithm>
+#include <array>
+#include <span>
 #include <sstream>
 #include <stdexcept>
 #include <string>
@@ -37,16 +40,6 @@ EdlibAlignConfig init_edlib_config_for_flanks() {
     return placement_config;
 }
 
-// Create edlib configuration for aligning each barcode against
-// the detected region.
-EdlibAlignConfig init_edlib_config_for_mask() {
-    EdlibAlignConfig mask_config = edlibDefaultAlignConfig();
-    mask_config.mode = EDLIB_MODE_NW;
-    mask_config.task =
-            (spdlog::get_level() == spdlog::level::trace) ? EDLIB_TASK_PATH : EDLIB_TASK_LOC;
-    return mask_config;
-}
-
 // Extract the position of the barcode mask in the read based
 // on the local alignment result from edlib.
 int extract_mask_location(EdlibAlignResult aln, std::string_view query) {
@@ -94,19 +87,19 @@ std::tuple<EdlibAlignResult, float, int> extract_flank_fit(std::string_view stra
     return {result, score, bc_loc};
 }
 
-// Helper function to globally align a barcode to a region
-// within the read.
-int extract_barcode_penalty(std::string_view barcode,
-                            std::string_view read,
-                            const EdlibAlignConfig& config,
-                            const char* debug_prefix) {
-    auto result = edlibAlign(barcode.data(), int(barcode.length()), read.data(), int(read.length()),
-                             config);
-    auto penalty = result.editDistance;
-    utils::trace_log("{} {}\n{}", debug_prefix, penalty,
-                     utils::alignment_to_str(barcode.data(), read.data(), result));
-    edlibFreeAlignResult(result);
-    return penalty;
+// Globally align every barcode of a kit to a region within the read.
+// The penalties are written to a per-thread buffer, which is only
+// valid until the next call with the same |slot|.
+enum class PenaltySlot { TOP, BOTTOM, TOP_V2, BOTTOM_V2, COUNT };
+
+std::span<const int> score_barcodes(const demux::BarcodeMaskScorer& scorer,
+                                    std::string_view read,
+                                    PenaltySlot slot) {
+    thread_local std::array<std::vector<int>, static_cast<size_t>(PenaltySlot::COUNT)> buffers;
+    auto& penalties = buffers[static_cast<size_t>(slot)];
+    penalties.resize(scorer.num_patterns());
+    scorer.score(read, penalties);
+    return penalties;
 }
 
 bool barcode_is_permitted(const BarcodeFilterSet& allowed_barcodes,
@@ -128,6 +121,18 @@ std::string extract_right_buffer(const std::string& flank, int buffer) {
     return flank.substr(0, buffer);
 }
 
+// Helper to surround each barcode with the padding taken from its flanks.
+std::vector<std::string> pad_barcodes(const std::vector<std::string>& barcodes,
+                                      const std::string& left_buffer,
+                                      const std::string& right_buffer) {
+    std::vector<std::string> padded;
+    padded.reserve(barcodes.size());
+    for (const auto& barcode : barcodes) {
+        padded.push_back(left_buffer + barcode + right_buffer);
+    }
+    return padded;
+}
+
 // Helper to pick the top or bottom window in a barcode. The one
 // with lower penalty and higher flank score is preferred. If both
 // are not satisfied by one of the windows, then just decide based
@@ -171,6 +176,13 @@ struct BarcodeClassifier::BarcodeCandidateKit {
     std::string bottom_context_rev_left_buffer;
     std::string bottom_context_rev_right_buffer;
     std::vector<std::string> barcode_names;
+    // Padded barcodes, compiled for scoring against the mask regions:
+    // barcodes1 with the top_context buffers, barcodes1_rev with the
+    // top_context_rev buffers, and likewise for barcodes2.
+    demux::BarcodeMaskScorer top_scorer;
+    demux::BarcodeMaskScorer top_rev_scorer;
+    demux::BarcodeMaskScorer bottom_scorer;
+    demux::BarcodeMaskScorer bottom_rev_scorer;
     // This is the specific barcode kit product name
     // that is selected by the user, such as SQK-RBK114-96
     // or EXP-PBC096
@@ -311,6 +323,21 @@ std::vector<BarcodeClassifier::BarcodeCandidateKit> BarcodeClassifier::generate_
             candidate.barcode_names.push_back(bc_name);
         }
 
+        candidate.top_scorer = BarcodeMaskScorer(pad_barcodes(candidate.barcodes1,
+                                                              candidate.top_context_left_buffer,
+                                                              candidate.top_context_right_buffer));
+        candidate.top_rev_scorer = BarcodeMaskScorer(
+                pad_barcodes(candidate.barcodes1_rev, candidate.top_context_rev_left_buffer,
+                             candidate.top_context_rev_right_buffer));
+        if (!kit_info.barcodes2.empty()) {
+            candidate.bottom_scorer = BarcodeMaskScorer(
+                    pad_barcodes(candidate.barcodes2, candidate.bottom_context_left_buffer,
+                                 candidate.bottom_context_right_buffer));
+            candidate.bottom_rev_scorer = BarcodeMaskScorer(
+                    pad_barcodes(candidate.barcodes2_rev, candidate.bottom_context_rev_left_buffer,
+                                 candidate.bottom_context_rev_right_buffer));
+        }
+
         candidates_list.push_back(std::move(candidate));
     }
     spdlog::debug("> Kits to evaluate: {}", candidates_list.size());
@@ -344,8 +371,6 @@ std::vector<BarcodeScoreResult> BarcodeClassifier::calculate_barcode_score_diffe
     // Try to find the location of the barcode + flanks in the top and bottom windows.
     EdlibAlignConfig placement_config = init_edlib_config_for_flanks();
 
-    EdlibAlignConfig mask_config = init_edlib_config_for_mask();
-
     std::string_view top_context_v1 = candidate.top_context;
     const auto& top_context_v1_left_buffer = candidate.top_context_left_buffer;
     const auto& top_context_v1_right_buffer = candidate.top_context_right_buffer;
@@ -408,20 +433,18 @@ std::vector<BarcodeScoreResult> BarcodeClassifier::calculate_barcode_score_diffe
     utils::trace_log("total v1 edit dist {}, total v2 edit dis {}", total_v1_penalty,
                      total_v2_penalty);
 
+    // Score all of the barcodes against each mask region in a single pass.
+    const auto top_penalties_v1 =
+            score_barcodes(candidate.top_scorer, top_mask_v1, PenaltySlot::TOP);
+    const auto bottom_penalties_v1 =
+            score_barcodes(candidate.bottom_rev_scorer, bottom_mask_v1, PenaltySlot::BOTTOM);
+    const auto top_penalties_v2 =
+            score_barcodes(candidate.bottom_scorer, top_mask_v2, PenaltySlot::TOP_V2);
+    const auto bottom_penalties_v2 =
+            score_barcodes(candidate.top_rev_scorer, bottom_mask_v2, PenaltySlot::BOTTOM_V2);
+
     std::vector<BarcodeScoreResult> results;
     for (size_t i = 0; i < candidate.barcodes1.size(); i++) {
-        const auto barcode1 = std::string(top_context_v1_left_buffer)
-                                      .append(candidate.barcodes1[i])
-                                      .append(top_context_v1_right_buffer);
-        const auto barcode1_rev = std::string(bottom_context_v2_left_buffer)
-                                          .append(candidate.barcodes1_rev[i])
-                                          .append(bottom_context_v2_right_buffer);
-        const auto barcode2 = std::string(top_context_v2_left_buffer)
-                                      .append(candidate.barcodes2[i])
-                                      .append(top_context_v2_right_buffer);
-        const auto barcode2_rev = std::string(bottom_context_v1_left_buffer)
-                                          .append(candidate.barcodes2_rev[i])
-                                          .append(bottom_context_v1_right_buffer);
         auto& barcode_name = candidate.barcode_names[i];
 
         if (!barcode_is_permitted(allowed_barcodes, barcode_name)) {
@@ -430,12 +453,11 @@ std::vector<BarcodeScoreResult> BarcodeClassifier::calculate_barcode_score_diffe
 
         utils::trace_log("Checking barcode {}", barcode_name);
 
-        // Calculate barcode penalties for v1.
-        auto top_mask_result_penalty_v1 =
-                extract_barcode_penalty(barcode1, top_mask_v1, mask_config, "top window v1");
-
-        auto bottom_mask_result_penalty_v1 = extract_barcode_penalty(
-                barcode2_rev, bottom_mask_v1, mask_config, "bottom window v1");
+        // Barcode penalties for v1.
+        auto top_mask_result_penalty_v1 = top_penalties_v1[i];
+        auto bottom_mask_result_penalty_v1 = bottom_penalties_v1[i];
+        utils::trace_log("top window v1 {}, bottom window v1 {}", top_mask_result_penalty_v1,
+                         bottom_mask_result_penalty_v1);
 
         BarcodeScoreResult v1;
         v1.top_penalty = top_mask_result_penalty_v1;
@@ -444,20 +466,20 @@ std::vector<BarcodeScoreResult> BarcodeClassifier::calculate_barcode_score_diffe
         v1.bottom_flank_score = bottom_flank_score_v1;
         std::tie(v1.use_top, v1.penalty, v1.flank_score) = pick_top_or_bottom(
                 v1.top_penalty, v1.top_flank_score, v1.bottom_penalty, v1.bottom_flank_score);
-        v1.top_barcode_score = (1.f - static_cast<float>(v1.top_penalty) / barcode1.length());
-        v1.bottom_barcode_score =
-                (1.f - static_cast<float>(v1.bottom_penalty) / barcode2_rev.length());
+        v1.top_barcode_score =
+                (1.f - static_cast<float>(v1.top_penalty) / candidate.top_scorer.pattern_length());
+        v1.bottom_barcode_score = (1.f - static_cast<float>(v1.bottom_penalty) /
+                                                 candidate.bottom_rev_scorer.pattern_length());
         v1.barcode_score = v1.use_top ? v1.top_barcode_score : v1.bottom_barcode_score;
         v1.top_barcode_pos = {top_result_v1.startLocations[0], top_result_v1.endLocations[0]};
         v1.bottom_barcode_pos = {bottom_start + bottom_result_v1.startLocations[0],
                                  bottom_start + bottom_result_v1.endLocations[0]};
 
-        // Calculate barcode penalties for v2.
-        auto top_mask_result_penalty_v2 =
-                extract_barcode_penalty(barcode2, top_mask_v2, mask_config, "top window v2");
-
-        auto bottom_mask_result_penalty_v2 = extract_barcode_penalty(
-                barcode1_rev, bottom_mask_v2, mask_config, "bottom window v2");
+        // Barcode penalties for v2.
+        auto top_mask_result_penalty_v2 = top_penalties_v2[i];
+        auto bottom_mask_result_penalty_v2 = bottom_penalties_v2[i];
+        utils::trace_log("top window v2 {}, bottom window v2 {}", top_mask_result_penalty_v2,
+                         bottom_mask_result_penalty_v2);
 
         BarcodeScoreResult v2;
         v2.top_penalty = top_mask_result_penalty_v2;
@@ -466,9 +488,10 @@ std::vector<BarcodeScoreResult> BarcodeClassifier::calculate_barcode_score_diffe
         v2.bottom_flank_score = bottom_flank_score_v2;
         std::tie(v2.use_top, v2.penalty, v2.flank_score) = pick_top_or_bottom(
                 v2.top_penalty, v2.top_flank_score, v2.bottom_penalty, v2.bottom_flank_score);
-        v2.top_barcode_score = (1.f - static_cast<float>(v2.top_penalty) / barcode2.length());
-        v2.bottom_barcode_score =
-                (1.f - static_cast<float>(v2.bottom_penalty) / barcode1_rev.length());
+        v2.top_barcode_score = (1.f - static_cast<float>(v2.top_penalty) /
+                                              candidate.bottom_scorer.pattern_length());
+        v2.bottom_barcode_score = (1.f - static_cast<float>(v2.bottom_penalty) /
+                                                 candidate.top_rev_scorer.pattern_length());
         v2.barcode_score = v2.use_top ? v2.top_barcode_score : v2.bottom_barcode_score;
         v2.top_barcode_pos = {top_result_v2.startLocations[0], top_result_v2.endLocations[0]};
         v2.bottom_barcode_pos = {bottom_start + bottom_result_v2.startLocations[0],
@@ -583,8 +606,6 @@ std::vector<BarcodeScoreResult> BarcodeClassifier::calculate_barcode_score_doubl
     // Try to find the location of the barcode + flanks in the top and bottom windows.
     EdlibAlignConfig placement_config = init_edlib_config_for_flanks();
 
-    EdlibAlignConfig mask_config = init_edlib_config_for_mask();
-
     std::string_view top_context = candidate.top_context;
     const auto& top_left_buffer = candidate.top_context_left_buffer;
     const auto& top_right_buffer = candidate.top_context_right_buffer;
@@ -610,14 +631,13 @@ std::vector<BarcodeScoreResult> BarcodeClassifier::calculate_barcode_score_doubl
     std::string_view bottom_mask =
             read_bottom.substr(bottom_start_idx, bottom_end_idx - bottom_start_idx);
 
+    // Score all of the barcodes against each mask region in a single pass.
+    const auto top_penalties = score_barcodes(candidate.top_scorer, top_mask, PenaltySlot::TOP);
+    const auto bottom_penalties =
+            score_barcodes(candidate.top_rev_scorer, bottom_mask, PenaltySlot::BOTTOM);
+
     std::vector<BarcodeScoreResult> results;
     for (size_t i = 0; i < candidate.barcodes1.size(); i++) {
-        auto barcode = std::string(top_left_buffer)
-                               .append(candidate.barcodes1[i])
-                               .append(top_right_buffer);
-        auto barcode_rev = std::string(bottom_left_buffer)
-                                   .append(candidate.barcodes1_rev[i])
-                                   .append(bottom_right_buffer);
         auto& barcode_name = candidate.barcode_names[i];
 
         if (!barcode_is_permitted(allowed_barcodes, barcode_name)) {
@@ -625,11 +645,9 @@ std::vector<BarcodeScoreResult> BarcodeClassifier::calculate_barcode_score_doubl
         }
         utils::trace_log("Checking barcode {}", barcode_name);
 
-        auto top_mask_penalty =
-                extract_barcode_penalty(barcode, top_mask, mask_config, "top window");
-
-        auto bottom_mask_penalty =
-                extract_barcode_penalty(barcode_rev, bottom_mask, mask_config, "bottom window");
+        auto top_mask_penalty = top_penalties[i];
+        auto bottom_mask_penalty = bottom_penalties[i];
+        utils::trace_log("top window {}, bottom window {}", top_mask_penalty, bottom_mask_penalty);
 
         BarcodeScoreResult res;
         res.barcode_name = barcode_name;
@@ -641,9 +659,10 @@ std::vector<BarcodeScoreResult> BarcodeClassifier::calculate_barcode_score_doubl
         res.bottom_flank_score = bottom_flank_score;
         std::tie(res.use_top, res.penalty, res.flank_score) = pick_top_or_bottom(
                 res.top_penalty, res.top_flank_score, res.bottom_penalty, res.bottom_flank_score);
-        res.top_barcode_score = (1.f - static_cast<float>(res.top_penalty) / barcode.length());
-        res.bottom_barcode_score =
-                (1.f - static_cast<float>(res.bottom_penalty) / barcode_rev.length());
+        res.top_barcode_score = (1.f - static_cast<float>(res.top_penalty) /
+                                               candidate.top_scorer.pattern_length());
+        res.bottom_barcode_score = (1.f - static_cast<float>(res.bottom_penalty) /
+                                                  candidate.top_rev_scorer.pattern_length());
         res.barcode_score = res.use_top ? res.top_barcode_score : res.bottom_barcode_score;
         res.top_barcode_pos = {top_result.startLocations[0], top_result.endLocations[0]};
         res.bottom_barcode_pos = {bottom_start + bottom_result.startLocations[0],
@@ -719,8 +738,6 @@ std::vector<BarcodeScoreResult> BarcodeClassifier::calculate_barcode_score(
     // Try to find the location of the barcode + flanks in the top and bottom windows.
     EdlibAlignConfig placement_config = init_edlib_config_for_flanks();
 
-    EdlibAlignConfig mask_config = init_edlib_config_for_mask();
-
     std::string_view top_context = candidate.top_context;
     int barcode_len = int(candidate.barcodes1[0].length());
     const auto& top_left_buffer = candidate.top_context_left_buffer;
@@ -735,10 +752,12 @@ std::vector<BarcodeScoreResult> BarcodeClassifier::calculate_barcode_score(
 
     utils::trace_log("BC location {}", top_bc_loc);
 
+    // Score all of the barcodes against the mask region in a single pass.
+    const auto top_penalties = score_barcodes(candidate.top_scorer, top_mask, PenaltySlot::TOP);
+    const auto barcode_length = candidate.top_scorer.pattern_length();
+
     std::vector<BarcodeScoreResult> results;
     for (size_t i = 0; i < candidate.barcodes1.size(); i++) {
-        const auto barcode = candidate.top_context_left_buffer + candidate.barcodes1[i] +
-                             candidate.top_context_right_buffer;
         auto& barcode_name = candidate.barcode_names[i];
 
         if (!barcode_is_permitted(allowed_barcodes, barcode_name)) {
@@ -746,8 +765,8 @@ std::vector<BarcodeScoreResult> BarcodeClassifier::calculate_barcode_score(
         }
         utils::trace_log("Checking barcode {}", barcode_name);
 
-        auto top_mask_penalty =
-                extract_barcode_penalty(barcode, top_mask, mask_config, "top window");
+        auto top_mask_penalty = top_penalties[i];
+        utils::trace_log("top window {}", top_mask_penalty);
 
         BarcodeScoreResult res;
         res.barcode_name = barcode_name;
@@ -760,7 +779,7 @@ std::vector<BarcodeScoreResult> BarcodeClassifier::calculate_barcode_score(
             res.penalty = res.bottom_penalty;
             res.use_top = false;
             res.bottom_barcode_score =
-                    1.f - static_cast<float>(res.bottom_penalty) / barcode.length();
+                    1.f - static_cast<float>(res.bottom_penalty) / barcode_length;
             res.barcode_score = res.bottom_barcode_score;
             int rear_start =
                     std::max(0, (int)read_seq.length() - m_scoring_params.rear_barcode_window);
@@ -772,7 +791,7 @@ std::vector<BarcodeScoreResult> BarcodeClassifier::calculate_barcode_score(
             res.top_penalty = top_mask_penalty;
             res.penalty = res.top_penalty;
             res.use_top = true;
-            res.top_barcode_score = 1.f - static_cast<float>(res.top_penalty) / barcode.length();
+            res.top_barcode_score = 1.f - static_cast<float>(res.top_penalty) / barcode_length;
             res.barcode_score = res.top_barcode_score;
             res.top_barcode_pos = {top_result.startLocations[0], top_result.endLocations[0]};
         }
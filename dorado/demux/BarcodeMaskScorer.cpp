@@ -0,0 +1,177 @@
+#include "BarcodeMaskScorer.h"
+
+#include "utils/simd.h"
+
+#include <edlib.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+constexpr std::size_t MAX_LANE_PATTERN_LENGTH = 64;
+constexpr std::size_t LANES = dorado::demux::BarcodeMaskScorer::LANES;
+
+// Runs Myers' algorithm for |window| against one group of LANES patterns, writing the final
+// scores to |scores|.  Global alignment is obtained by shifting a +1 horizontal delta into the
+// top row of every column, as edlib does for NW mode.
+#if ENABLE_AVX2_IMPL
+[[maybe_unused]] __attribute__((target("default")))
+#endif
+void score_lane_group(const uint64_t* peq,
+                      std::size_t row_stride,
+                      const uint8_t* codes,
+                      std::string_view window,
+                      std::size_t pattern_length,
+                      std::array<int, LANES>& scores) {
+    const uint64_t high_bit = uint64_t{1} << (pattern_length - 1);
+    std::array<uint64_t, LANES> pv, mv;
+    std::array<int, LANES> score;
+    pv.fill(~uint64_t{0});
+    mv.fill(0);
+    score.fill(static_cast<int>(pattern_length));
+
+    for (const char base : window) {
+        const uint64_t* eq = peq + codes[static_cast<uint8_t>(base)] * row_stride;
+        for (std::size_t lane = 0; lane < LANES; ++lane) {
+            const uint64_t xv = eq[lane] | mv[lane];
+            const uint64_t xh = (((eq[lane] & pv[lane]) + pv[lane]) ^ pv[lane]) | eq[lane];
+            uint64_t ph = mv[lane] | ~(xh | pv[lane]);
+            uint64_t mh = pv[lane] & xh;
+            score[lane] += int((ph & high_bit) != 0) - int((mh & high_bit) != 0);
+            ph = (ph << 1) | 1;
+            mh <<= 1;
+            pv[lane] = mh | ~(xv | ph);
+            mv[lane] = ph & xv;
+        }
+    }
+    scores = score;
+}
+
+#if ENABLE_AVX2_IMPL
+[[maybe_unused]] __attribute__((target("avx2"))) void score_lane_group(
+        const uint64_t* peq,
+        std::size_t row_stride,
+        const uint8_t* codes,
+        std::string_view window,
+        std::size_t pattern_length,
+        std::array<int, LANES>& scores) {
+    static_assert(LANES == 4, "AVX2 path holds four 64-bit lanes");
+    const __m256i all_ones = _mm256_set1_epi64x(-1);
+    const __m256i one = _mm256_set1_epi64x(1);
+    const __m256i high_bit = _mm256_set1_epi64x(int64_t(uint64_t{1} << (pattern_length - 1)));
+    __m256i pv = all_ones;
+    __m256i mv = _mm256_setzero_si256();
+    __m256i score = _mm256_set1_epi64x(int64_t(pattern_length));
+
+    for (const char base : window) {
+        const __m256i eq = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(
+                peq + codes[static_cast<uint8_t>(base)] * row_stride));
+        const __m256i xv = _mm256_or_si256(eq, mv);
+        const __m256i xh = _mm256_or_si256(
+                _mm256_xor_si256(_mm256_add_epi64(_mm256_and_si256(eq, pv), pv), pv), eq);
+        __m256i ph = _mm256_or_si256(mv, _mm256_xor_si256(_mm256_or_si256(xh, pv), all_ones));
+        __m256i mh = _mm256_and_si256(pv, xh);
+        // The comparisons give -1 in each lane whose top bit is set.
+        score = _mm256_sub_epi64(
+                score, _mm256_cmpeq_epi64(_mm256_and_si256(ph, high_bit), high_bit));
+        score = _mm256_add_epi64(
+                score, _mm256_cmpeq_epi64(_mm256_and_si256(mh, high_bit), high_bit));
+        ph = _mm256_or_si256(_mm256_slli_epi64(ph, 1), one);
+        mh = _mm256_slli_epi64(mh, 1);
+        pv = _mm256_or_si256(mh, _mm256_xor_si256(_mm256_or_si256(xv, ph), all_ones));
+        mv = _mm256_and_si256(ph, xv);
+    }
+
+    alignas(32) int64_t lane_scores[LANES];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lane_scores), score);
+    for (std::size_t lane = 0; lane < LANES; ++lane) {
+        scores[lane] = static_cast<int>(lane_scores[lane]);
+    }
+}
+#endif  // ENABLE_AVX2_IMPL
+
+}  // namespace
+
+namespace dorado::demux {
+
+BarcodeMaskScorer::BarcodeMaskScorer(const std::vector<std::string>& patterns)
+        : m_num_patterns(patterns.size()),
+          m_pattern_length(patterns.empty() ? 0 : patterns.front().length()) {
+    for (const auto& pattern : patterns) {
+        if (pattern.length() != m_pattern_length) {
+            throw std::runtime_error("BarcodeMaskScorer: all patterns must be the same length");
+        }
+    }
+    if (m_pattern_length > MAX_LANE_PATTERN_LENGTH) {
+        m_long_patterns = patterns;
+        return;
+    }
+
+    // Give each distinct pattern character its own row, and leave the final row empty.
+    std::array<bool, 256> seen{};
+    for (const auto& pattern : patterns) {
+        for (const char base : pattern) {
+            seen[static_cast<uint8_t>(base)] = true;
+        }
+    }
+    const auto num_rows = static_cast<std::size_t>(std::count(seen.begin(), seen.end(), true)) + 1;
+    uint8_t next_code = 0;
+    for (std::size_t c = 0; c < seen.size(); ++c) {
+        if (seen[c]) {
+            m_codes[c] = next_code++;
+        }
+    }
+    for (std::size_t c = 0; c < seen.size(); ++c) {
+        if (!seen[c]) {
+            m_codes[c] = next_code;
+        }
+    }
+
+    m_num_lane_groups = (m_num_patterns + LANES - 1) / LANES;
+    const std::size_t row_stride = m_num_lane_groups * LANES;
+    m_peq.assign(num_rows * row_stride, 0);
+    for (std::size_t p = 0; p < m_num_patterns; ++p) {
+        for (std::size_t j = 0; j < m_pattern_length; ++j) {
+            const auto code = m_codes[static_cast<uint8_t>(patterns[p][j])];
+            m_peq[code * row_stride + p] |= uint64_t{1} << j;
+        }
+    }
+}
+
+void BarcodeMaskScorer::score(std::string_view window, std::span<int> penalties) const {
+    if (penalties.size() < m_num_patterns) {
+        throw std::runtime_error("BarcodeMaskScorer: penalties span is too small");
+    }
+
+    if (!m_long_patterns.empty()) {
+        EdlibAlignConfig config = edlibDefaultAlignConfig();
+        config.mode = EDLIB_MODE_NW;
+        config.task = EDLIB_TASK_DISTANCE;
+        for (std::size_t p = 0; p < m_num_patterns; ++p) {
+            const auto& pattern = m_long_patterns[p];
+            auto result = edlibAlign(pattern.data(), int(pattern.length()), window.data(),
+                                     int(window.length()), config);
+            penalties[p] = result.editDistance;
+            edlibFreeAlignResult(result);
+        }
+        return;
+    }
+
+    if (m_pattern_length == 0) {
+        std::fill_n(penalties.begin(), m_num_patterns, static_cast<int>(window.length()));
+        return;
+    }
+
+    const std::size_t row_stride = m_num_lane_groups * LANES;
+    std::array<int, LANES> scores;
+    for (std::size_t group = 0; group < m_num_lane_groups; ++group) {
+        score_lane_group(m_peq.data() + group * LANES, row_stride, m_codes.data(), window,
+                         m_pattern_length, scores);
+        const std::size_t first = group * LANES;
+        const std::size_t count = std::min(LANES, m_num_patterns - first);
+        std::copy_n(scores.begin(), count, penalties.begin() + first);
+    }
+}
+
+}  // namespace dorado::demux
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace dorado::demux {
+
+// Computes the global (NW) edit distance between each of a fixed set of equal length patterns
+// and a window of a read, matching what edlib reports for EDLIB_MODE_NW.  The patterns are
+// compiled once into Myers' bit-vectors, one 64-bit lane per pattern, and scored together:
+// with AVX2 four patterns share each register, so a whole kit is scored in a single pass over
+// the window with no allocations.  Patterns longer than a lane fall back to edlib.
+class BarcodeMaskScorer {
+public:
+    BarcodeMaskScorer() = default;
+    explicit BarcodeMaskScorer(const std::vector<std::string>& patterns);
+
+    std::size_t num_patterns() const { return m_num_patterns; }
+    std::size_t pattern_length() const { return m_pattern_length; }
+
+    // Writes the edit distance of pattern i against |window| to penalties[i].
+    // |penalties| must hold num_patterns() entries.
+    void score(std::string_view window, std::span<int> penalties) const;
+
+    // Patterns in each register.
+    static constexpr std::size_t LANES = 4;
+
+private:
+    std::size_t m_num_patterns{0};
+    std::size_t m_pattern_length{0};
+    std::size_t m_num_lane_groups{0};
+    // Maps each character to a row of m_peq.  Characters that appear in no pattern map to the
+    // last row, which is all zeros.
+    std::array<uint8_t, 256> m_codes{};
+    // For each row, LANES * m_num_lane_groups masks with bit j set if pattern[j] is that row's
+    // character.
+    std::vector<uint64_t> m_peq;
+    // Only kept if the patterns are too long for the bit-parallel path.
+    std::vector<std::string> m_long_patterns;
+};
+
+}  // namespace dorado::demux
@@ -1,18 +1,22 @@
 #include "hts_utils/hts_file.h"
 
 #include "hts_utils/bam_utils.h"
+#include "utils/LoserTree.h"
 #include "utils/PostCondition.h"
 
-#include <htslib/bgzf.h>
 #include <htslib/hts.h>
 #include <htslib/sam.h>
+#include <htslib/thread_pool.h>
 #include <spdlog/spdlog.h>
 
+#include <algorithm>
 #include <array>
 #include <cassert>
 #include <filesystem>
-#include <map>
+#include <future>
+#include <mutex>
 #include <stdexcept>
+#include <unordered_set>
 
 namespace {
 
@@ -20,11 +24,47 @@ constexpr size_t MINIMUM_BUFFER_SIZE{100000};  // The smallest allowed buffer si
 constexpr size_t DEFAULT_BUFFER_SIZE{
         20000000};  // Arbitrary 20 MB. Can be overridden by application code.
 constexpr size_t MAX_FILES_FOR_MERGE{512};  // Maximum number of files to merge at once.
+constexpr size_t MERGE_PROGRESS_INTERVAL{10000};  // Records merged between progress updates.
 
 bool compare_headers(const dorado::SamHdrPtr& header1, const dorado::SamHdrPtr& header2) {
     return (strcmp(sam_hdr_str(header1.get()), sam_hdr_str(header2.get())) == 0);
 }
 
+// Stable LSD radix sort of buffered records by their sorting key, one byte per pass.  Passes over
+// bytes which are the same for every record, such as the high bytes of the tid and position, are
+// skipped, so typically only 3 or 4 of the 8 passes do any work.
+template <class Entry>
+void radix_sort_by_key(std::vector<Entry>& entries, std::vector<Entry>& scratch) {
+    if (entries.size() < 2) {
+        return;
+    }
+    constexpr int NUM_PASSES = sizeof(uint64_t);
+    auto digit = [](uint64_t key, int pass) { return size_t((key >> (8 * pass)) & 0xff); };
+
+    std::array<std::array<size_t, 256>, NUM_PASSES> counts{};
+    for (const auto& entry : entries) {
+        for (int pass = 0; pass < NUM_PASSES; ++pass) {
+            ++counts[pass][digit(entry.sorting_key, pass)];
+        }
+    }
+
+    scratch.resize(entries.size());
+    for (int pass = 0; pass < NUM_PASSES; ++pass) {
+        auto& pass_counts = counts[pass];
+        if (pass_counts[digit(entries.front().sorting_key, pass)] == entries.size()) {
+            continue;
+        }
+        size_t offset = 0;
+        for (auto& count : pass_counts) {
+            offset += std::exchange(count, offset);
+        }
+        for (const auto& entry : entries) {
+            scratch[pass_counts[digit(entry.sorting_key, pass)]++] = entry;
+        }
+        entries.swap(scratch);
+    }
+}
+
 // BAM tags to add to the read header for fastx output
 constexpr std::array fastq_aux_tags{"RG", "st", "DS", "qs", "ch", "PU", "DT", "mv", "SM", "al"};
 
@@ -177,11 +217,12 @@ void HtsFile::flush_temp_file(const bam1_t* last_record) {
         return;
     }
     if (last_record) {
-        // We add last_record to our buffer map with offset -1, so that we know where it should be sorted into
-        // the output.
-        auto sorting_key = calculate_sorting_key(last_record);
-        m_buffer_map.insert({sorting_key, -1});
+        // We add last_record to our buffer entries with offset -1, so that we know where it
+        // should be sorted into the output.
+        m_buffer_entries.push_back({calculate_sorting_key(last_record), -1});
     }
+    // The sort is stable, so records with equal keys keep the order in which they were written.
+    radix_sort_by_key(m_buffer_entries, m_sort_scratch);
 
     // Open the file for writing, and write the header. Note that all temp files will have the same header.
     auto file_index = m_temp_files.size();
@@ -203,9 +244,9 @@ void HtsFile::flush_temp_file(const bam1_t* last_record) {
         }
     }
 
-    for (const auto& item : m_buffer_map) {
+    for (const auto& entry : m_buffer_entries) {
         // This will give us the offsets into the buffer in sorted order.
-        int64_t offset = item.second;
+        int64_t offset = entry.offset;
         const bam1_t* record{nullptr};
         if (offset == -1) {
             record = last_record;
@@ -226,7 +267,7 @@ void HtsFile::flush_temp_file(const bam1_t* last_record) {
     }
     m_file.reset();
     m_current_buffer_offset = 0;
-    m_buffer_map.clear();
+    m_buffer_entries.clear();
 }
 
 // If we are doing sorted BAM/CRAM output, then when we are done we will have sorted temporary files
@@ -343,8 +384,7 @@ void HtsFile::cache_record(const bam1_t* record) {
         flush_temp_file(record);
         return;
     }
-    auto sorting_key = calculate_sorting_key(record);
-    m_buffer_map.insert({sorting_key, m_current_buffer_offset});
+    m_buffer_entries.push_back({calculate_sorting_key(record), m_current_buffer_offset});
 
     // Copy the contents of the bam1_t struct into the memory buffer.
     auto record_buff = m_bam_buffer.data() + m_current_buffer_offset;
@@ -375,29 +415,96 @@ bool HtsFile::merge_temp_files_iteratively(const ProgressCallback& progress_call
     progress_callback(percent_start_merging);
     ProgressUpdater update_progress(progress_callback, percent_start_merging, 100,
                                     m_num_records * progress_multiplier);
-    for (size_t iter = 0; iter < num_batches; ++iter) {
-        if (!merge_temp_files(update_progress, batcher.get_batch(iter),
-                              batcher.get_merge_filename(iter))) {
+    std::mutex progress_mutex;
+    size_t processed_records = 0;
+    auto add_progress = [&](size_t num_records) {
+        std::lock_guard lock(progress_mutex);
+        processed_records += num_records;
+        update_progress(processed_records);
+    };
+
+    size_t iter = 0;
+    while (iter < num_batches) {
+        // Batches which don't consume each other's output are merged concurrently, as long as
+        // that doesn't take the number of files open at once beyond MAX_FILES_FOR_MERGE.
+        std::unordered_set<std::string> outputs_in_flight;
+        size_t files_in_flight = 0;
+        size_t end = iter;
+        for (; end < num_batches; ++end) {
+            const auto& batch = batcher.get_batch(end);
+            const bool needs_output_in_flight =
+                    std::any_of(batch.begin(), batch.end(), [&](const std::string& file) {
+                        return outputs_in_flight.count(file) != 0;
+                    });
+            if (end > iter &&
+                (needs_output_in_flight || files_in_flight + batch.size() > MAX_FILES_FOR_MERGE)) {
+                break;
+            }
+            outputs_in_flight.insert(batcher.get_merge_filename(end));
+            files_in_flight += batch.size();
+        }
+
+        const int num_concurrent = int(end - iter);
+        const int threads_per_merge = m_threads > 0 ? std::max(1, m_threads / num_concurrent) : 0;
+        std::vector<std::future<bool>> merges;
+        for (size_t i = iter; i < end; ++i) {
+            merges.push_back(std::async(std::launch::async, [&, i] {
+                return merge_temp_files(add_progress, batcher.get_batch(i),
+                                        batcher.get_merge_filename(i), threads_per_merge);
+            }));
+        }
+        bool merges_succeeded = true;
+        for (auto& merge : merges) {
+            merges_succeeded &= merge.get();
+        }
+        if (!merges_succeeded) {
             return false;
         }
+        iter = end;
     }
     return true;
 }
 
-bool HtsFile::merge_temp_files(ProgressUpdater& update_progress,
+bool HtsFile::merge_temp_files(const std::function<void(size_t)>& add_progress,
                                const std::vector<std::string>& temp_files,
-                               const std::string& merged_filename) const {
+                               const std::string& merged_filename,
+                               int num_threads) const {
     // This code assumes the headers for the files are all the same. This will be
     // true if the temp-files were created by this class, but it means that this
     // function is not suitable for generic merging of BAM files.
+    // A single pool decompresses every input and compresses the output, rather than each file
+    // having a pool of its own.  Created first so that it outlives the files using it.
+    htsThreadPool thread_pool{nullptr, 0};
+    auto destroy_pool = utils::PostCondition([&thread_pool] {
+        if (thread_pool.pool) {
+            hts_tpool_destroy(thread_pool.pool);
+        }
+    });
+    if (num_threads > 0) {
+        thread_pool.pool = hts_tpool_init(num_threads);
+        if (!thread_pool.pool) {
+            spdlog::error("Could not create thread pool for merging.");
+            return false;
+        }
+    }
+
     const size_t num_temp_files = temp_files.size();
     std::vector<HtsFilePtr> in_files(num_temp_files);
     std::vector<BamPtr> top_records(num_temp_files);
-    std::vector<uint64_t> top_record_scores(num_temp_files);
+    utils::LoserTree<uint64_t> merge_tree(num_temp_files);
     SamHdrPtr header{};
+
+    auto use_thread_pool = [&thread_pool](const HtsFilePtr& file) {
+        return !thread_pool.pool || hts_set_thread_pool(file.get(), &thread_pool) == 0;
+    };
+
     for (size_t i = 0; i < num_temp_files; ++i) {
         in_files[i].reset(hts_open(temp_files[i].c_str(), "r"));
-        if (bgzf_mt(in_files[i]->fp.bgzf, m_threads, 128) < 0) {
+        if (!in_files[i]) {
+            spdlog::error("Could not open temporary file {}", temp_files[i]);
+            return false;
+        }
+        if (!use_thread_pool(in_files[i])) {
             spdlog::error("Could not enable multi threading for BAM reading.");
             return false;
         }
@@ -420,12 +527,17 @@ bool HtsFile::merge_temp_files(ProgressUpdater& update_progress,
                           res);
             return false;
         }
-        top_record_scores[i] = calculate_sorting_key(top_records[i].get());
+        merge_tree.set(i, calculate_sorting_key(top_records[i].get()));
     }
+    merge_tree.build();
 
     // Open the output file, and write the header.
     HtsFilePtr out_file(hts_open(merged_filename.c_str(), m_htslib_write_mode.c_str()));
-    if (bgzf_mt(out_file->fp.bgzf, m_threads, 128) < 0) {
+    if (!out_file) {
+        spdlog::error("Could not open file {} for merging.", merged_filename);
+        return false;
+    }
+    if (!use_thread_pool(out_file)) {
         spdlog::error("Could not enable multi threading for BAM generation.");
         return false;
     }
@@ -452,25 +564,10 @@ bool HtsFile::merge_temp_files(ProgressUpdater& update_progress,
         }
     }
 
-    size_t processed_records = 0;
-    size_t files_done = 0;
-    while (files_done < num_temp_files) {
-        // Find the next file to write a record from.
-        uint64_t best_score = std::numeric_limits<uint64_t>::max();
-        int best_index = -1;
-        for (size_t i = 0; i < num_temp_files; ++i) {
-            if (top_records[i]) {
-                auto score = top_record_scores[i];
-                if (best_index == -1 || score < best_score) {
-                    best_score = score;
-                    best_index = int(i);
-                }
-            }
-        }
-        if (best_index == -1) {
-            spdlog::error("Logic error in merging algorithm.");
-            return false;
-        }
+    size_t unreported_records = 0;
+    while (!merge_tree.empty()) {
+        // The tree gives us the file with the next record to write.
+        const auto best_index = merge_tree.top();
 
         // Write the record.
         auto res = sam_write1(out_file.get(), out_header.get(), top_records[best_index].get());
@@ -478,25 +575,26 @@ bool HtsFile::merge_temp_files(ProgressUpdater& update_progress,
             spdlog::error("Failed to write to sorted file {}, error code {}", out_file->fn, res);
             return false;
         }
-        ++processed_records;
-        update_progress(processed_records);
+        if (++unreported_records == MERGE_PROGRESS_INTERVAL) {
+            add_progress(std::exchange(unreported_records, 0));
+        }
 
-        // Load the next record for the file.
-        top_records[best_index].reset(bam_init1());
+        // Load the next record for the file, reusing the record we've just written.
         res = sam_read1(in_files[best_index].get(), header.get(), top_records[best_index].get());
         if (res >= 0) {
-            top_record_scores[best_index] = calculate_sorting_key(top_records[best_index].get());
+            merge_tree.replace_top(calculate_sorting_key(top_records[best_index].get()));
         } else if (res == -1) {
             // EOF reached. Close the file and mark that this file is done.
             top_records[best_index].reset();
             in_files[best_index].reset();
-            ++files_done;
+            merge_tree.pop_top();
         } else if (res < -1) {
             spdlog::error("Error reading record from file {}, error code {}",
                           in_files[best_index]->fn, res);
             return false;
         }
     }
+    add_progress(unreported_records);
 
     if (final_iteration) {
         // Write the index file.
@@ -508,6 +606,7 @@ bool HtsFile::merge_temp_files(ProgressUpdater& update_progress,
     }
 
     out_file.reset();
+    in_files.clear();
 
     // If we got this far, merging was successful, so remove the temporary files.
     // If we returned early due to a merging failure, the temporary files will remain.
@@ -2,10 +2,11 @@
 
 #include "hts_types.h"
 
+#include <cstdint>
 #include <filesystem>
 #include <functional>
-#include <map>
 #include <string>
+#include <vector>
 
 namespace dorado {
 namespace utils {
@@ -55,8 +56,15 @@ private:
     const std::string m_htslib_write_mode;
     std::string m_reference;
 
+    // Where each buffered record lives in m_bam_buffer, in the order the records arrived.
+    struct BufferEntry {
+        uint64_t sorting_key;
+        int64_t offset;
+    };
+
     std::vector<std::byte> m_bam_buffer;
-    std::multimap<uint64_t, int64_t> m_buffer_map;
+    std::vector<BufferEntry> m_buffer_entries;
+    std::vector<BufferEntry> m_sort_scratch;
     std::vector<std::string> m_temp_files;
     int64_t m_current_buffer_offset{0};
 
@@ -67,9 +75,10 @@ private:
     int write_to_file(const bam1_t* record);
     void cache_record(const bam1_t* record);
     bool merge_temp_files_iteratively(const ProgressCallback& progress_callback) const;
-    bool merge_temp_files(ProgressUpdater& update_progress,
+    bool merge_temp_files(const std::function<void(size_t)>& add_progress,
                           const std::vector<std::string>& temp_files,
-                          const std::string& merged_filename) const;
+                          const std::string& merged_filename,
+                          int num_threads) const;
     void initialise_threads();
 };
 
@@ -1,51 +1,159 @@
 #include "modbase/MotifMatcher.h"
 
 #include "config/ModBaseModelConfig.h"
+#include "utils/simd.h"
 
 #include <nvtx3/nvtx3.hpp>
 
-#include <iterator>
-#if defined(__GNUC__) && !defined(__clang__) && !defined(__INTEL_COMPILER)
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
-#endif
-#include <regex>
-#if defined(__GNUC__) && !defined(__clang__) && !defined(__INTEL_COMPILER)
-#pragma GCC diagnostic pop
-#endif
+#include <bit>
+#include <stdexcept>
 #include <unordered_map>
 
 namespace {
-const std::unordered_map<char, std::string> IUPAC_CODES =
+
+constexpr uint8_t BASE_A = 1 << 0;
+constexpr uint8_t BASE_C = 1 << 1;
+constexpr uint8_t BASE_G = 1 << 2;
+constexpr uint8_t BASE_T = 1 << 3;
+
+const std::unordered_map<char, uint8_t> IUPAC_CODES =
         {
                 // clang-format off
-        {'A', "A"},
-        {'C', "C"},
-        {'G', "G"},
-        {'T', "T"},
-        {'U', "T"},  // basecalls will have "T"s instead of "U"s
-        {'R', "[AG]"},
-        {'Y', "[CT]"}, 
-        {'S', "[GC]"}, 
-        {'W', "[AT]"},
-        {'K', "[GT]"}, 
-        {'M', "[AC]"}, 
-        {'B', "[CGT]"},
-        {'D', "[AGT]"},
-        {'H', "[ACT]"},
-        {'V', "[ACG]"},
-        {'N', "[ACGT]"},
+        {'A', BASE_A},
+        {'C', BASE_C},
+        {'G', BASE_G},
+        {'T', BASE_T},
+        {'U', BASE_T},  // basecalls will have "T"s instead of "U"s
+        {'R', BASE_A | BASE_G},
+        {'Y', BASE_C | BASE_T},
+        {'S', BASE_G | BASE_C},
+        {'W', BASE_A | BASE_T},
+        {'K', BASE_G | BASE_T},
+        {'M', BASE_A | BASE_C},
+        {'B', BASE_C | BASE_G | BASE_T},
+        {'D', BASE_A | BASE_G | BASE_T},
+        {'H', BASE_A | BASE_C | BASE_T},
+        {'V', BASE_A | BASE_C | BASE_G},
+        {'N', BASE_A | BASE_C | BASE_G | BASE_T},
                 // clang-format on
 };
 
-std::string expand_motif_regex(const std::string& motif) {
-    std::string motif_regex = "(";
+// Maps sequence characters to the base bits above. Only upper case ACGT can match a motif.
+constexpr std::array<uint8_t, 256> make_sequence_base_table() {
+    std::array<uint8_t, 256> table{};
+    table['A'] = BASE_A;
+    table['C'] = BASE_C;
+    table['G'] = BASE_G;
+    table['T'] = BASE_T;
+    return table;
+}
+constexpr auto SEQUENCE_BASES = make_sequence_base_table();
+
+std::vector<uint8_t> compile_motif(const std::string& motif) {
+    if (motif.empty()) {
+        throw std::runtime_error("MotifMatcher: motif must not be empty");
+    }
+    std::vector<uint8_t> position_bases;
+    position_bases.reserve(motif.size());
     for (auto base : motif) {
-        motif_regex += IUPAC_CODES.at(base);
+        position_bases.push_back(IUPAC_CODES.at(base));
+    }
+    return position_bases;
+}
+
+// Appends the positions of |seq| at which |motif| (1 or 2 plain bases) starts, shifted by |offset|.
+#if !ENABLE_NEON_IMPL
+#if ENABLE_AVX2_IMPL
+[[maybe_unused]] __attribute__((target("default")))
+#endif
+void exact_motif_hits_impl(std::string_view seq,
+                           std::string_view motif,
+                           size_t offset,
+                           std::vector<size_t>& hits) {
+    if (seq.size() < motif.size()) {
+        return;
+    }
+    const size_t num_starts = seq.size() - motif.size() + 1;
+    for (size_t i = 0; i < num_starts; ++i) {
+        if (seq[i] == motif[0] && (motif.size() == 1 || seq[i + 1] == motif[1])) {
+            hits.push_back(i + offset);
+        }
+    }
+}
+#endif  // !ENABLE_NEON_IMPL
+
+#if ENABLE_AVX2_IMPL || ENABLE_NEON_IMPL
+#if ENABLE_AVX2_IMPL
+[[maybe_unused]] __attribute__((target("avx2")))
+#endif
+void exact_motif_hits_impl(std::string_view seq,
+                           std::string_view motif,
+                           size_t offset,
+                           std::vector<size_t>& hits) {
+    if (seq.size() < motif.size()) {
+        return;
+    }
+    const size_t num_starts = seq.size() - motif.size() + 1;
+    const char* const data = seq.data();
+    const bool two_bases = motif.size() == 2;
+
+#if ENABLE_AVX2_IMPL
+    // 32 candidate start positions per iteration, giving one bit per position.
+    constexpr size_t kBlockSize = 32;
+    const __m256i first_base = _mm256_set1_epi8(motif[0]);
+    const __m256i second_base = _mm256_set1_epi8(two_bases ? motif[1] : 0);
+    constexpr int kBitsPerPosition = 1;
+#else
+    // 16 candidate start positions per iteration, giving a nibble per position.
+    constexpr size_t kBlockSize = 16;
+    const uint8x16_t first_base = vdupq_n_u8(static_cast<uint8_t>(motif[0]));
+    const uint8x16_t second_base = vdupq_n_u8(static_cast<uint8_t>(two_bases ? motif[1] : 0));
+    constexpr int kBitsPerPosition = 4;
+#endif
+
+    // The second base of a two base motif is read one past the block, so stop early enough that
+    // this stays within the sequence.
+    const size_t num_loadable = seq.size() - (two_bases ? 1 : 0);
+    size_t block_start = 0;
+    for (; block_start + kBlockSize <= num_loadable; block_start += kBlockSize) {
+        const char* const block = data + block_start;
+#if ENABLE_AVX2_IMPL
+        __m256i matches = _mm256_cmpeq_epi8(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block)), first_base);
+        if (two_bases) {
+            matches = _mm256_and_si256(
+                    matches,
+                    _mm256_cmpeq_epi8(
+                            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + 1)),
+                            second_base));
+        }
+        uint64_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(matches));
+#else
+        uint8x16_t matches = vceqq_u8(vld1q_u8(reinterpret_cast<const uint8_t*>(block)), first_base);
+        if (two_bases) {
+            matches = vandq_u8(
+                    matches,
+                    vceqq_u8(vld1q_u8(reinterpret_cast<const uint8_t*>(block + 1)), second_base));
+        }
+        // Narrow each 0x00/0xff byte to a nibble, since Neon has no movemask.
+        uint64_t mask = vget_lane_u64(
+                vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(matches), 4)), 0);
+#endif
+        while (mask != 0) {
+            const int bit = std::countr_zero(mask);
+            hits.push_back(block_start + bit / kBitsPerPosition + offset);
+            mask &= ~(((uint64_t(1) << kBitsPerPosition) - 1) << bit);
+        }
+    }
+
+    // Remaining starts.
+    for (size_t i = block_start; i < num_starts; ++i) {
+        if (data[i] == motif[0] && (!two_bases || data[i + 1] == motif[1])) {
+            hits.push_back(i + offset);
+        }
     }
-    motif_regex += ")";
-    return motif_regex;
 }
+#endif  // ENABLE_AVX2_IMPL || ENABLE_NEON_IMPL
 
 }  // namespace
 
@@ -55,25 +163,70 @@ MotifMatcher::MotifMatcher(const config::ModBaseModelConfig& model_config)
         : MotifMatcher(model_config.mods.motif, model_config.mods.motif_offset) {}
 
 MotifMatcher::MotifMatcher(const std::string& motif, size_t offset)
-        : m_motif(expand_motif_regex(motif)), m_motif_offset(offset) {}
+        : m_position_bases(compile_motif(motif)), m_motif_offset(offset) {
+    if (m_position_bases.size() <= 64) {
+        for (size_t c = 0; c < SEQUENCE_BASES.size(); ++c) {
+            for (size_t pos = 0; pos < m_position_bases.size(); ++pos) {
+                if (m_position_bases[pos] & SEQUENCE_BASES[c]) {
+                    m_char_masks[c] |= uint64_t(1) << pos;
+                }
+            }
+        }
+    }
+
+    // A motif of one or two plain bases can be found with straight comparisons.
+    if (m_position_bases.size() <= 2) {
+        const std::string_view plain_bases = "ACGT";
+        for (auto bases : m_position_bases) {
+            const auto base_idx = std::countr_zero(bases);
+            if (bases != (1 << base_idx)) {
+                m_exact_motif.clear();
+                break;
+            }
+            m_exact_motif += plain_bases[base_idx];
+        }
+    }
+}
 
 std::vector<size_t> MotifMatcher::get_motif_hits(std::string_view seq) const {
     NVTX3_FUNC_RANGE();
     std::vector<size_t> context_hits;
-
-    std::regex regex(m_motif);
-    auto start = std::cbegin(seq);
-    auto end = std::cend(seq);
-    auto pos = start;
-    // string_view on linux uses `const_iterator=const char*`,
-    // but on Windows it's a `std::_String_view_iterator<_Traits>`
-    std::match_results<decltype(pos)> motif_match;
-    while (std::regex_search(pos, end, motif_match, regex)) {
-        auto hit = std::distance(start, pos) + motif_match.position(0) + m_motif_offset;
-        context_hits.push_back(hit);
-        pos += motif_match.position(0) + 1;
+    if (!m_exact_motif.empty()) {
+        exact_motif_hits_impl(seq, m_exact_motif, m_motif_offset, context_hits);
+    } else if (m_position_bases.size() <= 64) {
+        get_shift_and_hits(seq, context_hits);
+    } else {
+        get_long_motif_hits(seq, context_hits);
     }
     return context_hits;
 }
 
+void MotifMatcher::get_shift_and_hits(std::string_view seq, std::vector<size_t>& hits) const {
+    // Bit i of |state| is set if the motif's first i + 1 positions match the sequence ending at
+    // the current base.
+    const size_t motif_len = m_position_bases.size();
+    const uint64_t final_bit = uint64_t(1) << (motif_len - 1);
+    uint64_t state = 0;
+    for (size_t i = 0; i < seq.size(); ++i) {
+        state = ((state << 1) | 1) & m_char_masks[static_cast<uint8_t>(seq[i])];
+        if (state & final_bit) {
+            hits.push_back(i + 1 - motif_len + m_motif_offset);
+        }
+    }
+}
+
+void MotifMatcher::get_long_motif_hits(std::string_view seq, std::vector<size_t>& hits) const {
+    const size_t motif_len = m_position_bases.size();
+    for (size_t start = 0; start + motif_len <= seq.size(); ++start) {
+        size_t pos = 0;
+        while (pos < motif_len &&
+               (m_position_bases[pos] & SEQUENCE_BASES[static_cast<uint8_t>(seq[start + pos])])) {
+            ++pos;
+        }
+        if (pos == motif_len) {
+            hits.push_back(start + m_motif_offset);
+        }
+    }
+}
+
 }  // namespace dorado::modbase
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <array>
+#include <cstdint>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -10,6 +12,9 @@ struct ModBaseModelConfig;
 
 namespace dorado::modbase {
 
+// Finds all (possibly overlapping) occurrences of an IUPAC motif in a basecalled sequence.
+// The motif is compiled once on construction into a bit-parallel (shift-and) matcher, with a
+// vectorised path for motifs made of one or two plain bases (e.g. C, CG, GC).
 class MotifMatcher {
 public:
     MotifMatcher(const config::ModBaseModelConfig& model_config);
@@ -18,8 +23,16 @@ public:
     std::vector<size_t> get_motif_hits(std::string_view seq) const;
 
 private:
-    const std::string m_motif;
+    void get_shift_and_hits(std::string_view seq, std::vector<size_t>& hits) const;
+    void get_long_motif_hits(std::string_view seq, std::vector<size_t>& hits) const;
+
+    // For each motif position, a mask of the bases (A=1, C=2, G=4, T=8) allowed there.
+    const std::vector<uint8_t> m_position_bases;
     const size_t m_motif_offset;
+    // For each character, a mask of the motif positions it can match (motifs up to 64 bases).
+    std::array<uint64_t, 256> m_char_masks{};
+    // Non-empty if the motif is one or two plain bases, in which case the vectorised path is used.
+    std::string m_exact_motif;
 };
 
 }  // namespace dorado::modbase
@@ -34,6 +34,8 @@ class FastxRandomReader;
 
 namespace dorado::polisher {
 
+class TaskScheduler;
+
 using IntervalTreeInt64 = interval_tree::IntervalTree<int64_t, int64_t>;
 using IntervalTreesInt64Map = std::unordered_map<int32_t, IntervalTreeInt64>;
 
@@ -136,15 +138,18 @@ std::vector<secondary::Window> create_windows_from_regions(
  * \brief Fetches the decode data from an async queue, decodes the consensus and collects
  *          the consensus results. It also returns a vector of the decode data taken off of the queue
  *          (i.e. the input used for decoding). This will be needed downstream for variant calling.
+ *          Each batch is decoded by a task on the scheduler as soon as it is taken off the queue.
+ * \param scheduler Scheduler which runs the decoding tasks.
  * \param results Return vector of consensus results.
  * \param decode_data Return vector of input data used for decoding, taken from the queue.
  * \param decode_queue Queue where messages will be received.
  * \param polish_stats Stats object, for the progress bar.
  * \param decoder Decoder to convert integers to bases.
- * \param num_threads Number of threads for processing.
+ * \param num_threads Maximum number of batches which are decoded at once.
  * \param min_depth Consensus sequences will be split in regions of insufficient depth.
  */
-void decode_samples_in_parallel(std::vector<std::vector<secondary::ConsensusResult>>& results_cons,
+void decode_samples_in_parallel(TaskScheduler& scheduler,
+                                std::vector<std::vector<secondary::ConsensusResult>>& results_cons,
                                 std::vector<secondary::VariantCallingSample>& results_vc_data,
                                 utils::AsyncQueue<DecodeData>& decode_queue,
                                 secondary::Stats& stats,
@@ -181,6 +186,7 @@ struct HaplotagResults {
 };
 
 HaplotagResults haplotag_regions_in_parallel(
+        TaskScheduler& scheduler,
         std::vector<std::unique_ptr<secondary::EncoderBase>>& encoders,
         const std::vector<secondary::Window>& regions,
         const std::vector<std::pair<std::string, int64_t>>& draft_lens,
@@ -189,6 +195,7 @@ HaplotagResults haplotag_regions_in_parallel(
         const float pass_min_qual);
 
 void sample_producer(
+        TaskScheduler& scheduler,
         PolisherResources& resources,
         const std::vector<secondary::Window>& bam_regions,
         const std::vector<std::pair<std::string, int64_t>>& draft_lens,
@@ -223,6 +230,7 @@ std::vector<std::vector<std::vector<secondary::ConsensusResult>>> construct_cons
 
 // Explicit full qualification of the Interval so it is not confused with the one from the IntervalTree library.
 std::vector<secondary::Variant> call_variants(
+        TaskScheduler& scheduler,
         std::atomic<bool>& worker_terminate,
         secondary::Stats& stats,
         const secondary::Interval& region_batch,
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "utils/concurrency/multi_queue_thread_pool.h"
+#include "utils/concurrency/task_priority.h"
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+
+namespace dorado::polisher {
+
+/**
+ * \brief Thread pool shared by all CPU stages of polishing and variant calling (encoding, merging,
+ *          decoding, haplotagging and variant calling). The stages submit tasks into it instead of
+ *          each creating and draining its own pool, so that concurrently running stages share the
+ *          cores, and a stage which is waiting on another leaves its cores to the rest.
+ *          Decoding is submitted with high priority so that it is not queued behind encoding.
+ *
+ *          Tasks must not wait on other tasks: submitting and waiting is done from threads which
+ *          are not owned by the scheduler.
+ */
+class TaskScheduler {
+public:
+    explicit TaskScheduler(int32_t num_threads);
+
+    int32_t num_threads() const { return m_num_threads; }
+
+    /**
+     * \brief A set of tasks which are waited on together.
+     */
+    class TaskGroup {
+    public:
+        /**
+         * \param max_tasks_in_flight Maximum number of tasks which are queued or running at once.
+         *          Limits the memory held by tasks which were submitted but have not yet run.
+         */
+        TaskGroup(TaskScheduler& scheduler,
+                  utils::concurrency::TaskPriority priority,
+                  size_t max_tasks_in_flight);
+
+        /**
+         * \brief Waits for the tasks to finish. Exceptions are dropped, call wait() to get them.
+         */
+        ~TaskGroup();
+
+        TaskGroup(const TaskGroup&) = delete;
+        TaskGroup& operator=(const TaskGroup&) = delete;
+
+        /**
+         * \brief Queues the task, blocking while max_tasks_in_flight tasks are in flight.
+         */
+        void submit(std::function<void()> task);
+
+        /**
+         * \brief Waits for all submitted tasks to finish, then rethrows the first exception
+         *          thrown by any of them.
+         */
+        void wait();
+
+    private:
+        void wait_for_tasks();
+
+        utils::concurrency::MultiQueueThreadPool::ThreadPoolQueue& m_queue;
+        const size_t m_max_tasks_in_flight;
+        std::mutex m_mutex;
+        std::condition_variable m_cv;
+        size_t m_tasks_in_flight{0};
+        std::exception_ptr m_exception;
+    };
+
+    /**
+     * \brief Runs task(id) for each id in [0, num_tasks) and waits for all of them to finish.
+     *          Rethrows the first exception thrown by a task.
+     */
+    void run(int32_t num_tasks,
+             const std::function<void(int32_t)>& task,
+             utils::concurrency::TaskPriority priority = utils::concurrency::TaskPriority::normal);
+
+private:
+    utils::concurrency::MultiQueueThreadPool::ThreadPoolQueue& queue(
+            utils::concurrency::TaskPriority priority);
+
+    const int32_t m_num_threads;
+    utils::concurrency::MultiQueueThreadPool m_pool;
+    utils::concurrency::MultiQueueThreadPool::ThreadPoolQueue& m_normal_queue;
+    utils::concurrency::MultiQueueThreadPool::ThreadPoolQueue& m_high_queue;
+};
+
+}  // namespace dorado::polisher
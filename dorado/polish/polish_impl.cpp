@@ -1,6 +1,7 @@
 #include "polish/polish_impl.h"
 
 #include "hts_utils/FastxRandomReader.h"
+#include "polish/task_scheduler.h"
 #include "secondary/architectures/model_factory.h"
 #include "secondary/common/batching.h"
 #include "secondary/common/region.h"
@@ -22,7 +23,9 @@
 #include <algorithm>
 #include <atomic>
 #include <cassert>
+#include <future>
 #include <memory>
+#include <mutex>
 #include <stdexcept>
 
 #if DORADO_CUDA_BUILD
@@ -824,6 +827,7 @@ std::vector<secondary::Sample> split_samples_tiled_with_candidates(
  *          1. Merges adjacent samples, which were split for efficiency of computing the pileup.
  *          2. Checks for discontinuities in any of the samples (based on major positions) and splits them.
  *          3. Splits the merged samples into equally sized pieces which will be used for inference to prevent memory usage spikes.
+ * \param scheduler Scheduler which runs the merging tasks.
  * \param window_samples Input samples which will be merged and split. Non-const to enable moving of data.
  * \param encoder Encoder used to produce the sample tensors. It is needed becaue of the secondary::EncoderBase::merge_adjacent_samples() function.
  * \param bam_regions BAM region coordinates. This is a Span to facilitate batching of BAM regions from the outside.
@@ -837,6 +841,7 @@ std::vector<secondary::Sample> split_samples_tiled_with_candidates(
  */
 std::pair<std::vector<secondary::Sample>, std::vector<secondary::TrimInfo>>
 merge_and_split_bam_regions_in_parallel(
+        TaskScheduler& scheduler,
         std::vector<secondary::Sample>& window_samples,
         std::atomic<bool>& worker_terminate,
         const std::vector<std::unique_ptr<secondary::EncoderBase>>& encoders,
@@ -1000,20 +1005,11 @@ merge_and_split_bam_regions_in_parallel(
                   std::size(bam_region_intervals), std::size(thread_chunks));
 
     // Parallel processing of BAM regions.
-    cxxpool::thread_pool pool{std::size(thread_chunks)};
-    std::vector<std::future<void>> futures;
-    futures.reserve(std::size(thread_chunks));
     std::vector<WorkerReturnStatus> worker_return_vals(std::size(thread_chunks));
-    for (size_t tid = 0; tid < std::size(thread_chunks); ++tid) {
+    scheduler.run(static_cast<int32_t>(std::size(thread_chunks)), [&](const int32_t tid) {
         const auto [chunk_start, chunk_end] = thread_chunks[tid];
-        futures.emplace_back(pool.push(worker, tid, chunk_start, chunk_end,
-                                       std::ref(merged_samples), std::ref(merged_trims),
-                                       std::ref(worker_return_vals[tid])));
-    }
-
-    for (auto& f : futures) {
-        f.get();
-    }
+        worker(tid, chunk_start, chunk_end, merged_samples, merged_trims, worker_return_vals[tid]);
+    });
 
     for (size_t tid = 0; tid < std::size(worker_return_vals); ++tid) {
         const WorkerReturnStatus& rv = worker_return_vals[tid];
@@ -1053,9 +1049,10 @@ merge_and_split_bam_regions_in_parallel(
 /**
  * \brief For each input window (region of the draft) runs the given encoder and produces a sample.
  *          The BamFile handels are used to fetch the pileup data and encode regions.
- *          Encoding is parallelized, where the actual number of threads is min(bam_handles.size(), num_threads, windows.size()).
+ *          Encoding is parallelized, where the actual number of tasks is min(bam_handles.size(), num_threads).
  */
 std::vector<secondary::Sample> encode_windows_in_parallel(
+        TaskScheduler& scheduler,
         std::vector<std::unique_ptr<secondary::EncoderBase>>& encoders,
         std::atomic<bool>& worker_terminate,
         const std::vector<std::pair<std::string, int64_t>>& draft_lens,
@@ -1143,27 +1140,17 @@ std::vector<secondary::Sample> encode_windows_in_parallel(
     }
     shared_window_queue.terminate(utils::AsyncQueueTerminateFast::No);
 
-    // Create the thread pool, futures and results.
-    const std::size_t actual_threads =
-            std::min(num_threads, static_cast<int32_t>(std::size(encoders)));
-    cxxpool::thread_pool pool{actual_threads};
-    std::vector<std::future<void>> futures;
-    futures.reserve(actual_threads);
+    // Create the results. Each task owns one encoder.
+    const int32_t actual_threads = std::min(num_threads, static_cast<int32_t>(std::size(encoders)));
     std::vector<secondary::Sample> results(std::size(windows));
     std::vector<WorkerReturnStatus> worker_return_vals(actual_threads);
 
     spdlog::debug("Starting to encode regions for {} windows using {} threads.", std::size(windows),
                   actual_threads);
 
-    // Add jobs to the pool.
-    for (int32_t tid = 0; tid < static_cast<int32_t>(actual_threads); ++tid) {
-        futures.emplace_back(pool.push(worker, tid, std::ref(shared_window_queue),
-                                       std::ref(results), std::ref(worker_return_vals[tid])));
-    }
-
-    for (auto& f : futures) {
-        f.get();
-    }
+    scheduler.run(actual_threads, [&](const int32_t tid) {
+        worker(tid, shared_window_queue, results, worker_return_vals[tid]);
+    });
 
     for (size_t tid = 0; tid < std::size(worker_return_vals); ++tid) {
         const WorkerReturnStatus& rv = worker_return_vals[tid];
@@ -1273,6 +1260,7 @@ std::vector<secondary::Variant> convert_variants(
 }
 
 HaplotagResults haplotag_regions_in_parallel(
+        TaskScheduler& scheduler,
         std::vector<std::unique_ptr<secondary::EncoderBase>>& encoders,
         const std::vector<secondary::Window>& regions,
         const std::vector<std::pair<std::string, int64_t>>& draft_lens,
@@ -1294,8 +1282,8 @@ HaplotagResults haplotag_regions_in_parallel(
         return {};
     }
 
-    const size_t final_num_threads =
-            std::min(static_cast<size_t>(num_threads), std::size(encoders));
+    const int32_t final_num_threads =
+            std::min(num_threads, static_cast<int32_t>(std::size(encoders)));
 
     // Result data.
     HaplotagResults ret;
@@ -1379,18 +1367,7 @@ HaplotagResults haplotag_regions_in_parallel(
             }
         };
 
-        cxxpool::thread_pool pool{final_num_threads};
-
-        std::vector<std::future<void>> futures;
-        futures.reserve(num_threads);
-
-        for (int32_t tid = 0; tid < static_cast<int32_t>(final_num_threads); ++tid) {
-            futures.emplace_back(pool.push(worker, tid));
-        }
-
-        for (auto& f : futures) {
-            f.get();
-        }
+        scheduler.run(final_num_threads, worker);
     }
 
     // Merge PASS variants from simple variant calling.
@@ -1434,21 +1411,20 @@ HaplotagResults haplotag_regions_in_parallel(
         };
 
         // Run on all references.
-        cxxpool::thread_pool pool{final_num_threads};
-        std::vector<std::future<void>> futures;
-        futures.reserve(std::size(ret.candidate_sites));
-        for (auto& [key, vals] : ret.candidate_sites) {
-            futures.emplace_back(pool.push(worker, key));
-        }
-        for (auto& f : futures) {
-            f.get();
+        std::vector<const std::string*> keys;
+        keys.reserve(std::size(ret.candidate_sites));
+        for (const auto& [key, vals] : ret.candidate_sites) {
+            keys.emplace_back(&key);
         }
+        scheduler.run(static_cast<int32_t>(std::size(keys)),
+                      [&](const int32_t key_id) { worker(*keys[key_id]); });
     }
 
     return ret;
 }
 
 void sample_producer(
+        TaskScheduler& scheduler,
         PolisherResources& resources,
         const std::vector<secondary::Window>& bam_regions,
         const std::vector<std::pair<std::string, int64_t>>& draft_lens,
@@ -1534,9 +1510,28 @@ void sample_producer(
     }
 
     // Divide BAM regions into groups of specified size (in terms of num windows), as sort of a barrier.
-    const std::vector<secondary::Interval> bam_region_batches = secondary::create_batches(
+    std::vector<secondary::Interval> bam_region_batches = secondary::create_batches(
             bam_region_intervals, encoding_batch_size,
             [](const secondary::Interval& val) { return val.end - val.start; });
+    bam_region_batches.erase(
+            std::remove_if(std::begin(bam_region_batches), std::end(bam_region_batches),
+                           [](const secondary::Interval& val) { return val.end <= val.start; }),
+            std::end(bam_region_batches));
+
+    // Encodes the windows of a batch of BAM regions on the scheduler, in the background.
+    const auto encode_batch = [&](const secondary::Interval& region_batch) {
+        return std::async(std::launch::async, [&, region_batch]() {
+            const int32_t window_id_start = bam_region_intervals[region_batch.start].start;
+            const int32_t window_id_end = bam_region_intervals[region_batch.end - 1].end;
+            const size_t num_windows = static_cast<size_t>(window_id_end - window_id_start);
+            return encode_windows_in_parallel(
+                    scheduler, resources.encoders, worker_terminate, draft_lens,
+                    bam_region_haplotags,
+                    std::span<const secondary::Window>(std::data(windows) + window_id_start,
+                                                       num_windows),
+                    num_threads, continue_on_exception);
+        });
+    };
 
     InferenceData buffer;
 
@@ -1545,25 +1540,32 @@ void sample_producer(
     assert(!std::empty(resources.models));
     const auto& model = resources.models.front();
 
+    std::future<std::vector<secondary::Sample>> next_region_samples;
+    if (!std::empty(bam_region_batches)) {
+        next_region_samples = encode_batch(bam_region_batches.front());
+    }
+
     // Each iteration of the for loop produces full BAM regions of samples to fit at least num_threads windows.
     // It is important to process full BAM regions because of splitting/merging/splitting and trimming.
-    for (const auto [region_id_start, region_id_end] : bam_region_batches) {
-        if (region_id_end <= region_id_start) {
-            continue;
+    for (size_t batch_id = 0; batch_id < std::size(bam_region_batches); ++batch_id) {
+        const auto [region_id_start, region_id_end] = bam_region_batches[batch_id];
+
+        // Wait for the encoding of this batch, then start encoding the next one so that it runs
+        // while this batch is merged and inferred. Only one batch is encoded at a time because
+        // the encoders are not thread safe, but merging only uses their const functions.
+        std::future<std::vector<secondary::Sample>> curr_region_samples =
+                std::move(next_region_samples);
+        curr_region_samples.wait();
+        if ((batch_id + 1) < std::size(bam_region_batches)) {
+            next_region_samples = encode_batch(bam_region_batches[batch_id + 1]);
         }
 
         try {
             const int32_t num_regions = region_id_end - region_id_start;
             const int32_t window_id_start = bam_region_intervals[region_id_start].start;
-            const int32_t window_id_end = bam_region_intervals[region_id_end - 1].end;
-            const size_t num_windows = static_cast<size_t>(window_id_end - window_id_start);
 
-            // Encode samples in parallel. Non-const by design, data will be moved.
-            std::vector<secondary::Sample> region_samples = encode_windows_in_parallel(
-                    resources.encoders, worker_terminate, draft_lens, bam_region_haplotags,
-                    std::span<const secondary::Window>(std::data(windows) + window_id_start,
-                                                       num_windows),
-                    num_threads, continue_on_exception);
+            // Samples encoded in parallel. Non-const by design, data will be moved.
+            std::vector<secondary::Sample> region_samples = curr_region_samples.get();
 
             spdlog::trace(
                     "[producer] Merging the samples into {} BAM chunks. parallel_results.size() = "
@@ -1572,7 +1574,7 @@ void sample_producer(
 
             // Passing only one const encoder because it only calls const functions without sideeffects.
             auto [samples, trims] = merge_and_split_bam_regions_in_parallel(
-                    region_samples, worker_terminate, resources.encoders,
+                    scheduler, region_samples, worker_terminate, resources.encoders,
                     std::span<const secondary::Window>(std::data(bam_regions) + region_id_start,
                                                        num_regions),
                     std::span<const secondary::Interval>(
@@ -1957,7 +1959,8 @@ void infer_samples_in_parallel(
     spdlog::debug("[infer_samples_in_parallel] Finished running inference.");
 }
 
-void decode_samples_in_parallel(std::vector<std::vector<secondary::ConsensusResult>>& results_cons,
+void decode_samples_in_parallel(TaskScheduler& scheduler,
+                                std::vector<std::vector<secondary::ConsensusResult>>& results_cons,
                                 std::vector<secondary::VariantCallingSample>& results_vc_data,
                                 utils::AsyncQueue<DecodeData>& decode_queue,
                                 secondary::Stats& stats,
@@ -1970,7 +1973,8 @@ void decode_samples_in_parallel(std::vector<std::vector<secondary::ConsensusResu
                                 const bool continue_on_exception) {
     utils::ScopedProfileRange spr1("decode_samples_in_parallel", 2);
 
-    auto batch_decode = [&decoder, &stats, min_depth](const DecodeData& item, const int32_t tid) {
+    auto batch_decode = [&decoder, &stats, min_depth](const DecodeData& item,
+                                                      const int32_t batch_id) {
         utils::ScopedProfileRange spr2("decode_samples_in_parallel-batch_decode", 3);
 
         timer::TimerHighRes timer_total;
@@ -2096,159 +2100,156 @@ void decode_samples_in_parallel(std::vector<std::vector<secondary::ConsensusResu
         spdlog::trace(
                 "[decoder {}] Computed batch decode. Timings - decode = {} "
                 "ms, trim = {} ms, total = {}",
-                tid, time_decode, time_trim, time_total);
+                batch_id, time_decode, time_trim, time_total);
 
         return final_results;
     };
 
-    const auto worker = [&](const int32_t tid,
-                            std::vector<std::vector<secondary::ConsensusResult>>& thread_results,
-                            std::vector<secondary::VariantCallingSample>& thread_vc_data,
-                            WorkerReturnStatus& ret_val) {
-        utils::ScopedProfileRange spr2("decode_samples_in_parallel-worker", 3);
-        at::InferenceMode infer_guard;
+    std::mutex results_mutex;
+    WorkerReturnStatus first_error;
 
-        while (!worker_terminate) {
-            utils::ScopedProfileRange spr3("decode_samples_in_parallel-worker-while", 4);
+    // Dimensions: batches x samples x haplotypes, in the order in which the batches were decoded.
+    std::vector<std::vector<std::vector<secondary::ConsensusResult>>> batch_results;
+    std::vector<std::vector<secondary::VariantCallingSample>> batch_vc_data;
 
-            DecodeData item;
-            const auto pop_status = decode_queue.try_pop(item);
+    const auto decode_batch = [&](DecodeData& item, const int32_t batch_id) {
+        utils::ScopedProfileRange spr2("decode_samples_in_parallel-decode_batch", 3);
+        at::InferenceMode infer_guard;
 
-            if (pop_status == utils::AsyncQueueStatus::Terminate) {
-                break;
-            }
+        if (worker_terminate) {
+            return;
+        }
 
-            try {
-                const int64_t tensor_batch_size =
-                        (item.logits.sizes().size() == 0) ? 0 : item.logits.size(0);
+        try {
+            const int64_t tensor_batch_size =
+                    (item.logits.sizes().size() == 0) ? 0 : item.logits.size(0);
 
-                assert(tensor_batch_size == dorado::ssize(item.trims));
+            assert(tensor_batch_size == dorado::ssize(item.trims));
 
-                spdlog::trace(
-                        "[decoder {}] Popped data: item.logits.shape = {}, item.trims.size = {}, "
-                        "tensor_batch_size = {}, queue size: {}",
-                        tid, utils::tensor_shape_as_string(item.logits), dorado::ssize(item.trims),
-                        tensor_batch_size, std::size(decode_queue));
+            spdlog::trace(
+                    "[decoder {}] Popped data: item.logits.shape = {}, item.trims.size = {}, "
+                    "tensor_batch_size = {}, queue size: {}",
+                    batch_id, utils::tensor_shape_as_string(item.logits), dorado::ssize(item.trims),
+                    tensor_batch_size, std::size(decode_queue));
 
-                // This should handle the timeout case too.
-                if (tensor_batch_size == 0) {
-                    continue;
-                }
+            // This should handle the timeout case too.
+            if (tensor_batch_size == 0) {
+                return;
+            }
 
-                // Inference.
-                std::vector<std::vector<secondary::ConsensusResult>> results_samples =
-                        batch_decode(item, tid);
-
-                thread_results.insert(std::end(thread_results),
-                                      std::make_move_iterator(std::begin(results_samples)),
-                                      std::make_move_iterator(std::end(results_samples)));
-
-                // Separate the logits for each sample.
-                if (collect_vc_data) {
-                    // Split logits for each input sample in the batch, and check that the number matches.
-                    const std::vector<torch::Tensor> split_logits = item.logits.unbind(0);
-                    if (std::size(item.samples) != std::size(split_logits)) {
-                        spdlog::error(
-                                "The number of logits produced by the batch inference does not "
-                                "match "
-                                "the "
-                                "input batch size! Variant calling for this batch will not be "
-                                "possible. "
-                                "samples.size = {}, split_logits.size = {}",
-                                std::size(item.samples), std::size(split_logits));
-                        continue;
-                    }
+            // Inference.
+            std::vector<std::vector<secondary::ConsensusResult>> results_samples =
+                    batch_decode(item, batch_id);
+
+            // Separate the logits for each sample.
+            std::vector<secondary::VariantCallingSample> vc_data;
+            if (collect_vc_data) {
+                // Split logits for each input sample in the batch, and check that the number matches.
+                const std::vector<torch::Tensor> split_logits = item.logits.unbind(0);
+                if (std::size(item.samples) != std::size(split_logits)) {
+                    spdlog::error(
+                            "The number of logits produced by the batch inference does not "
+                            "match "
+                            "the "
+                            "input batch size! Variant calling for this batch will not be "
+                            "possible. "
+                            "samples.size = {}, split_logits.size = {}",
+                            std::size(item.samples), std::size(split_logits));
+                } else {
                     // Create the variant calling data. Clone the tensor to convert the view to actual data.
+                    vc_data.reserve(std::size(item.samples));
                     for (int64_t i = 0; i < dorado::ssize(item.samples); ++i) {
-                        thread_vc_data.emplace_back(secondary::VariantCallingSample{
+                        vc_data.emplace_back(secondary::VariantCallingSample{
                                 item.samples[i].seq_id, std::move(item.samples[i].positions_major),
                                 std::move(item.samples[i].positions_minor),
                                 split_logits[i].clone()});
                     }
                 }
+            }
 
-            } catch (const std::exception& e) {
-                if (!continue_on_exception) {
-                    ret_val = {.exception_thrown = true,
-                               .message = std::string("Caught exception while decoding samples: '" +
-                                                      std::string(e.what()) + "'")};
-                    worker_terminate = true;
-                    return;
-                }
+            std::lock_guard lock(results_mutex);
+            batch_results.emplace_back(std::move(results_samples));
+            batch_vc_data.emplace_back(std::move(vc_data));
 
-                spdlog::warn(
-                        "Caught an exception when decoding a batch of samples. Skipping this "
-                        "batch. Exception: {}",
-                        e.what());
+        } catch (const std::exception& e) {
+            if (!continue_on_exception) {
+                std::lock_guard lock(results_mutex);
+                if (!first_error.exception_thrown) {
+                    first_error = {.exception_thrown = true,
+                                   .message = "Caught exception while decoding samples: '" +
+                                              std::string(e.what()) + "'"};
+                }
+                worker_terminate = true;
+                return;
             }
+
+            spdlog::warn(
+                    "Caught an exception when decoding a batch of samples. Skipping this "
+                    "batch. Exception: {}",
+                    e.what());
         }
     };
 
-    // Dimensions: threads x samples x haplotypes.
-    std::vector<std::vector<std::vector<secondary::ConsensusResult>>> thread_results(num_threads);
-    std::vector<std::vector<secondary::VariantCallingSample>> thread_vc_data(num_threads);
+    // Each batch is decoded by its own task as soon as its logits are popped. The tasks have
+    // high priority so that they are not queued behind encoding of the next regions.
+    {
+        TaskScheduler::TaskGroup task_group(scheduler, utils::concurrency::TaskPriority::high,
+                                            static_cast<size_t>(num_threads));
 
-    cxxpool::thread_pool pool{static_cast<size_t>(num_threads)};
+        int32_t batch_id = 0;
+        while (!worker_terminate) {
+            utils::ScopedProfileRange spr2("decode_samples_in_parallel-while", 3);
 
-    std::vector<WorkerReturnStatus> worker_return_vals(num_threads);
+            auto item = std::make_shared<DecodeData>();
+            const auto pop_status = decode_queue.try_pop(*item);
 
-    std::vector<std::future<void>> futures;
-    futures.reserve(num_threads);
+            if (pop_status == utils::AsyncQueueStatus::Terminate) {
+                break;
+            }
 
-    for (int32_t tid = 0; tid < static_cast<int32_t>(num_threads); ++tid) {
-        futures.emplace_back(pool.push(worker, tid, std::ref(thread_results[tid]),
-                                       std::ref(thread_vc_data[tid]),
-                                       std::ref(worker_return_vals[tid])));
-    }
+            task_group.submit([&decode_batch, item, batch_id]() { decode_batch(*item, batch_id); });
+            ++batch_id;
+        }
 
-    for (auto& f : futures) {
-        f.get();
+        task_group.wait();
     }
 
-    for (size_t tid = 0; tid < std::size(worker_return_vals); ++tid) {
-        const WorkerReturnStatus& rv = worker_return_vals[tid];
-        if (!rv.exception_thrown) {
-            continue;
-        }
-        if (!continue_on_exception) {
-            // Cannot throw because this is a worker function intended to run on a separate thread.
-            // Instead, communicate the error and return.
-            ret_status = rv;
-            worker_terminate = true;
-            return;
-        } else {
-            spdlog::warn(rv.message);
-        }
+    if (first_error.exception_thrown) {
+        // Cannot throw because this is a worker function intended to run on a separate thread.
+        // Instead, communicate the error and return.
+        ret_status = first_error;
+        worker_terminate = true;
+        return;
     }
 
     // Flatten the results.
     {
         size_t total_size = 0;
-        for (const auto& vals : thread_results) {
+        for (const auto& vals : batch_results) {
             total_size += std::size(vals);
         }
         results_cons.clear();
         results_cons.reserve(total_size);
 
         // Take only the first haplotype of the consensus.
-        for (size_t thread_id = 0; thread_id < std::size(thread_results); ++thread_id) {
-            for (size_t sample_id = 0; sample_id < std::size(thread_results[thread_id]);
+        for (size_t batch_id = 0; batch_id < std::size(batch_results); ++batch_id) {
+            for (size_t sample_id = 0; sample_id < std::size(batch_results[batch_id]);
                  ++sample_id) {
-                if (std::empty(thread_results[thread_id][sample_id])) {
+                if (std::empty(batch_results[batch_id][sample_id])) {
                     continue;
                 }
-                results_cons.emplace_back(std::move(thread_results[thread_id][sample_id]));
+                results_cons.emplace_back(std::move(batch_results[batch_id][sample_id]));
             }
         }
     }
     {
         size_t total_size = 0;
-        for (const auto& vals : thread_vc_data) {
+        for (const auto& vals : batch_vc_data) {
             total_size += std::size(vals);
         }
         results_vc_data.clear();
         results_vc_data.reserve(total_size);
-        for (auto& vals : thread_vc_data) {
+        for (auto& vals : batch_vc_data) {
             results_vc_data.insert(std::end(results_vc_data),
                                    std::make_move_iterator(std::begin(vals)),
                                    std::make_move_iterator(std::end(vals)));
@@ -2318,6 +2319,7 @@ std::vector<std::vector<std::vector<secondary::ConsensusResult>>> construct_cons
 }
 
 std::vector<secondary::Variant> call_variants(
+        TaskScheduler& scheduler,
         std::atomic<bool>& worker_terminate,
         secondary::Stats& stats,
         const secondary::Interval& region_batch,
@@ -2428,13 +2430,6 @@ std::vector<secondary::Variant> call_variants(
     const std::vector<secondary::Interval> thread_chunks =
             secondary::compute_partitions(static_cast<int32_t>(std::size(groups)), num_threads);
 
-    // Create the thread pool.
-    cxxpool::thread_pool pool{std::size(thread_chunks)};
-
-    // Create the futures.
-    std::vector<std::future<void>> futures;
-    futures.reserve(std::size(thread_chunks));
-
     // Reserve the space for results for each individual group.
     std::vector<std::vector<secondary::Variant>> thread_results(std::size(groups));
 
@@ -2484,18 +2479,11 @@ std::vector<secondary::Variant> call_variants(
     }
 #endif
 
-    // Add worker tasks.
-    for (int32_t tid = 0; tid < static_cast<int32_t>(std::size(thread_chunks)); ++tid) {
+    // Run the worker tasks. Each task uses the draft reader of its ID.
+    scheduler.run(static_cast<int32_t>(std::size(thread_chunks)), [&](const int32_t tid) {
         const auto [chunk_start, chunk_end] = thread_chunks[tid];
-        futures.emplace_back(pool.push(worker, tid, chunk_start, chunk_end,
-                                       std::ref(thread_results), std::ref(stats),
-                                       std::ref(worker_return_vals[tid])));
-    }
-
-    // Join and catch exceptions.
-    for (auto& f : futures) {
-        f.get();
-    }
+        worker(tid, chunk_start, chunk_end, thread_results, stats, worker_return_vals[tid]);
+    });
 
     for (size_t tid = 0; tid < std::size(worker_return_vals); ++tid) {
         const WorkerReturnStatus& rv = worker_return_vals[tid];
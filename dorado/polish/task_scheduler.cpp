@@ -0,0 +1,97 @@
+#include "polish/task_scheduler.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace dorado::polisher {
+
+namespace {
+
+int32_t validate_num_threads(const int32_t num_threads) {
+    if (num_threads <= 0) {
+        throw std::invalid_argument("TaskScheduler needs at least one thread, given: " +
+                                    std::to_string(num_threads));
+    }
+    return num_threads;
+}
+
+}  // namespace
+
+TaskScheduler::TaskScheduler(const int32_t num_threads)
+        : m_num_threads{validate_num_threads(num_threads)},
+          m_pool(static_cast<size_t>(num_threads), "polish_pool"),
+          m_normal_queue{m_pool.create_task_queue(utils::concurrency::TaskPriority::normal)},
+          m_high_queue{m_pool.create_task_queue(utils::concurrency::TaskPriority::high)} {}
+
+utils::concurrency::MultiQueueThreadPool::ThreadPoolQueue& TaskScheduler::queue(
+        const utils::concurrency::TaskPriority priority) {
+    return (priority == utils::concurrency::TaskPriority::high) ? m_high_queue : m_normal_queue;
+}
+
+void TaskScheduler::run(const int32_t num_tasks,
+                        const std::function<void(int32_t)>& task,
+                        const utils::concurrency::TaskPriority priority) {
+    if (num_tasks <= 0) {
+        return;
+    }
+    TaskGroup group(*this, priority, static_cast<size_t>(num_tasks));
+    for (int32_t id = 0; id < num_tasks; ++id) {
+        group.submit([&task, id]() { task(id); });
+    }
+    group.wait();
+}
+
+TaskScheduler::TaskGroup::TaskGroup(TaskScheduler& scheduler,
+                                    const utils::concurrency::TaskPriority priority,
+                                    const size_t max_tasks_in_flight)
+        : m_queue{scheduler.queue(priority)},
+          m_max_tasks_in_flight{std::max<size_t>(1, max_tasks_in_flight)} {}
+
+TaskScheduler::TaskGroup::~TaskGroup() { wait_for_tasks(); }
+
+void TaskScheduler::TaskGroup::submit(std::function<void()> task) {
+    {
+        std::unique_lock lock(m_mutex);
+        m_cv.wait(lock, [this] { return m_tasks_in_flight < m_max_tasks_in_flight; });
+        ++m_tasks_in_flight;
+    }
+
+    m_queue.push([this, task = std::move(task)]() {
+        std::exception_ptr exception;
+        try {
+            task();
+        } catch (...) {
+            exception = std::current_exception();
+        }
+
+        // Notify under the lock so that the group can't be destroyed by a waiting thread
+        // before the notification is done.
+        std::lock_guard lock(m_mutex);
+        if (exception && !m_exception) {
+            m_exception = std::move(exception);
+        }
+        --m_tasks_in_flight;
+        m_cv.notify_all();
+    });
+}
+
+void TaskScheduler::TaskGroup::wait() {
+    wait_for_tasks();
+    std::exception_ptr exception;
+    {
+        std::lock_guard lock(m_mutex);
+        std::swap(exception, m_exception);
+    }
+    if (exception) {
+        std::rethrow_exception(exception);
+    }
+}
+
+void TaskScheduler::TaskGroup::wait_for_tasks() {
+    std::unique_lock lock(m_mutex);
+    m_cv.wait(lock, [this] { return m_tasks_in_flight == 0; });
+}
+
+}  // namespace dorado::polisher
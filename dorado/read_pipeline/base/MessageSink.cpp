@@ -1,18 +1,76 @@
 #include "read_pipeline/base/MessageSink.h"
 
+#include "utils/PostCondition.h"
 #include "utils/thread_utils.h"
 
+#include <algorithm>
 #include <cassert>
+#include <chrono>
+#include <string>
 
 namespace dorado {
 
-MessageSink::MessageSink(size_t max_messages, int num_input_threads)
-        : m_work_queue(max_messages), m_num_input_threads(num_input_threads) {}
+namespace {
+
+// Identifies which of a sink's input threads we're on, so that busy time can be attributed.
+struct InputThreadState {
+    const MessageSink *sink = nullptr;
+    int index = -1;
+    std::chrono::steady_clock::time_point busy_since;
+};
+thread_local InputThreadState t_input_thread;
+
+int64_t steady_clock_ns() {
+    const auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(now).count();
+}
+
+}  // namespace
+
+MessageSink::MessageSink(size_t max_messages,
+                         int num_input_threads,
+                         utils::AsyncQueueBackend queue_backend)
+        : m_work_queue(max_messages, queue_backend),
+          m_num_input_threads(num_input_threads),
+          m_input_thread_busy_ns(
+                  std::make_unique<std::atomic<int64_t>[]>(std::max(num_input_threads, 0))) {}
 
 // Intentionally out-of-line for avoid vtable generation in every TU.
 MessageSink::~MessageSink() = default;
 
-stats::NamedStats MessageSink::sample_stats() const { return stats::from_obj(m_work_queue); }
+stats::NamedStats MessageSink::sample_stats() const {
+    auto stats = stats::from_obj(m_work_queue);
+    if (m_work_queue.is_profiling_enabled() && m_num_input_threads > 0) {
+        const double elapsed_ns = double(steady_clock_ns() - m_input_start_ns.load());
+        double total_busy_ns = 0;
+        for (int i = 0; i < m_num_input_threads; ++i) {
+            const double busy_ns = double(m_input_thread_busy_ns[i].load());
+            stats["input_thread_" + std::to_string(i) + ".busy_ms"] = busy_ns / 1e6;
+            total_busy_ns += busy_ns;
+        }
+        stats["input_threads_busy_fraction"] =
+                elapsed_ns > 0 ? total_busy_ns / (elapsed_ns * m_num_input_threads) : 0;
+    }
+    return stats;
+}
+
+void MessageSink::set_profiling_enabled(bool enabled) {
+    m_work_queue.set_profiling_enabled(enabled);
+}
+
+void MessageSink::begin_busy_period() {
+    if (t_input_thread.sink == this) {
+        t_input_thread.busy_since = std::chrono::steady_clock::now();
+    }
+}
+
+void MessageSink::end_busy_period() {
+    if (t_input_thread.sink == this) {
+        const auto busy = std::chrono::steady_clock::now() - t_input_thread.busy_since;
+        m_input_thread_busy_ns[t_input_thread.index] +=
+                std::chrono::duration_cast<std::chrono::nanoseconds>(busy).count();
+    }
+}
 
 void MessageSink::push_message_internal(Message &&message) {
     // We don't check the error return value since during fast terminate this will
@@ -20,6 +78,51 @@ void MessageSink::push_message_internal(Message &&message) {
     m_work_queue.try_push(std::move(message));
 }
 
+void MessageSink::push_messages(std::span<Message> messages) {
+    // As with push_message_internal, Terminate is expected during fast terminate.
+    m_work_queue.try_push_n(messages);
+}
+
+bool MessageSink::get_input_messages(std::vector<Message> &messages, size_t max_messages) {
+    const bool profiling = m_work_queue.is_profiling_enabled();
+    if (profiling) {
+        end_busy_period();
+    }
+    auto profile_guard = utils::PostCondition([this, profiling] {
+        if (profiling) {
+            begin_busy_period();
+        }
+    });
+
+    messages.clear();
+    const bool forward_disconnected = !m_sinks.empty() && forward_on_disconnected();
+    while (messages.empty()) {
+        const auto status = m_work_queue.process_and_pop_n(
+                [&messages](Message &&message) { messages.push_back(std::move(message)); },
+                max_messages);
+        if (status != utils::AsyncQueueStatus::Success) {
+            return false;
+        }
+        if (!forward_disconnected) {
+            break;
+        }
+
+        // Reads from disconnected clients go straight on without being processed.
+        auto is_disconnected = [](const Message &message) {
+            return is_read_message(message) && get_read_common_data(message).client_info &&
+                   get_read_common_data(message).client_info->is_disconnected();
+        };
+        const auto connected_end = std::stable_partition(
+                messages.begin(), messages.end(),
+                [&is_disconnected](const Message &message) { return !is_disconnected(message); });
+        if (connected_end != messages.end()) {
+            send_messages_to_sink(0, std::span<Message>(connected_end, messages.end()));
+            messages.erase(connected_end, messages.end());
+        }
+    }
+    return true;
+}
+
 void MessageSink::add_sink(MessageSink &sink) { m_sinks.push_back(std::ref(sink)); }
 
 void MessageSink::start_input_processing(const std::function<void()> &input_thread_fn,
@@ -36,9 +139,12 @@ void MessageSink::start_input_processing(const std::function<void()> &input_thre
     // The queue must be in started state before we attempt to pop an item,
     // otherwise the pop will fail and the thread will terminate.
     start_input_queue();
+    m_input_start_ns = steady_clock_ns();
     for (int i = 0; i < m_num_input_threads; ++i) {
-        m_input_threads.emplace_back([func = input_thread_fn, name = worker_name] {
+        m_input_thread_busy_ns[i] = 0;
+        m_input_threads.emplace_back([this, i, func = input_thread_fn, name = worker_name] {
             dorado::utils::set_thread_name(name.c_str());
+            t_input_thread = {this, i, std::chrono::steady_clock::now()};
             func();
         });
     }
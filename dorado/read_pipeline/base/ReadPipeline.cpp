@@ -10,6 +10,24 @@ using namespace std::chrono_literals;
 
 namespace dorado {
 
+namespace {
+
+// Summarises the stats gathered by a profiled node, so that the bottleneck stands out.
+void log_profile_summary(const std::string &node_name, const stats::NamedStats &node_stats) {
+    auto get = [&node_stats](const std::string &name) {
+        const auto it = node_stats.find(name);
+        return it != node_stats.end() ? it->second : 0.0;
+    };
+    spdlog::info(
+            "Pipeline profile: {}: input queue depth p50 < {}, p99 < {} of {}; producers blocked "
+            "{:.1f}s; input threads waited {:.1f}s and were {:.0f}% busy",
+            node_name, get("queue.depth_p50"), get("queue.depth_p99"), get("queue.capacity"),
+            get("queue.push_blocked_ms") / 1000, get("queue.pop_wait_ms") / 1000,
+            100 * get("input_threads_busy_fraction"));
+}
+
+}  // namespace
+
 // Depth first search that establishes a topological ordering for node destruction.
 // Returns true if a cycle is found.
 bool Pipeline::DFS(const std::vector<PipelineDescriptor::NodeDescriptor> &node_descriptors,
@@ -134,6 +152,9 @@ stats::NamedStats Pipeline::terminate(const TerminateOptions &terminate_options)
             node->terminate(terminate_options);
             auto node_stats = node->sample_stats();
             const auto node_name = node->get_name();
+            if (m_profiling_enabled) {
+                log_profile_summary(node_name, node_stats);
+            }
             for (const auto &[name, value] : node_stats) {
                 final_stats[std::string(node_name).append(".").append(name)] = value;
             }
@@ -142,6 +163,13 @@ stats::NamedStats Pipeline::terminate(const TerminateOptions &terminate_options)
     return final_stats;
 }
 
+void Pipeline::set_profiling_enabled(bool enabled) {
+    m_profiling_enabled = enabled;
+    for (auto &node : m_nodes) {
+        node->set_profiling_enabled(enabled);
+    }
+}
+
 void Pipeline::restart() {
     // The order in which we restart nodes shouldn't matter, so
     // we go source to sink.
@@ -0,0 +1,184 @@
+#include "read_pipeline/base/SignalStore.h"
+
+#include <ATen/ATen.h>
+#include <spdlog/spdlog.h>
+#include <zlib.h>
+
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+namespace {
+
+// Start a new spill file once the current one holds this much, so that space is given back as
+// older signals are released.
+constexpr size_t SPILL_FILE_BYTES = size_t{256} << 20;
+
+// Fast compression: most of the gain comes from the shuffled exponent bytes.
+constexpr int COMPRESSION_LEVEL = Z_BEST_SPEED;
+
+// Splits |num_bytes| of elements of size |element_size| into planes of their 1st bytes, 2nd bytes,
+// etc.  Neighbouring samples have similar high bytes, which then compress well.
+void shuffle_bytes(const uint8_t* src, uint8_t* dst, size_t num_bytes, size_t element_size) {
+    const size_t num_elements = num_bytes / element_size;
+    for (size_t b = 0; b < element_size; ++b) {
+        uint8_t* plane = dst + b * num_elements;
+        for (size_t i = 0; i < num_elements; ++i) {
+            plane[i] = src[i * element_size + b];
+        }
+    }
+}
+
+void unshuffle_bytes(const uint8_t* src, uint8_t* dst, size_t num_bytes, size_t element_size) {
+    const size_t num_elements = num_bytes / element_size;
+    for (size_t b = 0; b < element_size; ++b) {
+        const uint8_t* plane = src + b * num_elements;
+        for (size_t i = 0; i < num_elements; ++i) {
+            dst[i * element_size + b] = plane[i];
+        }
+    }
+}
+
+std::string random_suffix() {
+    std::random_device rd;
+    return std::to_string(rd()) + "_" + std::to_string(rd());
+}
+
+}  // namespace
+
+namespace dorado {
+
+// A file that parked signals are appended to.  It's removed once nothing refers to it.
+class SignalStore::SpillFile {
+public:
+    explicit SpillFile(std::filesystem::path path) : m_path(std::move(path)) {
+        m_stream.open(m_path, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!m_stream) {
+            throw std::runtime_error("SignalStore: failed to create spill file " +
+                                     m_path.string());
+        }
+    }
+
+    ~SpillFile() {
+        m_stream.close();
+        std::error_code ec;
+        std::filesystem::remove(m_path, ec);
+        if (ec) {
+            spdlog::warn("Failed to remove signal spill file {}: {}", m_path.string(),
+                         ec.message());
+        }
+    }
+
+    // Returns the offset the data was written at.
+    uint64_t append(const std::vector<uint8_t>& data) {
+        std::lock_guard lock(m_mutex);
+        const uint64_t offset = m_size;
+        m_stream.seekp(std::streamoff(offset));
+        m_stream.write(reinterpret_cast<const char*>(data.data()), std::streamsize(data.size()));
+        if (!m_stream) {
+            throw std::runtime_error("SignalStore: failed to write to spill file " +
+                                     m_path.string());
+        }
+        m_size += data.size();
+        return offset;
+    }
+
+    void read(uint64_t offset, std::vector<uint8_t>& data) {
+        std::lock_guard lock(m_mutex);
+        m_stream.seekg(std::streamoff(offset));
+        m_stream.read(reinterpret_cast<char*>(data.data()), std::streamsize(data.size()));
+        if (!m_stream) {
+            throw std::runtime_error("SignalStore: failed to read from spill file " +
+                                     m_path.string());
+        }
+    }
+
+    size_t size() const {
+        std::lock_guard lock(m_mutex);
+        return m_size;
+    }
+
+private:
+    const std::filesystem::path m_path;
+    mutable std::mutex m_mutex;
+    std::fstream m_stream;
+    size_t m_size{0};
+};
+
+SignalStore::SignalStore(Mode mode, std::filesystem::path spill_dir)
+        : m_mode(mode),
+          m_spill_dir(spill_dir.empty() ? std::filesystem::temp_directory_path()
+                                        : std::move(spill_dir)) {}
+
+SignalStore::~SignalStore() = default;
+
+std::shared_ptr<SignalStore::SpillFile> SignalStore::spill_file_for(size_t num_bytes) {
+    std::lock_guard lock(m_spill_mutex);
+    if (!m_current_spill_file || m_current_spill_file->size() + num_bytes > SPILL_FILE_BYTES) {
+        const auto name = "dorado_signal_" + random_suffix() + "_" +
+                          std::to_string(m_num_spill_files++) + ".tmp";
+        m_current_spill_file = std::make_shared<SpillFile>(m_spill_dir / name);
+    }
+    return m_current_spill_file;
+}
+
+SignalStore::ParkedSignal SignalStore::park(const at::Tensor& signal) {
+    if (!signal.device().is_cpu()) {
+        throw std::runtime_error("SignalStore: can only park CPU tensors");
+    }
+    const auto contiguous = signal.contiguous();
+
+    auto parked = std::make_shared<Parked>();
+    parked->m_dtype = contiguous.scalar_type();
+    parked->m_sizes = contiguous.sizes().vec();
+    parked->m_num_bytes = contiguous.nbytes();
+
+    std::vector<uint8_t> shuffled(parked->m_num_bytes);
+    shuffle_bytes(static_cast<const uint8_t*>(contiguous.data_ptr()), shuffled.data(),
+                  parked->m_num_bytes, contiguous.element_size());
+
+    std::vector<uint8_t> compressed(compressBound(uLong(shuffled.size())));
+    uLongf compressed_size = uLongf(compressed.size());
+    if (compress2(compressed.data(), &compressed_size, shuffled.data(), uLong(shuffled.size()),
+                  COMPRESSION_LEVEL) != Z_OK) {
+        throw std::runtime_error("SignalStore: failed to compress signal");
+    }
+    compressed.resize(compressed_size);
+    parked->m_stored_bytes = compressed.size();
+
+    if (m_mode == Mode::SPILL) {
+        parked->m_spill_file = spill_file_for(compressed.size());
+        parked->m_spill_offset = parked->m_spill_file->append(compressed);
+    } else {
+        compressed.shrink_to_fit();
+        parked->m_compressed = std::move(compressed);
+    }
+    return parked;
+}
+
+at::Tensor SignalStore::restore(const Parked& parked) const {
+    std::vector<uint8_t> spilled;
+    const std::vector<uint8_t>* compressed = &parked.m_compressed;
+    if (parked.m_spill_file) {
+        spilled.resize(parked.m_stored_bytes);
+        parked.m_spill_file->read(parked.m_spill_offset, spilled);
+        compressed = &spilled;
+    }
+
+    std::vector<uint8_t> shuffled(parked.m_num_bytes);
+    uLongf shuffled_size = uLongf(shuffled.size());
+    if (uncompress(shuffled.data(), &shuffled_size, compressed->data(),
+                   uLong(compressed->size())) != Z_OK ||
+        shuffled_size != shuffled.size()) {
+        throw std::runtime_error("SignalStore: failed to decompress signal");
+    }
+
+    auto signal = at::empty(parked.m_sizes, at::TensorOptions().dtype(parked.m_dtype));
+    unshuffle_bytes(shuffled.data(), static_cast<uint8_t*>(signal.data_ptr()), parked.m_num_bytes,
+                    signal.element_size());
+    return signal;
+}
+
+}  // namespace dorado
@@ -6,7 +6,9 @@
 #include "utils/AsyncQueue.h"
 #include "utils/stats.h"
 
+#include <atomic>
 #include <memory>
+#include <span>
 #include <stdexcept>
 #include <string>
 #include <thread>
@@ -21,7 +23,11 @@ namespace dorado {
 // waits on the input queue before attempting to join input worker threads.
 class MessageSink {
 public:
-    MessageSink(size_t max_messages, int num_input_threads);
+    // |queue_backend| selects how the input queue is synchronised. The lock-free backend suits
+    // nodes that receive a high rate of messages.
+    MessageSink(size_t max_messages,
+                int num_input_threads,
+                utils::AsyncQueueBackend queue_backend = utils::AsyncQueueBackend::Mutex);
 
     virtual ~MessageSink();
 
@@ -37,6 +43,15 @@ public:
         push_message_internal(Message(std::move(msg)));
     }
 
+    // Adds a batch of messages to the input queue, taking the queue's lock once per run of
+    // messages that fit rather than once per message.  This can block if the sink's queue is
+    // full.  The messages are moved from.
+    void push_messages(std::span<Message> messages);
+
+    // While enabled, sample_stats also reports input queue wait times and depths, and how busy
+    // each input thread is.  See Pipeline::set_profiling_enabled.
+    void set_profiling_enabled(bool enabled);
+
     // Waits until work is finished and shuts down worker threads.
     // No work can be done by the node after this returns until
     // restart is subsequently called.
@@ -46,6 +61,9 @@ public:
     virtual void restart() = 0;
 
 protected:
+    // A reasonable number of messages for lightweight nodes to pop and forward at a time.
+    static constexpr size_t DEFAULT_INPUT_BATCH_SIZE = 64;
+
     virtual bool forward_on_disconnected() const { return true; }
 
     // Mark the input queue as terminating.
@@ -71,9 +89,26 @@ protected:
         send_message_to_sink(0, std::forward<Msg>(message));
     }
 
+    // Sends a batch of messages to the designated sink.  The messages are moved from.
+    void send_messages_to_sink(int sink_index, std::span<Message> messages) {
+        m_sinks.at(sink_index).get().push_messages(messages);
+    }
+
+    // Version for nodes with a single sink that is implicit.
+    void send_messages_to_sink(std::span<Message> messages) {
+        if (m_sinks.size() != 1) {
+            throw std::runtime_error("Invalid m_sinks size");
+        }
+        send_messages_to_sink(0, messages);
+    }
+
     // Pops the next input message, returning true on success.
     // If terminating, returns false.
     bool get_input_message(Message& message) {
+        const bool profiling = m_work_queue.is_profiling_enabled();
+        if (profiling) {
+            end_busy_period();
+        }
         auto status = m_work_queue.try_pop(message);
         if (!m_sinks.empty() && forward_on_disconnected()) {
             while (status == utils::AsyncQueueStatus::Success && is_read_message(message) &&
@@ -83,9 +118,16 @@ protected:
                 status = m_work_queue.try_pop(message);
             }
         }
+        if (profiling) {
+            begin_busy_period();
+        }
         return status == utils::AsyncQueueStatus::Success;
     }
 
+    // Replaces the contents of |messages| with up to |max_messages| input messages, waiting
+    // for at least one to arrive.  Returns false once terminating and no more are available.
+    bool get_input_messages(std::vector<Message>& messages, size_t max_messages);
+
     // Mark the input queue as active, and start input processing threads executing the
     // supplied functor.
     void start_input_processing(const std::function<void()>& input_thread_fn,
@@ -106,9 +148,16 @@ private:
 
     void push_message_internal(Message&& message);
 
+    // Track the time input threads spend outside of get_input_message(s), when profiling.
+    void begin_busy_period();
+    void end_busy_period();
+
     // Input processing threads.
     const int m_num_input_threads;
     std::vector<std::thread> m_input_threads;
+    std::unique_ptr<std::atomic<int64_t>[]> m_input_thread_busy_ns;
+    // steady_clock time at which input processing started, in ns.
+    std::atomic<int64_t> m_input_start_ns{0};
 };
 
 }  // namespace dorado
\ No newline at end of file
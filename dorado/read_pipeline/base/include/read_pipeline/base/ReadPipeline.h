@@ -92,6 +92,12 @@ public:
     // Restarts pipeline after a call to terminate.
     void restart();
 
+    // Enables or disables profiling of every node.  While enabled, node stats also include
+    // input queue depth percentiles and histograms, time producers spent blocked pushing to each
+    // node, time its input threads spent waiting for messages, and how busy those threads were.
+    // A summary of these is logged when the pipeline is terminated.
+    void set_profiling_enabled(bool enabled);
+
     // Indicates whether the pipeline is running.
     bool is_running() const { return m_is_running.load(); }
 
@@ -114,6 +120,7 @@ private:
     std::vector<std::unique_ptr<MessageSink>> m_nodes;
     std::vector<NodeHandle> m_source_to_sink_order;
     std::atomic<bool> m_is_running{false};
+    bool m_profiling_enabled{false};
 
     enum class DFSState { Unvisited, Visiting, Visited };
 
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <ATen/core/TensorBody.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace dorado {
+
+// Holds read signal away from the reads it belongs to, so that reads which are only waiting
+// around (e.g. for a duplex partner) don't keep their full signal tensors resident.
+//
+// Signal is byte-shuffled and deflated when parked.  In COMPRESSED mode the compressed bytes are
+// kept in memory; in SPILL mode they're appended to files in a local directory.  A spill file is
+// deleted once it's full and every signal parked in it has been released, or with the store.
+class SignalStore {
+public:
+    enum class Mode { COMPRESSED, SPILL };
+
+    class SpillFile;
+
+    // A parked signal.  It's released when the last copy of its pointer is dropped.
+    class Parked {
+    public:
+        // The bytes used to hold the signal while parked, in memory or on disk.
+        size_t stored_bytes() const { return m_stored_bytes; }
+
+    private:
+        friend class SignalStore;
+
+        at::ScalarType m_dtype{};
+        std::vector<int64_t> m_sizes;
+        size_t m_num_bytes{0};
+        size_t m_stored_bytes{0};
+        // COMPRESSED mode.
+        std::vector<uint8_t> m_compressed;
+        // SPILL mode.
+        std::shared_ptr<SpillFile> m_spill_file;
+        uint64_t m_spill_offset{0};
+    };
+    using ParkedSignal = std::shared_ptr<const Parked>;
+
+    // |spill_dir| is only used in SPILL mode, and defaults to the system temp directory.
+    SignalStore(Mode mode, std::filesystem::path spill_dir);
+    ~SignalStore();
+
+    // Takes a copy of |signal|, which must be a CPU tensor.
+    ParkedSignal park(const at::Tensor& signal);
+
+    // Returns a new tensor holding the parked signal.  Thread safe, and the signal stays parked.
+    at::Tensor restore(const Parked& parked) const;
+
+    Mode mode() const { return m_mode; }
+
+private:
+    std::shared_ptr<SpillFile> spill_file_for(size_t num_bytes);
+
+    const Mode m_mode;
+    const std::filesystem::path m_spill_dir;
+
+    std::mutex m_spill_mutex;
+    std::shared_ptr<SpillFile> m_current_spill_file;
+    size_t m_num_spill_files{0};
+};
+
+}  // namespace dorado
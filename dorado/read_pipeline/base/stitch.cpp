@@ -2,26 +2,52 @@
 
 #include "read_pipeline/base/messages.h"
 #include "utils/math_utils.h"
-#include "utils/string_utils.h"
 
+#include <algorithm>
 #include <cassert>
+#include <iterator>
 #include <numeric>
+#include <string_view>
 
 namespace dorado::utils {
 
+namespace {
+
+// The trimmed part of a chunk which ends up in the stitched read.
+struct ChunkContribution {
+    std::string_view seq;
+    std::string_view qstring;
+    std::span<const uint8_t> moves;
+};
+
+// Copies each piece to its offset in |out|, which is resized once to fit all of them.
+template <typename Output, typename Piece>
+void copy_pieces(Output& out, const std::vector<ChunkContribution>& contributions, Piece piece) {
+    size_t total_size = 0;
+    for (const auto& contribution : contributions) {
+        total_size += piece(contribution).size();
+    }
+    out.resize(total_size);
+    auto out_it = out.begin();
+    for (const auto& contribution : contributions) {
+        const auto in = piece(contribution);
+        out_it = std::copy(in.begin(), in.end(), out_it);
+    }
+}
+
+}  // namespace
+
 void stitch_chunks(ReadCommon& read_common, std::span<const Chunk*> called_chunks) {
     assert(static_cast<int>(div_round_closest(called_chunks[0]->raw_chunk_size,
                                               called_chunks[0]->moves.size())) ==
            read_common.attributes.model_stride);
 
+    // Work out which part of each chunk is kept first, so that the read's seq, qstring and moves
+    // can be sized once and each chunk copied straight to its place, with no intermediate copies.
     int start_pos = 0;
     int mid_point_front = 0;
-    std::vector<uint8_t> moves;
-    std::vector<std::string_view> sequences;
-    std::vector<std::string_view> qstrings;
-
-    sequences.reserve(called_chunks.size());
-    qstrings.reserve(called_chunks.size());
+    std::vector<ChunkContribution> contributions;
+    contributions.reserve(called_chunks.size());
 
     for (int i = 0; i < int(called_chunks.size()) - 1; i++) {
         auto& current_chunk = called_chunks[i];
@@ -41,11 +67,10 @@ void stitch_chunks(ReadCommon& read_common, std::span<const Chunk*> called_chunk
         const int trimmed_len = end_pos - start_pos;
         const std::string_view seq = current_chunk->seq;
         const std::string_view qstring = current_chunk->qstring;
-        sequences.push_back(seq.substr(start_pos, trimmed_len));
-        qstrings.push_back(qstring.substr(start_pos, trimmed_len));
-
-        moves.insert(moves.end(), std::next(current_chunk->moves.begin(), mid_point_front),
-                     std::prev(current_chunk->moves.end(), mid_point_rear));
+        contributions.push_back({seq.substr(start_pos, trimmed_len),
+                                 qstring.substr(start_pos, trimmed_len),
+                                 {std::next(current_chunk->moves.begin(), mid_point_front),
+                                  std::prev(current_chunk->moves.end(), mid_point_rear)}});
 
         mid_point_front = overlap_down_sampled - mid_point_rear;
 
@@ -57,8 +82,8 @@ void stitch_chunks(ReadCommon& read_common, std::span<const Chunk*> called_chunk
 
     // Append the final chunk
     auto& last_chunk = called_chunks.back();
-    moves.insert(moves.end(), std::next(last_chunk->moves.begin(), mid_point_front),
-                 last_chunk->moves.end());
+    std::span<const uint8_t> last_moves(std::next(last_chunk->moves.begin(), mid_point_front),
+                                        last_chunk->moves.end());
     const std::string_view last_seq = last_chunk->seq;
     const std::string_view last_qstring = last_chunk->qstring;
 
@@ -66,20 +91,20 @@ void stitch_chunks(ReadCommon& read_common, std::span<const Chunk*> called_chunk
         // shorten the sequence, qstring & moves where the read is shorter than chunksize
         const int last_index_in_moves_to_keep =
                 int(read_common.get_raw_data_samples() / read_common.attributes.model_stride);
-        moves = std::vector<uint8_t>(moves.begin(), moves.begin() + last_index_in_moves_to_keep);
-        const int end = std::reduce(moves.begin(), moves.end(), 0);
-        sequences.push_back(last_seq.substr(start_pos, end));
-        qstrings.push_back(last_qstring.substr(start_pos, end));
+        last_moves = last_moves.first(last_index_in_moves_to_keep);
+        const int end = std::reduce(last_moves.begin(), last_moves.end(), 0);
+        contributions.push_back(
+                {last_seq.substr(start_pos, end), last_qstring.substr(start_pos, end), last_moves});
 
     } else {
-        sequences.push_back(last_seq.substr(start_pos));
-        qstrings.push_back(last_qstring.substr(start_pos));
+        contributions.push_back(
+                {last_seq.substr(start_pos), last_qstring.substr(start_pos), last_moves});
     }
 
     // Set the read seq and qstring
-    read_common.seq = utils::join(sequences, {});
-    read_common.qstring = utils::join(qstrings, {});
-    read_common.moves = std::move(moves);
+    copy_pieces(read_common.seq, contributions, [](const auto& c) { return c.seq; });
+    copy_pieces(read_common.qstring, contributions, [](const auto& c) { return c.qstring; });
+    copy_pieces(read_common.moves, contributions, [](const auto& c) { return c.moves; });
 
     // remove partial stride overhang
     if (static_cast<int>(read_common.moves.size()) >
@@ -16,6 +16,7 @@
 #include <spdlog/spdlog.h>
 
 #include <cassert>
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -48,18 +49,21 @@ std::shared_ptr<const dorado::alignment::Minimap2Index> load_and_get_index(
 }
 
 void update_bed_results(dorado::ReadCommon& read_common, const dorado::alignment::BedFile& bed) {
+    std::vector<size_t> hits;
     for (auto& align_result : read_common.alignment_results) {
-        for (const auto& entry : bed.entries(align_result.genome)) {
-            if (!(entry.start > (size_t)align_result.genome_end ||
-                  entry.end < (size_t)align_result.genome_start) &&
-                (entry.strand == align_result.direction || entry.strand == '.')) {
-                // A hit
-                align_result.bed_hits++;
-                if (!align_result.bed_lines.empty()) {
-                    align_result.bed_lines += "\n";
-                }
-                align_result.bed_lines += entry.bed_line;
+        // Entries which only touch the ends of the alignment are hits too.
+        bed.find_overlaps(align_result.genome, int64_t{align_result.genome_start} - 1,
+                          int64_t{align_result.genome_end} + 1, align_result.direction, hits);
+        if (hits.empty()) {
+            continue;
+        }
+        const auto& entries = bed.entries(align_result.genome);
+        align_result.bed_hits += static_cast<int>(hits.size());
+        for (const size_t hit : hits) {
+            if (!align_result.bed_lines.empty()) {
+                align_result.bed_lines += "\n";
             }
+            align_result.bed_lines += entries[hit].bed_line;
         }
     }
 }
@@ -74,7 +78,7 @@ AlignerNode::AlignerNode(std::shared_ptr<alignment::IndexFileAccess> index_file_
                          const std::string& bed_file,
                          const alignment::Minimap2Options& options,
                          int threads)
-        : MessageSink(MAX_INPUT_QUEUE_SIZE, 1),
+        : MessageSink(MAX_INPUT_QUEUE_SIZE, 1, utils::AsyncQueueBackend::LockFree),
           m_thread_pool(
                   std::make_shared<utils::concurrency::MultiQueueThreadPool>(threads,
                                                                              "align_node_pool")),
@@ -104,7 +108,7 @@ AlignerNode::AlignerNode(std::shared_ptr<alignment::IndexFileAccess> index_file_
                          std::shared_ptr<alignment::BedFileAccess> bed_file_access,
                          std::shared_ptr<utils::concurrency::MultiQueueThreadPool> thread_pool,
                          utils::concurrency::TaskPriority pipeline_priority)
-        : MessageSink(MAX_INPUT_QUEUE_SIZE, 1),
+        : MessageSink(MAX_INPUT_QUEUE_SIZE, 1, utils::AsyncQueueBackend::LockFree),
           m_thread_pool(std::move(thread_pool)),
           m_pipeline_priority(pipeline_priority),
           m_index_file_access(std::move(index_file_access)),
@@ -135,8 +139,8 @@ std::shared_ptr<const alignment::Minimap2Index> AlignerNode::get_index(
     return index;
 }
 
-std::shared_ptr<alignment::BedFile> AlignerNode::get_bedfile(const ClientInfo& client_info,
-                                                             const std::string& bedfile) {
+std::shared_ptr<const alignment::BedFile> AlignerNode::get_bedfile(const ClientInfo& client_info,
+                                                                   const std::string& bedfile) {
     if (m_bed_file_access && !bedfile.empty()) {
         return m_bed_file_access->get_bedfile(bedfile);
     }
@@ -250,16 +254,11 @@ stats::NamedStats AlignerNode::sample_stats() const {
 }
 
 void AlignerNode::add_bed_hits_to_record(const std::string& genome, bam1_t* record) {
-    size_t genome_start = record->core.pos;
-    size_t genome_end = bam_endpos(record);
-    char direction = (bam_is_rev(record)) ? '-' : '+';
-    int bed_hits = 0;
-    for (const auto& interval : m_bedfile_for_bam_messages->entries(genome)) {
-        if (!(interval.start >= genome_end || interval.end <= genome_start) &&
-            (interval.strand == direction || interval.strand == '.')) {
-            bed_hits++;
-        }
-    }
+    const int64_t genome_start = record->core.pos;
+    const int64_t genome_end = bam_endpos(record);
+    const char direction = (bam_is_rev(record)) ? '-' : '+';
+    const auto bed_hits = static_cast<int>(m_bedfile_for_bam_messages->count_overlaps(
+            genome, genome_start, genome_end, direction));
     // update the record.
     bam_aux_append(record, "bh", 'i', sizeof(bed_hits), (uint8_t*)&bed_hits);
 }
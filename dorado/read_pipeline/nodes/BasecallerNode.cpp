@@ -17,6 +17,7 @@
 #include <cassert>
 #include <chrono>
 #include <cstdlib>
+#include <iterator>
 #include <stdexcept>
 
 #if DORADO_METAL_BUILD
@@ -29,24 +30,95 @@ using namespace at::indexing;
 namespace dorado {
 
 struct BasecallerNode::BasecallingChunk : utils::Chunk {
-    BasecallingChunk(std::shared_ptr<BasecallingRead> owner,
-                     size_t offset,
-                     size_t chunk_in_read_idx,
-                     size_t chunk_size)
-            : Chunk(offset, chunk_size),
-              owning_read(std::move(owner)),
-              idx_in_read(chunk_in_read_idx) {}
-
-    std::shared_ptr<BasecallingRead> owning_read;  // The object that owns us.
-    size_t idx_in_read;  // Just for tracking that the chunks don't go out of order.
+    BasecallingChunk() : Chunk(0, 0) {}
+
+    void reset(BasecallingRead *owner, size_t offset, size_t chunk_in_read_idx, size_t chunk_size) {
+        input_offset = offset;
+        raw_chunk_size = chunk_size;
+        owning_read = owner;
+        idx_in_read = chunk_in_read_idx;
+    }
+
+    // The read this chunk belongs to. Owned by m_working_reads, which keeps it alive until all of
+    // its chunks have been called.
+    BasecallingRead *owning_read = nullptr;
+    size_t idx_in_read = 0;  // Slot of this chunk in the read's called_chunks.
 };
 
 struct BasecallerNode::BasecallingRead {
-    Message read;                                                  // The read itself.
-    std::vector<std::unique_ptr<BasecallingChunk>> called_chunks;  // Vector of basecalled chunks.
+    Message read;  // The read itself.
+    // Basecalled chunks, indexed by BasecallingChunk::idx_in_read.
+    std::vector<std::unique_ptr<BasecallingChunk>> called_chunks;
     std::atomic_size_t num_chunks_called;  // Number of chunks which have been basecalled.
 };
 
+// Recycles chunks, so that reads don't allocate and free a chunk object for every chunk. Chunks
+// are taken and given back a whole read at a time, so the lock is only held once per read on each
+// side.
+class BasecallerNode::ChunkPool {
+public:
+    explicit ChunkPool(size_t max_free_chunks) : m_max_free_chunks(max_free_chunks) {}
+
+    // Appends |num_chunks| chunks to |chunks|, reusing free chunks before allocating new ones.
+    void acquire(size_t num_chunks, std::vector<std::unique_ptr<BasecallingChunk>> &chunks) {
+        size_t num_reused = 0;
+        {
+            std::lock_guard lock(m_mutex);
+            num_reused = std::min(num_chunks, m_free_chunks.size());
+            const auto reused_begin = std::prev(m_free_chunks.end(), num_reused);
+            std::move(reused_begin, m_free_chunks.end(), std::back_inserter(chunks));
+            m_free_chunks.erase(reused_begin, m_free_chunks.end());
+            m_num_free = m_free_chunks.size();
+        }
+        for (size_t i = num_reused; i < num_chunks; ++i) {
+            chunks.emplace_back(std::make_unique<BasecallingChunk>());
+        }
+        m_num_in_use += num_chunks;
+        m_num_reused += num_reused;
+        m_num_allocated += num_chunks - num_reused;
+    }
+
+    // Returns all of |chunks| to the pool, freeing any beyond the pool's capacity, and empties it.
+    void release(std::vector<std::unique_ptr<BasecallingChunk>> &chunks) {
+        m_num_in_use -= chunks.size();
+        // The results are replaced by the decoder's buffers on the next use, so don't hold on to
+        // them while the chunk is free.
+        for (auto &chunk : chunks) {
+            chunk->seq = {};
+            chunk->qstring = {};
+            chunk->moves = {};
+        }
+        {
+            std::lock_guard lock(m_mutex);
+            const size_t num_to_keep =
+                    std::min(chunks.size(), m_max_free_chunks - m_free_chunks.size());
+            std::move(chunks.begin(), std::next(chunks.begin(), num_to_keep),
+                      std::back_inserter(m_free_chunks));
+            m_num_free = m_free_chunks.size();
+        }
+        // Chunks which didn't fit are destroyed here, outside the lock.
+        chunks.clear();
+    }
+
+    void add_stats(stats::NamedStats &stats) const {
+        stats["chunk_pool_free"] = double(m_num_free);
+        stats["chunk_pool_in_use"] = double(m_num_in_use);
+        stats["chunk_pool_allocated"] = double(m_num_allocated);
+        stats["chunk_pool_reused"] = double(m_num_reused);
+    }
+
+private:
+    const size_t m_max_free_chunks;
+
+    std::mutex m_mutex;
+    std::vector<std::unique_ptr<BasecallingChunk>> m_free_chunks;
+
+    std::atomic<int64_t> m_num_free = 0;
+    std::atomic<int64_t> m_num_in_use = 0;
+    std::atomic<int64_t> m_num_allocated = 0;
+    std::atomic<int64_t> m_num_reused = 0;
+};
+
 struct BasecallerNode::BatchedChunks {
     BatchedChunks(int id) : worker_id(id) { reset(); }
 
@@ -96,6 +168,8 @@ size_t BasecallerNode::get_chunk_queue_idx(size_t read_raw_size) {
 void BasecallerNode::input_thread_fn() {
     at::InferenceMode inference_mode_guard;
 
+    std::vector<std::unique_ptr<BasecallingChunk>> read_chunks;
+
     Message message;
     while (get_input_message(message)) {
         // If this message isn't a read, just forward it to the sink.
@@ -125,29 +199,30 @@ void BasecallerNode::input_thread_fn() {
         const std::size_t chunk_queue_idx = get_chunk_queue_idx(raw_size);
         const std::size_t chunk_size = m_chunk_sizes[chunk_queue_idx];
 
-        auto working_read = std::make_shared<BasecallingRead>();
-        std::vector<std::unique_ptr<BasecallingChunk>> read_chunks;
+        auto working_read = std::make_unique<BasecallingRead>();
+        read_chunks.clear();
 
         if (m_variable_chunk_sizes) {
             const std::vector<std::pair<std::size_t, std::size_t>> intervals =
                     utils::generate_variable_chunks(raw_size, chunk_size, m_model_stride,
                                                     m_overlap);
 
+            m_chunk_pool->acquire(std::size(intervals), read_chunks);
             for (std::size_t i = 0; i < std::size(intervals); ++i) {
-                read_chunks.emplace_back(std::make_unique<BasecallingChunk>(
-                        working_read, intervals[i].first, i,
-                        intervals[i].second - intervals[i].first));
+                read_chunks[i]->reset(working_read.get(), intervals[i].first, i,
+                                      intervals[i].second - intervals[i].first);
             }
         } else {
             const std::vector<std::size_t> offsets =
                     utils::generate_chunks(raw_size, chunk_size, m_model_stride, m_overlap);
 
+            m_chunk_pool->acquire(std::size(offsets), read_chunks);
             for (std::size_t i = 0; i < std::size(offsets); ++i) {
-                read_chunks.emplace_back(std::make_unique<BasecallingChunk>(
-                        working_read, offsets[i], i, chunk_size));
+                read_chunks[i]->reset(working_read.get(), offsets[i], i, chunk_size);
             }
         }
 
+        // Called chunks are put back in their slots by working_reads_manager().
         working_read->called_chunks.resize(std::size(read_chunks));
         working_read->num_chunks_called.store(0);
         working_read->read = std::move(message);
@@ -157,7 +232,8 @@ void BasecallerNode::input_thread_fn() {
             std::lock_guard working_reads_lock(m_working_reads_mutex);
             m_working_reads_signal_bytes +=
                     get_read_common_data(working_read->read).raw_data.nbytes();
-            m_working_reads.insert(std::move(working_read));
+            BasecallingRead *const working_read_key = working_read.get();
+            m_working_reads.emplace(working_read_key, std::move(working_read));
             ++m_working_reads_size;
         }
 
@@ -182,6 +258,8 @@ void BasecallerNode::basecall_current_batch(BatchedChunks &current_batch) {
     auto decode_results = model_runner->call_chunks(int(batched_chunks.size()));
     m_call_chunks_ms += timer.GetElapsedMS();
 
+    // Take over the decoder's buffers rather than copying them. stitch_chunks() then copies each
+    // chunk's contribution straight into the read.
     for (size_t i = 0; i < batched_chunks.size(); i++) {
         batched_chunks[i]->seq = std::move(decode_results[i].sequence);
         batched_chunks[i]->qstring = std::move(decode_results[i].qstring);
@@ -212,7 +290,7 @@ void BasecallerNode::working_reads_manager() {
     while (m_processed_chunks.try_pop(chunk) == utils::AsyncQueueStatus::Success) {
         nvtx3::scoped_range loop{"working_reads_manager"};
 
-        auto working_read = std::move(chunk->owning_read);
+        BasecallingRead *const working_read = chunk->owning_read;
         auto idx_in_read = chunk->idx_in_read;
         working_read->called_chunks[idx_in_read] = std::move(chunk);
         auto num_chunks_called = ++working_read->num_chunks_called;
@@ -245,8 +323,8 @@ void BasecallerNode::working_reads_manager() {
             m_num_bases_processed += read_common_data.seq.length();
             m_num_samples_processed += read_common_data.get_raw_data_samples();
 
-            // Chunks have ownership of the working read, so destroy them to avoid a leak.
-            working_read->called_chunks.clear();
+            // Hand the chunks back for the next reads.
+            m_chunk_pool->release(working_read->called_chunks);
 
             // Trim reads which are affected by mux change and unblocking
             // Needs to be done before we reverse the sequence for RNA, as we want
@@ -477,7 +555,7 @@ BasecallerNode::BasecallerNode(std::vector<basecall::RunnerPtr> model_runners,
                                size_t max_reads,
                                std::string node_name,
                                uint32_t read_mean_qscore_start_pos)
-        : MessageSink(max_reads, 1),
+        : MessageSink(max_reads, 1, utils::AsyncQueueBackend::LockFree),
           m_model_runners(std::move(model_runners)),
           m_overlap(overlap),
           m_model_stride(m_model_runners.front()->config().stride),
@@ -485,6 +563,8 @@ BasecallerNode::BasecallerNode(std::vector<basecall::RunnerPtr> model_runners,
           m_model_name(std::move(model_name)),
           m_mean_qscore_start_pos(read_mean_qscore_start_pos),
           m_variable_chunk_sizes(m_model_runners.front()->variable_chunk_sizes()),
+          // Enough free chunks to refill every chunk queue and the processed chunks.
+          m_chunk_pool(std::make_unique<ChunkPool>(2 * CalcMaxChunksIn(m_model_runners))),
           m_processed_chunks(CalcMaxChunksIn(m_model_runners)),
           m_node_name(std::move(node_name)) {
     for (auto &runner_ptr : m_model_runners) {
@@ -603,6 +683,7 @@ stats::NamedStats BasecallerNode::sample_stats() const {
         stats.merge(stats::from_obj(*chunk_queue));
     }
     stats.merge(stats::from_obj(m_processed_chunks));
+    m_chunk_pool->add_stats(stats);
     stats["batches_called"] = double(m_num_batches_called);
     stats["partial_batches_called"] = double(m_num_partial_batches_called);
     stats["call_chunks_ms"] = double(m_call_chunks_ms);
@@ -0,0 +1,43 @@
+#include "read_pipeline/nodes/CorrectionOverlapStoreWriterNode.h"
+
+#include "correct/overlap_store.h"
+
+namespace dorado {
+
+CorrectionOverlapStoreWriterNode::CorrectionOverlapStoreWriterNode(
+        const std::filesystem::path &path)
+        : MessageSink(10000, 1), m_writer(std::make_unique<correction::OverlapStoreWriter>(path)) {}
+
+CorrectionOverlapStoreWriterNode::~CorrectionOverlapStoreWriterNode() {
+    stop_input_processing(utils::AsyncQueueTerminateFast::Yes);
+}
+
+std::string CorrectionOverlapStoreWriterNode::get_name() const {
+    return "CorrectionOverlapStoreWriterNode";
+}
+
+void CorrectionOverlapStoreWriterNode::input_thread_fn() {
+    Message message;
+    while (get_input_message(message)) {
+        const auto *alignments_ptr = std::get_if<CorrectionAlignmentsPtr>(&message);
+        if (!alignments_ptr) {
+            continue;
+        }
+        m_writer->add(**alignments_ptr);
+    }
+}
+
+void CorrectionOverlapStoreWriterNode::terminate(const TerminateOptions &terminate_options) {
+    stop_input_processing(terminate_options.fast);
+    // A fast termination drops queued alignments, so leave the store unfinished rather than
+    // incomplete.
+    if (terminate_options.fast == utils::AsyncQueueTerminateFast::No) {
+        m_writer->finalise();
+    }
+}
+
+void CorrectionOverlapStoreWriterNode::restart() {
+    start_input_processing([this] { input_thread_fn(); }, "ovl_writer");
+}
+
+}  // namespace dorado
@@ -18,9 +18,13 @@ const int kMaxTimeDeltaMs = 10000;
 const int kMinOverlapLength = 50;
 const int kMinSeqLength = 500;
 const float kMinSimplexQScore = 8.f;
+// Enough that a few dozen pairing threads spread over a flowcell's worth of pores rarely meet.
+const size_t kNumCacheShards = 32;
 
 size_t read_signal_bytes(const dorado::SimplexRead& read) {
-    return read.read_common.raw_data.nbytes();
+    // Stubs whose signal has been parked don't hold any.
+    const auto& raw_data = read.read_common.raw_data;
+    return raw_data.defined() ? raw_data.nbytes() : 0;
 }
 
 // There are 4 different cases to consider when checking for adjacent reads -
@@ -64,6 +68,242 @@ std::map<std::string, std::string> build_complement_template_map(
 
 namespace dorado {
 
+struct PairingNode::CachedRead {
+    SimplexReadPtr read;
+    SignalStore::ParkedSignal parked_signal;
+};
+
+// A circular buffer of reads kept sorted by start time.  Reads mostly arrive in time order, so
+// inserts are usually appends, and evicting the oldest read doesn't move the others.
+class PairingNode::ReadRing {
+public:
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+    CachedRead& operator[](size_t i) { return m_slots[(m_head + i) & (m_slots.size() - 1)]; }
+    const CachedRead& operator[](size_t i) const {
+        return m_slots[(m_head + i) & (m_slots.size() - 1)];
+    }
+
+    // The index of the first read that doesn't start before |start_time_ms|.
+    size_t lower_bound(uint64_t start_time_ms) const {
+        size_t first = 0;
+        size_t count = m_size;
+        // Check the back first, since that's where most reads go.
+        if (count == 0 || (*this)[count - 1].read->read_common.start_time_ms < start_time_ms) {
+            return count;
+        }
+        while (count > 0) {
+            const size_t step = count / 2;
+            if ((*this)[first + step].read->read_common.start_time_ms < start_time_ms) {
+                first += step + 1;
+                count -= step + 1;
+            } else {
+                count = step;
+            }
+        }
+        return first;
+    }
+
+    void insert(size_t pos, CachedRead read) {
+        if (m_size == m_slots.size()) {
+            grow();
+        }
+        for (size_t i = m_size; i > pos; --i) {
+            (*this)[i] = std::move((*this)[i - 1]);
+        }
+        (*this)[pos] = std::move(read);
+        ++m_size;
+    }
+
+    CachedRead pop_front() {
+        auto read = std::move((*this)[0]);
+        m_head = (m_head + 1) & (m_slots.size() - 1);
+        --m_size;
+        return read;
+    }
+
+private:
+    void grow() {
+        std::vector<CachedRead> slots(std::max<size_t>(4, 2 * m_slots.size()));
+        for (size_t i = 0; i < m_size; ++i) {
+            slots[i] = std::move((*this)[i]);
+        }
+        m_slots = std::move(slots);
+        m_head = 0;
+    }
+
+    // Always a power of 2 in size, or empty.
+    std::vector<CachedRead> m_slots;
+    size_t m_head{0};
+    size_t m_size{0};
+};
+
+struct PairingNode::CacheShard {
+    std::mutex mutex;
+    std::unordered_map<PoreKey, ReadRing, PoreKeyHash> pores;
+
+    // Track reads which need to be emptied from the cache but are still being
+    // evaluated for pairs by other threads.
+    std::unordered_map<const SimplexRead*, int> reads_in_flight_ctr;
+    std::unordered_map<const SimplexRead*, CachedRead> reads_to_clear;
+
+    // Stats, updated under the lock.
+    std::atomic<size_t> num_pores{0};
+    std::atomic<size_t> num_reads{0};
+    std::atomic<uint64_t> lock_acquisitions{0};
+    std::atomic<uint64_t> contended_locks{0};
+
+    std::unique_lock<std::mutex> lock() {
+        lock_acquisitions.fetch_add(1, std::memory_order_relaxed);
+        std::unique_lock<std::mutex> guard(mutex, std::try_to_lock);
+        if (!guard.owns_lock()) {
+            contended_locks.fetch_add(1, std::memory_order_relaxed);
+            guard.lock();
+        }
+        return guard;
+    }
+
+    // Moves every read of |pore| to reads_to_clear.  Must be called with the lock held.
+    void retire_pore(std::unordered_map<PoreKey, ReadRing, PoreKeyHash>::iterator pore,
+                     std::atomic<size_t>& cache_signal_bytes) {
+        auto& reads = pore->second;
+        num_reads -= reads.size();
+        while (!reads.empty()) {
+            auto cached = reads.pop_front();
+            cache_signal_bytes -= read_signal_bytes(*cached.read);
+            const SimplexRead* read_ptr = cached.read.get();
+            reads_to_clear.emplace(read_ptr, std::move(cached));
+        }
+        pores.erase(pore);
+        --num_pores;
+    }
+
+    // Moves the reads to clear that aren't being evaluated by any thread to |cleared|.
+    // Must be called with the lock held.
+    void take_cleared_reads(std::vector<CachedRead>& cleared) {
+        for (auto to_clear_itr = reads_to_clear.begin(); to_clear_itr != reads_to_clear.end();) {
+            auto in_flight_itr = reads_in_flight_ctr.find(to_clear_itr->first);
+            bool ok_to_clear = false;
+            // If a read to clear is not in-flight (not in the in-flight list
+            // or in-flight counter is 0), then clear it
+            // from the cache.
+            if (in_flight_itr == reads_in_flight_ctr.end()) {
+                ok_to_clear = true;
+            } else if (in_flight_itr->second == 0) {
+                reads_in_flight_ctr.erase(in_flight_itr);
+                ok_to_clear = true;
+            }
+            if (ok_to_clear) {
+                cleared.push_back(std::move(to_clear_itr->second));
+                to_clear_itr = reads_to_clear.erase(to_clear_itr);
+            } else {
+                ++to_clear_itr;
+            }
+        }
+    }
+};
+
+size_t PairingNode::PoreKeyHash::operator()(const PoreKey& key) const {
+    // Channels are dense small integers, so mix them before they pick a shard.
+    uint64_t h = (uint64_t(uint32_t(key.channel)) << 32) | key.run_key;
+    h ^= uint64_t(uint32_t(key.client_id)) * 0x9e3779b97f4a7c15ULL;
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    return size_t(h);
+}
+
+uint32_t PairingNode::intern_run(const std::string& run_id, const std::string& flowcell_id) {
+    {
+        std::shared_lock lock(m_run_keys_mutex);
+        auto run_it = m_run_keys.find(run_id);
+        if (run_it != m_run_keys.end()) {
+            auto flowcell_it = run_it->second.find(flowcell_id);
+            if (flowcell_it != run_it->second.end()) {
+                return flowcell_it->second;
+            }
+        }
+    }
+    std::unique_lock lock(m_run_keys_mutex);
+    auto [it, inserted] = m_run_keys[run_id].try_emplace(flowcell_id, m_num_run_keys);
+    if (inserted) {
+        ++m_num_run_keys;
+    }
+    return it->second;
+}
+
+PairingNode::CacheShard& PairingNode::shard_for(const PoreKey& key) const {
+    return m_cache_shards[PoreKeyHash{}(key) % kNumCacheShards];
+}
+
+// Records a newly cached pore, and if that takes its client over m_max_num_keys pores, retires
+// the client's oldest pore.
+void PairingNode::track_new_pore(const PoreKey& key, std::vector<CachedRead>& reads_to_send) {
+    std::lock_guard order_lock(m_pore_order_mutex);
+    auto& pore_order = m_pore_order[key.client_id];
+    pore_order.push_back(key);
+    if (pore_order.size() <= m_max_num_keys) {
+        return;
+    }
+
+    // Remove the oldest key (front of the list)
+    const auto oldest_key = pore_order.front();
+    pore_order.pop_front();
+    auto& shard = shard_for(oldest_key);
+    auto lock = shard.lock();
+    auto oldest_key_it = shard.pores.find(oldest_key);
+    if (oldest_key_it != shard.pores.end()) {
+        shard.retire_pore(oldest_key_it, m_cache_signal_bytes);
+    }
+    shard.take_cleared_reads(reads_to_send);
+}
+
+void PairingNode::flush_client(int32_t client_id) {
+    {
+        std::lock_guard order_lock(m_pore_order_mutex);
+        m_pore_order.erase(client_id);
+    }
+    std::vector<CachedRead> reads_to_send;
+    for (size_t i = 0; i < kNumCacheShards; ++i) {
+        auto& shard = m_cache_shards[i];
+        auto lock = shard.lock();
+        for (auto it = shard.pores.begin(); it != shard.pores.end();) {
+            if (it->first.client_id == client_id) {
+                shard.retire_pore(it++, m_cache_signal_bytes);
+            } else {
+                ++it;
+            }
+        }
+        shard.take_cleared_reads(reads_to_send);
+        lock.unlock();
+        send_reads_to_sink(reads_to_send);
+    }
+}
+
+void PairingNode::send_reads_to_sink(std::vector<CachedRead>& reads) {
+    for (auto& cached : reads) {
+        if (cached.parked_signal) {
+            cached.read->read_common.raw_data = m_signal_store->restore(*cached.parked_signal);
+            m_parked_signal_bytes -= cached.parked_signal->stored_bytes();
+        }
+        send_message_to_sink(std::move(cached.read));
+    }
+    reads.clear();
+}
+
+ReadPair::ReadData PairingNode::read_data_for_pair(const SimplexRead& read,
+                                                   const SignalStore::ParkedSignal& parked_signal,
+                                                   uint64_t seq_start,
+                                                   uint64_t seq_end) const {
+    auto data = ReadPair::ReadData::from_read(read, seq_start, seq_end);
+    if (parked_signal) {
+        // The stereo encoder needs the signal, but the read itself stays a stub while cached.
+        data.read_common.raw_data = m_signal_store->restore(*parked_signal);
+    }
+    return data;
+}
+
 // Determine whether 2 proposed reads form a duplex pair or not.
 // The algorithm utilizes the following heuristics to make a decision -
 // 1. Reads must be within 1000ms of each other, and the ratio of their
@@ -258,25 +498,13 @@ void PairingNode::pair_generating_worker_thread(int tid) {
     utils::set_thread_name("pair_gen_thrd");
     at::InferenceMode inference_mode_guard;
 
-    auto compare_reads_by_time = [](const SimplexReadPtr& read1, const SimplexReadPtr& read2) {
-        return read1->read_common.start_time_ms < read2->read_common.start_time_ms;
-    };
+    const bool track_pore_order = m_max_num_keys != std::numeric_limits<size_t>::max();
+    std::vector<CachedRead> reads_to_send;
 
     Message message;
     while (get_input_message(message)) {
         if (std::holds_alternative<CacheFlushMessage>(message)) {
-            std::unique_lock<std::mutex> lock(m_read_caches_mutex);
-            auto flush_message = std::get<CacheFlushMessage>(message);
-            auto& read_cache = m_read_caches[flush_message.client_id];
-            for (auto& [key, reads_list] : read_cache.channel_read_map) {
-                // kv is a std::pair<UniquePoreIdentifierKey, std::list<std::shared_ptr<Read>>>
-                for (auto& read_ptr : reads_list) {
-                    // Push each read message
-                    m_cache_signal_bytes -= read_signal_bytes(*read_ptr);
-                    send_message_to_sink(std::move(read_ptr));
-                }
-            }
-            m_read_caches.erase(flush_message.client_id);
+            flush_client(std::get<CacheFlushMessage>(message).client_id);
             continue;
         }
 
@@ -291,143 +519,116 @@ void PairingNode::pair_generating_worker_thread(int tid) {
         // If this message isn't a read, we'll get a bad_variant_access exception.
         auto read = std::get<SimplexReadPtr>(std::move(message));
 
-        int channel = read->read_common.attributes.channel_number;
-        std::string run_id = read->read_common.run_id;
-        std::string flowcell_id = read->read_common.flowcell_id;
-        int32_t client_id = read->read_common.client_info->client_id();
-
-        std::unique_lock<std::mutex> lock(m_read_caches_mutex);
-
-        auto& read_cache = m_read_caches[client_id];
-        UniquePoreIdentifierKey key = std::make_tuple(channel, run_id, flowcell_id);
-        auto read_list_iter = read_cache.channel_read_map.find(key);
-        // Check if the key is already in the list
-        if (read_list_iter == read_cache.channel_read_map.end()) {
-            // Key is not in the dequeue
-            // Add the new key to the end of the list
-            {
-                read_cache.working_channel_keys.push_back(key);
-                std::list<SimplexReadPtr> reads;
-                m_cache_signal_bytes += read_signal_bytes(*read);
-                reads.push_back(std::move(read));
-                read_cache.channel_read_map.emplace(key, std::move(reads));
-            }
+        // Park the signal before taking any lock, leaving a stub for the cache.
+        SignalStore::ParkedSignal parked_signal;
+        if (m_signal_store && read->read_common.raw_data.defined()) {
+            parked_signal = m_signal_store->park(read->read_common.raw_data);
+            read->read_common.raw_data = at::Tensor();
+            m_parked_signal_bytes += parked_signal->stored_bytes();
+        }
 
-            if (read_cache.working_channel_keys.size() > m_max_num_keys) {
-                // Remove the oldest key (front of the list)
-                auto oldest_key = read_cache.working_channel_keys.front();
-                read_cache.working_channel_keys.pop_front();
+        const PoreKey key{read->read_common.client_info->client_id(),
+                          read->read_common.attributes.channel_number,
+                          intern_run(read->read_common.run_id, read->read_common.flowcell_id)};
+        auto& shard = shard_for(key);
+        auto lock = shard.lock();
 
-                auto oldest_key_it = read_cache.channel_read_map.find(oldest_key);
+        auto [pore_it, new_pore] = shard.pores.try_emplace(key);
+        if (new_pore) {
+            ++shard.num_pores;
+        }
+        auto& cached_reads = pore_it->second;
+
+        // It's safe to take raw pointers of these reads since their ownership isn't released from this
+        // node until their counter in |reads_in_flight_ctr| hits 0.
+        SimplexRead* later_read = nullptr;
+        SimplexRead* earlier_read = nullptr;
+        SignalStore::ParkedSignal later_parked_signal;
+        SignalStore::ParkedSignal earlier_parked_signal;
+
+        const size_t later_read_idx = cached_reads.lower_bound(read->read_common.start_time_ms);
+        if (later_read_idx != cached_reads.size()) {
+            later_read = cached_reads[later_read_idx].read.get();
+            later_parked_signal = cached_reads[later_read_idx].parked_signal;
+            shard.reads_in_flight_ctr[later_read]++;
+        }
+        if (later_read_idx != 0) {
+            earlier_read = cached_reads[later_read_idx - 1].read.get();
+            earlier_parked_signal = cached_reads[later_read_idx - 1].parked_signal;
+            shard.reads_in_flight_ctr[earlier_read]++;
+        }
 
-                // Remove the oldest key from the map
-                for (auto& read_ptr : oldest_key_it->second) {
-                    m_cache_signal_bytes -= read_signal_bytes(*read_ptr);
-                    m_reads_to_clear.insert(std::move(read_ptr));
-                }
-                read_cache.channel_read_map.erase(oldest_key);
-                assert(read_cache.channel_read_map.size() ==
-                       read_cache.working_channel_keys.size());
-            }
-        } else {
-            auto& cached_read_list = read_list_iter->second;
-            // It's safe to take raw pointers of these reads since their ownership isn't released from this
-            // node until their counter in |m_reads_in_flight_ctr| hits 0.
-            SimplexRead* later_read = nullptr;
-            SimplexRead* earlier_read = nullptr;
-
-            auto later_read_iter = std::lower_bound(
-                    cached_read_list.begin(), cached_read_list.end(), read, compare_reads_by_time);
-            if (later_read_iter != cached_read_list.end()) {
-                later_read = later_read_iter->get();
-                m_reads_in_flight_ctr[later_read]++;
-            }
+        SimplexRead* const read_ptr = read.get();
+        m_cache_signal_bytes += read_signal_bytes(*read);
+        cached_reads.insert(later_read_idx, CachedRead{std::move(read), parked_signal});
+        ++shard.num_reads;
+        shard.reads_in_flight_ctr[read_ptr]++;
+
+        while (cached_reads.size() > m_max_num_reads) {
+            auto cached_read = cached_reads.pop_front();
+            m_cache_signal_bytes -= read_signal_bytes(*cached_read.read);
+            --shard.num_reads;
+            const SimplexRead* evicted_ptr = cached_read.read.get();
+            shard.reads_to_clear.emplace(evicted_ptr, std::move(cached_read));
+        }
 
-            if (later_read_iter != cached_read_list.begin()) {
-                earlier_read = std::prev(later_read_iter)->get();
-                m_reads_in_flight_ctr[earlier_read]++;
-            }
+        // Release mutex around read cache to run pair evaluations.
+        lock.unlock();
 
-            SimplexRead* const read_ptr = read.get();
-            m_cache_signal_bytes += read_signal_bytes(*read);
-            cached_read_list.insert(later_read_iter, std::move(read));
-            m_reads_in_flight_ctr[read_ptr]++;
+        if (new_pore && track_pore_order) {
+            track_new_pore(key, reads_to_send);
+            send_reads_to_sink(reads_to_send);
+        }
 
-            while (cached_read_list.size() > m_max_num_reads) {
-                m_cache_signal_bytes -= read_signal_bytes(*cached_read_list.front());
-                auto cached_read = std::move(cached_read_list.front());
-                cached_read_list.pop_front();
-                m_reads_to_clear.insert(std::move(cached_read));
+        if (later_read) {
+            auto [is_pair, qs, qe, rs, re] =
+                    is_within_time_and_length_criteria(*read_ptr, *later_read, tid);
+            if (is_pair) {
+                auto pair = std::make_unique<ReadPair>();
+                pair->template_read = read_data_for_pair(*read_ptr, parked_signal, qs, qe);
+                pair->complement_read =
+                        read_data_for_pair(*later_read, later_parked_signal, rs, re);
+
+                read_ptr->is_duplex_parent = true;
+                later_read->is_duplex_parent = true;
+                ++read_ptr->num_duplex_candidate_pairs;
+                send_message_to_sink(std::move(pair));
             }
+        }
 
-            // Release mutex around read cache to run pair evaluations.
-            lock.unlock();
-
-            if (later_read) {
-                auto [is_pair, qs, qe, rs, re] =
-                        is_within_time_and_length_criteria(*read_ptr, *later_read, tid);
-                if (is_pair) {
-                    auto pair = std::make_unique<ReadPair>();
-                    pair->template_read = ReadPair::ReadData::from_read(*read_ptr, qs, qe);
-                    pair->complement_read = ReadPair::ReadData::from_read(*later_read, rs, re);
-
-                    read_ptr->is_duplex_parent = true;
-                    later_read->is_duplex_parent = true;
-                    ++read_ptr->num_duplex_candidate_pairs;
-                    send_message_to_sink(std::move(pair));
-                }
-            }
-
-            if (earlier_read) {
-                auto [is_pair, qs, qe, rs, re] =
-                        is_within_time_and_length_criteria(*earlier_read, *read_ptr, tid);
-                if (is_pair) {
-                    auto pair = std::make_unique<ReadPair>();
-                    pair->template_read = ReadPair::ReadData::from_read(*earlier_read, qs, qe);
-                    pair->complement_read = ReadPair::ReadData::from_read(*read_ptr, rs, re);
-
-                    earlier_read->is_duplex_parent = true;
-                    read_ptr->is_duplex_parent = true;
-                    ++earlier_read->num_duplex_candidate_pairs;
-                    send_message_to_sink(std::move(pair));
-                }
+        if (earlier_read) {
+            auto [is_pair, qs, qe, rs, re] =
+                    is_within_time_and_length_criteria(*earlier_read, *read_ptr, tid);
+            if (is_pair) {
+                auto pair = std::make_unique<ReadPair>();
+                pair->template_read =
+                        read_data_for_pair(*earlier_read, earlier_parked_signal, qs, qe);
+                pair->complement_read = read_data_for_pair(*read_ptr, parked_signal, rs, re);
+
+                earlier_read->is_duplex_parent = true;
+                read_ptr->is_duplex_parent = true;
+                ++earlier_read->num_duplex_candidate_pairs;
+                send_message_to_sink(std::move(pair));
             }
+        }
 
-            // Acquire read cache lock again to decrement in flight read counters.
-            lock.lock();
+        // Acquire read cache lock again to decrement in flight read counters.
+        lock = shard.lock();
 
-            // Decrement in-flight counter for each read.
-            m_reads_in_flight_ctr[read_ptr]--;
-            if (earlier_read) {
-                m_reads_in_flight_ctr[earlier_read]--;
-            }
-            if (later_read) {
-                m_reads_in_flight_ctr[later_read]--;
-            }
+        // Decrement in-flight counter for each read.
+        shard.reads_in_flight_ctr[read_ptr]--;
+        if (earlier_read) {
+            shard.reads_in_flight_ctr[earlier_read]--;
+        }
+        if (later_read) {
+            shard.reads_in_flight_ctr[later_read]--;
         }
 
         // Once pairs have been evaluated, check if any of the in-flight reads
         // need to be purged from the cache.
-        for (auto to_clear_itr = m_reads_to_clear.begin();
-             to_clear_itr != m_reads_to_clear.end();) {
-            auto in_flight_itr = m_reads_in_flight_ctr.find(to_clear_itr->get());
-            bool ok_to_clear = false;
-            // If a read to clear is not in-flight (not in the in-flight list
-            // or in-flight counter is 0), then clear it
-            // from the cache.
-            if (in_flight_itr == m_reads_in_flight_ctr.end()) {
-                ok_to_clear = true;
-            } else if (in_flight_itr->second.load() == 0) {
-                m_reads_in_flight_ctr.erase(in_flight_itr);
-                ok_to_clear = true;
-            }
-            if (ok_to_clear) {
-                auto read_handle = m_reads_to_clear.extract(*to_clear_itr++);
-                send_message_to_sink(std::move(read_handle.value()));
-            } else {
-                ++to_clear_itr;
-            }
-        }
+        shard.take_cleared_reads(reads_to_send);
+        lock.unlock();
+        send_reads_to_sink(reads_to_send);
     }
 }
 
@@ -437,7 +638,8 @@ PairingNode::PairingNode(std::map<std::string, std::string> template_complement_
         : MessageSink(max_reads, 0),
           m_num_worker_threads(num_worker_threads),
           m_template_complement_map(std::move(template_complement_map)),
-          m_complement_template_map(build_complement_template_map(m_template_complement_map)) {
+          m_complement_template_map(build_complement_template_map(m_template_complement_map)),
+          m_cache_shards(std::make_unique<CacheShard[]>(kNumCacheShards)) {
     m_pairing_func = &PairingNode::pair_list_worker_thread;
 }
 
@@ -446,6 +648,7 @@ PairingNode::PairingNode(DuplexPairingParameters pairing_params,
                          size_t max_reads)
         : MessageSink(max_reads, 0),
           m_num_worker_threads(num_worker_threads),
+          m_cache_shards(std::make_unique<CacheShard[]>(kNumCacheShards)),
           m_max_num_keys(std::numeric_limits<size_t>::max()),
           m_max_num_reads(std::numeric_limits<size_t>::max()) {
     switch (pairing_params.read_order) {
@@ -467,6 +670,20 @@ PairingNode::PairingNode(DuplexPairingParameters pairing_params,
         throw std::runtime_error("Unsupported read order detected: " +
                                  dorado::to_string(pairing_params.read_order));
     }
+    switch (pairing_params.signal_storage) {
+    case PairingSignalStorage::RESIDENT:
+        break;
+    case PairingSignalStorage::COMPRESSED:
+        m_signal_store = std::make_unique<SignalStore>(SignalStore::Mode::COMPRESSED,
+                                                       std::filesystem::path{});
+        spdlog::debug("Parking duplex pairing cache signal in memory");
+        break;
+    case PairingSignalStorage::SPILL:
+        m_signal_store = std::make_unique<SignalStore>(SignalStore::Mode::SPILL,
+                                                       pairing_params.spill_dir);
+        spdlog::debug("Parking duplex pairing cache signal in spill files");
+        break;
+    }
     m_pairing_func = &PairingNode::pair_generating_worker_thread;
 }
 
@@ -509,22 +726,23 @@ void PairingNode::terminate(const TerminateOptions& terminate_options) {
     }
     m_workers.clear();
 
-    if (!terminate_options.preserve_pairing_caches) {
-        // There are still reads in channel_read_map. Push them to the sink.
-        for (auto& [client_id, read_cache] : m_read_caches) {
-            for (auto& kv : read_cache.channel_read_map) {
-                // kv is a std::pair<UniquePoreIdentifierKey, std::list<SimplexReadPtr>>
-                auto& reads_list = kv.second;
-                for (auto& read_ptr : reads_list) {
-                    m_cache_signal_bytes -= read_signal_bytes(*read_ptr);
-                    // Push each read message
-                    send_message_to_sink(std::move(read_ptr));
-                }
+    std::vector<CachedRead> reads_to_send;
+    for (size_t i = 0; i < kNumCacheShards; ++i) {
+        auto& shard = m_cache_shards[i];
+        // The workers have stopped, so nothing is in flight.
+        shard.reads_in_flight_ctr.clear();
+        if (!terminate_options.preserve_pairing_caches) {
+            // There are still reads in the cache. Push them to the sink.
+            while (!shard.pores.empty()) {
+                shard.retire_pore(shard.pores.begin(), m_cache_signal_bytes);
             }
         }
-        m_read_caches.clear();
+        shard.take_cleared_reads(reads_to_send);
+        send_reads_to_sink(reads_to_send);
+    }
+    if (!terminate_options.preserve_pairing_caches) {
+        m_pore_order.clear();
     }
-    m_reads_in_flight_ctr.clear();
 
     m_tbufs.clear();
 }
@@ -540,6 +758,31 @@ stats::NamedStats PairingNode::sample_stats() const {
     stats["overlap_accepted_pairs"] = m_overlap_accepted_pairs.load();
     stats["cached_signal_mb"] =
             static_cast<double>(m_cache_signal_bytes) / static_cast<double>(1024 * 1024);
+
+    if (m_pairing_func == &PairingNode::pair_generating_worker_thread) {
+        size_t total_pores = 0;
+        size_t total_reads = 0;
+        uint64_t total_acquisitions = 0;
+        uint64_t total_contended = 0;
+        for (size_t i = 0; i < kNumCacheShards; ++i) {
+            const auto& shard = m_cache_shards[i];
+            const auto num_reads = shard.num_reads.load(std::memory_order_relaxed);
+            const auto contended = shard.contended_locks.load(std::memory_order_relaxed);
+            const std::string prefix = "cache_shard_" + std::to_string(i) + ".";
+            stats[prefix + "reads"] = double(num_reads);
+            stats[prefix + "contended_locks"] = double(contended);
+            total_pores += shard.num_pores.load(std::memory_order_relaxed);
+            total_reads += num_reads;
+            total_acquisitions += shard.lock_acquisitions.load(std::memory_order_relaxed);
+            total_contended += contended;
+        }
+        stats["parked_signal_mb"] = static_cast<double>(m_parked_signal_bytes) /
+                                    static_cast<double>(1024 * 1024);
+        stats["cached_pores"] = double(total_pores);
+        stats["cached_reads"] = double(total_reads);
+        stats["cache_lock_acquisitions"] = double(total_acquisitions);
+        stats["cache_contended_locks"] = double(total_contended);
+    }
     return stats;
 }
 
@@ -1,12 +1,16 @@
 #include "read_pipeline/nodes/ReadForwarderNode.h"
 
+#include <vector>
+
 namespace dorado {
 
 void ReadForwarderNode::input_thread_fn() {
-    Message message;
-    while (get_input_message(message)) {
-        if (is_read_message(message)) {
-            m_message_callback(std::move(message));
+    std::vector<Message> messages;
+    while (get_input_messages(messages, DEFAULT_INPUT_BATCH_SIZE)) {
+        for (auto &message : messages) {
+            if (is_read_message(message)) {
+                m_message_callback(std::move(message));
+            }
         }
     }
 }
@@ -5,60 +5,68 @@
 #include <spdlog/spdlog.h>
 
 #include <algorithm>
+#include <vector>
 
 namespace dorado {
 
 void ReadToBamTypeNode::input_thread_fn() {
     at::InferenceMode inference_mode_guard;
 
-    Message message;
-    while (get_input_message(message)) {
-        // If this message isn't a read, just forward it to the sink.
-        if (!is_read_message(message)) {
-            send_message_to_sink(std::move(message));
-            continue;
+    std::vector<Message> messages;
+    std::vector<Message> bam_messages;
+    while (get_input_messages(messages, DEFAULT_INPUT_BATCH_SIZE)) {
+        bam_messages.clear();
+        for (auto& message : messages) {
+            // If this message isn't a read, just forward it to the sink.
+            if (!is_read_message(message)) {
+                bam_messages.push_back(std::move(message));
+                continue;
+            }
+
+            auto& read_common_data = get_read_common_data(message);
+
+            bool is_duplex_parent = false;
+            if (!read_common_data.is_duplex) {
+                is_duplex_parent = std::get<SimplexReadPtr>(message)->is_duplex_parent;
+            }
+
+            const bool is_status_pass =
+                    m_min_qscore > 0 ? (read_common_data.calculate_mean_qscore() >= m_min_qscore)
+                                     : true;
+
+            auto alns = read_common_data.extract_sam_lines(m_emit_moves, m_modbase_threshold,
+                                                           is_duplex_parent);
+
+            const HtsData::ReadAttributes read_attrs{
+                    std::move(read_common_data.sequencing_kit),
+                    std::move(read_common_data.experiment_id),
+                    std::move(read_common_data.sample_id),
+                    std::move(read_common_data.position_id),
+                    std::move(read_common_data.flowcell_id),
+                    std::move(read_common_data.run_id),
+                    std::move(read_common_data.acquisition_id),
+                    read_common_data.barcoding_result
+                            ? barcode_kits::normalize_barcode_name(
+                                      read_common_data.barcoding_result->barcode_name)
+                            : std::string(),
+                    read_common_data.barcoding_result ? read_common_data.barcoding_result->alias
+                                                      : std::string(),
+                    read_common_data.protocol_start_time_ms,
+                    read_common_data.subread_id,
+                    is_status_pass,
+                    read_common_data.start_time_ms,
+                    read_common_data.attributes.model_stride,
+            };
+
+            for (auto& aln : alns) {
+                auto hts_data = std::make_unique<HtsData>(
+                        HtsData{std::move(aln), read_attrs, read_common_data.barcoding_result});
+                BamMessage bam_msg{std::move(hts_data), read_common_data.client_info};
+                bam_messages.emplace_back(std::move(bam_msg));
+            }
         }
-
-        auto& read_common_data = get_read_common_data(message);
-
-        bool is_duplex_parent = false;
-        if (!read_common_data.is_duplex) {
-            is_duplex_parent = std::get<SimplexReadPtr>(message)->is_duplex_parent;
-        }
-
-        const bool is_status_pass =
-                m_min_qscore > 0 ? (read_common_data.calculate_mean_qscore() >= m_min_qscore)
-                                 : true;
-
-        auto alns = read_common_data.extract_sam_lines(m_emit_moves, m_modbase_threshold,
-                                                       is_duplex_parent);
-
-        const HtsData::ReadAttributes read_attrs{
-                std::move(read_common_data.sequencing_kit),
-                std::move(read_common_data.experiment_id),
-                std::move(read_common_data.sample_id),
-                std::move(read_common_data.position_id),
-                std::move(read_common_data.flowcell_id),
-                std::move(read_common_data.run_id),
-                std::move(read_common_data.acquisition_id),
-                read_common_data.barcoding_result
-                        ? barcode_kits::normalize_barcode_name(
-                                  read_common_data.barcoding_result->barcode_name)
-                        : std::string(),
-                read_common_data.barcoding_result ? read_common_data.barcoding_result->alias
-                                                  : std::string(),
-                read_common_data.protocol_start_time_ms,
-                read_common_data.subread_id,
-                is_status_pass,
-                read_common_data.start_time_ms,
-                read_common_data.attributes.model_stride,
-        };
-
-        for (auto& aln : alns) {
-            auto hts_data = std::make_unique<HtsData>(
-                    HtsData{std::move(aln), read_attrs, read_common_data.barcoding_result});
-            BamMessage bam_msg{std::move(hts_data), read_common_data.client_info};
-            send_message_to_sink(std::move(bam_msg));
+        if (!bam_messages.empty()) {
+            send_messages_to_sink(bam_messages);
         }
     }
 }
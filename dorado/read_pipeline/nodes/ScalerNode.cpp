@@ -7,6 +7,7 @@
 #include "torch_utils/trim.h"
 #include "utils/context_container.h"
 #include "utils/log_utils.h"
+#include "utils/signal_stats.h"
 
 #include <ATen/Functions.h>
 #include <ATen/TensorIndexing.h>
@@ -30,22 +31,21 @@ namespace {
 
 using namespace dorado::config;
 
-std::pair<float, float> med_mad(const at::Tensor& x) {
+std::pair<float, float> med_mad(const dorado::utils::SignalStats& stats) {
     // See https://en.wikipedia.org/wiki/Median_absolute_deviation
     //  (specifically the "Relation to standard deviation" section)
     constexpr float factor = 1.4826f;
     //Calculate signal median and median absolute deviation
-    auto med = x.median();
-    auto mad = at::median(at::abs(x - med)) * factor + EPS;
-    return {med.item<float>(), mad.item<float>()};
+    const float med = stats.median();
+    const float mad = stats.median_abs_deviation() * factor + EPS;
+    return {med, mad};
 }
 
-std::pair<float, float> normalisation(const QuantileScalingParams& params, const at::Tensor& x) {
+std::pair<float, float> normalisation(const QuantileScalingParams& params,
+                                      const dorado::utils::SignalStats& stats) {
     // Calculate shift and scale factors for normalisation.
-    auto quantiles =
-            dorado::utils::quantile_counting(x, at::tensor({params.quantile_a, params.quantile_b}));
-    float q_a = quantiles[0].item<float>();
-    float q_b = quantiles[1].item<float>();
+    float q_a = stats.quantile(params.quantile_a);
+    float q_b = stats.quantile(params.quantile_b);
     float shift = std::max(10.0f, params.shift_multiplier * (q_a + q_b));
     float scale = std::max(1.0f, params.scale_multiplier * (q_b - q_a));
     return {shift, scale};
@@ -76,11 +76,9 @@ int determine_rna_adapter_pos(const dorado::SimplexRead& read) {
     int break_point = 0;
     const int signal_start = 1000;
     const int signal_end = 3 * signal_len / 4;
+    dorado::utils::SlidingMedian sliding_median(signal, signal_len, kWindowSize);
     for (int i = signal_start; i < signal_end; i += kStride) {
-        auto slice = at::from_blob(const_cast<int16_t*>(&signal[i]),
-                                   {static_cast<int>(std::min(kWindowSize, signal_len - i))},
-                                   at::TensorOptions().dtype(at::kShort));
-        int16_t median = slice.median().item<int16_t>();
+        const int16_t median = sliding_median.median_at(i);
         medians[median_pos % medians.size()] = median;
         // Since the medians are stored in a circular buffer, we need
         // to store the actual window positions for the median values
@@ -144,6 +142,9 @@ namespace dorado {
 void ScalerNode::input_thread_fn() {
     at::InferenceMode inference_mode_guard;
 
+    // Reused for every read handled by this thread, so that scaling doesn't allocate.
+    utils::SignalStats signal_stats;
+
     Message message;
     while (get_input_message(message)) {
         // If this message isn't a Simplex read, just forward it to the sink.
@@ -215,12 +216,16 @@ void ScalerNode::input_thread_fn() {
             }
         } else {
             // Ignore the RNA adapter. If this is DNA or we've already trimmed the adapter, this will be zero
-            auto scaling_data = read->read_common.raw_data.index(
-                    {Slice(read->read_common.rna_adapter_end_signal_pos, at::indexing::None)});
+            assert(read->read_common.raw_data.is_contiguous());
+            const size_t num_samples = read->read_common.get_raw_data_samples();
+            const size_t adapter_end = std::min(
+                    static_cast<size_t>(read->read_common.rna_adapter_end_signal_pos), num_samples);
+            signal_stats.compute(read->read_common.raw_data.data_ptr<int16_t>() + adapter_end,
+                                 num_samples - adapter_end);
             std::tie(shift, scale) =
                     m_scaling_params.strategy == ScalingStrategy::QUANTILE
-                            ? normalisation(m_scaling_params.quantile, scaling_data)
-                            : med_mad(scaling_data);
+                            ? normalisation(m_scaling_params.quantile, signal_stats)
+                            : med_mad(signal_stats);
         }
 
         // raw_data comes from DataLoader with dtype int16.  We send it on as float16 after
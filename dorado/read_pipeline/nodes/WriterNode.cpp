@@ -12,7 +12,8 @@
 namespace dorado {
 
 WriterNode::WriterNode(std::vector<std::unique_ptr<hts_writer::IWriter>> writers)
-        : MessageSink(10000, 1), m_writers(std::move(writers)) {}
+        : MessageSink(10000, 1, utils::AsyncQueueBackend::LockFree),
+          m_writers(std::move(writers)) {}
 
 WriterNode::~WriterNode() { stop_input_processing(utils::AsyncQueueTerminateFast::Yes); }
 
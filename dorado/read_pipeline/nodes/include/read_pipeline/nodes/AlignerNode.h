@@ -50,8 +50,8 @@ public:
 private:
     void input_thread_fn();
     std::shared_ptr<const alignment::Minimap2Index> get_index(const ClientInfo& client_info);
-    std::shared_ptr<dorado::alignment::BedFile> get_bedfile(const ClientInfo& client_info,
-                                                            const std::string& bedfile);
+    std::shared_ptr<const dorado::alignment::BedFile> get_bedfile(const ClientInfo& client_info,
+                                                                  const std::string& bedfile);
     template <typename READ>
     void align_read(READ&& read);
 
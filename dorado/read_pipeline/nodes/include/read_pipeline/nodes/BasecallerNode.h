@@ -8,7 +8,7 @@
 #include <mutex>
 #include <string>
 #include <thread>
-#include <unordered_set>
+#include <unordered_map>
 #include <vector>
 
 namespace dorado {
@@ -22,6 +22,7 @@ class BasecallerNode final : public MessageSink {
     struct BasecallingRead;
     struct BasecallingChunk;
     struct BatchedChunks;
+    class ChunkPool;
 
 public:
     // Chunk size and overlap are in raw samples
@@ -76,8 +77,12 @@ private:
             m_chunk_in_queues;
 
     std::mutex m_working_reads_mutex;
-    // Reads removed from input queue and being basecalled.
-    std::unordered_set<std::shared_ptr<BasecallingRead>> m_working_reads;
+    // Reads removed from input queue and being basecalled, keyed by the address which their chunks
+    // refer to them by.
+    std::unordered_map<const BasecallingRead *, std::unique_ptr<BasecallingRead>> m_working_reads;
+
+    // Recycled chunks, shared by all reads.
+    std::unique_ptr<ChunkPool> m_chunk_pool;
 
     utils::AsyncQueue<std::unique_ptr<BasecallingChunk>> m_processed_chunks;
 
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "read_pipeline/base/MessageSink.h"
+
+#include <filesystem>
+#include <memory>
+
+namespace dorado {
+
+namespace correction {
+class OverlapStoreWriter;
+}
+
+// Writes correction alignments to an overlap store, which is completed when the node terminates
+// (see correct/overlap_store.h).
+class CorrectionOverlapStoreWriterNode : public MessageSink {
+public:
+    explicit CorrectionOverlapStoreWriterNode(const std::filesystem::path &path);
+    ~CorrectionOverlapStoreWriterNode();
+
+    std::string get_name() const override;
+    void terminate(const TerminateOptions &) override;
+    void restart() override;
+
+private:
+    void input_thread_fn();
+
+    std::unique_ptr<correction::OverlapStoreWriter> m_writer;
+};
+
+}  // namespace dorado
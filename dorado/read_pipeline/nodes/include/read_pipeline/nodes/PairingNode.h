@@ -1,15 +1,17 @@
 #pragma once
 
 #include "read_pipeline/base/MessageSink.h"
+#include "read_pipeline/base/SignalStore.h"
 #include "utils/sequence_utils.h"
 #include "utils/types.h"
 
 #include <atomic>
 #include <cstdint>
 #include <deque>
-#include <list>
 #include <map>
+#include <memory>
 #include <mutex>
+#include <shared_mutex>
 #include <string>
 #include <thread>
 #include <tuple>
@@ -19,15 +21,25 @@
 namespace dorado {
 
 class PairingNode final : public MessageSink {
-    // A key for a unique Pore, Duplex reads must have the same UniquePoreIdentifierKey
-    // The values are channel, run_id, flowcell_id
-    using UniquePoreIdentifierKey = std::tuple<int, std::string, std::string>;
-
-    struct ReadCache {
-        std::map<UniquePoreIdentifierKey, std::list<SimplexReadPtr>> channel_read_map;
-        std::deque<UniquePoreIdentifierKey> working_channel_keys;
+    // A key for a unique Pore, Duplex reads must have the same PoreKey.
+    // The run_id and flowcell_id are interned to run_key, see intern_run().
+    struct PoreKey {
+        int32_t client_id;
+        int32_t channel;
+        uint32_t run_key;
+        bool operator==(const PoreKey&) const = default;
+    };
+    struct PoreKeyHash {
+        size_t operator()(const PoreKey& key) const;
     };
 
+    // A read held by the cache, and its parked signal if m_signal_store is in use.
+    struct CachedRead;
+    // Time ordered reads from a single pore.
+    class ReadRing;
+    // A lock striped slice of the pair_generating read caches.
+    struct CacheShard;
+
 public:
     // Template-complement map: uses the pair_list pairing method
     PairingNode(std::map<std::string, std::string> template_complement_map,
@@ -55,11 +67,11 @@ private:
      * This is a worker thread function for generating pairs of reads that fall within pairing criteria.
      * 
      * The function goes through the incoming messages, which are expected to be reads. For each read, it finds its pore 
-     * in the list of active pores. If the pore isn't in the list yet, it is added. If the list of active pores has reached 
-     * its maximum size (m_max_num_keys), the oldest pore is removed from the list, and its associated reads are discarded.
-     * The function then inserts the new read into the sorted list of reads for its pore, and checks if it can be paired 
-     * with the reads immediately before and after it in the list. If the list of reads for a pore has reached its maximum 
-     * size (m_max_num_reads), the oldest read is removed from the list.
+     * in the cache shard for that pore. If the pore isn't in the cache yet, it is added. If the number of active pores has
+     * reached its maximum size (m_max_num_keys), the oldest pore is removed, and its associated reads are discarded.
+     * The function then inserts the new read into the time ordered ring of reads for its pore, and checks if it can be
+     * paired with the reads immediately before and after it, without holding any lock. If the ring of reads for a pore
+     * has reached its maximum size (m_max_num_reads), the oldest read is removed from the ring.
      */
     void pair_generating_worker_thread(int tid);
 
@@ -78,9 +90,36 @@ private:
 
     // Members for pair_generating method
 
-    // individual read caches per client, keyed by client_id
-    std::mutex m_read_caches_mutex;
-    std::unordered_map<int32_t, ReadCache> m_read_caches;
+    uint32_t intern_run(const std::string& run_id, const std::string& flowcell_id);
+    CacheShard& shard_for(const PoreKey& key) const;
+    void track_new_pore(const PoreKey& key, std::vector<CachedRead>& reads_to_send);
+    void flush_client(int32_t client_id);
+    // Restores the signal of each read before sending it on.
+    void send_reads_to_sink(std::vector<CachedRead>& reads);
+    ReadPair::ReadData read_data_for_pair(const SimplexRead& read,
+                                          const SignalStore::ParkedSignal& parked_signal,
+                                          uint64_t seq_start,
+                                          uint64_t seq_end) const;
+
+    // If set, cached reads are held as signal-free stubs, with their signal parked here until
+    // they leave the cache or are emitted as part of a ReadPair.
+    std::unique_ptr<SignalStore> m_signal_store;
+
+    // Run/flowcell pairs seen so far, keyed by run_id then flowcell_id.
+    std::shared_mutex m_run_keys_mutex;
+    std::unordered_map<std::string, std::unordered_map<std::string, uint32_t>> m_run_keys;
+    uint32_t m_num_run_keys{0};
+
+    // The read caches for all clients, sharded by pore so that threads working on different
+    // pores rarely contend.  Pairs are only formed within a pore, so each shard also tracks the
+    // in-flight state of its own reads.
+    const std::unique_ptr<CacheShard[]> m_cache_shards;
+
+    // The order in which each client's pores were first seen, only tracked if m_max_num_keys is
+    // bounded.  Lock ordering: m_pore_order_mutex may be held while taking one shard's lock, but
+    // not the other way round.
+    std::mutex m_pore_order_mutex;
+    std::unordered_map<int32_t, std::deque<PoreKey>> m_pore_order;
 
     /**
      * The maximum number of different channels (pores) to keep in memory concurrently. 
@@ -112,15 +151,11 @@ private:
     // Store the minimap2 buffers used for mapping. One buffer per thread.
     std::vector<MmTbufPtr> m_tbufs;
 
-    // Track reads which need to be emptied from the cache but are still being
-    // evaluated for pairs by other threads.
-    std::unordered_map<const SimplexRead*, std::atomic<int>> m_reads_in_flight_ctr;
-    std::unordered_set<SimplexReadPtr> m_reads_to_clear;
-
     // Stats tracking for pairing node.
     std::atomic<int> m_early_accepted_pairs{0};
     std::atomic<int> m_overlap_accepted_pairs{0};
     std::atomic<size_t> m_cache_signal_bytes{0};
+    std::atomic<size_t> m_parked_signal_bytes{0};
 };
 
 }  // namespace dorado
@@ -10,6 +10,7 @@
 
 #include <filesystem>
 #include <memory>
+#include <string_view>
 
 namespace dorado {
 
@@ -42,24 +43,21 @@ void ResumeLoader::copy_completed_reads() {
     spdlog::info("Resuming from file {}...", m_resume_file);
 
     auto client_info = std::make_shared<DefaultClientInfo>();
+    size_t num_records = 0;
     // Iterate over all reads and write to sink.
     try {
         while (reader.read()) {
-            std::string read_id;
             // If a split read is found, use the parent read id to
             // resume basecalling since that's the read id found in
             // the raw dataset.
             auto pid_tag = bam_aux_get(reader.record.get(), "pi");
-            if (pid_tag) {
-                read_id = std::string(bam_aux2Z(pid_tag));
-            } else {
-                read_id = bam_get_qname(reader.record);
-            }
+            const std::string_view read_id =
+                    pid_tag ? bam_aux2Z(pid_tag) : bam_get_qname(reader.record);
             m_processed_read_ids.insert(read_id);
             auto hts_data =
                     std::make_unique<HtsData>(HtsData{BamPtr(bam_dup1(reader.record.get()))});
             m_sink.push_message(BamMessage{std::move(hts_data), client_info});
-            if (is_safe_to_log && m_processed_read_ids.size() % 100 == 0) {
+            if (is_safe_to_log && ++num_records % 100 == 0) {
                 bar.tick();
             }
         }
@@ -68,13 +66,14 @@ void ResumeLoader::copy_completed_reads() {
         // the last record. We take this to be the end of
         // properly formatted records.
     }
+    m_processed_read_ids.finalise();
     std::cerr << "\r";
     spdlog::info("> {} original read ids found in resume file.", m_processed_read_ids.size());
 
     hts_set_log_level(initial_hts_log_level);
 }
 
-std::unordered_set<std::string> ResumeLoader::get_processed_read_ids() const {
+const utils::ReadIdSet& ResumeLoader::get_processed_read_ids() const {
     return m_processed_read_ids;
 }
 
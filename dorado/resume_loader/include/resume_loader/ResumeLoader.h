@@ -1,9 +1,9 @@
 #pragma once
 
 #include "read_pipeline/base/MessageSink.h"
+#include "utils/ReadIdSet.h"
 
 #include <string>
-#include <unordered_set>
 
 namespace dorado {
 
@@ -12,13 +12,14 @@ public:
     ResumeLoader(MessageSink& sink, const std::string& resume_file);
 
     void copy_completed_reads();
-    std::unordered_set<std::string> get_processed_read_ids() const;
+    // Ids of the reads which were copied. Split reads are listed under their parent read id.
+    const utils::ReadIdSet& get_processed_read_ids() const;
 
 private:
     MessageSink& m_sink;
     std::string m_resume_file;
 
-    std::unordered_set<std::string> m_processed_read_ids;
+    utils::ReadIdSet m_processed_read_ids;
 };
 
 }  // namespace dorado
@@ -7,6 +7,7 @@
 
 #include <cassert>
 #include <cstddef>
+#include <cstdint>
 #include <stdexcept>
 
 namespace dorado::secondary {
@@ -17,9 +18,9 @@ namespace {
  * \brief Converts the vectors produced by the pileup function into proper tensors.
  */
 CountsResult counts_data_to_tensors(PileupData& data, const size_t n_rows) {
-    const size_t num_bytes = static_cast<size_t>(data.n_cols * n_rows * sizeof(int64_t));
+    const size_t num_counts = static_cast<size_t>(data.n_cols * n_rows);
 
-    if (num_bytes == 0) {
+    if (num_counts == 0) {
         return {};
     }
 
@@ -31,8 +32,12 @@ CountsResult counts_data_to_tensors(PileupData& data, const size_t n_rows) {
 
     assert(result.counts.data_ptr<int64_t>() != nullptr);
 
-    // Copy the data from `data.matrix` into `result.counts`
-    std::memcpy(result.counts.data_ptr<int64_t>(), std::data(data.matrix), num_bytes);
+    // Widen the 32-bit counts from `data.matrix` into `result.counts`.
+    const uint32_t* src = std::data(data.matrix);
+    int64_t* dst = result.counts.data_ptr<int64_t>();
+    for (size_t i = 0; i < num_counts; ++i) {
+        dst[i] = src[i];
+    }
 
     result.positions_major = std::move(data.major);
     result.positions_minor = std::move(data.minor);
@@ -1,5 +1,6 @@
 #include "medaka_counts.h"
 
+#include "hts_utils/hts_types.h"
 #include "medaka_bamiter.h"
 
 #include <htslib/sam.h>
@@ -9,10 +10,14 @@
 #include <cmath>
 #include <cstdlib>
 #include <cstring>
+#include <functional>
+#include <limits>
 #include <memory>
 #include <ostream>
+#include <queue>
 #include <stdexcept>
 #include <unordered_set>
+#include <vector>
 
 #define bam1_seq(b) ((b)->data + (b)->core.n_cigar * 4 + (b)->core.l_qname)
 #define bam1_seqi(s, i) (bam_seqi((s), (i)))
@@ -81,6 +86,15 @@ void print_pileup_data(std::ostream &os,
 
 namespace {
 
+// Maximum number of alignments which the mpileup keeps at a position (htslib's default maxcnt).
+// Regions whose depth stays below this are counted in full.
+constexpr size_t MPILEUP_MAX_DEPTH = 8000;
+
+void add_count(uint32_t &count, const uint32_t value) {
+    constexpr uint32_t MAX_COUNT = std::numeric_limits<uint32_t>::max();
+    count = (value > (MAX_COUNT - count)) ? MAX_COUNT : (count + value);
+}
+
 std::vector<float> get_weibull_scores(const bam_pileup1_t *p,
                                       const int64_t indel,
                                       const int64_t num_homop,
@@ -122,6 +136,230 @@ std::vector<float> get_weibull_scores(const bam_pileup1_t *p,
     return fraction_counts;
 }
 
+/**
+ * \brief Reads all alignments which pass the filters of mpileup_read_bam.
+ *          Stops early if the depth reaches |max_depth| at any position, since the mpileup drops
+ *          alignments there. The depth is tracked from the end positions of the alignments which
+ *          are still open at each start, including those ending just before it, which the mpileup
+ *          still holds. This relies on the alignments being sorted by position.
+ * \returns False if reading failed or the depth reached |max_depth|.
+ */
+bool fetch_alignments(HtslibMpileupData &data,
+                      const size_t max_depth,
+                      std::vector<BamPtr> &alignments) {
+    std::priority_queue<int64_t, std::vector<int64_t>, std::greater<int64_t>> open_ends;
+    while (true) {
+        BamPtr record{bam_init1()};
+        const int32_t ret = mpileup_read_bam(&data, record.get());
+        if (ret < -1) {
+            return false;
+        }
+        if (ret < 0) {
+            return true;
+        }
+        const bam1_t *b = record.get();
+        while (!std::empty(open_ends) && (open_ends.top() < b->core.pos)) {
+            open_ends.pop();
+        }
+        open_ends.push(bam_endpos(b));
+        if (std::size(open_ends) >= max_depth) {
+            return false;
+        }
+        alignments.emplace_back(std::move(record));
+    }
+}
+
+/**
+ * \brief Checks whether the counts of the alignments can be accumulated from their CIGARs
+ *          with the same result as the mpileup.
+ */
+bool can_count_from_cigars(const std::vector<BamPtr> &alignments) {
+    for (const BamPtr &record : alignments) {
+        const bam1_t *b = record.get();
+        if (b->core.l_qseq <= 0) {
+            return false;
+        }
+        const uint32_t *cigar = bam_get_cigar(b);
+        bool consumes_ref = false;
+        for (uint32_t k = 0; k < b->core.n_cigar; ++k) {
+            const int32_t op = bam_cigar_op(cigar[k]);
+            if ((op == BAM_CPAD) || (op == BAM_CBACK) || (bam_cigar_oplen(cigar[k]) == 0)) {
+                return false;
+            }
+            consumes_ref |= (bam_cigar_type(op) & 2) != 0;
+        }
+        if (!consumes_ref) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * \brief Walks the CIGAR of an alignment in the same way as the mpileup.
+ *          Calls on_ref_op(op, ref_pos, query_pos, len) for each operation which consumes the
+ *          reference, and on_insertion(anchor_op, anchor_pos, query_pos, len) for each insertion
+ *          which follows such an operation. Consecutive insertions are merged, and the anchor is
+ *          the last reference position before the insertion.
+ */
+template <typename RefOpCallback, typename InsertionCallback>
+void walk_cigar(const bam1_t *b, RefOpCallback &&on_ref_op, InsertionCallback &&on_insertion) {
+    const uint32_t *cigar = bam_get_cigar(b);
+    const uint32_t n_cigar = b->core.n_cigar;
+    int64_t ref_pos = b->core.pos;
+    int32_t query_pos = 0;
+
+    // Previous operation if it consumed the reference, otherwise -1. Leading insertions and
+    // insertions after clipping are not reported by the mpileup.
+    int32_t anchor_op = -1;
+
+    for (uint32_t k = 0; k < n_cigar; ++k) {
+        const int32_t op = bam_cigar_op(cigar[k]);
+        const int32_t len = static_cast<int32_t>(bam_cigar_oplen(cigar[k]));
+        if (op == BAM_CINS) {
+            int32_t ins_len = len;
+            while (((k + 1) < n_cigar) && (bam_cigar_op(cigar[k + 1]) == BAM_CINS)) {
+                ++k;
+                ins_len += static_cast<int32_t>(bam_cigar_oplen(cigar[k]));
+            }
+            if (anchor_op >= 0) {
+                on_insertion(anchor_op, ref_pos - 1, query_pos, ins_len);
+            }
+            query_pos += ins_len;
+            anchor_op = -1;
+        } else if (bam_cigar_type(op) & 2) {
+            on_ref_op(op, ref_pos, query_pos, len);
+            ref_pos += len;
+            if (bam_cigar_type(op) & 1) {
+                query_pos += len;
+            }
+            anchor_op = op;
+        } else {
+            if (op == BAM_CSOFT_CLIP) {
+                query_pos += len;
+            }
+            anchor_op = -1;
+        }
+    }
+}
+
+/**
+ * \brief Accumulates the counts of a single datatype directly from the CIGARs of the alignments,
+ *          without the per-position overhead of the mpileup. The columns are laid out up front
+ *          from the coverage and the longest insertion at each position, then each alignment adds
+ *          its bases to the columns it covers.
+ */
+void count_from_cigars(const std::vector<BamPtr> &alignments,
+                       const int64_t start,
+                       const int64_t end,
+                       const int64_t num_homop,
+                       PileupData &pileup) {
+    const int64_t dtype_featlen = PILEUP_BASES_SIZE * num_homop;
+    const int64_t region_len = end - start;
+
+    // Coverage (as differences) and the longest insertion at each position of the region.
+    std::vector<int32_t> coverage_diff(region_len + 1, 0);
+    std::vector<int32_t> max_ins(region_len, 0);
+    for (const BamPtr &record : alignments) {
+        const bam1_t *b = record.get();
+        const int64_t cov_start = std::max<int64_t>(b->core.pos, start);
+        const int64_t cov_end = std::min<int64_t>(bam_endpos(b), end);
+        if (cov_start >= cov_end) {
+            continue;
+        }
+        ++coverage_diff[cov_start - start];
+        --coverage_diff[cov_end - start];
+        walk_cigar(
+                b, [](int32_t, int64_t, int32_t, int32_t) {},
+                [&](int32_t, const int64_t anchor_pos, int32_t, const int32_t len) {
+                    if ((anchor_pos >= start) && (anchor_pos < end)) {
+                        max_ins[anchor_pos - start] =
+                                std::max(max_ins[anchor_pos - start], len);
+                    }
+                });
+    }
+
+    // First column of each covered position. Positions without coverage have no columns.
+    std::vector<int64_t> columns(region_len, -1);
+    int64_t n_cols = 0;
+    int32_t depth = 0;
+    for (int64_t i = 0; i < region_len; ++i) {
+        depth += coverage_diff[i];
+        if (depth > 0) {
+            columns[i] = n_cols;
+            n_cols += 1 + max_ins[i];
+        }
+    }
+
+    pileup.resize_cols(n_cols);
+    pileup.n_cols = n_cols;
+    for (int64_t i = 0; i < region_len; ++i) {
+        if (columns[i] < 0) {
+            continue;
+        }
+        for (int64_t minor = 0; minor <= max_ins[i]; ++minor) {
+            pileup.major[columns[i] + minor] = start + i;
+            pileup.minor[columns[i] + minor] = minor;
+        }
+    }
+
+    uint32_t *matrix = std::data(pileup.matrix);
+
+    for (const BamPtr &record : alignments) {
+        const bam1_t *b = record.get();
+        const uint8_t *seq = bam_get_seq(b);
+        const uint8_t *qual = bam_get_qual(b);
+        const int32_t strand_offset = bam_is_rev(b) ? 16 : 0;
+        const int64_t del_i = bam_is_rev(b) ? PILEUP_POS_DEL_REV : PILEUP_POS_DEL_FWD;
+
+        const auto count_base = [&](const int64_t col, const int32_t query_pos) {
+            const int32_t base_i = NUM_TO_COUNT_BASE[bam_seqi(seq, query_pos) + strand_offset];
+            if (base_i == -1) {  // ambiguity code
+                return;
+            }
+            int64_t qstrat = 0;
+            if (num_homop > 1) {
+                qstrat = std::max<int64_t>(0, std::min<int64_t>(qual[query_pos], num_homop) - 1);
+            }
+            add_count(matrix[col * dtype_featlen + PILEUP_BASES_SIZE * qstrat + base_i], 1);
+        };
+
+        walk_cigar(
+                b,
+                [&](const int32_t op, const int64_t ref_pos, const int32_t query_pos,
+                    const int32_t len) {
+                    if (op == BAM_CREF_SKIP) {
+                        return;
+                    }
+                    const int64_t from = std::max(ref_pos, start);
+                    const int64_t to = std::min(ref_pos + len, end);
+                    if (op == BAM_CDEL) {
+                        // Deletions are kept in the first layer of qscore stratification.
+                        for (int64_t pos = from; pos < to; ++pos) {
+                            add_count(matrix[columns[pos - start] * dtype_featlen + del_i], 1);
+                        }
+                        return;
+                    }
+                    for (int64_t pos = from; pos < to; ++pos) {
+                        count_base(columns[pos - start],
+                                   query_pos + static_cast<int32_t>(pos - ref_pos));
+                    }
+                },
+                [&](const int32_t anchor_op, const int64_t anchor_pos, const int32_t query_pos,
+                    const int32_t len) {
+                    // Insertions after a reference skip extend the column but are not counted.
+                    if ((anchor_op == BAM_CREF_SKIP) || (anchor_pos < start) ||
+                        (anchor_pos >= end)) {
+                        return;
+                    }
+                    const int64_t col = columns[anchor_pos - start];
+                    for (int32_t i = 0; i < len; ++i) {
+                        count_base(col + 1 + i, query_pos + i);
+                    }
+                });
+    }
+}
+
 }  // namespace
 
 PileupData calculate_pileup(secondary::BamFile &bam_file,
@@ -136,7 +374,8 @@ PileupData calculate_pileup(secondary::BamFile &bam_file,
                             const bool keep_missing,
                             const bool weibull_summation,
                             const std::string &read_group,
-                            const int32_t min_mapq) {
+                            const int32_t min_mapq,
+                            const bool force_mpileup) {
     if ((num_dtypes == 1) && !std::empty(dtypes)) {
         throw std::runtime_error(
                 "Received invalid num_dtypes and dtypes args. num_dtypes == 1 but size(dtypes) = " +
@@ -178,6 +417,22 @@ PileupData calculate_pileup(secondary::BamFile &bam_file,
         return pileup;
     }
 
+    if (!force_mpileup && (num_dtypes == 1) && !weibull_summation) {
+        std::vector<BamPtr> alignments;
+        const bool fetched = fetch_alignments(*data, MPILEUP_MAX_DEPTH, alignments);
+        bam_itr_destroy(data->iter);
+        if (fetched && can_count_from_cigars(alignments)) {
+            count_from_cigars(alignments, start, end, num_homop, pileup);
+            return pileup;
+        }
+
+        // Start over with the mpileup.
+        data->iter = bam_itr_querys(idx, hdr, region.c_str());
+        if (!data->iter) {
+            return pileup;
+        }
+    }
+
     bam_mplp_t mplp = bam_mplp_init(1, mpileup_read_bam, reinterpret_cast<void **>(&raw_data_ptr));
 
     std::array<bam_pileup1_t *, 1> plp;
@@ -186,7 +441,7 @@ PileupData calculate_pileup(secondary::BamFile &bam_file,
     int32_t tid = 0;
     int32_t n_plp = 0;
 
-    int64_t *pileup_matrix = std::data(pileup.matrix);
+    uint32_t *pileup_matrix = std::data(pileup.matrix);
     int64_t *pileup_major = std::data(pileup.major);
     int64_t *pileup_minor = std::data(pileup.minor);
 
@@ -279,8 +534,9 @@ PileupData calculate_pileup(secondary::BamFile &bam_file,
                 // deletions are kept in the first layer of qscore stratification, if any
                 int32_t qstrat = 0;
                 base_i = bam_is_rev(p->b) ? PILEUP_POS_DEL_REV : PILEUP_POS_DEL_FWD;
-                pileup_matrix[major_col + PILEUP_BASES_SIZE * dtype * num_homop +
-                              PILEUP_BASES_SIZE * qstrat + base_i] += 1;
+                add_count(pileup_matrix[major_col + PILEUP_BASES_SIZE * dtype * num_homop +
+                                        PILEUP_BASES_SIZE * qstrat + base_i],
+                          1);
                 min_minor = 1;  // in case there is also an indel, skip the major position
             }
             // loop over any query bases at or inserted after pos
@@ -305,8 +561,8 @@ PileupData calculate_pileup(secondary::BamFile &bam_file,
                                 get_weibull_scores(p, query_pos_offset, num_homop, no_rle_tags);
                         for (int64_t qstrat = 0; qstrat < num_homop; ++qstrat) {
                             static const int32_t scale = 10000;
-                            pileup_matrix[partial_index + PILEUP_BASES_SIZE * qstrat] +=
-                                    static_cast<int64_t>(scale * fraction_counts[qstrat]);
+                            add_count(pileup_matrix[partial_index + PILEUP_BASES_SIZE * qstrat],
+                                      static_cast<uint32_t>(scale * fraction_counts[qstrat]));
                         }
                     } else {
                         int32_t qstrat = 0;
@@ -316,7 +572,7 @@ PileupData calculate_pileup(secondary::BamFile &bam_file,
                                     bam_get_qual(p->b)[p->qpos + query_pos_offset], num_homop));
                             qstrat = std::max(0, qstrat - 1);
                         }
-                        pileup_matrix[partial_index + PILEUP_BASES_SIZE * qstrat] += 1;
+                        add_count(pileup_matrix[partial_index + PILEUP_BASES_SIZE * qstrat], 1);
                     }
                 }
             }
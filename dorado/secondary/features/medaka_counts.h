@@ -52,7 +52,7 @@ public:
     int64_t num_dtypes = 0;
     int64_t num_homop = 0;
     int64_t n_cols = 0;
-    std::vector<int64_t> matrix;
+    std::vector<uint32_t> matrix;  // Saturating counts, column-major.
     std::vector<int64_t> major;
     std::vector<int64_t> minor;
 };
@@ -85,6 +85,8 @@ void print_pileup_data(std::ostream &os,
  * \param weibull_summation Use predefined BAM tags to perform homopolymer partial counts.
  * \param read_group Used for filtering.
  * \param min_mapq Mininimum mapping quality.
+ * \param force_mpileup Always count through the htslib mpileup, instead of directly from the CIGARs
+ *                      of the alignments. Used to validate the CIGAR path.
  * \returns PileupData object which contains base counts per column.
  *
  * Throws exceptions on errors.
@@ -97,6 +99,11 @@ void print_pileup_data(std::ostream &os,
  *  If tag_name is not empty, alignments are filtered by the (integer) tag value.
  *  When tag_name is given, the behaviour for alignments without the tag is
  *  determined by keep_missing.
+ *
+ *  With a single datatype and without Weibull summation the counts are accumulated directly from
+ *  the CIGARs of the alignments, which produces the same counts as the mpileup. The mpileup is used
+ *  otherwise, and for regions it would not count in full (alignments with padding, or more
+ *  alignments than the mpileup keeps at a position).
  */
 PileupData calculate_pileup(secondary::BamFile &bam_file,
                             const std::string &chr_name,
@@ -110,6 +117,7 @@ PileupData calculate_pileup(secondary::BamFile &bam_file,
                             const bool keep_missing,
                             const bool weibull_summation,
                             const std::string &read_group,
-                            const int32_t min_mapq);
+                            const int32_t min_mapq,
+                            const bool force_mpileup = false);
 
 }  // namespace dorado::secondary
@@ -3,8 +3,6 @@
 #include "read_pipeline/base/messages.h"
 #include "splitter/myers.h"
 #include "splitter_utils.h"
-#include "utils/PostCondition.h"
-#include "utils/alignment_utils.h"
 #include "utils/log_utils.h"
 #include "utils/sequence_utils.h"
 #include "utils/uuid_utils.h"
@@ -28,11 +26,12 @@ namespace dorado::splitter {
 namespace {
 
 //[start, end)
-std::optional<PosRange> find_best_adapter_match(const std::string& adapter,
+std::optional<PosRange> find_best_adapter_match(const MyersPattern& adapter,
                                                 const std::string& seq,
                                                 int dist_thr,
                                                 PosRange subrange) {
     assert(subrange.first <= subrange.second && subrange.second <= seq.size());
+    assert(dist_thr >= 0);
     auto shift = subrange.first;
     auto span = subrange.second - subrange.first;
 
@@ -40,23 +39,18 @@ std::optional<PosRange> find_best_adapter_match(const std::string& adapter,
         return std::nullopt;
     }
 
-    auto edlib_cfg = edlibNewAlignConfig(dist_thr, EDLIB_MODE_HW, EDLIB_TASK_LOC, NULL, 0);
-
-    auto edlib_result = edlibAlign(adapter.c_str(), int(adapter.size()), seq.c_str() + shift,
-                                   int(span), edlib_cfg);
-    assert(edlib_result.status == EDLIB_STATUS_OK);
-    std::optional<PosRange> res = std::nullopt;
-    if (edlib_result.status == EDLIB_STATUS_OK && edlib_result.editDistance != -1) {
-        assert(edlib_result.editDistance <= dist_thr);
-        res = {edlib_result.startLocations[0] + shift, edlib_result.endLocations[0] + shift + 1};
+    const auto match = myers_best_match(adapter, std::string_view(seq).substr(shift, span),
+                                        static_cast<std::size_t>(dist_thr));
+    if (!match) {
+        return std::nullopt;
     }
-    edlibFreeAlignResult(edlib_result);
-    return res;
+    assert(match->edist <= static_cast<std::size_t>(dist_thr));
+    return PosRange{match->begin + shift, match->end + shift};
 }
 
 //currently just finds a single best match
 //TODO efficiently find more matches
-std::vector<PosRange> find_adapter_matches(const std::string& adapter,
+std::vector<PosRange> find_adapter_matches(const MyersPattern& adapter,
                                            const std::string& seq,
                                            int dist_thr,
                                            uint64_t ignore_prefix) {
@@ -83,24 +77,18 @@ std::optional<PosRange> check_rc_match(const std::string& seq,
     auto rc_compl = dorado::utils::reverse_complement(
             seq.substr(compl_r.first, compl_r.second - compl_r.first));
 
-    auto edlib_cfg = edlibNewAlignConfig(dist_thr, EDLIB_MODE_HW, EDLIB_TASK_LOC, NULL, 0);
-
-    auto edlib_result = edlibAlign(seq.c_str() + templ_r.first, int(templ_r.second - templ_r.first),
-                                   rc_compl.c_str(), int(rc_compl.size()), edlib_cfg);
-    assert(edlib_result.status == EDLIB_STATUS_OK);
+    const MyersPattern templ(
+            std::string_view(seq).substr(templ_r.first, templ_r.second - templ_r.first));
+    const auto match = myers_best_match(templ, rc_compl, static_cast<std::size_t>(dist_thr));
 
-    bool match = (edlib_result.status == EDLIB_STATUS_OK) && (edlib_result.editDistance != -1);
     std::optional<PosRange> res = std::nullopt;
     if (match) {
-        assert(edlib_result.editDistance <= dist_thr);
-        assert(edlib_result.numLocations > 0 &&
-               edlib_result.endLocations[0] < int(compl_r.second) &&
-               edlib_result.startLocations[0] < int(compl_r.second));
-        res = PosRange(compl_r.second - edlib_result.endLocations[0],
-                       compl_r.second - edlib_result.startLocations[0]);
+        assert(match->edist <= static_cast<std::size_t>(dist_thr));
+        assert(match->end <= compl_r.second && match->begin < compl_r.second);
+        // The range is built from the inclusive end of the match.
+        const auto last = match->end - 1;
+        res = PosRange(compl_r.second - last, compl_r.second - match->begin);
     }
-
-    edlibFreeAlignResult(edlib_result);
     return res;
 }
 
@@ -223,7 +211,10 @@ PosRanges DuplexReadSplitter::find_muA_adapter_spikes(const ExtRead& read) const
         return {};
     }
 
-    auto match_start_range = [&](std::string_view query, std::int64_t min_start,
+    static const MyersPattern muA_pattern(muA_seq);
+    static const MyersPattern adapter_pattern(adapter_seq);
+
+    auto match_start_range = [&](const MyersPattern& query, std::int64_t min_start,
                                  std::int64_t max_start, std::int64_t max_edist,
                                  bool best_only) -> PosRanges {
         const auto max_end_pos =
@@ -238,19 +229,14 @@ PosRanges DuplexReadSplitter::find_muA_adapter_spikes(const ExtRead& read) const
 
         // Search the sequence.
         if (best_only) {
-            auto edlib_cfg = edlibNewAlignConfig(static_cast<int>(max_edist), EDLIB_MODE_HW,
-                                                 EDLIB_TASK_LOC, nullptr, 0);
-            auto edlib_result = edlibAlign(query.data(), static_cast<int>(query.size()), seq.data(),
-                                           static_cast<int>(seq.size()), edlib_cfg);
-            assert(edlib_result.status == EDLIB_STATUS_OK);
-            auto edlib_cleanup = utils::PostCondition([&] { edlibFreeAlignResult(edlib_result); });
+            const auto match = myers_best_match(query, seq, max_edist);
 
             // Add the match if it looks good.
             PosRanges ranges;
-            if (edlib_result.status == EDLIB_STATUS_OK && edlib_result.editDistance != -1) {
+            if (match) {
                 PosRange range;
-                range.first = min_start + edlib_result.startLocations[0];
-                range.second = min_start + edlib_result.endLocations[0] + 1;
+                range.first = min_start + match->begin;
+                range.second = min_start + match->end;
                 if (static_cast<std::int64_t>(range.first) <= max_start) {
                     ranges.push_back(range);
                 }
@@ -279,7 +265,7 @@ PosRanges DuplexReadSplitter::find_muA_adapter_spikes(const ExtRead& read) const
 
     // Search for muAs.
     const auto muA_ranges =
-            match_start_range(muA_seq, ignore_start, read_seq.size(), max_muA_edist, false);
+            match_start_range(muA_pattern, ignore_start, read_seq.size(), max_muA_edist, false);
     if (muA_ranges.empty()) {
         utils::trace_log("No muA found in read: id={}", read.read->read_common.read_id);
         return {};
@@ -290,8 +276,8 @@ PosRanges DuplexReadSplitter::find_muA_adapter_spikes(const ExtRead& read) const
     for (auto muA_range : muA_ranges) {
         const auto adapter_start = std::max(
                 ignore_start, static_cast<std::int64_t>(muA_range.first) - max_muA_adapter_dist);
-        const auto adapter_ranges = match_start_range(adapter_seq, adapter_start, muA_range.first,
-                                                      max_adapter_edist, true);
+        const auto adapter_ranges = match_start_range(adapter_pattern, adapter_start,
+                                                      muA_range.first, max_adapter_edist, true);
         if (adapter_ranges.empty()) {
             continue;
         }
@@ -352,7 +338,7 @@ PosRanges DuplexReadSplitter::find_muA_adapter_spikes(const ExtRead& read) const
 bool DuplexReadSplitter::check_nearby_adapter(const SimplexRead& read,
                                               PosRange r,
                                               int adapter_edist) const {
-    return find_best_adapter_match(m_settings.adapter, read.read_common.seq, adapter_edist,
+    return find_best_adapter_match(m_adapter_pattern, read.read_common.seq, adapter_edist,
                                    //including spacer region in search
                                    {r.first, std::min(r.second + m_settings.pore_adapter_span,
                                                       (uint64_t)read.read_common.seq.size())})
@@ -411,7 +397,7 @@ std::optional<PosRange> DuplexReadSplitter::identify_middle_adapter_split(
     utils::trace_log("Searching for adapter match");
 
     if (auto adapter_match = find_best_adapter_match(
-                m_settings.adapter, read.read_common.seq, m_settings.relaxed_adapter_edist,
+                m_adapter_pattern, read.read_common.seq, m_settings.relaxed_adapter_edist,
                 {r_l / 2 - search_span / 2, r_l / 2 + search_span / 2})) {
         const uint64_t adapter_start = adapter_match->first;
         const uint64_t adapter_end = adapter_match->second;
@@ -573,7 +559,7 @@ std::vector<DuplexReadSplitter::ExtRead> DuplexReadSplitter::apply_split_finders
                 return check_flank_match(*read.read, {r.first, r.first}, m_settings.flank_err);
             };
             return filter_ranges(
-                    find_adapter_matches(m_settings.adapter, read.read->read_common.seq,
+                    find_adapter_matches(m_adapter_pattern, read.read->read_common.seq,
                                          m_settings.adapter_edist,
                                          m_settings.expect_adapter_prefix),
                     filter);
@@ -691,7 +677,7 @@ std::vector<SimplexReadPtr> DuplexReadSplitter::split(SimplexReadPtr init_read)
 }
 
 DuplexReadSplitter::DuplexReadSplitter(DuplexSplitSettings settings)
-        : m_settings(std::move(settings)) {}
+        : m_settings(std::move(settings)), m_adapter_pattern(m_settings.adapter) {}
 
 DuplexReadSplitter::~DuplexReadSplitter() {}
 
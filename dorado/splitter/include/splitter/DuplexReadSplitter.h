@@ -1,5 +1,6 @@
 #pragma once
 #include "ReadSplitter.h"
+#include "myers.h"
 #include "utils/types.h"
 
 #include <cstdint>
@@ -41,6 +42,7 @@ private:
                             const SplitFinder& split_finder) const;
 
     const DuplexSplitSettings m_settings;
+    const MyersPattern m_adapter_pattern;
 };
 
 }  // namespace dorado::splitter
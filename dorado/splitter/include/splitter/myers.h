@@ -1,6 +1,10 @@
 #pragma once
 
+#include <array>
+#include <cstdint>
 #include <iosfwd>
+#include <optional>
+#include <string>
 #include <string_view>
 #include <vector>
 
@@ -11,6 +15,48 @@ struct EdistResult {
     std::size_t end;    // exclusive
     std::size_t edist;
 };
+
+// Bit-parallel profile of a pattern for the Myers algorithm. Patterns of any length are split
+// into 64-bit blocks. Build it once and reuse it for every sequence the pattern is searched in.
+class MyersPattern {
+public:
+    explicit MyersPattern(std::string_view pattern);
+
+    std::string_view pattern() const { return m_pattern; }
+    std::size_t size() const { return m_pattern.size(); }
+    std::size_t num_blocks() const { return m_num_blocks; }
+
+    // Match bits of each block for character |c|.
+    const uint64_t* peq(char c) const {
+        return m_peq.data() + m_char_index[static_cast<uint8_t>(c)] * m_num_blocks;
+    }
+
+private:
+    std::string m_pattern;
+    std::size_t m_num_blocks;
+    // Characters which don't appear in the pattern share index 0, which never matches.
+    std::array<uint8_t, 256> m_char_index{};
+    std::vector<uint64_t> m_peq;
+};
+
+// Returns the array D[0..n], where D[i] is the edit distance of the best local alignment of the
+// pattern to a suffix of seq[0..i). Only distances up to |max_edist| are computed, larger ones
+// are reported as max_edist + 1, which limits the work to the band of the pattern which can
+// still match.
+std::vector<std::size_t> myers_edists(const MyersPattern& pattern,
+                                      std::string_view seq,
+                                      std::size_t max_edist);
+
+// Finds the best match of the pattern in |seq| with at most |max_edist| edits. Ties are broken in
+// favour of the earliest end, like edlib. Stops early on an exact match.
+std::optional<EdistResult> myers_best_match(const MyersPattern& pattern,
+                                            std::string_view seq,
+                                            std::size_t max_edist);
+
+// Finds all matches of the query in |seq| with at most |max_edist| edits.
+std::vector<EdistResult> myers_align(const MyersPattern& query,
+                                     std::string_view seq,
+                                     std::size_t max_edist);
 std::vector<EdistResult> myers_align(std::string_view query,
                                      std::string_view seq,
                                      std::size_t max_edist);
@@ -7,105 +7,233 @@
 #include <cassert>
 #include <cstdint>
 #include <iomanip>
+#include <limits>
 #include <optional>
 #include <ostream>
+#include <vector>
 
 namespace dorado::splitter {
 
 namespace {
 
-// Returns the array D[0..n], where D[i] is equal to local alignment of the pattern to suffix of text[0..i).
-std::vector<size_t> d_myers(const char* pattern, size_t m, const char* text, size_t n) {
-    constexpr size_t MAX_ALPHABET = 256;
-    assert(m < 64);
-    uint64_t PM[MAX_ALPHABET]{};
-    for (size_t i = 0; i < m; i++) {
-        PM[static_cast<uint8_t>(pattern[i])] |= uint64_t{1} << i;
+constexpr std::size_t WORD_SIZE = 64;
+
+// Advances a block of the DP matrix by one column. |hin| is the horizontal delta entering the top
+// of the block, and the horizontal delta leaving the row selected by |out_mask| is returned.
+int advance_block(uint64_t& vp, uint64_t& vn, uint64_t eq, int hin, uint64_t out_mask) {
+    const uint64_t hin_neg = (hin < 0) ? 1 : 0;
+    const uint64_t hin_pos = (hin > 0) ? 1 : 0;
+    const uint64_t xv = eq | vn;
+    eq |= hin_neg;
+    const uint64_t xh = (((eq & vp) + vp) ^ vp) | eq;
+    uint64_t hp = vn | ~(xh | vp);
+    uint64_t hn = vp & xh;
+    const int hout = ((hp & out_mask) ? 1 : 0) - ((hn & out_mask) ? 1 : 0);
+    hp = (hp << 1) | hin_pos;
+    hn = (hn << 1) | hin_neg;
+    vp = hn | ~(xv | hp);
+    vn = hp & xv;
+    return hout;
+}
+
+// Calls on_column(i, D[i]) for i in [1, n], where D is as described for myers_edists().
+// Stops early if on_column returns false.
+//
+// Uses the blocked algorithm with Ukkonen's cut-off: only the blocks down to the last one which
+// can hold a distance <= max_edist are computed, any blocks below are assumed to be out of reach.
+template <typename Callback>
+void myers_scan(const MyersPattern& pattern,
+                std::string_view seq,
+                std::size_t max_edist,
+                Callback&& on_column) {
+    const std::size_t m = pattern.size();
+    const std::size_t num_blocks = pattern.num_blocks();
+    assert(m > 0);
+
+    // Distances never exceed the pattern length, so there's no need to look further.
+    const int64_t k = static_cast<int64_t>(std::min(max_edist, m));
+    const std::size_t out_of_reach = std::min(max_edist, m) + 1;
+
+    const int64_t last_block_rows = static_cast<int64_t>(m - (num_blocks - 1) * WORD_SIZE);
+    auto block_rows = [&](std::size_t block) {
+        return (block + 1 == num_blocks) ? last_block_rows : static_cast<int64_t>(WORD_SIZE);
+    };
+    auto out_mask = [&](std::size_t block) { return uint64_t{1} << (block_rows(block) - 1); };
+
+    std::vector<uint64_t> vp(num_blocks, ~uint64_t{0});
+    std::vector<uint64_t> vn(num_blocks, 0);
+    // Distance at the last row of each block.
+    std::vector<int64_t> score(num_blocks);
+    for (std::size_t block = 0; block < num_blocks; ++block) {
+        score[block] = static_cast<int64_t>(block * WORD_SIZE) + block_rows(block);
     }
+    // Last block which is computed.
+    std::size_t last_block = std::min(num_blocks - 1, static_cast<std::size_t>(k) / WORD_SIZE);
+
+    for (std::size_t j = 0; j < seq.size(); j++) {
+        const uint64_t* peq = pattern.peq(seq[j]);
+        const int64_t prev_last_score = score[last_block];
+
+        // The top row is always 0, since the match can start anywhere.
+        int hout = 0;
+        for (std::size_t block = 0; block <= last_block; ++block) {
+            hout = advance_block(vp[block], vn[block], peq[block], hout, out_mask(block));
+            score[block] += hout;
+        }
+
+        // Bring in the next block if its top row can now be in reach. Its previous column wasn't
+        // computed, so assume it was as far out as possible.
+        bool prev_in_reach = prev_last_score <= k;
+        while ((last_block + 1 < num_blocks) && (prev_in_reach || score[last_block] < k)) {
+            ++last_block;
+            vp[last_block] = ~uint64_t{0};
+            vn[last_block] = 0;
+            score[last_block] = score[last_block - 1] - hout + block_rows(last_block);
+            hout = advance_block(vp[last_block], vn[last_block], peq[last_block], hout,
+                                 out_mask(last_block));
+            score[last_block] += hout;
+            prev_in_reach = false;
+        }
 
-    std::vector<size_t> D(n + 1);
-    uint64_t VP = ~uint64_t{0};
-    uint64_t VN = 0;
-    size_t score = m;
-    D[0] = score;
-    for (size_t j = 0; j < n; j++) {
-        const uint64_t EQ = PM[static_cast<uint8_t>(text[j])];
-        const uint64_t D0 = (((EQ & VP) + VP) ^ VP) | EQ | VN;
-        uint64_t HP = VN | ~(D0 | VP);
-        uint64_t HN = D0 & VP;
-
-        if (HP & (uint64_t{1} << (m - 1))) {
-            score++;
+        // Drop the blocks which are entirely out of reach.
+        while ((last_block > 0) && (score[last_block] >= k + block_rows(last_block))) {
+            --last_block;
         }
-        if (HN & (uint64_t{1} << (m - 1))) {
-            score--;
+
+        const bool in_reach = (last_block + 1 == num_blocks) && (score[last_block] <= k);
+        if (!on_column(j + 1,
+                       in_reach ? static_cast<std::size_t>(score[last_block]) : out_of_reach)) {
+            return;
         }
-        D[j + 1] = score;
+    }
+}
+
+// Finds the starts of the matches of |query| with |edist| edits which end at |end|, by handing
+// over to edlib.
+std::vector<std::size_t> find_match_starts(std::string_view query,
+                                           std::string_view seq,
+                                           std::size_t end,
+                                           std::size_t edist) {
+    const auto query_len = query.size();
+
+    // |edist| is for the full query ending at |end|, so we know the earliest that the match can start.
+    const auto max_match_len = std::min(query_len + edist, end);
+    const auto min_match_start = end - max_match_len;
 
-        HP <<= 1;
-        HN <<= 1;
-        VP = HN | ~(D0 | HP);
-        VN = D0 & HP;
+    if (edist == 0) {
+        // Exact match, nothing more to do.
+        return {min_match_start};
     }
-    return D;
+
+    std::vector<std::size_t> starts;
+    const auto max_match_span = seq.substr(min_match_start, max_match_len);
+    auto edlib_cfg = edlibNewAlignConfig(static_cast<int>(edist), EDLIB_MODE_HW, EDLIB_TASK_LOC,
+                                         nullptr, 0);
+    auto edlib_result =
+            edlibAlign(query.data(), static_cast<int>(query.size()), max_match_span.data(),
+                       static_cast<int>(max_match_span.size()), edlib_cfg);
+    assert(edlib_result.status == EDLIB_STATUS_OK);
+    auto edlib_cleanup = utils::PostCondition([&] { edlibFreeAlignResult(edlib_result); });
+
+    if (edlib_result.status == EDLIB_STATUS_OK) {
+        // edlib only reports the best edist it finds, so if there's a better match in the same span then it'll
+        // report that instead. This can happen for spans that are close together, for example:
+        // edists:...,7,6,5,5,4,5,6,6,6,5,6,..., max_edist=5
+        //               end1=^    end2=^
+        // When processing 'end2' we have to extend our search span to include that of 'end1' (since it's
+        // |max_edist| indices away). This means that, if the edits aren't insertions, we end up finding the
+        // same sequence as |end1|, which has a better edist and hence is the only thing edlib reports.
+        // We should be safe to ignore the worse edist in those cases.
+        for (int i = 0; i < edlib_result.numLocations; i++) {
+            // edlib indices are inclusive, ours are exclusive.
+            const std::size_t edlib_end = min_match_start + edlib_result.endLocations[i] + 1;
+            if (edlib_result.editDistance == static_cast<int>(edist) && edlib_end == end) {
+                starts.push_back(min_match_start + edlib_result.startLocations[i]);
+            }
+        }
+    }
+    return starts;
 }
 
 }  // namespace
 
-std::vector<EdistResult> myers_align(std::string_view query,
+MyersPattern::MyersPattern(std::string_view pattern)
+        : m_pattern(pattern), m_num_blocks((pattern.size() + WORD_SIZE - 1) / WORD_SIZE) {
+    std::size_t num_chars = 1;
+    for (const char c : m_pattern) {
+        auto& index = m_char_index[static_cast<uint8_t>(c)];
+        if (index == 0) {
+            index = static_cast<uint8_t>(num_chars++);
+        }
+    }
+
+    m_peq.resize(num_chars * m_num_blocks);
+    for (std::size_t i = 0; i < m_pattern.size(); i++) {
+        const auto index = m_char_index[static_cast<uint8_t>(m_pattern[i])];
+        m_peq[index * m_num_blocks + i / WORD_SIZE] |= uint64_t{1} << (i % WORD_SIZE);
+    }
+}
+
+std::vector<std::size_t> myers_edists(const MyersPattern& pattern,
+                                      std::string_view seq,
+                                      std::size_t max_edist) {
+    std::vector<std::size_t> edists(seq.size() + 1, 0);
+    if (pattern.size() == 0) {
+        return edists;
+    }
+    edists[0] = (pattern.size() <= max_edist) ? pattern.size() : max_edist + 1;
+    myers_scan(pattern, seq, max_edist, [&edists](std::size_t end, std::size_t edist) {
+        edists[end] = edist;
+        return true;
+    });
+    return edists;
+}
+
+std::optional<EdistResult> myers_best_match(const MyersPattern& pattern,
+                                            std::string_view seq,
+                                            std::size_t max_edist) {
+    if (pattern.size() == 0) {
+        return std::nullopt;
+    }
+
+    std::size_t best_end = 0;
+    std::size_t best_edist = std::numeric_limits<std::size_t>::max();
+    myers_scan(pattern, seq, max_edist, [&](std::size_t end, std::size_t edist) {
+        if (edist < best_edist) {
+            best_edist = edist;
+            best_end = end;
+        }
+        return best_edist > 0;
+    });
+    if (best_edist > max_edist) {
+        return std::nullopt;
+    }
+
+    const auto starts = find_match_starts(pattern.pattern(), seq, best_end, best_edist);
+    if (starts.empty()) {
+        return std::nullopt;
+    }
+    return EdistResult{starts.front(), best_end, best_edist};
+}
+
+std::vector<EdistResult> myers_align(const MyersPattern& query,
                                      std::string_view seq,
                                      std::size_t max_edist) {
     std::vector<EdistResult> ranges;
     const auto query_len = query.size();
-    if (seq.size() < query_len) {
+    if (query_len == 0 || seq.size() < query_len) {
         // Too small, don't bother.
         return ranges;
     }
 
     auto add_match = [&](std::size_t end, std::size_t edist) {
-        // |edist| is for the full query ending at |end|, so we know the earliest that the match can start.
-        const auto max_match_len = std::min(query_len + edist, end);
-        const auto min_match_start = end - max_match_len;
-
-        if (edist == 0) {
-            // Exact match, nothing more to do.
-            ranges.push_back({min_match_start, end, edist});
-
-        } else {
-            // If this isn't an exact match then hand over to edlib to get the start index.
-            const auto max_match_span = seq.substr(min_match_start, max_match_len);
-            auto edlib_cfg = edlibNewAlignConfig(static_cast<int>(edist), EDLIB_MODE_HW,
-                                                 EDLIB_TASK_LOC, nullptr, 0);
-            auto edlib_result =
-                    edlibAlign(query.data(), static_cast<int>(query.size()), max_match_span.data(),
-                               static_cast<int>(max_match_span.size()), edlib_cfg);
-            assert(edlib_result.status == EDLIB_STATUS_OK);
-            auto edlib_cleanup = utils::PostCondition([&] { edlibFreeAlignResult(edlib_result); });
-
-            if (edlib_result.status == EDLIB_STATUS_OK) {
-                // edlib only reports the best edist it finds, so if there's a better match in the same span then it'll
-                // report that instead. This can happen for spans that are close together, for example:
-                // edists:...,7,6,5,5,4,5,6,6,6,5,6,..., max_edist=5
-                //               end1=^    end2=^
-                // When processing 'end2' we have to extend our search span to include that of 'end1' (since it's
-                // |max_edist| indices away). This means that, if the edits aren't insertions, we end up finding the
-                // same sequence as |end1|, which has a better edist and hence is the only thing edlib reports.
-                // We should be safe to ignore the worse edist in those cases.
-                for (int i = 0; i < edlib_result.numLocations; i++) {
-                    // edlib indices are inclusive, ours are exclusive.
-                    const std::size_t edlib_end =
-                            min_match_start + edlib_result.endLocations[i] + 1;
-                    if (edlib_result.editDistance == static_cast<int>(edist) && edlib_end == end) {
-                        ranges.push_back(
-                                {min_match_start + edlib_result.startLocations[i], end, edist});
-                    }
-                }
-            }
+        for (const auto start : find_match_starts(query.pattern(), seq, end, edist)) {
+            ranges.push_back({start, end, edist});
         }
     };
 
     // Calculate edit distances for each index.
-    const auto local_edists = d_myers(query.data(), query.size(), seq.data(), seq.size());
+    const auto local_edists = myers_edists(query, seq, max_edist);
 
     // Look for drops below the threshold and join neighbouring ranges together.
     //
@@ -149,6 +277,12 @@ std::vector<EdistResult> myers_align(std::string_view query,
     return ranges;
 }
 
+std::vector<EdistResult> myers_align(std::string_view query,
+                                     std::string_view seq,
+                                     std::size_t max_edist) {
+    return myers_align(MyersPattern(query), seq, max_edist);
+}
+
 void print_edists(std::ostream& os, std::string_view seq, const std::vector<size_t>& edists) {
     assert(edists.size() == seq.size() + 1);
 
@@ -158,7 +292,7 @@ void print_edists(std::ostream& os, std::string_view seq, const std::vector<size
     }
     os << '\n';
 
-    // Print the edists. Maximum edist is 64, so we only need to pad 2 spaces.
+    // Print the edists, padded to line up with the sequence.
     const auto old_fill = os.fill(' ');
     for (size_t s : edists) {
         os << std::setw(3) << s;
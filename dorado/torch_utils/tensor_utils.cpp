@@ -1,6 +1,7 @@
 #include "torch_utils/tensor_utils.h"
 
 #include "utils/dev_utils.h"
+#include "utils/signal_stats.h"
 #include "utils/simd.h"
 
 #include <torch/csrc/jit/serialization/pickle.h>
@@ -216,29 +217,16 @@ at::Tensor quantile(const at::Tensor& t, const at::Tensor& q) {
 
 at::Tensor quantile_counting(const at::Tensor& t, const at::Tensor& q) {
     assert(q.dtype() == at::ScalarType::Float);
+    assert(t.dtype() == at::ScalarType::Short && t.is_contiguous());
 
-    auto p = t.data_ptr<int16_t>();
-    auto range_min = t.min().item<int16_t>();
-    auto range_max = t.max().item<int16_t>();
+    const SignalHistogram histogram(t.data_ptr<int16_t>(), t.size(0));
 
-    size_t size = t.size(0);
-
-    std::vector<int> counts(range_max - range_min + 1, 0);
-    for (size_t i = 0; i < size; ++i) {
-        counts[p[i] - range_min]++;
-    }
-    std::partial_sum(counts.begin(), counts.end(), counts.begin());
-
-    auto res = at::empty_like(q);
-
-    for (size_t idx = 0; idx < size_t(q.numel()); idx++) {
-        int threshold = int(q[idx].item<float>() * (size - 1));
-        for (int i = 0; i < int(counts.size()); ++i) {
-            if (counts[i] > threshold) {
-                res[idx] = i + range_min;
-                break;
-            }
-        }
+    const auto q_values = q.contiguous();
+    const float* const q_ptr = q_values.data_ptr<float>();
+    auto res = at::empty_like(q_values);
+    float* const res_ptr = res.data_ptr<float>();
+    for (int64_t idx = 0; idx < q_values.numel(); ++idx) {
+        res_ptr[idx] = histogram.quantile(q_ptr[idx]);
     }
 
     return res;
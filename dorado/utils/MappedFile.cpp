@@ -0,0 +1,70 @@
+#include "utils/MappedFile.h"
+
+#include <cerrno>
+#include <system_error>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace dorado::utils {
+
+MappedFile::MappedFile(const std::filesystem::path& path) : m_path(path) {
+    const auto fail = [&path](const std::string& what) {
+        throw std::runtime_error("Failed to map " + path.string() + ": " + what);
+    };
+#ifdef _WIN32
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        fail("can't open file");
+    }
+    LARGE_INTEGER file_size{};
+    HANDLE mapping = nullptr;
+    if (GetFileSizeEx(file, &file_size) && file_size.QuadPart > 0) {
+        mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    }
+    CloseHandle(file);
+    if (!mapping) {
+        fail("can't create file mapping");
+    }
+    m_data = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    CloseHandle(mapping);
+    if (!m_data) {
+        fail("can't map view of file");
+    }
+    m_size = size_t(file_size.QuadPart);
+#else
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        fail(std::system_category().message(errno));
+    }
+    struct stat file_stat {};
+    if (fstat(fd, &file_stat) != 0 || file_stat.st_size <= 0) {
+        close(fd);
+        fail("can't read file size");
+    }
+    void* data = mmap(nullptr, size_t(file_stat.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        fail(std::system_category().message(errno));
+    }
+    m_data = static_cast<const uint8_t*>(data);
+    m_size = size_t(file_stat.st_size);
+#endif
+}
+
+MappedFile::~MappedFile() {
+#ifdef _WIN32
+    UnmapViewOfFile(m_data);
+#else
+    munmap(const_cast<uint8_t*>(m_data), m_size);
+#endif
+}
+
+}  // namespace dorado::utils
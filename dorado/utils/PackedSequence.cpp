@@ -0,0 +1,84 @@
+#include "utils/PackedSequence.h"
+
+#include <array>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+constexpr uint8_t NOT_ACGT = 4;
+
+constexpr std::array<uint8_t, 256> make_base_codes() {
+    std::array<uint8_t, 256> codes{};
+    for (auto& code : codes) {
+        code = NOT_ACGT;
+    }
+    codes['A'] = codes['a'] = 0;
+    codes['C'] = codes['c'] = 1;
+    codes['G'] = codes['g'] = 2;
+    codes['T'] = codes['t'] = 3;
+    return codes;
+}
+constexpr auto BASE_CODES = make_base_codes();
+
+// The four bases held in each possible packed byte.
+constexpr std::array<std::array<char, 4>, 256> make_unpacked_bytes() {
+    std::array<std::array<char, 4>, 256> bytes{};
+    for (size_t byte = 0; byte < bytes.size(); ++byte) {
+        for (size_t i = 0; i < 4; ++i) {
+            bytes[byte][i] = "ACGT"[(byte >> (2 * i)) & 3];
+        }
+    }
+    return bytes;
+}
+constexpr auto UNPACKED_BYTES = make_unpacked_bytes();
+
+}  // namespace
+
+namespace dorado::utils {
+
+PackedSequence::PackedSequence(std::string_view seq)
+        : m_bases((seq.size() + 3) / 4, 0), m_length(seq.size()) {
+    if (seq.size() > UINT32_MAX) {
+        throw std::runtime_error("PackedSequence: sequence is too long");
+    }
+    for (size_t i = 0; i < seq.size(); ++i) {
+        const uint8_t code = BASE_CODES[static_cast<uint8_t>(seq[i])];
+        if (code == NOT_ACGT) {
+            if (!m_n_runs.empty() && m_n_runs.back().first + m_n_runs.back().second == i) {
+                ++m_n_runs.back().second;
+            } else {
+                m_n_runs.emplace_back(static_cast<uint32_t>(i), 1);
+            }
+            continue;
+        }
+        m_bases[i / 4] |= static_cast<uint8_t>(code << (2 * (i % 4)));
+    }
+    m_n_runs.shrink_to_fit();
+}
+
+void PackedSequence::unpack(std::string& seq) const {
+    // Unpack whole bytes, then trim the padding of the last one.
+    seq.resize(m_bases.size() * 4);
+    char* out = seq.data();
+    for (const uint8_t byte : m_bases) {
+        std::memcpy(out, UNPACKED_BYTES[byte].data(), 4);
+        out += 4;
+    }
+    seq.resize(m_length);
+    for (const auto& [start, length] : m_n_runs) {
+        seq.replace(start, length, length, 'N');
+    }
+}
+
+std::string PackedSequence::unpack() const {
+    std::string seq;
+    unpack(seq);
+    return seq;
+}
+
+size_t PackedSequence::memory_bytes() const {
+    return m_bases.capacity() + m_n_runs.capacity() * sizeof(m_n_runs[0]);
+}
+
+}  // namespace dorado::utils
@@ -0,0 +1,87 @@
+#include "utils/ReadIdSet.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace dorado::utils {
+
+namespace {
+
+constexpr size_t UUID_STRING_LENGTH = 36;
+
+int hex_value(const char c) {
+    if ((c >= '0') && (c <= '9')) {
+        return c - '0';
+    }
+    if ((c >= 'a') && (c <= 'f')) {
+        return c - 'a' + 10;
+    }
+    return -1;
+}
+
+template <typename T>
+void sort_and_deduplicate(std::vector<T>& values) {
+    std::sort(std::begin(values), std::end(values));
+    values.erase(std::unique(std::begin(values), std::end(values)), std::end(values));
+}
+
+}  // namespace
+
+std::optional<ReadIdSet::BinaryId> ReadIdSet::parse_uuid(const std::string_view read_id) {
+    if (std::size(read_id) != UUID_STRING_LENGTH) {
+        return std::nullopt;
+    }
+    BinaryId ret{};
+    size_t pos = 0;
+    for (size_t i = 0; i < std::size(ret); ++i) {
+        if ((pos == 8) || (pos == 13) || (pos == 18) || (pos == 23)) {
+            if (read_id[pos] != '-') {
+                return std::nullopt;
+            }
+            ++pos;
+        }
+        const int hi = hex_value(read_id[pos]);
+        const int lo = hex_value(read_id[pos + 1]);
+        if ((hi < 0) || (lo < 0)) {
+            return std::nullopt;
+        }
+        ret[i] = static_cast<uint8_t>((hi << 4) | lo);
+        pos += 2;
+    }
+    return ret;
+}
+
+void ReadIdSet::insert(const std::string_view read_id) {
+    assert(!m_finalised);
+    if (const auto uuid = parse_uuid(read_id); uuid) {
+        m_uuids.emplace_back(*uuid);
+    } else {
+        m_other_ids.emplace_back(read_id);
+    }
+}
+
+void ReadIdSet::finalise() {
+    sort_and_deduplicate(m_uuids);
+    sort_and_deduplicate(m_other_ids);
+    m_uuids.shrink_to_fit();
+    m_other_ids.shrink_to_fit();
+    m_finalised = true;
+}
+
+bool ReadIdSet::contains(const uint8_t* const read_id) const {
+    assert(m_finalised || empty());
+    BinaryId key{};
+    std::memcpy(key.data(), read_id, std::size(key));
+    return std::binary_search(std::begin(m_uuids), std::end(m_uuids), key);
+}
+
+bool ReadIdSet::contains(const std::string_view read_id) const {
+    assert(m_finalised || empty());
+    if (const auto uuid = parse_uuid(read_id); uuid) {
+        return std::binary_search(std::begin(m_uuids), std::end(m_uuids), *uuid);
+    }
+    return std::binary_search(std::begin(m_other_ids), std::end(m_other_ids), read_id);
+}
+
+}  // namespace dorado::utils
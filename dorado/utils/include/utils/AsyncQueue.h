@@ -1,24 +1,25 @@
 #pragma once
 
+#include "utils/AsyncQueueStatus.h"
 #include "utils/FixedSizeQueue.h"
+#include "utils/LockFreeQueue.h"
+#include "utils/QueueProfile.h"
 
 #include <algorithm>
 #include <cassert>
 #include <condition_variable>
+#include <memory>
 #include <mutex>
+#include <span>
 #include <string>
 #include <unordered_map>
 
 namespace dorado::utils {
 
-// Status return by push/pop methods.
-enum class AsyncQueueStatus { Success, Timeout, Terminate };
-
-// Whether to terminate the queue fast or wait until it's empty.
-enum class AsyncQueueTerminateFast : bool { No = false, Yes = true };
-
 // Asynchronous queue for producer/consumer use.
 // Items must be movable.
+// With AsyncQueueBackend::LockFree all operations are forwarded to a LockFreeQueue, which has
+// the same semantics.
 template <class Item>
 class AsyncQueue {
     // Guards the entire structure.  Should be held while adding/removing items,
@@ -41,6 +42,10 @@ class AsyncQueue {
     int64_t m_num_pops = 0;
     // Name of the queue, for logging and stat collection.
     std::string m_name = "queue";
+    // Set if the queue uses the lock-free backend, in which case nothing above is used.
+    const std::unique_ptr<LockFreeQueue<Item>> m_lock_free;
+    // Wait times and depths, gathered only while profiling is enabled.
+    QueueProfile m_profile;
 
     // Sets item to the next element in the queue and
     // notifies a waiting thread that the queue is not full.
@@ -107,7 +112,11 @@ public:
     using Clock = std::chrono::steady_clock;
 
     // Attempts to push items beyond capacity will block.
-    explicit AsyncQueue(size_t capacity) : m_items(capacity) {}
+    explicit AsyncQueue(size_t capacity, AsyncQueueBackend backend = AsyncQueueBackend::Mutex)
+            : m_items(backend == AsyncQueueBackend::Mutex ? capacity : 0),
+              m_lock_free(backend == AsyncQueueBackend::LockFree
+                                  ? std::make_unique<LockFreeQueue<Item>>(capacity)
+                                  : nullptr) {}
 
     ~AsyncQueue() {
         // Ensure CV waits terminate before destruction.
@@ -128,6 +137,14 @@ public:
     // is returned.
     // Items pushed must be rvalues, since we assume sole ownership.
     AsyncQueueStatus try_push(Item&& item) {
+        const auto profile_wait = m_profile.time_push();
+        if (m_lock_free) {
+            const auto status = m_lock_free->try_push(std::move(item));
+            if (status == AsyncQueueStatus::Success && m_profile.enabled()) {
+                m_profile.record_depth(m_lock_free->size());
+            }
+            return status;
+        }
         std::unique_lock lock(m_mutex);
 
         // Ensure there is space for the new item, given our limit on capacity.
@@ -142,6 +159,9 @@ public:
 
         m_items.push(std::move(item));
         ++m_num_pushes;
+        if (m_profile.enabled()) {
+            m_profile.record_depth(m_items.size());
+        }
 
         // Inform a waiting thread that there is now an item available.
         lock.unlock();
@@ -150,6 +170,51 @@ public:
         return AsyncQueueStatus::Success;
     }
 
+    // Adds all of |items| to the queue, in order, filling whatever space is available each time
+    // the lock is taken rather than locking once per item.
+    // If the queue is full, blocks until there is space or terminate() is called.
+    // Returns AsyncQueueStatus::Success once every item has been added.
+    // If terminate() was called, AsyncQueueStatus::Terminate is returned, and the items which
+    // had not yet been added are left untouched in |items|.
+    AsyncQueueStatus try_push_n(std::span<Item> items) {
+        const auto profile_wait = m_profile.time_push();
+        if (m_lock_free) {
+            const auto status = m_lock_free->try_push_n(items);
+            if (status == AsyncQueueStatus::Success && m_profile.enabled()) {
+                m_profile.record_depth(m_lock_free->size());
+            }
+            return status;
+        }
+        size_t num_pushed = 0;
+        while (num_pushed < items.size()) {
+            std::unique_lock lock(m_mutex);
+            m_not_full_cv.wait(lock,
+                               [this] { return !m_items.full() || m_terminate != Terminate::No; });
+            if (m_terminate != Terminate::No) {
+                return AsyncQueueStatus::Terminate;
+            }
+
+            const size_t num_to_push =
+                    std::min(items.size() - num_pushed, m_items.capacity() - m_items.size());
+            for (size_t i = 0; i < num_to_push; ++i) {
+                m_items.push(std::move(items[num_pushed + i]));
+            }
+            num_pushed += num_to_push;
+            m_num_pushes += num_to_push;
+            if (m_profile.enabled()) {
+                m_profile.record_depth(m_items.size());
+            }
+
+            lock.unlock();
+            if (num_to_push == 1) {
+                m_not_empty_cv.notify_one();
+            } else {
+                m_not_empty_cv.notify_all();
+            }
+        }
+        return AsyncQueueStatus::Success;
+    }
+
     // Obtains the next item in the queue, potentially timing out.
     // If queue is empty:
     // If timeout is reached, but we are not terminating, returns AsyncQueueStatus::Timeout.
@@ -158,6 +223,10 @@ public:
     template <class Duration>
     AsyncQueueStatus try_pop_until(Item& item,
                                    const std::chrono::time_point<Clock, Duration>& timeout_time) {
+        const auto profile_wait = m_profile.time_pop();
+        if (m_lock_free) {
+            return m_lock_free->try_pop_until(item, timeout_time);
+        }
         auto [lock, wait_status] = wait_for_item_or_timeout(timeout_time);
 
         if (wait_status == false) {
@@ -181,6 +250,10 @@ public:
     // Otherwise block until an item is added, upon which AsyncQueueStatus::Success
     // is returned.
     AsyncQueueStatus try_pop(Item& item) {
+        const auto profile_wait = m_profile.time_pop();
+        if (m_lock_free) {
+            return m_lock_free->try_pop(item);
+        }
         auto lock = wait_for_item();
 
         if (m_terminate == Terminate::Fast ||
@@ -202,6 +275,10 @@ public:
     // is returned.
     template <class ProcessFn>
     AsyncQueueStatus process_and_pop_n(ProcessFn process_fn, size_t max_count) {
+        const auto profile_wait = m_profile.time_pop();
+        if (m_lock_free) {
+            return m_lock_free->process_and_pop_n(std::move(process_fn), max_count);
+        }
         auto lock = wait_for_item();
 
         if (m_terminate == Terminate::Fast ||
@@ -220,6 +297,11 @@ public:
             ProcessFn process_fn,
             size_t max_count,
             const std::chrono::time_point<Clock, Duration>& timeout_time) {
+        const auto profile_wait = m_profile.time_pop();
+        if (m_lock_free) {
+            return m_lock_free->process_and_pop_n_with_timeout(std::move(process_fn), max_count,
+                                                               timeout_time);
+        }
         auto [lock, wait_status] = wait_for_item_or_timeout(timeout_time);
 
         if (wait_status == false) {
@@ -241,6 +323,10 @@ public:
     // Pushes will fail and return return AsyncQueueStatus::Terminate until restart is called.
     // Pops will return AsyncQueueStatus::Terminate once the queue is empty, or immediately if fast.
     void terminate(AsyncQueueTerminateFast fast) {
+        if (m_lock_free) {
+            m_lock_free->terminate(fast);
+            return;
+        }
         {
             std::lock_guard lock(m_mutex);
             m_terminate =
@@ -257,6 +343,11 @@ public:
 
     // Resets state to active following a terminate call.
     void restart() {
+        m_profile.reset();
+        if (m_lock_free) {
+            m_lock_free->restart();
+            return;
+        }
         std::lock_guard lock(m_mutex);
         m_items.clear();
         m_num_pushes = 0;
@@ -265,11 +356,16 @@ public:
     }
 
     // Maximum number of items the queue can contain.
-    size_t capacity() const { return m_items.capacity(); }
+    size_t capacity() const {
+        return m_lock_free ? m_lock_free->capacity() : m_items.capacity();
+    }
 
     // Current number of items in the queue.  Only useful for stats sampling and
     // testing.
     size_t size() const {
+        if (m_lock_free) {
+            return m_lock_free->size();
+        }
         std::lock_guard lock(m_mutex);
         return m_items.size();
     }
@@ -279,9 +375,19 @@ public:
 
     const std::string& get_name() const { return m_name; }
 
+    // While enabled, sample_stats also reports the capacity, time spent blocked in pushes, time
+    // spent waiting in pops and a histogram of queue depths.  Wait times for process_and_pop_n
+    // include the time spent in process_fn.
+    void set_profiling_enabled(bool enabled) { m_profile.set_enabled(enabled); }
+    bool is_profiling_enabled() const { return m_profile.enabled(); }
+
     std::unordered_map<std::string, double> sample_stats() const {
         double num_items, num_pushes, num_pops;
-        {
+        if (m_lock_free) {
+            num_items = double(m_lock_free->size());
+            num_pushes = double(m_lock_free->num_pushes());
+            num_pops = double(m_lock_free->num_pops());
+        } else {
             std::lock_guard<std::mutex> lock(m_mutex);
             num_items = double(m_items.size());
             num_pushes = double(m_num_pushes);
@@ -292,6 +398,10 @@ public:
         stats["items"] = num_items;
         stats["pushes"] = num_pushes;
         stats["pops"] = num_pops;
+        if (m_profile.enabled()) {
+            stats["capacity"] = double(capacity());
+            m_profile.add_stats(stats);
+        }
         return stats;
     }
 };
@@ -0,0 +1,17 @@
+#pragma once
+
+namespace dorado::utils {
+
+// Status return by push/pop methods.
+enum class AsyncQueueStatus { Success, Timeout, Terminate };
+
+// Whether to terminate the queue fast or wait until it's empty.
+enum class AsyncQueueTerminateFast : bool { No = false, Yes = true };
+
+// How an AsyncQueue synchronises access to its items.
+// Mutex: a mutex and condition variables, taken on every push and pop.
+// LockFree: a LockFreeQueue, where pushes and pops only contend on a CAS, which scales better
+// for queues that see a high rate of small items from several threads.
+enum class AsyncQueueBackend { Mutex, LockFree };
+
+}  // namespace dorado::utils
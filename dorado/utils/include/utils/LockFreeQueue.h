@@ -0,0 +1,363 @@
+#pragma once
+
+#include "utils/AsyncQueueStatus.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <thread>
+
+namespace dorado::utils {
+
+namespace detail {
+
+// Somewhere for threads to sleep once spinning on a LockFreeQueue hasn't turned up any work.
+// The mutex is only taken by threads that are going to sleep, and by notifiers when there is
+// someone to wake, so it's uncontended while the queue is flowing.
+class QueueWaitPoint {
+    static constexpr int kMinSpins = 4;
+    static constexpr int kMaxSpins = 256;
+
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::atomic<int> m_num_waiters{0};
+    // Adapts to how long it typically takes for work to turn up, so that we spin for as long as
+    // that usually pays off, and go straight to sleep when it doesn't.
+    std::atomic<int> m_spin_limit{kMaxSpins / 4};
+
+    template <class Poll>
+    auto spin(Poll& poll) -> decltype(poll()) {
+        const int spin_limit = m_spin_limit.load(std::memory_order_relaxed);
+        for (int i = 0; i < spin_limit; ++i) {
+            if (auto result = poll()) {
+                const int target = std::min(2 * i + kMinSpins, kMaxSpins);
+                m_spin_limit.store((7 * spin_limit + target) / 8, std::memory_order_relaxed);
+                return result;
+            }
+            std::this_thread::yield();
+        }
+        m_spin_limit.store(std::max(7 * spin_limit / 8, kMinSpins), std::memory_order_relaxed);
+        return std::nullopt;
+    }
+
+public:
+    // Waits until poll() returns a value, and returns it.
+    template <class Poll>
+    auto wait(Poll poll) -> decltype(poll()) {
+        if (auto result = poll()) {
+            return result;
+        }
+        if (auto result = spin(poll)) {
+            return result;
+        }
+        std::unique_lock lock(m_mutex);
+        // This and the poll() that follows are sequentially consistent with the change the
+        // notifier makes and its check for waiters, so either we see the change or the notifier
+        // sees us waiting.
+        m_num_waiters.fetch_add(1);
+        decltype(poll()) result;
+        m_cv.wait(lock, [&] { return (result = poll()).has_value(); });
+        m_num_waiters.fetch_sub(1);
+        return result;
+    }
+
+    // As wait, but returns std::nullopt if |timeout_time| passes first.
+    template <class Poll, class Clock, class Duration>
+    auto wait_until(Poll poll, const std::chrono::time_point<Clock, Duration>& timeout_time)
+            -> decltype(poll()) {
+        if (auto result = poll()) {
+            return result;
+        }
+        if (auto result = spin(poll)) {
+            return result;
+        }
+        std::unique_lock lock(m_mutex);
+        m_num_waiters.fetch_add(1);
+        decltype(poll()) result;
+        m_cv.wait_until(lock, timeout_time, [&] { return (result = poll()).has_value(); });
+        m_num_waiters.fetch_sub(1);
+        return result;
+    }
+
+    // Wakes sleeping threads.  Must be called after the (sequentially consistent) change they
+    // may be waiting for.
+    void notify(bool all) {
+        if (m_num_waiters.load() == 0) {
+            return;
+        }
+        // Taking the lock ensures that any thread that has registered as a waiter is now
+        // inside the CV wait, so can't miss the notification.
+        { std::lock_guard lock(m_mutex); }
+        if (all) {
+            m_cv.notify_all();
+        } else {
+            m_cv.notify_one();
+        }
+    }
+};
+
+}  // namespace detail
+
+// Bounded multi-producer/multi-consumer queue, with the same interface and termination
+// semantics as AsyncQueue, which it backs when AsyncQueueBackend::LockFree is requested.
+// Each slot carries a sequence number that says whether it's ready to be written (2 * pos) or
+// read (2 * pos + 1) at a given position, so pushes and pops only contend on claiming a position
+// with a CAS.  Doubling the positions keeps the two states distinct even for a capacity of 1.
+// Threads that can't make progress spin for a while and then sleep.
+template <class Item>
+class LockFreeQueue {
+    static constexpr std::size_t kCacheLineSize = 64;
+
+    struct alignas(kCacheLineSize) Slot {
+        // Sequentially consistent, since sleeping threads rely on it to see progress.
+        std::atomic<std::size_t> sequence{0};
+        std::optional<Item> item;
+    };
+
+    enum class Terminate : int { No, WhenEmpty, Fast };
+
+    const std::size_t m_capacity;
+    const std::unique_ptr<Slot[]> m_slots;
+    // Producers and consumers claim positions from separate cache lines.
+    alignas(kCacheLineSize) std::atomic<std::size_t> m_enqueue_pos{0};
+    alignas(kCacheLineSize) std::atomic<std::size_t> m_dequeue_pos{0};
+    alignas(kCacheLineSize) std::atomic<Terminate> m_terminate{Terminate::No};
+    // Number of threads inside try_push, so that a WhenEmpty terminate doesn't report the queue
+    // as drained while a push that started before it is still landing.
+    std::atomic<int> m_pushers_in_flight{0};
+    detail::QueueWaitPoint m_not_empty;
+    detail::QueueWaitPoint m_not_full;
+
+    void reset_slots() {
+        for (std::size_t i = 0; i < m_capacity; ++i) {
+            m_slots[i].sequence.store(2 * i, std::memory_order_relaxed);
+        }
+        m_enqueue_pos.store(0, std::memory_order_relaxed);
+        m_dequeue_pos.store(0, std::memory_order_relaxed);
+    }
+
+    bool try_enqueue(Item& item) {
+        std::size_t pos = m_enqueue_pos.load(std::memory_order_relaxed);
+        while (true) {
+            Slot& slot = m_slots[pos % m_capacity];
+            const std::size_t sequence = slot.sequence.load();
+            const auto diff = static_cast<std::ptrdiff_t>(sequence - 2 * pos);
+            if (diff == 0) {
+                if (m_enqueue_pos.compare_exchange_weak(pos, pos + 1,
+                                                        std::memory_order_relaxed)) {
+                    slot.item.emplace(std::move(item));
+                    slot.sequence.store(2 * pos + 1);
+                    return true;
+                }
+            } else if (diff < 0) {
+                // The slot still holds the item from the previous lap: we're full.
+                return false;
+            } else {
+                pos = m_enqueue_pos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // |out| is either an Item or a std::optional<Item>, so Item needn't be default constructible.
+    template <class Out>
+    bool try_dequeue(Out& out) {
+        std::size_t pos = m_dequeue_pos.load(std::memory_order_relaxed);
+        while (true) {
+            Slot& slot = m_slots[pos % m_capacity];
+            const std::size_t sequence = slot.sequence.load();
+            const auto diff = static_cast<std::ptrdiff_t>(sequence - (2 * pos + 1));
+            if (diff == 0) {
+                if (m_dequeue_pos.compare_exchange_weak(pos, pos + 1,
+                                                        std::memory_order_relaxed)) {
+                    out = std::move(*slot.item);
+                    slot.item.reset();
+                    slot.sequence.store(2 * (pos + m_capacity));
+                    return true;
+                }
+            } else if (diff < 0) {
+                // Nothing has been written at this position yet: we're empty.
+                return false;
+            } else {
+                pos = m_dequeue_pos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Attempts to pop an item, returning std::nullopt if the caller should wait for one.
+    template <class Out>
+    std::optional<AsyncQueueStatus> poll_pop(Out& item) {
+        const auto terminate = m_terminate.load();
+        if (terminate == Terminate::Fast) {
+            return AsyncQueueStatus::Terminate;
+        }
+        if (try_dequeue(item)) {
+            return AsyncQueueStatus::Success;
+        }
+        if (terminate == Terminate::WhenEmpty && m_pushers_in_flight.load() == 0) {
+            // A push that raced with terminate may have landed since we looked.
+            return try_dequeue(item) ? AsyncQueueStatus::Success : AsyncQueueStatus::Terminate;
+        }
+        return std::nullopt;
+    }
+
+    // Calls process_fn on |first| and then on up to max_count - 1 further items that are
+    // immediately available, and wakes pushers accordingly.
+    template <class ProcessFn>
+    void process_items(std::optional<Item>& first, ProcessFn& process_fn, std::size_t max_count) {
+        process_fn(std::move(*first));
+        std::size_t num_popped = 1;
+        for (; num_popped < max_count; ++num_popped) {
+            std::optional<Item> item;
+            if (!try_dequeue(item)) {
+                break;
+            }
+            process_fn(std::move(*item));
+        }
+        m_not_full.notify(num_popped > 1);
+    }
+
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit LockFreeQueue(std::size_t capacity)
+            : m_capacity(std::max<std::size_t>(capacity, 1)),
+              m_slots(std::make_unique<Slot[]>(m_capacity)) {
+        reset_slots();
+    }
+
+    LockFreeQueue(const LockFreeQueue&) = delete;
+    LockFreeQueue(LockFreeQueue&&) = delete;
+    LockFreeQueue& operator=(const LockFreeQueue&) = delete;
+    LockFreeQueue& operator=(LockFreeQueue&&) = delete;
+
+    AsyncQueueStatus try_push(Item&& item) {
+        m_pushers_in_flight.fetch_add(1);
+        const auto status = m_not_full.wait([this, &item]() -> std::optional<AsyncQueueStatus> {
+            if (m_terminate.load() != Terminate::No) {
+                return AsyncQueueStatus::Terminate;
+            }
+            if (try_enqueue(item)) {
+                return AsyncQueueStatus::Success;
+            }
+            return std::nullopt;
+        });
+        m_pushers_in_flight.fetch_sub(1);
+        // On termination a popper may be waiting for us to leave.
+        m_not_empty.notify(status != AsyncQueueStatus::Success);
+        return *status;
+    }
+
+    // Consumers are woken as soon as part of |items| lands, rather than once the whole span has
+    // been pushed, so that a batch larger than the queue can't stall.
+    AsyncQueueStatus try_push_n(std::span<Item> items) {
+        m_pushers_in_flight.fetch_add(1);
+        std::size_t num_pushed = 0;
+        const auto status =
+                m_not_full.wait([this, items, &num_pushed]() -> std::optional<AsyncQueueStatus> {
+                    if (m_terminate.load() != Terminate::No) {
+                        return AsyncQueueStatus::Terminate;
+                    }
+                    const std::size_t num_before = num_pushed;
+                    while (num_pushed < items.size() && try_enqueue(items[num_pushed])) {
+                        ++num_pushed;
+                    }
+                    if (num_pushed == items.size()) {
+                        return AsyncQueueStatus::Success;
+                    }
+                    if (num_pushed != num_before) {
+                        m_not_empty.notify(true);
+                    }
+                    return std::nullopt;
+                });
+        m_pushers_in_flight.fetch_sub(1);
+        m_not_empty.notify(status != AsyncQueueStatus::Success || items.size() > 1);
+        return *status;
+    }
+
+    template <class Duration>
+    AsyncQueueStatus try_pop_until(Item& item,
+                                   const std::chrono::time_point<Clock, Duration>& timeout_time) {
+        const auto status = m_not_empty.wait_until([this, &item] { return poll_pop(item); },
+                                                   timeout_time);
+        if (!status) {
+            return AsyncQueueStatus::Timeout;
+        }
+        if (*status == AsyncQueueStatus::Success) {
+            m_not_full.notify(false);
+        }
+        return *status;
+    }
+
+    AsyncQueueStatus try_pop(Item& item) {
+        const auto status = m_not_empty.wait([this, &item] { return poll_pop(item); });
+        if (*status == AsyncQueueStatus::Success) {
+            m_not_full.notify(false);
+        }
+        return *status;
+    }
+
+    template <class ProcessFn>
+    AsyncQueueStatus process_and_pop_n(ProcessFn process_fn, std::size_t max_count) {
+        std::optional<Item> first;
+        const auto status = m_not_empty.wait([this, &first] { return poll_pop(first); });
+        if (*status == AsyncQueueStatus::Success) {
+            process_items(first, process_fn, max_count);
+        }
+        return *status;
+    }
+
+    template <class ProcessFn, class Duration>
+    AsyncQueueStatus process_and_pop_n_with_timeout(
+            ProcessFn process_fn,
+            std::size_t max_count,
+            const std::chrono::time_point<Clock, Duration>& timeout_time) {
+        std::optional<Item> first;
+        const auto status = m_not_empty.wait_until([this, &first] { return poll_pop(first); },
+                                                   timeout_time);
+        if (!status) {
+            return AsyncQueueStatus::Timeout;
+        }
+        if (*status == AsyncQueueStatus::Success) {
+            process_items(first, process_fn, max_count);
+        }
+        return *status;
+    }
+
+    void terminate(AsyncQueueTerminateFast fast) {
+        m_terminate.store(fast == AsyncQueueTerminateFast::Yes ? Terminate::Fast
+                                                               : Terminate::WhenEmpty);
+        m_not_full.notify(true);
+        m_not_empty.notify(true);
+    }
+
+    // Must not be called while other threads are using the queue.
+    void restart() {
+        for (std::size_t i = 0; i < m_capacity; ++i) {
+            m_slots[i].item.reset();
+        }
+        reset_slots();
+        m_terminate.store(Terminate::No);
+    }
+
+    std::size_t capacity() const { return m_capacity; }
+
+    std::size_t size() const {
+        const auto dequeue_pos = m_dequeue_pos.load(std::memory_order_relaxed);
+        const auto enqueue_pos = m_enqueue_pos.load(std::memory_order_relaxed);
+        return enqueue_pos > dequeue_pos ? std::min(enqueue_pos - dequeue_pos, m_capacity) : 0;
+    }
+
+    // Positions only ever advance, so they double as push/pop counts since the last restart.
+    std::size_t num_pushes() const { return m_enqueue_pos.load(std::memory_order_relaxed); }
+    std::size_t num_pops() const { return m_dequeue_pos.load(std::memory_order_relaxed); }
+};
+
+}  // namespace dorado::utils
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace dorado::utils {
+
+// Tournament tree for k-way merging.  Each internal node holds the loser of the match played
+// there, so when the winning source advances only the matches on the path from its leaf to the
+// root are replayed: log2(k) comparisons per item rather than k for a linear scan.
+// Ties are won by the source with the lower index, so merging sorted sources is stable.
+template <class Key, class Compare = std::less<Key>>
+class LoserTree {
+public:
+    explicit LoserTree(std::size_t num_sources, Compare compare = Compare())
+            : m_num_leaves(std::bit_ceil(std::max<std::size_t>(num_sources, 1))),
+              m_compare(std::move(compare)),
+              m_keys(m_num_leaves),
+              m_exhausted(m_num_leaves, true),
+              m_tree(m_num_leaves, 0) {}
+
+    // Sets the first key of a source.  Sources that are never set are treated as exhausted.
+    // Must be followed by build() before the tree is used.
+    void set(std::size_t source, Key key) {
+        assert(source < m_num_leaves);
+        m_keys[source] = std::move(key);
+        m_exhausted[source] = false;
+    }
+
+    // Plays all of the matches.
+    void build() {
+        std::vector<std::size_t> winners(2 * m_num_leaves);
+        for (std::size_t i = 0; i < m_num_leaves; ++i) {
+            winners[m_num_leaves + i] = i;
+        }
+        for (std::size_t node = m_num_leaves - 1; node >= 1; --node) {
+            const auto left = winners[2 * node];
+            const auto right = winners[2 * node + 1];
+            const bool left_wins = beats(left, right);
+            winners[node] = left_wins ? left : right;
+            m_tree[node] = left_wins ? right : left;
+        }
+        m_tree[0] = m_num_leaves == 1 ? 0 : winners[1];
+    }
+
+    // True once every source is exhausted.
+    bool empty() const { return m_exhausted[m_tree[0]]; }
+
+    // The source holding the smallest key.  Only valid if !empty().
+    std::size_t top() const { return m_tree[0]; }
+    const Key& top_key() const { return m_keys[m_tree[0]]; }
+
+    // Replaces the key of the top source with its next one.
+    void replace_top(Key key) {
+        const auto source = m_tree[0];
+        m_keys[source] = std::move(key);
+        replay(source);
+    }
+
+    // Marks the top source as exhausted.
+    void pop_top() {
+        const auto source = m_tree[0];
+        m_exhausted[source] = true;
+        replay(source);
+    }
+
+private:
+    bool beats(std::size_t a, std::size_t b) const {
+        if (m_exhausted[a] || m_exhausted[b]) {
+            return m_exhausted[b] && (!m_exhausted[a] || a < b);
+        }
+        if (m_compare(m_keys[a], m_keys[b])) {
+            return true;
+        }
+        return !m_compare(m_keys[b], m_keys[a]) && a < b;
+    }
+
+    void replay(std::size_t source) {
+        auto winner = source;
+        for (auto node = (m_num_leaves + source) / 2; node >= 1; node /= 2) {
+            if (beats(m_tree[node], winner)) {
+                std::swap(m_tree[node], winner);
+            }
+        }
+        m_tree[0] = winner;
+    }
+
+    const std::size_t m_num_leaves;
+    Compare m_compare;
+    std::vector<Key> m_keys;
+    std::vector<bool> m_exhausted;
+    // m_tree[0] is the overall winner, and m_tree[1, m_num_leaves) the losers of each match.
+    std::vector<std::size_t> m_tree;
+};
+
+}  // namespace dorado::utils
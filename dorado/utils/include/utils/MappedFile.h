@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+
+namespace dorado::utils {
+
+// A read-only mapping of a whole file.  Pages are loaded on demand and shared, through the page
+// cache, with every other process mapping the same file.
+class MappedFile {
+public:
+    // Throws if the file can't be opened or mapped, or is empty.
+    explicit MappedFile(const std::filesystem::path& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const uint8_t* data() const { return m_data; }
+    size_t size() const { return m_size; }
+    const std::filesystem::path& path() const { return m_path; }
+
+    // Returns |count| T's at |offset|, throwing if they're outside of the file or misaligned.
+    template <typename T>
+    const T* section(uint64_t offset, uint64_t count) const {
+        if (offset % alignof(T) != 0 || offset > m_size ||
+            count > (m_size - offset) / sizeof(T)) {
+            throw std::runtime_error("Mapped file " + m_path.string() +
+                                     " is truncated or corrupt");
+        }
+        return reinterpret_cast<const T*>(m_data + offset);
+    }
+
+private:
+    const std::filesystem::path m_path;
+    const uint8_t* m_data{nullptr};
+    size_t m_size{0};
+};
+
+}  // namespace dorado::utils
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace dorado::utils {
+
+// A nucleotide sequence held at two bits per base, for keeping many reads in memory.
+// Bases other than ACGT are kept as runs alongside the packed bases and unpack as 'N', and
+// lowercase bases unpack as uppercase, which is all that minimap2 distinguishes anyway.
+class PackedSequence {
+public:
+    PackedSequence() = default;
+    explicit PackedSequence(std::string_view seq);
+
+    size_t size() const { return m_length; }
+
+    // Unpacks into |seq|, reusing its storage.
+    void unpack(std::string& seq) const;
+    std::string unpack() const;
+
+    // Heap memory used.
+    size_t memory_bytes() const;
+
+private:
+    // Four bases per byte, first base in the lowest bits.
+    std::vector<uint8_t> m_bases;
+    // (start, length) of each run of non-ACGT bases.
+    std::vector<std::pair<uint32_t, uint32_t>> m_n_runs;
+    size_t m_length{0};
+};
+
+}  // namespace dorado::utils
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+namespace dorado::utils {
+
+// Counters gathered by an AsyncQueue while profiling is enabled: how long producers are held up
+// in pushes, how long consumers wait in pops, and a histogram of the queue depth seen by each
+// push.  When disabled the only cost is a relaxed load per queue operation.
+class QueueProfile {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // Bucket 0 counts pushes that left the queue with depth 0 (i.e. an immediate pop beat us to
+    // it), and bucket i > 0 counts depths in [2^(i-1), 2^i).
+    static constexpr std::size_t NUM_DEPTH_BUCKETS = 32;
+
+    // Adds the time until it's destroyed to a total, if given one.
+    class ScopedWait {
+        std::atomic<uint64_t>* const m_total_ns;
+        const Clock::time_point m_start;
+
+    public:
+        explicit ScopedWait(std::atomic<uint64_t>* total_ns)
+                : m_total_ns(total_ns), m_start(total_ns ? Clock::now() : Clock::time_point{}) {}
+        ~ScopedWait() {
+            if (m_total_ns) {
+                const auto elapsed = Clock::now() - m_start;
+                m_total_ns->fetch_add(
+                        std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count(),
+                        std::memory_order_relaxed);
+            }
+        }
+        ScopedWait(const ScopedWait&) = delete;
+        ScopedWait& operator=(const ScopedWait&) = delete;
+    };
+
+    bool enabled() const { return m_enabled.load(std::memory_order_relaxed); }
+    void set_enabled(bool enabled) { m_enabled.store(enabled, std::memory_order_relaxed); }
+
+    ScopedWait time_push() { return ScopedWait(enabled() ? &m_push_blocked_ns : nullptr); }
+    ScopedWait time_pop() { return ScopedWait(enabled() ? &m_pop_wait_ns : nullptr); }
+
+    void record_depth(std::size_t depth) {
+        const auto bucket = std::min<std::size_t>(std::bit_width(depth), NUM_DEPTH_BUCKETS - 1);
+        m_depth_counts[bucket].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void reset() {
+        m_push_blocked_ns.store(0, std::memory_order_relaxed);
+        m_pop_wait_ns.store(0, std::memory_order_relaxed);
+        for (auto& count : m_depth_counts) {
+            count.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    // Adds push_blocked_ms, pop_wait_ms, depth percentiles (as bucket upper bounds) and the
+    // non-empty histogram buckets, keyed depth_lt_<upper bound>, to |stats|.
+    void add_stats(std::unordered_map<std::string, double>& stats) const {
+        stats["push_blocked_ms"] = to_ms(m_push_blocked_ns);
+        stats["pop_wait_ms"] = to_ms(m_pop_wait_ns);
+
+        std::array<uint64_t, NUM_DEPTH_BUCKETS> counts;
+        uint64_t total = 0;
+        for (std::size_t i = 0; i < NUM_DEPTH_BUCKETS; ++i) {
+            counts[i] = m_depth_counts[i].load(std::memory_order_relaxed);
+            total += counts[i];
+            if (counts[i] != 0) {
+                stats["depth_lt_" + std::to_string(bucket_upper_bound(i))] = double(counts[i]);
+            }
+        }
+        if (total == 0) {
+            return;
+        }
+        auto percentile = [&counts, total](double fraction) {
+            const auto target = static_cast<uint64_t>(fraction * double(total));
+            uint64_t seen = 0;
+            for (std::size_t i = 0; i < NUM_DEPTH_BUCKETS; ++i) {
+                seen += counts[i];
+                if (seen > target) {
+                    return double(bucket_upper_bound(i));
+                }
+            }
+            return double(bucket_upper_bound(NUM_DEPTH_BUCKETS - 1));
+        };
+        stats["depth_p50"] = percentile(0.5);
+        stats["depth_p99"] = percentile(0.99);
+    }
+
+private:
+    static double to_ms(const std::atomic<uint64_t>& ns) {
+        return double(ns.load(std::memory_order_relaxed)) / 1e6;
+    }
+    static uint64_t bucket_upper_bound(std::size_t bucket) { return uint64_t{1} << bucket; }
+
+    std::atomic<bool> m_enabled{false};
+    std::atomic<uint64_t> m_push_blocked_ns{0};
+    std::atomic<uint64_t> m_pop_wait_ns{0};
+    std::array<std::atomic<uint64_t>, NUM_DEPTH_BUCKETS> m_depth_counts{};
+};
+
+}  // namespace dorado::utils
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace dorado::utils {
+
+// A set of read ids for skip lists which can hold millions of reads. Ids in the canonical
+// lowercase UUID form, which is how POD5 read ids are formatted, are kept as their 16 bytes in a
+// sorted array. Any other ids are kept as strings.
+class ReadIdSet {
+public:
+    using BinaryId = std::array<uint8_t, 16>;
+
+    // Parses a read id in the canonical lowercase UUID form.
+    static std::optional<BinaryId> parse_uuid(std::string_view read_id);
+
+    // Ids can be inserted in any order, but finalise() must be called before the lookups, and no
+    // more ids can be inserted after it.
+    void insert(std::string_view read_id);
+
+    // Sorts the ids and removes the duplicates.
+    void finalise();
+
+    // Only valid once the set has been finalised, or while it is empty.
+    bool contains(const uint8_t* read_id) const;
+    bool contains(std::string_view read_id) const;
+
+    size_t size() const { return m_uuids.size() + m_other_ids.size(); }
+    bool empty() const { return size() == 0; }
+
+private:
+    std::vector<BinaryId> m_uuids;
+    std::vector<std::string> m_other_ids;
+    bool m_finalised = false;
+};
+
+}  // namespace dorado::utils
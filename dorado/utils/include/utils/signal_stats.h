@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace dorado::utils {
+
+// Smallest and largest sample of a non-empty int16 signal.
+std::pair<int16_t, int16_t> signal_minmax(const int16_t* signal, size_t size);
+
+// Counts of int16 signal values, for order statistics without sorting. The range of counted
+// values grows as samples outside of it are added.
+class SignalHistogram {
+public:
+    SignalHistogram() = default;
+    // Counts all of the samples, sized to their range.
+    SignalHistogram(const int16_t* signal, size_t size);
+
+    // Replaces the counts with those of the signal. The storage is reused, so this only allocates
+    // when the range of the signal is wider than any counted before.
+    void assign(const int16_t* signal, size_t size);
+
+    void add(int16_t value);
+    void add(const int16_t* signal, size_t size);
+    // The value must have been added before.
+    void remove(int16_t value);
+
+    size_t size() const { return m_size; }
+    size_t count(int32_t value) const;
+
+    // Smallest and largest samples. Throw if there are no samples.
+    int16_t min_sample() const;
+    int16_t max_sample() const;
+
+    // Value at position |rank| of the sorted samples. Throws if rank >= size().
+    int16_t value_at_rank(size_t rank) const;
+    // Lower quantile: the value at rank q * (size() - 1), rounded down.
+    int16_t quantile(float q) const;
+    // Lower median, like at::median.
+    int16_t median() const;
+    // Lower median of the absolute differences of the samples from |center|.
+    int32_t median_abs_deviation(int32_t center) const;
+
+private:
+    void extend(int16_t value);
+    void check_not_empty() const;
+
+    int32_t m_min_value{0};
+    std::vector<uint32_t> m_counts;
+    size_t m_size{0};
+};
+
+// Statistics of an int16 signal, as used for scaling, returned as plain floats. The histogram is
+// kept between signals, so a SignalStats per thread computes them without allocating.
+class SignalStats {
+public:
+    // Counts the signal, replacing the previous one.
+    void compute(const int16_t* signal, size_t size);
+
+    size_t size() const { return m_histogram.size(); }
+    float minimum() const { return m_histogram.min_sample(); }
+    float maximum() const { return m_histogram.max_sample(); }
+    float quantile(float q) const { return m_histogram.quantile(q); }
+    float median() const { return m_histogram.median(); }
+    // Median absolute deviation from the median.
+    float median_abs_deviation() const;
+
+private:
+    SignalHistogram m_histogram;
+};
+
+// Median of a window sliding along an int16 signal. The samples which enter and leave the window
+// are counted in and out of a histogram, and the median is found by moving from the previous one,
+// so each step costs time in the stride and in how far the median moves, not in the window size.
+class SlidingMedian {
+public:
+    SlidingMedian(const int16_t* signal, size_t size, size_t window_size);
+
+    // Lower median of signal[start, min(start + window_size, size)), which must not be empty.
+    // The start must not be before the previous one.
+    int16_t median_at(size_t start);
+
+private:
+    const int16_t* m_signal;
+    size_t m_size;
+    size_t m_window_size;
+    size_t m_begin{0};
+    size_t m_end{0};
+
+    SignalHistogram m_histogram;
+    // The current median, and the number of samples in the window below it.
+    int32_t m_median{0};
+    size_t m_num_below{0};
+};
+
+}  // namespace dorado::utils
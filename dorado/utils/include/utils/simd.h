@@ -33,6 +33,7 @@ using Int16Register = int16x4_t;
 #define simd_convert_f32_f16(reg) vcvt_f16_f32(reg)
 #define simd_store_f32(ptr, reg) vst1q_f32(ptr, reg)
 #define simd_store1_f32(ptr, reg) *(ptr) = vgetq_lane_f32(reg, 0)
+#define simd_max_f32(regA, regB) vmaxq_f32(regA, regB)
 
 #define simd_load_f16(ptr) vld1_f16(reinterpret_cast<float16_t const *>(ptr))
 #define simd_load1_f16(ptr) vdup_n_f16(*(ptr))
@@ -59,6 +60,8 @@ using Int16Register = __m128i;
 #define simd_load_f32(ptr) _mm256_loadu_ps(ptr)
 #define simd_load1_f32(ptr) _mm256_broadcast_ss(ptr)
 #define simd_convert_f32_f16(reg) _mm256_cvtps_ph(reg, dorado::utils::simd::kRoundNearestEven)
+#define simd_store_f32(ptr, reg) _mm256_storeu_ps(ptr, reg)
+#define simd_max_f32(regA, regB) _mm256_max_ps(regA, regB)
 
 #define simd_load_f16(ptr) _mm_loadu_si128(reinterpret_cast<const __m128i *>(ptr))
 #define simd_store_f16(ptr, reg) _mm_storeu_si128(reinterpret_cast<__m128i *>(ptr), reg)
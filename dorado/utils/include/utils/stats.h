@@ -13,6 +13,7 @@
 #include <iosfwd>
 #include <optional>
 #include <regex>
+#include <set>
 #include <string>
 #include <thread>
 #include <tuple>
@@ -45,8 +46,15 @@ public:
 
     void terminate();
 
-    // Dumps stats in CSV form, with entries filtered optionally according to name_filter.
-    void dump_stats(std::ostream& out_stream, std::optional<std::regex> name_filter) const;
+    enum class DumpFormat {
+        CSV,   // One row per sample, one column per stat.
+        JSON,  // An array of {"elapsed_ms": ..., "stats": {name: value, ...}} objects.
+    };
+
+    // Dumps stats in the given form, with entries filtered optionally according to name_filter.
+    void dump_stats(std::ostream& out_stream,
+                    std::optional<std::regex> name_filter,
+                    DumpFormat format = DumpFormat::CSV) const;
 
 private:
     std::vector<StatsReporter> m_stats_reporters;  // Entities we monitor
@@ -63,6 +71,7 @@ private:
     std::vector<StatsRecord> m_records;
 
     void sampling_thread_fn();
+    void dump_stats_json(std::ostream& out_stream, const std::set<std::string>& stat_names) const;
 };
 
 // Constructs a callable StatsReporter object based on an object
@@ -88,12 +88,22 @@ using BarcodeFilterSet = std::optional<std::unordered_set<std::string>>;
 
 enum class ReadOrder { UNRESTRICTED, BY_CHANNEL, BY_TIME };
 
+// Where the duplex pairing cache keeps the signal of reads waiting for a partner:
+// in the reads themselves, compressed in memory, or compressed in local spill files.
+enum class PairingSignalStorage { RESIDENT, COMPRESSED, SPILL };
+
 struct DuplexPairingParameters {
     ReadOrder read_order;
     size_t cache_depth;
+    PairingSignalStorage signal_storage{PairingSignalStorage::RESIDENT};
+    // Where SPILL files are written. Defaults to the system temp directory.
+    std::string spill_dir{};
 };
 /// Default cache depth to be used for the duplex pairing cache.
 constexpr static size_t DEFAULT_DUPLEX_CACHE_DEPTH = 10;
+/// Default number of reads kept per channel by the duplex pairing cache when reads arrive in
+/// time order. It only needs to absorb the reordering introduced by simplex basecalling.
+constexpr static size_t DEFAULT_DUPLEX_READS_PER_CHANNEL = 20;
 
 inline std::string to_string(ReadOrder read_order) {
     switch (read_order) {
@@ -0,0 +1,272 @@
+#include "utils/signal_stats.h"
+
+#include "utils/simd.h"
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace dorado::utils {
+
+namespace {
+
+#if !ENABLE_NEON_IMPL
+#if ENABLE_AVX2_IMPL
+[[maybe_unused]] __attribute__((target("default")))
+#endif
+std::pair<int16_t, int16_t> signal_minmax_impl(const int16_t* signal, size_t size) {
+    int16_t min_value = std::numeric_limits<int16_t>::max();
+    int16_t max_value = std::numeric_limits<int16_t>::min();
+    for (size_t i = 0; i < size; ++i) {
+        min_value = std::min(min_value, signal[i]);
+        max_value = std::max(max_value, signal[i]);
+    }
+    return {min_value, max_value};
+}
+#endif  // !ENABLE_NEON_IMPL
+
+#if ENABLE_AVX2_IMPL || ENABLE_NEON_IMPL
+#if ENABLE_AVX2_IMPL
+[[maybe_unused]] __attribute__((target("avx2")))
+#endif
+std::pair<int16_t, int16_t> signal_minmax_impl(const int16_t* signal, size_t size) {
+    int16_t min_value = std::numeric_limits<int16_t>::max();
+    int16_t max_value = std::numeric_limits<int16_t>::min();
+    size_t i = 0;
+
+#if ENABLE_AVX2_IMPL
+    constexpr size_t kBlockSize = 16;
+    if (size >= kBlockSize) {
+        __m256i mins = _mm256_set1_epi16(min_value);
+        __m256i maxs = _mm256_set1_epi16(max_value);
+        for (; i + kBlockSize <= size; i += kBlockSize) {
+            const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(signal + i));
+            mins = _mm256_min_epi16(mins, block);
+            maxs = _mm256_max_epi16(maxs, block);
+        }
+        alignas(32) int16_t lanes[2][kBlockSize];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lanes[0]), mins);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lanes[1]), maxs);
+        min_value = *std::min_element(lanes[0], lanes[0] + kBlockSize);
+        max_value = *std::max_element(lanes[1], lanes[1] + kBlockSize);
+    }
+#else
+    constexpr size_t kBlockSize = 8;
+    if (size >= kBlockSize) {
+        int16x8_t mins = vdupq_n_s16(min_value);
+        int16x8_t maxs = vdupq_n_s16(max_value);
+        for (; i + kBlockSize <= size; i += kBlockSize) {
+            const int16x8_t block = vld1q_s16(signal + i);
+            mins = vminq_s16(mins, block);
+            maxs = vmaxq_s16(maxs, block);
+        }
+        min_value = vminvq_s16(mins);
+        max_value = vmaxvq_s16(maxs);
+    }
+#endif
+
+    // Remaining samples.
+    for (; i < size; ++i) {
+        min_value = std::min(min_value, signal[i]);
+        max_value = std::max(max_value, signal[i]);
+    }
+    return {min_value, max_value};
+}
+#endif  // ENABLE_AVX2_IMPL || ENABLE_NEON_IMPL
+
+}  // namespace
+
+std::pair<int16_t, int16_t> signal_minmax(const int16_t* signal, size_t size) {
+    return signal_minmax_impl(signal, size);
+}
+
+SignalHistogram::SignalHistogram(const int16_t* signal, size_t size) { assign(signal, size); }
+
+void SignalHistogram::assign(const int16_t* signal, size_t size) {
+    m_size = 0;
+    if (size == 0) {
+        m_counts.clear();
+        return;
+    }
+    const auto [min_value, max_value] = signal_minmax(signal, size);
+    m_min_value = min_value;
+    m_counts.assign(max_value - min_value + 1, 0);
+    uint32_t* const counts = m_counts.data() - m_min_value;
+    for (size_t i = 0; i < size; ++i) {
+        ++counts[signal[i]];
+    }
+    m_size = size;
+}
+
+void SignalHistogram::add(int16_t value) {
+    if ((value < m_min_value) || (value >= m_min_value + static_cast<int32_t>(m_counts.size()))) {
+        extend(value);
+    }
+    ++m_counts[value - m_min_value];
+    ++m_size;
+}
+
+void SignalHistogram::add(const int16_t* signal, size_t size) {
+    if (size == 0) {
+        return;
+    }
+    // Size the range once, so that the counting loop has no range checks.
+    const auto [min_value, max_value] = signal_minmax(signal, size);
+    if ((min_value < m_min_value) || m_counts.empty()) {
+        extend(min_value);
+    }
+    if (max_value >= m_min_value + static_cast<int32_t>(m_counts.size())) {
+        extend(max_value);
+    }
+    uint32_t* const counts = m_counts.data() - m_min_value;
+    for (size_t i = 0; i < size; ++i) {
+        ++counts[signal[i]];
+    }
+    m_size += size;
+}
+
+void SignalHistogram::remove(int16_t value) {
+    --m_counts[value - m_min_value];
+    --m_size;
+}
+
+size_t SignalHistogram::count(int32_t value) const {
+    const int32_t index = value - m_min_value;
+    if ((index < 0) || (index >= static_cast<int32_t>(m_counts.size()))) {
+        return 0;
+    }
+    return m_counts[index];
+}
+
+void SignalHistogram::check_not_empty() const {
+    if (m_size == 0) {
+        throw std::out_of_range("SignalHistogram has no samples.");
+    }
+}
+
+int16_t SignalHistogram::min_sample() const {
+    check_not_empty();
+    const auto it = std::find_if(std::cbegin(m_counts), std::cend(m_counts),
+                                 [](const uint32_t count) { return count != 0; });
+    return static_cast<int16_t>(m_min_value + std::distance(std::cbegin(m_counts), it));
+}
+
+int16_t SignalHistogram::max_sample() const {
+    check_not_empty();
+    const auto it = std::find_if(std::crbegin(m_counts), std::crend(m_counts),
+                                 [](const uint32_t count) { return count != 0; });
+    return static_cast<int16_t>(m_min_value + std::distance(it, std::crend(m_counts)) - 1);
+}
+
+void SignalHistogram::extend(int16_t value) {
+    int32_t lo = value;
+    int32_t hi = value;
+    if (!m_counts.empty()) {
+        lo = std::min(lo, m_min_value);
+        hi = std::max(hi, m_min_value + static_cast<int32_t>(m_counts.size()) - 1);
+    }
+    // Leave room on the side being extended, so that a signal drifting out of the range doesn't
+    // cause a resize for every new value.
+    const int32_t slack = std::max((hi - lo + 1) / 2, 64);
+    if (value == lo) {
+        lo = std::max<int32_t>(lo - slack, std::numeric_limits<int16_t>::min());
+    }
+    if (value == hi) {
+        hi = std::min<int32_t>(hi + slack, std::numeric_limits<int16_t>::max());
+    }
+
+    std::vector<uint32_t> counts(hi - lo + 1, 0);
+    std::copy(std::cbegin(m_counts), std::cend(m_counts),
+              std::begin(counts) + (m_counts.empty() ? 0 : m_min_value - lo));
+    m_counts.swap(counts);
+    m_min_value = lo;
+}
+
+int16_t SignalHistogram::value_at_rank(size_t rank) const {
+    if (rank >= m_size) {
+        throw std::out_of_range("SignalHistogram rank " + std::to_string(rank) +
+                                " is out of range for " + std::to_string(m_size) + " samples.");
+    }
+    size_t num_below = 0;
+    for (size_t i = 0; i < m_counts.size(); ++i) {
+        num_below += m_counts[i];
+        if (num_below > rank) {
+            return static_cast<int16_t>(m_min_value + static_cast<int32_t>(i));
+        }
+    }
+    // Unreachable, the counts add up to m_size.
+    throw std::logic_error("SignalHistogram counts are inconsistent.");
+}
+
+int16_t SignalHistogram::quantile(float q) const {
+    return value_at_rank(static_cast<size_t>(q * static_cast<float>(m_size - 1)));
+}
+
+int16_t SignalHistogram::median() const { return value_at_rank((m_size - 1) / 2); }
+
+int32_t SignalHistogram::median_abs_deviation(int32_t center) const {
+    check_not_empty();
+    // Count the samples in order of their distance from the center.
+    const size_t rank = (m_size - 1) / 2;
+    size_t num_within = count(center);
+    int32_t deviation = 0;
+    while (num_within <= rank) {
+        ++deviation;
+        num_within += count(center - deviation) + count(center + deviation);
+    }
+    return deviation;
+}
+
+void SignalStats::compute(const int16_t* signal, size_t size) { m_histogram.assign(signal, size); }
+
+float SignalStats::median_abs_deviation() const {
+    return static_cast<float>(m_histogram.median_abs_deviation(m_histogram.median()));
+}
+
+SlidingMedian::SlidingMedian(const int16_t* signal, size_t size, size_t window_size)
+        : m_signal(signal), m_size(size), m_window_size(window_size) {}
+
+int16_t SlidingMedian::median_at(size_t start) {
+    const size_t end = std::min(start + m_window_size, m_size);
+    if (start < m_begin) {
+        throw std::invalid_argument("SlidingMedian window can't move backwards.");
+    }
+    if (start >= end) {
+        throw std::out_of_range("SlidingMedian window is empty.");
+    }
+
+    // Samples which left the window.
+    for (size_t i = m_begin; i < std::min(start, m_end); ++i) {
+        const int16_t value = m_signal[i];
+        m_histogram.remove(value);
+        m_num_below -= (value < m_median) ? 1 : 0;
+    }
+    if (m_histogram.size() == 0) {
+        m_median = m_signal[start];
+        m_num_below = 0;
+    }
+    // Samples which entered the window.
+    for (size_t i = std::max(start, m_end); i < end; ++i) {
+        const int16_t value = m_signal[i];
+        m_histogram.add(value);
+        m_num_below += (value < m_median) ? 1 : 0;
+    }
+    m_begin = start;
+    m_end = end;
+
+    // Move the median until it's the value at the median rank.
+    const size_t rank = (m_histogram.size() - 1) / 2;
+    while (m_num_below > rank) {
+        --m_median;
+        m_num_below -= m_histogram.count(m_median);
+    }
+    while (m_num_below + m_histogram.count(m_median) <= rank) {
+        m_num_below += m_histogram.count(m_median);
+        ++m_median;
+    }
+    return static_cast<int16_t>(m_median);
+}
+
+}  // namespace dorado::utils
@@ -2,8 +2,8 @@
 
 #include "utils/thread_utils.h"
 
+#include <cmath>
 #include <ostream>
-#include <set>
 
 namespace dorado::stats {
 
@@ -34,7 +34,8 @@ void StatsSampler::terminate() {
 }
 
 void StatsSampler::dump_stats(std::ostream& out_stream,
-                              std::optional<std::regex> name_filter) const {
+                              std::optional<std::regex> name_filter,
+                              DumpFormat format) const {
     if (m_records.empty()) {
         return;
     }
@@ -51,6 +52,11 @@ void StatsSampler::dump_stats(std::ostream& out_stream,
         }
     }
 
+    if (format == DumpFormat::JSON) {
+        dump_stats_json(out_stream, stat_names);
+        return;
+    }
+
     // Emit headings.
     out_stream << "elapsed_ms";
     for (const auto& stat_name : stat_names) {
@@ -73,6 +79,51 @@ void StatsSampler::dump_stats(std::ostream& out_stream,
     }
 }
 
+void StatsSampler::dump_stats_json(std::ostream& out_stream,
+                                   const std::set<std::string>& stat_names) const {
+    // Stat names are built from node names and identifiers, but escape them to be safe.
+    auto write_string = [&out_stream](const std::string& str) {
+        out_stream << '"';
+        for (const char c : str) {
+            if (c == '"' || c == '\\') {
+                out_stream << '\\' << c;
+            } else if (static_cast<unsigned char>(c) < 0x20) {
+                out_stream << ' ';
+            } else {
+                out_stream << c;
+            }
+        }
+        out_stream << '"';
+    };
+
+    out_stream << "[\n";
+    for (size_t i = 0; i < m_records.size(); ++i) {
+        const auto& [elapsed_ms, record] = m_records[i];
+        out_stream << "{\"elapsed_ms\":" << elapsed_ms << ",\"stats\":{";
+        bool first = true;
+        for (const auto& stat_name : stat_names) {
+            const auto stat_it = record.find(stat_name);
+            if (stat_it == record.end()) {
+                continue;
+            }
+            if (!first) {
+                out_stream << ",";
+            }
+            first = false;
+            write_string(stat_name);
+            out_stream << ":";
+            // JSON has no representation for inf or NaN.
+            if (std::isfinite(stat_it->second)) {
+                out_stream << stat_it->second;
+            } else {
+                out_stream << "null";
+            }
+        }
+        out_stream << "}}" << (i + 1 < m_records.size() ? ",\n" : "\n");
+    }
+    out_stream << "]\n";
+}
+
 void StatsSampler::sampling_thread_fn() {
     utils::set_thread_name("stats_sampling");
     m_start_time = std::chrono::system_clock::now();
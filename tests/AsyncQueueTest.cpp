@@ -8,18 +8,23 @@
 #include <catch2/generators/catch_generators.hpp>
 #include <spdlog/spdlog.h>
 
+#include <algorithm>
 #include <atomic>
+#include <memory>
 #include <numeric>
 #include <thread>
+#include <vector>
 
 using dorado::utils::AsyncQueue;
+using dorado::utils::AsyncQueueBackend;
 using dorado::utils::AsyncQueueStatus;
 
 #define TEST_GROUP "AsyncQueue "
 
 CATCH_TEST_CASE(TEST_GROUP ": InputsMatchOutputs") {
+    const auto backend = GENERATE(AsyncQueueBackend::Mutex, AsyncQueueBackend::LockFree);
     const int n = 10;
-    AsyncQueue<int> queue(n);
+    AsyncQueue<int> queue(n, backend);
 
     for (int i = 0; i < n; ++i) {
         // clang-tidy don't like us reusing a moved-from variable even if it's trivial,
@@ -37,17 +42,19 @@ CATCH_TEST_CASE(TEST_GROUP ": InputsMatchOutputs") {
 }
 
 CATCH_TEST_CASE(TEST_GROUP ": PushFailsIfTerminating") {
+    const auto backend = GENERATE(AsyncQueueBackend::Mutex, AsyncQueueBackend::LockFree);
     const auto terminate_mode = GENERATE(dorado::utils::AsyncQueueTerminateFast::No,
                                          dorado::utils::AsyncQueueTerminateFast::Yes);
 
-    AsyncQueue<int> queue(1);
+    AsyncQueue<int> queue(1, backend);
     queue.terminate(terminate_mode);
     const auto status = queue.try_push(42);
     CATCH_CHECK(status == AsyncQueueStatus::Terminate);
 }
 
 CATCH_TEST_CASE(TEST_GROUP ": PopFailsIfTerminatingFast") {
-    AsyncQueue<int> queue(1);
+    const auto backend = GENERATE(AsyncQueueBackend::Mutex, AsyncQueueBackend::LockFree);
+    AsyncQueue<int> queue(1, backend);
     auto status = queue.try_push(42);
     CATCH_CHECK(status == AsyncQueueStatus::Success);
     queue.terminate(dorado::utils::AsyncQueueTerminateFast::Yes);
@@ -57,7 +64,8 @@ CATCH_TEST_CASE(TEST_GROUP ": PopFailsIfTerminatingFast") {
 }
 
 CATCH_TEST_CASE(TEST_GROUP ": PopSucceedsIfTerminatingSlow") {
-    AsyncQueue<int> queue(1);
+    const auto backend = GENERATE(AsyncQueueBackend::Mutex, AsyncQueueBackend::LockFree);
+    AsyncQueue<int> queue(1, backend);
     auto status = queue.try_push(42);
     CATCH_CHECK(status == AsyncQueueStatus::Success);
     queue.terminate(dorado::utils::AsyncQueueTerminateFast::No);
@@ -70,10 +78,11 @@ CATCH_TEST_CASE(TEST_GROUP ": PopSucceedsIfTerminatingSlow") {
 }
 
 CATCH_TEST_CASE(TEST_GROUP ": PushPopSucceedAfterRestarting") {
+    const auto backend = GENERATE(AsyncQueueBackend::Mutex, AsyncQueueBackend::LockFree);
     const auto terminate_mode = GENERATE(dorado::utils::AsyncQueueTerminateFast::No,
                                          dorado::utils::AsyncQueueTerminateFast::Yes);
 
-    AsyncQueue<int> queue(1);
+    AsyncQueue<int> queue(1, backend);
     queue.terminate(terminate_mode);
     queue.restart();
     const auto push_status = queue.try_push(42);
@@ -85,10 +94,11 @@ CATCH_TEST_CASE(TEST_GROUP ": PushPopSucceedAfterRestarting") {
 }
 
 CATCH_TEST_CASE(TEST_GROUP ": QueueEmptyAfterRestarting") {
+    const auto backend = GENERATE(AsyncQueueBackend::Mutex, AsyncQueueBackend::LockFree);
     const auto terminate_mode = GENERATE(dorado::utils::AsyncQueueTerminateFast::No,
                                          dorado::utils::AsyncQueueTerminateFast::Yes);
 
-    AsyncQueue<int> queue(5);
+    AsyncQueue<int> queue(5, backend);
     CATCH_CHECK(queue.try_push(1) == AsyncQueueStatus::Success);
     CATCH_CHECK(queue.try_push(2) == AsyncQueueStatus::Success);
     CATCH_CHECK(queue.try_push(3) == AsyncQueueStatus::Success);
@@ -100,7 +110,8 @@ CATCH_TEST_CASE(TEST_GROUP ": QueueEmptyAfterRestarting") {
 // Spawned thread sits waiting for an item.
 // Main thread supplies that item.
 CATCH_TEST_CASE(TEST_GROUP ": PopFromOtherThread") {
-    AsyncQueue<int> queue(1);
+    const auto backend = GENERATE(AsyncQueueBackend::Mutex, AsyncQueueBackend::LockFree);
+    AsyncQueue<int> queue(1, backend);
     std::atomic_bool thread_started{false};
     AsyncQueueStatus pop_status;
 
@@ -127,7 +138,8 @@ CATCH_TEST_CASE(TEST_GROUP ": PopFromOtherThread") {
 // Spawned thread sits waiting for an item.
 // Main thread terminates wait.
 CATCH_TEST_CASE(TEST_GROUP ": TerminateFromOtherThread") {
-    AsyncQueue<int> queue(1);
+    const auto backend = GENERATE(AsyncQueueBackend::Mutex, AsyncQueueBackend::LockFree);
+    AsyncQueue<int> queue(1, backend);
     std::atomic_bool thread_started{false};
     AsyncQueueStatus pop_status;
 
@@ -152,8 +164,9 @@ CATCH_TEST_CASE(TEST_GROUP ": TerminateFromOtherThread") {
 }
 
 CATCH_TEST_CASE(TEST_GROUP ": process_and_pop_n") {
+    const auto backend = GENERATE(AsyncQueueBackend::Mutex, AsyncQueueBackend::LockFree);
     const int n = 10;
-    AsyncQueue<int> queue(n);
+    AsyncQueue<int> queue(n, backend);
     for (int i = 0; i < n; ++i) {
         // clang-tidy don't like us reusing a moved-from variable even if it's trivial,
         // so store to a temporary that's not used again after it's moved.
@@ -181,6 +194,132 @@ CATCH_TEST_CASE(TEST_GROUP ": process_and_pop_n") {
     CATCH_CHECK(queue.size() == 0);
 }
 
+CATCH_TEST_CASE(TEST_GROUP ": PushNLargerThanCapacity") {
+    const auto backend = GENERATE(AsyncQueueBackend::Mutex, AsyncQueueBackend::LockFree);
+    const int n = 100;
+    AsyncQueue<int> queue(7, backend);
+
+    std::vector<int> popped;
+    dorado::utils::jthread consumer([&queue, &popped] {
+        int item = 0;
+        while (queue.try_pop(item) == AsyncQueueStatus::Success) {
+            popped.push_back(item);
+        }
+    });
+
+    std::vector<int> items(n);
+    std::iota(items.begin(), items.end(), 0);
+    std::vector<int> expected = items;
+    CATCH_CHECK(queue.try_push_n(items) == AsyncQueueStatus::Success);
+    queue.terminate(dorado::utils::AsyncQueueTerminateFast::No);
+    consumer.join();
+
+    CATCH_CHECK(popped == expected);
+    CATCH_CHECK(queue.sample_stats().at("pushes") == n);
+}
+
+CATCH_TEST_CASE(TEST_GROUP ": PushNAfterTerminate") {
+    const auto backend = GENERATE(AsyncQueueBackend::Mutex, AsyncQueueBackend::LockFree);
+    AsyncQueue<int> queue(4, backend);
+    queue.terminate(dorado::utils::AsyncQueueTerminateFast::No);
+
+    std::vector<int> items{1, 2, 3};
+    CATCH_CHECK(queue.try_push_n(items) == AsyncQueueStatus::Terminate);
+    CATCH_CHECK(queue.size() == 0);
+}
+
+// Several producers and consumers, mixing single and batched pops, on queues small enough to
+// fill up.  Every item must come out exactly once.
+CATCH_TEST_CASE(TEST_GROUP ": ManyProducersManyConsumers") {
+    const auto backend = GENERATE(AsyncQueueBackend::Mutex, AsyncQueueBackend::LockFree);
+    const size_t capacity = GENERATE(1, 3, 100);
+    const int num_producers = 4;
+    const int num_consumers = 4;
+    const int items_per_producer = 10'000;
+    CATCH_CAPTURE(capacity);
+
+    AsyncQueue<std::unique_ptr<int>> queue(capacity, backend);
+    std::vector<std::vector<int>> consumed(num_consumers);
+    {
+        std::vector<dorado::utils::jthread> consumers;
+        for (int i = 0; i < num_consumers; ++i) {
+            consumers.emplace_back([&queue, &items = consumed[i], batched = i % 2 == 1] {
+                auto consume = [&items](std::unique_ptr<int> item) { items.push_back(*item); };
+                while (true) {
+                    if (batched) {
+                        if (queue.process_and_pop_n(consume, 7) != AsyncQueueStatus::Success) {
+                            break;
+                        }
+                    } else {
+                        std::unique_ptr<int> item;
+                        if (queue.try_pop(item) != AsyncQueueStatus::Success) {
+                            break;
+                        }
+                        consume(std::move(item));
+                    }
+                }
+            });
+        }
+
+        std::vector<dorado::utils::jthread> producers;
+        for (int i = 0; i < num_producers; ++i) {
+            producers.emplace_back([&queue, first = i * items_per_producer] {
+                for (int j = 0; j < items_per_producer; ++j) {
+                    queue.try_push(std::make_unique<int>(first + j));
+                }
+            });
+        }
+        producers.clear();
+        queue.terminate(dorado::utils::AsyncQueueTerminateFast::No);
+    }
+
+    std::vector<int> all_items;
+    for (const auto& items : consumed) {
+        all_items.insert(all_items.end(), items.begin(), items.end());
+    }
+    std::sort(all_items.begin(), all_items.end());
+    std::vector<int> expected(num_producers * items_per_producer);
+    std::iota(expected.begin(), expected.end(), 0);
+    CATCH_CHECK(all_items == expected);
+
+    const auto stats = queue.sample_stats();
+    CATCH_CHECK(stats.at("pushes") == expected.size());
+    CATCH_CHECK(stats.at("pops") == expected.size());
+}
+
+CATCH_TEST_CASE(TEST_GROUP ": PopTimesOut") {
+    const auto backend = GENERATE(AsyncQueueBackend::Mutex, AsyncQueueBackend::LockFree);
+    AsyncQueue<int> queue(1, backend);
+    int val = 0;
+    const auto status =
+            queue.try_pop_until(val, AsyncQueue<int>::Clock::now() + std::chrono::milliseconds(10));
+    CATCH_CHECK(status == AsyncQueueStatus::Timeout);
+}
+
+CATCH_TEST_CASE(TEST_GROUP ": Profiling") {
+    const auto backend = GENERATE(AsyncQueueBackend::Mutex, AsyncQueueBackend::LockFree);
+    AsyncQueue<int> queue(8, backend);
+    CATCH_CHECK(queue.sample_stats().count("depth_p50") == 0);
+
+    queue.set_profiling_enabled(true);
+    for (int i = 0; i < 5; ++i) {
+        queue.try_push(int(i));
+    }
+    int val = 0;
+    queue.try_pop(val);
+
+    const auto stats = queue.sample_stats();
+    CATCH_CHECK(stats.at("capacity") == 8);
+    CATCH_CHECK(stats.count("push_blocked_ms") == 1);
+    CATCH_CHECK(stats.count("pop_wait_ms") == 1);
+    // Depths after each push were 1, 2, 3, 4, 5.
+    CATCH_CHECK(stats.at("depth_lt_2") == 1);
+    CATCH_CHECK(stats.at("depth_lt_4") == 2);
+    CATCH_CHECK(stats.at("depth_lt_8") == 2);
+    CATCH_CHECK(stats.at("depth_p50") == 4);
+    CATCH_CHECK(stats.at("depth_p99") == 8);
+}
+
 CATCH_TEST_CASE(TEST_GROUP ": name") {
     AsyncQueue<int> queue(1);
     CATCH_CHECK(queue.get_name() == "queue");
@@ -190,6 +329,7 @@ CATCH_TEST_CASE(TEST_GROUP ": name") {
 
 #if DORADO_ENABLE_BENCHMARK_TESTS
 CATCH_TEST_CASE(TEST_GROUP ": benchmarks") {
+    const auto backend = GENERATE(AsyncQueueBackend::Mutex, AsyncQueueBackend::LockFree);
     const int run_for_ms = 2'500;
 
     const bool unbounded = GENERATE(true, false);
@@ -197,7 +337,7 @@ CATCH_TEST_CASE(TEST_GROUP ": benchmarks") {
     const int num_consumers = GENERATE(1, 2, 4);
 
     using Item = std::unique_ptr<int>;
-    AsyncQueue<Item> queue(unbounded ? 1'000'000 : 10);
+    AsyncQueue<Item> queue(unbounded ? 1'000'000 : 10, backend);
     dorado::utils::concurrency::Latch latch(num_producers + num_consumers);
     std::vector<std::size_t> processed_counts(num_consumers);
 
@@ -248,8 +388,9 @@ CATCH_TEST_CASE(TEST_GROUP ": benchmarks") {
             std::accumulate(processed_counts.begin(), processed_counts.end(), std::size_t{0});
     const double speed = total_processed * 1000.0 / run_for_ms;
     spdlog::info(TEST_GROUP
-                 ": Speed for unbounded={}, producers={}, consumers={}: {:.2e} items in {}ms "
-                 "({:.2e}items/s)",
-                 unbounded, num_producers, num_consumers, total_processed, run_for_ms, speed);
+                 ": Speed for lock_free={}, unbounded={}, producers={}, consumers={}: {:.2e} items "
+                 "in {}ms ({:.2e}items/s)",
+                 backend == AsyncQueueBackend::LockFree, unbounded, num_producers, num_consumers,
+                 total_processed, run_for_ms, speed);
 }
 #endif
@@ -1,5 +1,6 @@
 #include "demux/BarcodeClassifier.h"
 
+#include "../dorado/demux/BarcodeMaskScorer.h"
 #include "MessageSinkUtils.h"
 #include "TestUtils.h"
 #include "demux/barcoding_info.h"
@@ -16,13 +17,16 @@
 #include "utils/types.h"
 
 #include <ATen/Functions.h>
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/generators/catch_generators.hpp>
 #include <catch2/matchers/catch_matchers_all.hpp>
+#include <edlib.h>
 #include <htslib/sam.h>
 
 #include <cstdint>
 #include <filesystem>
+#include <random>
 #include <string>
 #include <vector>
 
@@ -46,6 +50,40 @@ std::shared_ptr<const demux::BarcodingInfo> create_barcoding_info(
     return std::make_shared<demux::BarcodingInfo>(std::move(result));
 }
 
+std::string random_sequence(std::mt19937& rng, size_t length, std::string_view alphabet) {
+    std::uniform_int_distribution<size_t> dist(0, alphabet.size() - 1);
+    std::string seq(length, 'A');
+    for (auto& base : seq) {
+        base = alphabet[dist(rng)];
+    }
+    return seq;
+}
+
+int edlib_global_distance(const std::string& pattern, std::string_view window) {
+    EdlibAlignConfig config = edlibDefaultAlignConfig();
+    config.mode = EDLIB_MODE_NW;
+    config.task = EDLIB_TASK_DISTANCE;
+    auto result = edlibAlign(pattern.data(), int(pattern.length()), window.data(),
+                             int(window.length()), config);
+    const int distance = result.editDistance;
+    edlibFreeAlignResult(result);
+    return distance;
+}
+
+std::vector<std::string> load_sequences(const fs::path& data_dir) {
+    std::vector<std::string> seqs;
+    for (const auto& entry : fs::directory_iterator(data_dir)) {
+        if (entry.path().extension() != ".fastq") {
+            continue;
+        }
+        HtsReader reader(entry.path().string(), std::nullopt);
+        while (reader.read()) {
+            seqs.push_back(utils::extract_sequence(reader.record.get()));
+        }
+    }
+    return seqs;
+}
+
 }  // namespace
 
 CATCH_TEST_CASE("BarcodeClassifier: check instantiation for all kits", TEST_GROUP) {
@@ -68,6 +106,42 @@ CATCH_TEST_CASE("BarcodeClassifier: check instantiation for all kits", TEST_GROU
     }
 }
 
+CATCH_TEST_CASE("BarcodeMaskScorer: matches edlib global alignment", TEST_GROUP) {
+    // Lengths either side of the 64 base lane limit, and pattern counts that leave a
+    // partially filled register.
+    const size_t pattern_length = GENERATE(1, 24, 44, 63, 64, 65, 100);
+    const size_t num_patterns = GENERATE(1, 3, 4, 96);
+    CATCH_CAPTURE(pattern_length, num_patterns);
+
+    std::mt19937 rng(42);
+    std::vector<std::string> patterns;
+    for (size_t i = 0; i < num_patterns; ++i) {
+        patterns.push_back(random_sequence(rng, pattern_length, "ACGT"));
+    }
+    demux::BarcodeMaskScorer scorer(patterns);
+    CATCH_CHECK(scorer.num_patterns() == num_patterns);
+    CATCH_CHECK(scorer.pattern_length() == pattern_length);
+
+    std::vector<int> penalties(num_patterns);
+    for (size_t window_length : {size_t{0}, size_t{1}, pattern_length / 2, pattern_length,
+                                 pattern_length + 7, 2 * pattern_length + 3}) {
+        // Include bases which are in none of the patterns.
+        auto window = random_sequence(rng, window_length, "ACGTN");
+        if (window_length >= pattern_length) {
+            window.replace(0, pattern_length, patterns.back());
+        }
+        scorer.score(window, penalties);
+        for (size_t i = 0; i < num_patterns; ++i) {
+            CATCH_CAPTURE(window_length, i);
+            CATCH_CHECK(penalties[i] == edlib_global_distance(patterns[i], window));
+        }
+    }
+}
+
+CATCH_TEST_CASE("BarcodeMaskScorer: rejects mismatched pattern lengths", TEST_GROUP) {
+    CATCH_CHECK_THROWS(demux::BarcodeMaskScorer({"ACGT", "ACG"}));
+}
+
 CATCH_TEST_CASE("BarcodeClassifier: instantiate barcode with unknown kit", TEST_GROUP) {
     CATCH_CHECK_THROWS(demux::BarcodeClassifier("MY_RANDOM_KIT"));
 }
@@ -513,4 +587,54 @@ CATCH_TEST_CASE("BarcodeClassifier: test custom kit with double ended barcode",
     }
 }
 
+#if DORADO_ENABLE_BENCHMARK_TESTS
+CATCH_TEST_CASE("BarcodeMaskScorer: benchmark against edlib", TEST_GROUP) {
+    // A 96 barcode kit with the default flank padding.
+    const size_t num_patterns = 96;
+    const size_t pattern_length = 5 + 24 + 10;
+
+    std::mt19937 rng(42);
+    std::vector<std::string> patterns;
+    for (size_t i = 0; i < num_patterns; ++i) {
+        patterns.push_back(random_sequence(rng, pattern_length, "ACGT"));
+    }
+    const auto window = random_sequence(rng, pattern_length + 2, "ACGT");
+    demux::BarcodeMaskScorer scorer(patterns);
+    std::vector<int> penalties(num_patterns);
+
+    CATCH_BENCHMARK("edlib per barcode") {
+        int total = 0;
+        for (const auto& pattern : patterns) {
+            total += edlib_global_distance(pattern, window);
+        }
+        return total;
+    };
+    CATCH_BENCHMARK("BarcodeMaskScorer") {
+        scorer.score(window, penalties);
+        return penalties[0];
+    };
+}
+
+CATCH_TEST_CASE("BarcodeClassifier: classification benchmark", TEST_GROUP) {
+    const auto [kit_name, data_subdir] = GENERATE(table<std::string, std::string>({
+            {"SQK-RBK114-96", "barcode_demux/single_end"},
+            {"SQK-RPB004", "barcode_demux/double_end"},
+            {"EXP-PBC096", "barcode_demux/double_end_variant"},
+    }));
+    const bool barcode_both_ends = GENERATE(false, true);
+
+    const auto seqs = load_sequences(fs::path(get_data_dir(data_subdir)));
+    demux::BarcodeClassifier classifier(kit_name);
+
+    CATCH_BENCHMARK(kit_name + (barcode_both_ends ? " (both ends)" : "")) {
+        size_t num_classified = 0;
+        for (const auto& seq : seqs) {
+            auto res = classifier.barcode(seq, barcode_both_ends, std::nullopt);
+            num_classified += res.barcode_name != dorado::UNCLASSIFIED;
+        }
+        return num_classified;
+    };
+}
+#endif  // DORADO_ENABLE_BENCHMARK_TESTS
+
 }  // namespace dorado::barcode_classifier_test
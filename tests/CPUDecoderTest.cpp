@@ -0,0 +1,85 @@
+#include "../dorado/basecall/decode/CPUDecoder.h"
+#include "../dorado/basecall/decode/crf_forward_backward.h"
+
+#include <ATen/ATen.h>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <spdlog/spdlog.h>
+
+#define CUT_TAG "[CPUDecoder]"
+
+namespace {
+
+using namespace dorado::basecall::decode;
+
+constexpr float kFixedStayScore = 2.0f;
+
+// The ATen path, as used by the decoder before the fused kernel.
+std::pair<at::Tensor, at::Tensor> reference_forward_backward(const at::Tensor& scores_TNC) {
+    const auto fwd = inner::forward_scores(scores_TNC, kFixedStayScore);
+    const auto bwd = inner::backward_scores(scores_TNC, kFixedStayScore);
+    const auto posts = at::softmax(fwd + bwd, -1);
+    return {bwd.transpose(0, 1).contiguous(), posts.transpose(0, 1).contiguous()};
+}
+
+}  // namespace
+
+CATCH_TEST_CASE(CUT_TAG ": fused forward_backward matches ATen", CUT_TAG) {
+    at::manual_seed(42);
+
+    const int state_len = GENERATE(2, 3, 4, 5);
+    const int num_blocks = GENERATE(1, 17, 100);
+    const int num_chunks = 3;
+    const int num_states = 1 << (2 * state_len);
+    CATCH_CAPTURE(state_len, num_blocks);
+
+    const auto scores_TNC = at::randn({num_blocks, num_chunks, num_states * 4}) * 2.0f;
+    const auto [expected_bwd, expected_posts] = reference_forward_backward(scores_TNC);
+
+    ForwardBackwardWorkspace workspace;
+    for (int chunk_idx = 0; chunk_idx < num_chunks; ++chunk_idx) {
+        forward_backward(scores_TNC.data_ptr<float>() + chunk_idx * num_states * 4,
+                         num_chunks * num_states * 4, num_blocks, num_states, kFixedStayScore,
+                         workspace);
+        const auto bwd = at::from_blob(workspace.bwd(), {num_blocks + 1, num_states});
+        const auto posts = at::from_blob(workspace.posts(), {num_blocks + 1, num_states});
+
+        CATCH_CHECK(at::allclose(bwd, expected_bwd[chunk_idx], 1e-5, 1e-3));
+        CATCH_CHECK(at::allclose(posts, expected_posts[chunk_idx], 1e-4, 1e-5));
+    }
+}
+
+CATCH_TEST_CASE(CUT_TAG ": forward_backward rejects bad state counts", CUT_TAG) {
+    ForwardBackwardWorkspace workspace;
+    std::vector<float> scores(4 * 6);
+    CATCH_CHECK_THROWS(forward_backward(scores.data(), 4 * 6, 1, 6, kFixedStayScore, workspace));
+    CATCH_CHECK_THROWS(forward_backward(scores.data(), 4 * 2, 1, 2, kFixedStayScore, workspace));
+}
+
+#if DORADO_ENABLE_BENCHMARK_TESTS
+CATCH_TEST_CASE(CUT_TAG ": forward_backward benchmark", CUT_TAG) {
+    // Typical CPU chunk sizes: 10k samples at stride 5/6, for state_len 4 and 5 models.
+    const int state_len = GENERATE(4, 5);
+    const int num_blocks = GENERATE(1666, 2000);
+    const int num_chunks = 4;
+    const int num_states = 1 << (2 * state_len);
+
+    const auto scores_TNC = at::randn({num_blocks, num_chunks, num_states * 4});
+    ForwardBackwardWorkspace workspace;
+
+    CATCH_BENCHMARK(fmt::format("ATen forward/backward ({} states, {} blocks)", num_states,
+                                num_blocks)) {
+        return reference_forward_backward(scores_TNC);
+    };
+    CATCH_BENCHMARK(fmt::format("fused forward_backward ({} states, {} blocks)", num_states,
+                                num_blocks)) {
+        for (int chunk_idx = 0; chunk_idx < num_chunks; ++chunk_idx) {
+            forward_backward(scores_TNC.data_ptr<float>() + chunk_idx * num_states * 4,
+                             num_chunks * num_states * 4, num_blocks, num_states,
+                             kFixedStayScore, workspace);
+        }
+        return workspace.posts()[0];
+    };
+}
+#endif  // DORADO_ENABLE_BENCHMARK_TESTS
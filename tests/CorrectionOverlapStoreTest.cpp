@@ -0,0 +1,133 @@
+#include "TestUtils.h"
+#include "correct/overlap_store.h"
+#include "read_pipeline/base/messages.h"
+#include "utils/cigar.h"
+#include "utils/overlap.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#define TEST_GROUP "[Correction-OverlapStore]"
+
+namespace dorado::correction::overlap_store_tests {
+
+namespace {
+
+CorrectionAlignments make_pile(const std::string& target, int num_overlaps) {
+    CorrectionAlignments alignments;
+    alignments.read_name = target;
+    for (int i = 0; i < num_overlaps; ++i) {
+        alignments.qnames.push_back("query_" + std::to_string(i % 3));
+        utils::Overlap overlap;
+        overlap.qstart = i;
+        overlap.qend = 1000 + i;
+        overlap.qlen = 2000;
+        overlap.tstart = 100000 + i;
+        overlap.tend = 101000 + i;
+        overlap.tlen = 200000;
+        overlap.fwd = (i % 2) == 0;
+        alignments.overlaps.push_back(overlap);
+        alignments.cigars.push_back({{CigarOpType::EQ, 500},
+                                     {CigarOpType::I, 1},
+                                     {CigarOpType::X, uint32_t(i)},
+                                     {CigarOpType::D, 70000}});
+    }
+    return alignments;
+}
+
+void check_equal(const CorrectionAlignments& lhs, const CorrectionAlignments& rhs) {
+    CATCH_CHECK(lhs.read_name == rhs.read_name);
+    CATCH_CHECK(lhs.qnames == rhs.qnames);
+    CATCH_REQUIRE(lhs.overlaps.size() == rhs.overlaps.size());
+    CATCH_REQUIRE(lhs.cigars.size() == rhs.cigars.size());
+    for (size_t i = 0; i < lhs.overlaps.size(); ++i) {
+        const auto& l = lhs.overlaps[i];
+        const auto& r = rhs.overlaps[i];
+        CATCH_CHECK(l.qstart == r.qstart);
+        CATCH_CHECK(l.qend == r.qend);
+        CATCH_CHECK(l.qlen == r.qlen);
+        CATCH_CHECK(l.tstart == r.tstart);
+        CATCH_CHECK(l.tend == r.tend);
+        CATCH_CHECK(l.tlen == r.tlen);
+        CATCH_CHECK(l.fwd == r.fwd);
+        CATCH_REQUIRE(lhs.cigars[i].size() == rhs.cigars[i].size());
+        for (size_t j = 0; j < lhs.cigars[i].size(); ++j) {
+            CATCH_CHECK(lhs.cigars[i][j].op == rhs.cigars[i][j].op);
+            CATCH_CHECK(lhs.cigars[i][j].len == rhs.cigars[i][j].len);
+        }
+    }
+}
+
+}  // namespace
+
+CATCH_TEST_CASE("Overlaps round trip through the store", TEST_GROUP) {
+    auto temp_dir = tests::make_temp_dir("overlap_store_test");
+    const auto path = temp_dir.m_path / "overlaps.dovl";
+
+    // Piles arrive in no particular order.
+    const std::vector<CorrectionAlignments> piles{make_pile("target_c", 5),
+                                                  make_pile("target_a", 1),
+                                                  make_pile("query_1", 3)};
+    {
+        OverlapStoreWriter writer(path);
+        for (const auto& pile : piles) {
+            writer.add(pile);
+        }
+        writer.finalise();
+        CATCH_CHECK(writer.num_overlaps() == 9);
+    }
+    CATCH_REQUIRE(is_overlap_store_file(path));
+
+    const OverlapStoreReader reader(path);
+    CATCH_CHECK(reader.num_overlaps() == 9);
+    CATCH_REQUIRE(reader.num_piles() == 3);
+
+    // Piles are sorted by target name.
+    CATCH_CHECK(reader.target_name(0) == "query_1");
+    CATCH_CHECK(reader.target_name(1) == "target_a");
+    CATCH_CHECK(reader.target_name(2) == "target_c");
+
+    for (const auto& pile : piles) {
+        const auto index = reader.find_target(pile.read_name);
+        CATCH_REQUIRE(index.has_value());
+        CorrectionAlignments loaded;
+        reader.load(*index, loaded);
+        check_equal(loaded, pile);
+    }
+    CATCH_CHECK_FALSE(reader.find_target("target_b").has_value());
+    CATCH_CHECK_FALSE(reader.find_target("").has_value());
+}
+
+CATCH_TEST_CASE("An unfinalised store is not written", TEST_GROUP) {
+    auto temp_dir = tests::make_temp_dir("overlap_store_test");
+    const auto path = temp_dir.m_path / "overlaps.dovl";
+    {
+        OverlapStoreWriter writer(path);
+        writer.add(make_pile("target", 2));
+    }
+    CATCH_CHECK(std::filesystem::is_empty(temp_dir.m_path));
+}
+
+CATCH_TEST_CASE("Truncated stores and PAF files are rejected", TEST_GROUP) {
+    auto temp_dir = tests::make_temp_dir("overlap_store_test");
+    const auto path = temp_dir.m_path / "overlaps.dovl";
+    {
+        OverlapStoreWriter writer(path);
+        writer.add(make_pile("target", 2));
+        writer.finalise();
+    }
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+    CATCH_CHECK(is_overlap_store_file(path));
+    CATCH_CHECK_THROWS(OverlapStoreReader(path));
+
+    const auto paf_path = temp_dir.m_path / "overlaps.paf";
+    std::ofstream(paf_path) << "query\t2000\t0\t1000\t+\ttarget\t2000\t0\t1000\t0\t0\t60\n";
+    CATCH_CHECK_FALSE(is_overlap_store_file(paf_path));
+    CATCH_CHECK_THROWS(OverlapStoreReader(paf_path));
+}
+
+}  // namespace dorado::correction::overlap_store_tests
@@ -0,0 +1,80 @@
+#include "utils/LoserTree.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
+
+#define TEST_GROUP "[utils][LoserTree]"
+
+using dorado::utils::LoserTree;
+
+namespace {
+
+// Merges the sorted sources, returning (value, source index) pairs in output order.
+std::vector<std::pair<int, size_t>> merge(const std::vector<std::vector<int>>& sources) {
+    LoserTree<int> tree(sources.size());
+    for (size_t i = 0; i < sources.size(); ++i) {
+        if (!sources[i].empty()) {
+            tree.set(i, sources[i].front());
+        }
+    }
+    tree.build();
+
+    std::vector<size_t> positions(sources.size(), 0);
+    std::vector<std::pair<int, size_t>> merged;
+    while (!tree.empty()) {
+        const auto source = tree.top();
+        merged.emplace_back(tree.top_key(), source);
+        if (++positions[source] < sources[source].size()) {
+            tree.replace_top(sources[source][positions[source]]);
+        } else {
+            tree.pop_top();
+        }
+    }
+    return merged;
+}
+
+}  // namespace
+
+CATCH_TEST_CASE("LoserTree: no sources with data", TEST_GROUP) {
+    CATCH_CHECK(merge({}).empty());
+    CATCH_CHECK(merge({{}, {}, {}}).empty());
+}
+
+CATCH_TEST_CASE("LoserTree: single source", TEST_GROUP) {
+    const auto merged = merge({{1, 2, 2, 5}});
+    const std::vector<std::pair<int, size_t>> expected{{1, 0}, {2, 0}, {2, 0}, {5, 0}};
+    CATCH_CHECK(merged == expected);
+}
+
+CATCH_TEST_CASE("LoserTree: ties go to the lowest source", TEST_GROUP) {
+    const auto merged = merge({{3}, {1, 3}, {}, {3}});
+    const std::vector<std::pair<int, size_t>> expected{{1, 1}, {3, 0}, {3, 1}, {3, 3}};
+    CATCH_CHECK(merged == expected);
+}
+
+CATCH_TEST_CASE("LoserTree: matches a stable sort", TEST_GROUP) {
+    const size_t num_sources = GENERATE(2, 3, 7, 64, 513);
+    CATCH_CAPTURE(num_sources);
+
+    std::mt19937 rng(42);
+    std::vector<std::vector<int>> sources(num_sources);
+    std::vector<std::pair<int, size_t>> expected;
+    for (size_t i = 0; i < num_sources; ++i) {
+        const auto length = rng() % 50;
+        for (size_t j = 0; j < length; ++j) {
+            sources[i].push_back(int(rng() % 100));
+        }
+        std::sort(sources[i].begin(), sources[i].end());
+        for (const int value : sources[i]) {
+            expected.emplace_back(value, i);
+        }
+    }
+    std::sort(expected.begin(), expected.end());
+
+    CATCH_CHECK(merge(sources) == expected);
+}
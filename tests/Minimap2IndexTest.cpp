@@ -1,17 +1,26 @@
 #include "alignment/Minimap2Index.h"
 
 #include "TestUtils.h"
+#include "alignment/Minimap2MappedIndex.h"
 #include "alignment/minimap2_args.h"
 #include "alignment/minimap2_wrappers.h"
 #include "hts_utils/hts_file.h"
 #include "read_pipeline/nodes/HtsWriterNode.h"
+#include "utils/sequence_utils.h"
 #include "utils/stream_utils.h"
 #include "utils/types.h"
 
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/catch_test_macros.hpp>
 #include <htslib/sam.h>
 
+#include <cstdio>
+#include <cstdlib>
 #include <filesystem>
+#include <fstream>
+#include <string>
+#include <tuple>
+#include <vector>
 
 #define TEST_GROUP "[alignment::Minimap2Index]"
 
@@ -38,6 +47,36 @@ public:
     }
 };
 
+using Hit = std::tuple<int32_t, int32_t, int32_t, uint32_t, int32_t>;
+
+// Maps |seq| against |index|, returning (rid, rs, re, rev, mapq) for each hit.
+std::vector<Hit> map_sequence(const dorado::alignment::Minimap2Index& index,
+                              const std::string& seq) {
+    mm_tbuf_t* tbuf = mm_tbuf_init();
+    int n_regs = 0;
+    mm_reg1_t* regs = mm_map(index.index(), int(seq.length()), seq.data(), &n_regs, tbuf,
+                             &index.mapping_options(), "query");
+    std::vector<Hit> hits;
+    for (int i = 0; i < n_regs; ++i) {
+        hits.emplace_back(regs[i].rid, regs[i].rs, regs[i].re, regs[i].rev, regs[i].mapq);
+        std::free(regs[i].p);
+    }
+    std::free(regs);
+    mm_tbuf_destroy(tbuf);
+    return hits;
+}
+
+// Returns bases [start, end) of reference |rid| from the sequence held in |index|.
+std::string extract_reference(const mm_idx_t& index, uint32_t rid, uint32_t start, uint32_t end) {
+    std::vector<uint8_t> codes(end - start);
+    mm_idx_getseq(&index, rid, start, end, codes.data());
+    std::string seq(codes.size(), 'N');
+    for (size_t i = 0; i < codes.size(); ++i) {
+        seq[i] = codes[i] < 4 ? "ACGT"[codes[i]] : 'N';
+    }
+    return seq;
+}
+
 }  // namespace
 
 namespace dorado::alignment::test {
@@ -226,6 +265,125 @@ CATCH_TEST_CASE(TEST_GROUP " Test split index loading", TEST_GROUP) {
         }
         CATCH_CHECK(cut.load_next_chunk(1) == IndexLoadResult::end_of_index);
     }
+
+    CATCH_SECTION("Sequential index loading with prefetching") {
+        Minimap2Index cut{};
+        cut.initialise(opts);
+
+        CATCH_CHECK(cut.load(temp_input_file.string(), 1, true) == IndexLoadResult::success);
+        for (int i = 2; i < 6; ++i) {
+            CATCH_CHECK(cut.has_next_chunk());
+            cut.prefetch_next_chunk(1);
+            // Prefetching doesn't change the current chunk.
+            CATCH_CHECK(cut.get_sequence_records_for_header()[0].sequence_name ==
+                        ("read" + std::to_string(i - 1)));
+
+            CATCH_CHECK(cut.load_next_chunk(1) == IndexLoadResult::success);
+            const auto header_records = cut.get_sequence_records_for_header();
+            CATCH_CHECK(header_records.size() == 1);
+            CATCH_CHECK(header_records[0].sequence_name == ("read" + std::to_string(i)));
+            MD5Hex hex;
+            md5gen.get_sequence_md5(hex, sequences[header_records[0].sequence_name]);
+            CATCH_CHECK(std::string(header_records[0].md5) == std::string(hex));
+        }
+        cut.prefetch_next_chunk(1);
+        CATCH_CHECK_FALSE(cut.has_next_chunk());
+        CATCH_CHECK(cut.load_next_chunk(1) == IndexLoadResult::end_of_index);
+        CATCH_CHECK_FALSE(cut.has_next_chunk());
+    }
+}
+
+CATCH_TEST_CASE_METHOD(Minimap2IndexTestFixture,
+                       TEST_GROUP " save_mapped_index() then load() gives an identical index",
+                       TEST_GROUP) {
+    CATCH_REQUIRE(cut.load(reference_file, 1, false) == IndexLoadResult::success);
+    auto temp_dir = tests::make_temp_dir("mm2_mapped_index_test");
+    const auto mapped_file = temp_dir.m_path / ("target" + std::string(MAPPED_INDEX_EXTENSION));
+    cut.save_mapped_index(mapped_file);
+    CATCH_REQUIRE(is_mapped_index_file(mapped_file));
+    CATCH_CHECK_FALSE(is_mapped_index_file(reference_file));
+
+    Minimap2Index mapped{};
+    mapped.initialise(create_dflt_options());
+    CATCH_REQUIRE(mapped.load(mapped_file.string(), 1, false) == IndexLoadResult::success);
+    CATCH_CHECK(mapped.num_loaded_index_blocks() == 1);
+    CATCH_CHECK(mapped.load_next_chunk(1) == IndexLoadResult::end_of_index);
+
+    const auto& expected = *cut.index();
+    const auto& actual = *mapped.index();
+    CATCH_CHECK(actual.k == expected.k);
+    CATCH_CHECK(actual.w == expected.w);
+    CATCH_CHECK(actual.b == expected.b);
+    CATCH_CHECK(actual.flag == expected.flag);
+    CATCH_REQUIRE(actual.n_seq == expected.n_seq);
+    for (uint32_t i = 0; i < expected.n_seq; ++i) {
+        CATCH_CHECK(std::string(actual.seq[i].name) == expected.seq[i].name);
+        CATCH_CHECK(actual.seq[i].len == expected.seq[i].len);
+        CATCH_CHECK(extract_reference(actual, i, 0, actual.seq[i].len) ==
+                    extract_reference(expected, i, 0, expected.seq[i].len));
+    }
+    CATCH_CHECK(mapped.mapping_options().mid_occ == cut.mapping_options().mid_occ);
+
+    // Map pieces of the reference, in both orientations, against both indexes.
+    const uint32_t ref_len = expected.seq[0].len;
+    for (uint32_t start = 0; start + 500 <= ref_len; start += 250) {
+        const auto query = extract_reference(expected, 0, start, start + 500);
+        CATCH_CHECK(map_sequence(mapped, query) == map_sequence(cut, query));
+        const auto rc_query = reverse_complement(query);
+        CATCH_CHECK(map_sequence(mapped, rc_query) == map_sequence(cut, rc_query));
+    }
+}
+
+CATCH_TEST_CASE_METHOD(Minimap2IndexTestFixture,
+                       TEST_GROUP " load() with a truncated mapped index returns file_open_error",
+                       TEST_GROUP) {
+    CATCH_REQUIRE(cut.load(reference_file, 1, false) == IndexLoadResult::success);
+    auto temp_dir = tests::make_temp_dir("mm2_mapped_index_test");
+    const auto mapped_file = temp_dir.m_path / "truncated.dmmi";
+    cut.save_mapped_index(mapped_file);
+    std::filesystem::resize_file(mapped_file, std::filesystem::file_size(mapped_file) / 2);
+
+    Minimap2Index mapped{};
+    mapped.initialise(create_dflt_options());
+    CATCH_CHECK(mapped.load(mapped_file.string(), 1, false) == IndexLoadResult::file_open_error);
+}
+
+#if DORADO_ENABLE_BENCHMARK_TESTS
+CATCH_TEST_CASE(TEST_GROUP " Benchmark index startup", TEST_GROUP) {
+    auto temp_dir = tests::make_temp_dir("mm2_mapped_index_benchmark");
+    const auto fasta_file = temp_dir.m_path / "reference.fa";
+    {
+        std::ofstream fasta(fasta_file);
+        for (int i = 0; i < 16; ++i) {
+            fasta << ">contig" << i << '\n' << generate_random_sequence_string(2'000'000) << '\n';
+        }
+    }
+
+    Minimap2Index built{};
+    built.initialise(create_dflt_options());
+    CATCH_REQUIRE(built.load(fasta_file.string(), 4, false) == IndexLoadResult::success);
+
+    const auto mmi_file = temp_dir.m_path / "reference.mmi";
+    {
+        FILE* fp = std::fopen(mmi_file.string().c_str(), "wb");
+        CATCH_REQUIRE(fp != nullptr);
+        mm_idx_dump(fp, built.index());
+        std::fclose(fp);
+    }
+    const auto mapped_file = temp_dir.m_path / "reference.dmmi";
+    built.save_mapped_index(mapped_file);
+
+    CATCH_BENCHMARK("load .mmi") {
+        Minimap2Index index{};
+        index.initialise(create_dflt_options());
+        return index.load(mmi_file.string(), 4, false);
+    };
+    CATCH_BENCHMARK("load .dmmi") {
+        Minimap2Index index{};
+        index.initialise(create_dflt_options());
+        return index.load(mapped_file.string(), 4, false);
+    };
 }
+#endif  // DORADO_ENABLE_BENCHMARK_TESTS
 
 }  // namespace dorado::alignment::test
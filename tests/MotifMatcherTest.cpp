@@ -1,8 +1,22 @@
 #include "modbase/MotifMatcher.h"
 
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/generators/catch_generators.hpp>
 
+#include <random>
+#if defined(__GNUC__) && !defined(__clang__) && !defined(__INTEL_COMPILER)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+#include <regex>
+#if defined(__GNUC__) && !defined(__clang__) && !defined(__INTEL_COMPILER)
+#pragma GCC diagnostic pop
+#endif
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 #define TEST_GROUP "[modbase_motif_matcher]"
 
 using std::make_tuple;
@@ -20,6 +34,44 @@ const std::string SEQ = "AACCGGTTACGTGGACTGACACTAAA";
 //                      "            DRACH         "
 //                      "                DRACH     "
 // clang-format on
+
+// The std::regex based matcher that MotifMatcher used to be.
+std::vector<size_t> regex_motif_hits(const std::string& motif,
+                                     size_t motif_offset,
+                                     const std::string& seq) {
+    const std::unordered_map<char, std::string> iupac_codes{
+            {'A', "A"},      {'C', "C"},     {'G', "G"},     {'T', "T"},     {'U', "T"},
+            {'R', "[AG]"},   {'Y', "[CT]"},  {'S', "[GC]"},  {'W', "[AT]"},  {'K', "[GT]"},
+            {'M', "[AC]"},   {'B', "[CGT]"}, {'D', "[AGT]"}, {'H', "[ACT]"}, {'V', "[ACG]"},
+            {'N', "[ACGT]"},
+    };
+    std::string motif_regex = "(";
+    for (auto base : motif) {
+        motif_regex += iupac_codes.at(base);
+    }
+    motif_regex += ")";
+
+    std::vector<size_t> hits;
+    const std::regex regex(motif_regex);
+    std::smatch motif_match;
+    auto start = seq.cbegin();
+    while (std::regex_search(start, seq.cend(), motif_match, regex)) {
+        hits.push_back(std::distance(seq.cbegin(), start) + motif_match.position(0) +
+                       motif_offset);
+        start += motif_match.position(0) + 1;
+    }
+    return hits;
+}
+
+std::string random_sequence(std::mt19937& rng, size_t length, std::string_view alphabet) {
+    std::uniform_int_distribution<size_t> dist(0, alphabet.size() - 1);
+    std::string seq(length, 'A');
+    for (auto& base : seq) {
+        base = alphabet[dist(rng)];
+    }
+    return seq;
+}
+
 }  // namespace
 
 CATCH_TEST_CASE(TEST_GROUP ": test motifs", TEST_GROUP) {
@@ -41,3 +93,38 @@ CATCH_TEST_CASE(TEST_GROUP ": test motifs", TEST_GROUP) {
     auto hits = matcher.get_motif_hits(SEQ);
     CATCH_CHECK(hits == expected_results);
 }
+
+CATCH_TEST_CASE(TEST_GROUP ": matches regex reference", TEST_GROUP) {
+    // Covers the vectorised path (C, CG, GC), the shift-and path, and motifs over 64 bases.
+    const std::string motif = GENERATE(as<std::string>{}, "C", "CG", "GC", "AA", "N", "TAC",
+                                       "DRACH", "GATC", "RN", std::string(70, 'N') + "CG");
+    // Lower case and N bases never match.
+    const std::string alphabet = GENERATE(as<std::string>{}, "ACGT", "ACGTNa");
+    CATCH_CAPTURE(motif, alphabet);
+
+    std::mt19937 rng(42);
+    dorado::modbase::MotifMatcher matcher(motif, 1);
+    for (size_t length : {0, 1, 2, 15, 16, 17, 31, 32, 33, 65, 1000}) {
+        CATCH_CAPTURE(length);
+        const auto seq = random_sequence(rng, length, alphabet);
+        CATCH_CHECK(matcher.get_motif_hits(seq) == regex_motif_hits(motif, 1, seq));
+    }
+}
+
+CATCH_TEST_CASE(TEST_GROUP ": invalid motifs throw", TEST_GROUP) {
+    CATCH_CHECK_THROWS(dorado::modbase::MotifMatcher("CX", 0));
+    CATCH_CHECK_THROWS(dorado::modbase::MotifMatcher("cg", 0));
+    CATCH_CHECK_THROWS(dorado::modbase::MotifMatcher("", 0));
+}
+
+#if DORADO_ENABLE_BENCHMARK_TESTS
+CATCH_TEST_CASE(TEST_GROUP ": benchmark", TEST_GROUP) {
+    const std::string motif = GENERATE(as<std::string>{}, "CG", "DRACH");
+    std::mt19937 rng(42);
+    const auto seq = random_sequence(rng, 4'000'000, "ACGT");
+    dorado::modbase::MotifMatcher matcher(motif, 0);
+
+    CATCH_BENCHMARK("regex " + motif) { return regex_motif_hits(motif, 0, seq); };
+    CATCH_BENCHMARK("MotifMatcher " + motif) { return matcher.get_motif_hits(seq); };
+}
+#endif  // DORADO_ENABLE_BENCHMARK_TESTS
@@ -24,6 +24,7 @@
 #include "utils/PostCondition.h"
 #include "utils/SampleSheet.h"
 #include "utils/parameters.h"
+#include "utils/stats.h"
 
 #include <torch/cuda.h>
 
@@ -102,6 +103,9 @@ protected:
     void set_read_mutator(ReadMutator mutator) { m_read_mutator = std::move(mutator); }
     void set_pipeline_restart(bool restart) { m_pipeline_restart = restart; }
 
+    // Stats of the nodes when the pipeline was terminated at the end of the test.
+    dorado::stats::NamedStats m_final_stats;
+
     template <class NodeType, class... Args>
     void run_smoke_test(Args&&... args) {
         dorado::PipelineDescriptor pipeline_desc;
@@ -122,7 +126,7 @@ protected:
             pipeline->push_message(std::move(read));
         }
         // Wait for them to complete.
-        pipeline->terminate({.fast = dorado::utils::AsyncQueueTerminateFast::No});
+        m_final_stats = pipeline->terminate({.fast = dorado::utils::AsyncQueueTerminateFast::No});
         // Check that we get the expected number of outputs
         CATCH_CHECK(messages.size() == m_num_messages);
         // Check the message types match
@@ -257,6 +261,14 @@ DEFINE_TEST(NodeSmokeTestRead, "BasecallerNode") {
     CATCH_CHECK(num_devices != 0);
     run_smoke_test<dorado::BasecallerNode>(std::move(runners), model_config.basecaller.overlap(),
                                            model_name, 1000, "BasecallerNode", 0);
+
+    // Every read takes at least one chunk from the pool, and all of them are given back.
+    const double allocated = m_final_stats.at("BasecallerNode.chunk_pool_allocated");
+    const double reused = m_final_stats.at("BasecallerNode.chunk_pool_reused");
+    CATCH_CHECK(allocated > 0);
+    CATCH_CHECK(allocated + reused >= 5);
+    CATCH_CHECK(m_final_stats.at("BasecallerNode.chunk_pool_in_use") == 0);
+    CATCH_CHECK(m_final_stats.at("BasecallerNode.chunk_pool_free") <= allocated);
 }
 
 DEFINE_TEST(NodeSmokeTestRead, "ModBaseCallerNode") {
@@ -0,0 +1,48 @@
+#include "utils/PackedSequence.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <string>
+
+#define TEST_GROUP "[PackedSequence]"
+
+using dorado::utils::PackedSequence;
+
+CATCH_TEST_CASE(TEST_GROUP " ACGT sequences round trip", TEST_GROUP) {
+    // Cover every length modulo 4, so that the last byte is partly filled.
+    const std::string seq = GENERATE(as<std::string>{}, "", "A", "CG", "TAC", "GATT",
+                                     "ACGTTGCAACGTACGTAAACCCGGGTTT");
+    CATCH_CAPTURE(seq);
+
+    const PackedSequence packed(seq);
+    CATCH_CHECK(packed.size() == seq.size());
+    CATCH_CHECK(packed.unpack() == seq);
+}
+
+CATCH_TEST_CASE(TEST_GROUP " Lowercase bases unpack as uppercase", TEST_GROUP) {
+    const PackedSequence packed("acgtACGTtgca");
+    CATCH_CHECK(packed.unpack() == "ACGTACGTTGCA");
+}
+
+CATCH_TEST_CASE(TEST_GROUP " Non-ACGT bases unpack as N", TEST_GROUP) {
+    CATCH_CHECK(PackedSequence("NNACGT").unpack() == "NNACGT");
+    CATCH_CHECK(PackedSequence("ACNNNGT").unpack() == "ACNNNGT");
+    CATCH_CHECK(PackedSequence("ACGTN").unpack() == "ACGTN");
+    CATCH_CHECK(PackedSequence("NNNN").unpack() == "NNNN");
+    CATCH_CHECK(PackedSequence("ARYNCsWg").unpack() == "ANNNCNNG");
+}
+
+CATCH_TEST_CASE(TEST_GROUP " Packed sequences are a quarter of the size", TEST_GROUP) {
+    const std::string seq(1000, 'G');
+    const PackedSequence packed(seq);
+    CATCH_CHECK(packed.memory_bytes() == seq.size() / 4);
+}
+
+CATCH_TEST_CASE(TEST_GROUP " Unpacking overwrites the output", TEST_GROUP) {
+    std::string seq = "this will be replaced by something shorter";
+    PackedSequence("NACGTN").unpack(seq);
+    CATCH_CHECK(seq == "NACGTN");
+    PackedSequence().unpack(seq);
+    CATCH_CHECK(seq.empty());
+}
@@ -14,6 +14,8 @@
 #include <htslib/sam.h>
 
 #include <filesystem>
+#include <string>
+#include <unordered_set>
 
 #define TEST_GROUP "[PairingNodeTest]"
 #define DEFINE_TEST(name) CATCH_TEST_CASE(TEST_GROUP " " name, TEST_GROUP)
@@ -57,6 +59,11 @@ DEFINE_TEST("Split read pairing") {
     // the second read must start within 1000ms of the end of the first read
     // and min/max length ratio must be greater than 0.2
     // expected pairs: {2, 3} and {5, 6}
+    const auto signal_storage = GENERATE(dorado::PairingSignalStorage::RESIDENT,
+                                         dorado::PairingSignalStorage::COMPRESSED,
+                                         dorado::PairingSignalStorage::SPILL);
+    CATCH_CAPTURE(signal_storage);
+    auto spill_dir = make_temp_dir("pairing_spill");
 
     // Load a pre-determined read to exercise the mapping pathway.
     const auto fa_file = std::filesystem::path(get_aligner_data_dir()) / "long_target.fa";
@@ -81,12 +88,12 @@ DEFINE_TEST("Split read pairing") {
     dorado::PipelineDescriptor pipeline_desc;
     std::vector<dorado::Message> messages;
     auto sink = pipeline_desc.add_node<MessageSinkToVector>({}, 5, messages);
+    dorado::DuplexPairingParameters pairing_params{dorado::ReadOrder::BY_CHANNEL,
+                                                   dorado::DEFAULT_DUPLEX_CACHE_DEPTH};
+    pairing_params.signal_storage = signal_storage;
+    pairing_params.spill_dir = spill_dir.m_path.string();
     // one thread, one read - force reads through in order
-    pipeline_desc.add_node<dorado::PairingNode>(
-            {sink},
-            dorado::DuplexPairingParameters{dorado::ReadOrder::BY_CHANNEL,
-                                            dorado::DEFAULT_DUPLEX_CACHE_DEPTH},
-            1, 1);
+    pipeline_desc.add_node<dorado::PairingNode>({sink}, pairing_params, 1, 1);
     auto pipeline = dorado::Pipeline::create(std::move(pipeline_desc), nullptr);
 
     for (auto& read : reads) {
@@ -94,6 +101,18 @@ DEFINE_TEST("Split read pairing") {
     }
     pipeline->terminate({.fast = dorado::utils::AsyncQueueTerminateFast::No});
 
+    // Signal parked while reads were cached is restored, both for reads and for pairs.
+    for (const auto& message : messages) {
+        if (const auto* read = std::get_if<dorado::SimplexReadPtr>(&message)) {
+            CATCH_CHECK(at::equal((*read)->read_common.raw_data, at::zeros({10})));
+        } else if (const auto* pair = std::get_if<dorado::ReadPairPtr>(&message)) {
+            CATCH_CHECK(at::equal((*pair)->template_read.read_common.raw_data, at::zeros({10})));
+            CATCH_CHECK(at::equal((*pair)->complement_read.read_common.raw_data, at::zeros({10})));
+        }
+    }
+    pipeline.reset();
+    CATCH_CHECK(std::filesystem::is_empty(spill_dir.m_path));
+
     // the 4 split reads generate one additional readpair
     CATCH_CHECK(messages.size() == 9);
     auto num_reads =
@@ -145,3 +164,42 @@ DEFINE_TEST("Terminate behaviour") {
         CATCH_CHECK(messages.size() == reads.size());
     }
 }
+
+DEFINE_TEST("Reads from many pores across threads") {
+    // Short reads spread over a flowcell's worth of channels, so nothing pairs but every read
+    // goes through the sharded cache, including evictions when the cache is shallow.
+    const auto read_order = GENERATE(dorado::ReadOrder::BY_CHANNEL, dorado::ReadOrder::BY_TIME);
+    const size_t cache_depth = GENERATE(size_t{2}, dorado::DEFAULT_DUPLEX_CACHE_DEPTH);
+    CATCH_CAPTURE(dorado::to_string(read_order), cache_depth);
+
+    const int num_channels = 3000;
+    const int reads_per_channel = 4;
+
+    dorado::PipelineDescriptor pipeline_desc;
+    std::vector<dorado::Message> messages;
+    auto sink = pipeline_desc.add_node<MessageSinkToVector>({}, 100, messages);
+    auto pairing_node = pipeline_desc.add_node<dorado::PairingNode>(
+            {sink}, dorado::DuplexPairingParameters{read_order, cache_depth}, 4, 100);
+    auto pipeline = dorado::Pipeline::create(std::move(pipeline_desc), nullptr);
+
+    for (int i = 0; i < reads_per_channel; ++i) {
+        for (int channel = 1; channel <= num_channels; ++channel) {
+            auto read = make_read(i * 20000, 100);
+            read->read_common.attributes.channel_number = channel;
+            read->read_common.read_id = std::to_string(channel) + "_" + std::to_string(i);
+            pipeline->push_message(std::move(read));
+        }
+    }
+    const auto stats = pipeline->get_node_ref<dorado::PairingNode>(pairing_node).sample_stats();
+    pipeline->terminate({.fast = dorado::utils::AsyncQueueTerminateFast::No});
+
+    std::unordered_set<std::string> read_ids;
+    for (const auto& message : messages) {
+        CATCH_REQUIRE(std::holds_alternative<dorado::SimplexReadPtr>(message));
+        read_ids.insert(std::get<dorado::SimplexReadPtr>(message)->read_common.read_id);
+    }
+    CATCH_CHECK(messages.size() == size_t(num_channels * reads_per_channel));
+    CATCH_CHECK(read_ids.size() == messages.size());
+    CATCH_CHECK(stats.count("cache_shard_0.reads") == 1);
+    CATCH_CHECK(stats.count("cache_contended_locks") == 1);
+}
@@ -225,3 +225,26 @@ CATCH_TEST_CASE("TerminateFast", TEST_GROUP) {
     CATCH_REQUIRE(was_fast_terminate.has_value());
     CATCH_CHECK(*was_fast_terminate == terminate_fast);
 }
+
+CATCH_TEST_CASE("Profiling", TEST_GROUP) {
+    PipelineDescriptor pipeline_desc;
+    std::vector<dorado::Message> messages;
+    pipeline_desc.add_node<MessageSinkToVector>({}, 100, messages);
+    auto pipeline = dorado::Pipeline::create(std::move(pipeline_desc), nullptr);
+    CATCH_REQUIRE(pipeline != nullptr);
+    pipeline->set_profiling_enabled(true);
+    for (int i = 0; i < 10; ++i) {
+        pipeline->push_message(std::make_unique<dorado::SimplexRead>());
+    }
+    const auto stats = pipeline->terminate({.fast = dorado::utils::AsyncQueueTerminateFast::No});
+    CATCH_CHECK(messages.size() == 10);
+
+    CATCH_CHECK(stats.at("sink.queue.capacity") == 100);
+    CATCH_CHECK(stats.count("sink.queue.push_blocked_ms") == 1);
+    CATCH_CHECK(stats.count("sink.queue.pop_wait_ms") == 1);
+    CATCH_CHECK(stats.count("sink.queue.depth_p99") == 1);
+    CATCH_CHECK(stats.count("sink.input_thread_0.busy_ms") == 1);
+    const double busy_fraction = stats.at("sink.input_threads_busy_fraction");
+    CATCH_CHECK(busy_fraction >= 0);
+    CATCH_CHECK(busy_fraction <= 1);
+}
@@ -6,6 +6,7 @@
 #include "utils/fs_utils.h"
 
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
 
 #define TEST_GROUP "[dorado::DataLoader::pod5]"
 
@@ -86,16 +87,18 @@ CATCH_TEST_CASE(TEST_GROUP " Test loading POD5 file with read ignore list", TEST
     auto data_path = get_data_dir("multi_read_pod5");
 
     CATCH_SECTION("read ignore list with 1 read") {
-        auto read_ignore_list = std::unordered_set<std::string>();
+        dorado::utils::ReadIdSet read_ignore_list;
         read_ignore_list.insert("0007f755-bc82-432c-82be-76220b107ec5");  // read present in POD5
+        read_ignore_list.finalise();
         CATCH_CHECK(CountSinkReads(data_path, "cpu", 1, 0, std::nullopt, read_ignore_list) == 3);
     }
 
     CATCH_SECTION("same read in read_ids and ignore list") {
         auto read_list = std::unordered_set<std::string>();
         read_list.insert("0007f755-bc82-432c-82be-76220b107ec5");  // read present in POD5
-        auto read_ignore_list = std::unordered_set<std::string>();
+        dorado::utils::ReadIdSet read_ignore_list;
         read_ignore_list.insert("0007f755-bc82-432c-82be-76220b107ec5");  // read present in POD5
+        read_ignore_list.finalise();
         CATCH_CHECK(CountSinkReads(data_path, "cpu", 1, 0, read_list, read_ignore_list) == 0);
     }
 }
@@ -133,3 +136,85 @@ CATCH_TEST_CASE(TEST_GROUP " Test correct previous and next read ids when loaded
         next_read_id = (*i)->read_common.read_id;
     }
 }
+
+CATCH_TEST_CASE(TEST_GROUP " Test unrestricted loading with tight prefetch limits", TEST_GROUP) {
+    auto data_path = get_data_dir("multi_read_pod5");
+
+    const size_t max_reads = GENERATE(0, 2);
+    const size_t max_batches_in_flight = GENERATE(1, 4);
+    const size_t max_signal_bytes_in_flight = GENERATE(size_t{1}, size_t{1} << 30);
+    CATCH_CAPTURE(max_reads, max_batches_in_flight, max_signal_bytes_in_flight);
+
+    dorado::PipelineDescriptor pipeline_desc;
+    std::vector<dorado::Message> messages;
+    pipeline_desc.add_node<MessageSinkToVector>({}, 100, messages);
+    auto pipeline = dorado::Pipeline::create(std::move(pipeline_desc), nullptr);
+
+    dorado::DataLoader loader(*pipeline, "cpu", 2, max_reads, std::nullopt, {});
+    loader.set_prefetch_limits(max_batches_in_flight, max_signal_bytes_in_flight);
+    auto input_pod5_files = dorado::DataLoader::InputFiles::search_pod5s(data_path, false);
+    loader.load_reads(input_pod5_files, dorado::ReadOrder::UNRESTRICTED);
+    pipeline->terminate({.fast = dorado::utils::AsyncQueueTerminateFast::No});
+
+    const size_t expected_reads = max_reads == 0 ? 4 : max_reads;
+    CATCH_CHECK(messages.size() == expected_reads);
+
+    const auto stats = loader.sample_stats();
+    CATCH_CHECK(stats.at("reads_pushed") == expected_reads);
+    CATCH_CHECK(stats.at("batches_in_flight") == 0);
+    CATCH_CHECK(stats.at("signal_bytes_in_flight") == 0);
+}
+
+CATCH_TEST_CASE(TEST_GROUP " Test loading POD5 file by time", TEST_GROUP) {
+    auto data_path = get_data_dir("multi_read_pod5");
+
+    dorado::PipelineDescriptor pipeline_desc;
+    std::vector<dorado::Message> messages;
+    pipeline_desc.add_node<MessageSinkToVector>({}, 100, messages);
+    auto pipeline = dorado::Pipeline::create(std::move(pipeline_desc), nullptr);
+
+    dorado::DataLoader loader(*pipeline, "cpu", 2, 0, std::nullopt, {});
+    auto input_pod5_files = dorado::DataLoader::InputFiles::search_pod5s(data_path, false);
+    loader.load_reads(input_pod5_files, dorado::ReadOrder::BY_TIME);
+    pipeline->terminate({.fast = dorado::utils::AsyncQueueTerminateFast::No});
+    CATCH_CHECK(messages.size() == 4);
+}
+
+CATCH_TEST_CASE(TEST_GROUP " Test reads are time ordered with neighbours when loaded by time.",
+                TEST_GROUP) {
+    auto data_path = get_data_dir("single_channel_multi_read_pod5");
+    const size_t max_open_batches = GENERATE(1, 64);
+    CATCH_CAPTURE(max_open_batches);
+
+    dorado::PipelineDescriptor pipeline_desc;
+    std::vector<dorado::Message> messages;
+    pipeline_desc.add_node<MessageSinkToVector>({}, 10, messages);
+    auto pipeline = dorado::Pipeline::create(std::move(pipeline_desc), nullptr);
+
+    dorado::DataLoader loader(*pipeline, "cpu", 1, 0, std::nullopt, {});
+    loader.set_max_open_batches(max_open_batches);
+    auto input_pod5_files = dorado::DataLoader::InputFiles::search_pod5s(data_path, false);
+    if (input_pod5_files.get().empty()) {
+        throw std::runtime_error("No pod5 files in " + data_path.string());
+    }
+    loader.load_reads(input_pod5_files, dorado::ReadOrder::BY_TIME);
+    pipeline->terminate({.fast = dorado::utils::AsyncQueueTerminateFast::No});
+    auto reads = ConvertMessages<dorado::SimplexReadPtr>(std::move(messages));
+    CATCH_REQUIRE(!reads.empty());
+
+    // All reads are on one channel, so they should arrive in start time order.
+    std::string prev_read_id = "";
+    uint64_t prev_start_time_ms = 0;
+    for (auto& read : reads) {
+        CATCH_CHECK(read->read_common.start_time_ms >= prev_start_time_ms);
+        CATCH_CHECK(prev_read_id == read->prev_read);
+        prev_start_time_ms = read->read_common.start_time_ms;
+        prev_read_id = read->read_common.read_id;
+    }
+
+    std::string next_read_id = "";
+    for (auto it = reads.rbegin(); it != reads.rend(); ++it) {
+        CATCH_CHECK(next_read_id == (*it)->next_read);
+        next_read_id = (*it)->read_common.read_id;
+    }
+}
@@ -3,6 +3,7 @@
 #include "hts_utils/fai_utils.h"
 #include "local_haplotagging.h"
 #include "polish/polish_impl.h"
+#include "polish/task_scheduler.h"
 #include "secondary/common/variant.h"
 #include "secondary/features/haplotag_source.h"
 #include "utils/container_utils.h"
@@ -306,6 +307,8 @@ CATCH_TEST_CASE("haplotag_regions_in_parallel", TEST_GROUP) {
     };
     // clang-format on
 
+    polisher::TaskScheduler scheduler(2);
+
     // Not using Catch2's GENERATE because it explodes on MSVC.
     for (const auto& test_case : test_cases) {
         CATCH_CAPTURE(test_case.name);
@@ -320,12 +323,12 @@ CATCH_TEST_CASE("haplotag_regions_in_parallel", TEST_GROUP) {
 
         if (test_case.expect_throw) {
             CATCH_CHECK_THROWS(polisher::haplotag_regions_in_parallel(
-                    encoders, test_case.regions, test_case.draft_lens, test_case.num_threads,
-                    test_case.ploidy, test_case.pass_min_qual));
+                    scheduler, encoders, test_case.regions, test_case.draft_lens,
+                    test_case.num_threads, test_case.ploidy, test_case.pass_min_qual));
         } else {
             const polisher::HaplotagResults result = polisher::haplotag_regions_in_parallel(
-                    encoders, test_case.regions, test_case.draft_lens, test_case.num_threads,
-                    test_case.ploidy, test_case.pass_min_qual);
+                    scheduler, encoders, test_case.regions, test_case.draft_lens,
+                    test_case.num_threads, test_case.ploidy, test_case.pass_min_qual);
 
             CATCH_CHECK(result == test_case.expected);
         }
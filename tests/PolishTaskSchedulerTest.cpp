@@ -0,0 +1,73 @@
+#include "polish/task_scheduler.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#define TEST_GROUP "[PolishTaskScheduler]"
+
+namespace dorado::polisher::tests {
+
+CATCH_TEST_CASE("TaskScheduler rejects an empty pool", TEST_GROUP) {
+    CATCH_CHECK_THROWS_AS(TaskScheduler(0), std::invalid_argument);
+}
+
+CATCH_TEST_CASE("TaskScheduler::run runs every task once", TEST_GROUP) {
+    TaskScheduler scheduler(3);
+
+    std::vector<int32_t> counts(100, 0);
+    scheduler.run(static_cast<int32_t>(std::size(counts)),
+                  [&counts](const int32_t id) { ++counts[id]; });
+
+    CATCH_CHECK(counts == std::vector<int32_t>(100, 1));
+
+    // No tasks is a no-op.
+    scheduler.run(0, [](int32_t) { throw std::runtime_error("Unexpected task."); });
+}
+
+CATCH_TEST_CASE("TaskScheduler::run rethrows an exception from a task", TEST_GROUP) {
+    TaskScheduler scheduler(2);
+
+    std::atomic<int32_t> num_done{0};
+    CATCH_CHECK_THROWS_AS(scheduler.run(10,
+                                        [&num_done](const int32_t id) {
+                                            if (id == 3) {
+                                                throw std::runtime_error("Task failed.");
+                                            }
+                                            ++num_done;
+                                        }),
+                          std::runtime_error);
+
+    // The other tasks still ran to completion before the exception was rethrown.
+    CATCH_CHECK(num_done == 9);
+}
+
+CATCH_TEST_CASE("TaskScheduler::TaskGroup limits the tasks in flight", TEST_GROUP) {
+    TaskScheduler scheduler(4);
+
+    std::atomic<int32_t> in_flight{0};
+    std::atomic<int32_t> max_in_flight{0};
+    std::atomic<int32_t> num_done{0};
+    {
+        TaskScheduler::TaskGroup group(scheduler, utils::concurrency::TaskPriority::high, 2);
+        for (int32_t i = 0; i < 50; ++i) {
+            group.submit([&]() {
+                const int32_t curr = ++in_flight;
+                int32_t prev = max_in_flight;
+                while ((prev < curr) && !max_in_flight.compare_exchange_weak(prev, curr)) {
+                }
+                --in_flight;
+                ++num_done;
+            });
+        }
+        group.wait();
+    }
+
+    CATCH_CHECK(num_done == 50);
+    CATCH_CHECK(max_in_flight <= 2);
+}
+
+}  // namespace dorado::polisher::tests
@@ -4,6 +4,9 @@
 
 #include <catch2/catch_test_macros.hpp>
 
+#include <string>
+#include <vector>
+
 #define TEST_GROUP "[ReadForwarderNodeTest]"
 
 CATCH_TEST_CASE("OnlyReadsExtracted", TEST_GROUP) {
@@ -26,3 +29,26 @@ CATCH_TEST_CASE("OnlyReadsExtracted", TEST_GROUP) {
 
     CATCH_CHECK(messages.size() == 2);
 }
+
+CATCH_TEST_CASE("BatchesPreserveOrder", TEST_GROUP) {
+    std::vector<std::string> read_ids;
+    auto add_to_vec_callback = [&read_ids](dorado::Message&& message) {
+        read_ids.push_back(dorado::get_read_common_data(message).read_id);
+    };
+
+    dorado::PipelineDescriptor pipeline_desc;
+    pipeline_desc.add_node<dorado::ReadForwarderNode>({}, 10, 1, add_to_vec_callback);
+    auto pipeline = dorado::Pipeline::create(std::move(pipeline_desc), nullptr);
+
+    // More reads than both the queue size and the input batch size.
+    std::vector<std::string> expected_read_ids;
+    for (int i = 0; i < 500; ++i) {
+        auto read = std::make_unique<dorado::SimplexRead>();
+        read->read_common.read_id = std::to_string(i);
+        expected_read_ids.push_back(read->read_common.read_id);
+        pipeline->push_message(std::move(read));
+    }
+    pipeline->terminate({.fast = dorado::utils::AsyncQueueTerminateFast::No});
+
+    CATCH_CHECK(read_ids == expected_read_ids);
+}
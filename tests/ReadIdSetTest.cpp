@@ -0,0 +1,56 @@
+#include "utils/ReadIdSet.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+#define TEST_GROUP "[ReadIdSet]"
+
+using dorado::utils::ReadIdSet;
+
+CATCH_TEST_CASE(TEST_GROUP " Parses canonical UUIDs", TEST_GROUP) {
+    const auto uuid = ReadIdSet::parse_uuid("002bd127-db82-436f-b828-28567c3d505d");
+    const ReadIdSet::BinaryId expected{0x00, 0x2b, 0xd1, 0x27, 0xdb, 0x82, 0x43, 0x6f,
+                                       0xb8, 0x28, 0x28, 0x56, 0x7c, 0x3d, 0x50, 0x5d};
+    CATCH_REQUIRE(uuid.has_value());
+    CATCH_CHECK(*uuid == expected);
+
+    // Wrong length, misplaced dashes, uppercase and non-hex characters.
+    CATCH_CHECK(!ReadIdSet::parse_uuid(""));
+    CATCH_CHECK(!ReadIdSet::parse_uuid("002bd127-db82-436f-b828-28567c3d505"));
+    CATCH_CHECK(!ReadIdSet::parse_uuid("002bd127db82-436f-b828-28567c3d505d0"));
+    CATCH_CHECK(!ReadIdSet::parse_uuid("002BD127-DB82-436F-B828-28567C3D505D"));
+    CATCH_CHECK(!ReadIdSet::parse_uuid("002bd127-db82-436f-b828-28567c3d505g"));
+}
+
+CATCH_TEST_CASE(TEST_GROUP " Looks up UUIDs and other ids", TEST_GROUP) {
+    ReadIdSet read_ids;
+    CATCH_CHECK(read_ids.empty());
+    // An empty set can be looked up without being finalised.
+    CATCH_CHECK(!read_ids.contains("002bd127-db82-436f-b828-28567c3d505d"));
+
+    read_ids.insert("ccccdddd-db82-436f-b828-28567c3d505d");
+    read_ids.insert("002bd127-db82-436f-b828-28567c3d505d");
+    read_ids.insert("not_a_uuid");
+    read_ids.insert("002bd127-db82-436f-b828-28567c3d505d");
+    read_ids.finalise();
+
+    // Duplicates are dropped.
+    CATCH_CHECK(read_ids.size() == 3);
+
+    CATCH_CHECK(read_ids.contains("002bd127-db82-436f-b828-28567c3d505d"));
+    CATCH_CHECK(read_ids.contains("ccccdddd-db82-436f-b828-28567c3d505d"));
+    CATCH_CHECK(read_ids.contains("not_a_uuid"));
+    CATCH_CHECK(!read_ids.contains("aaaadddd-db82-436f-b828-28567c3d505d"));
+    CATCH_CHECK(!read_ids.contains("not_a_uuid_either"));
+
+    // Binary lookups, as done with POD5 read ids.
+    const ReadIdSet::BinaryId present{0xcc, 0xcc, 0xdd, 0xdd, 0xdb, 0x82, 0x43, 0x6f,
+                                      0xb8, 0x28, 0x28, 0x56, 0x7c, 0x3d, 0x50, 0x5d};
+    ReadIdSet::BinaryId absent = present;
+    absent[15] = 0;
+    CATCH_CHECK(read_ids.contains(present.data()));
+    CATCH_CHECK(!read_ids.contains(absent.data()));
+}
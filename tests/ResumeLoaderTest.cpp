@@ -22,7 +22,8 @@ CATCH_TEST_CASE(TEST_GROUP) {
     loader.copy_completed_reads();
     sink.terminate({.fast = dorado::utils::AsyncQueueTerminateFast::No});
     CATCH_CHECK(messages.size() == 2);
-    auto read_ids = loader.get_processed_read_ids();
-    CATCH_CHECK(read_ids.count("002bd127-db82-436f-b828-28567c3d505d") == 1);
-    CATCH_CHECK(read_ids.count("ccccdddd-db82-436f-b828-28567c3d505d") == 1);
+    const auto& read_ids = loader.get_processed_read_ids();
+    CATCH_CHECK(read_ids.size() == 2);
+    CATCH_CHECK(read_ids.contains("002bd127-db82-436f-b828-28567c3d505d"));
+    CATCH_CHECK(read_ids.contains("ccccdddd-db82-436f-b828-28567c3d505d"));
 }
@@ -0,0 +1,291 @@
+#include "../dorado/secondary/features/medaka_counts.h"
+#include "TestUtils.h"
+#include "hts_utils/hts_file.h"
+#include "hts_utils/hts_types.h"
+#include "secondary/common/bam_file.h"
+#include "utils/cigar.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <htslib/sam.h>
+
+#if DORADO_ENABLE_BENCHMARK_TESTS
+#include <catch2/benchmark/catch_benchmark.hpp>
+#endif
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <random>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+#define TEST_GROUP "[SecondaryMedakaCounts]"
+
+namespace {
+
+// Utility struct to make test cases.
+struct BamRecord {
+    std::string qname{};
+    int32_t pos{0};
+    uint16_t flag{0};
+    std::string cigar{};
+    std::string seq{};
+    std::string qual{};
+};
+
+// Parses a CIGAR from string, but returns a HTS-style vector of packed lengths and ops.
+std::vector<uint32_t> parse_cigar_from_string_hts(const std::string_view cigar) {
+    const std::vector<dorado::CigarOp> parsed = dorado::parse_cigar_from_string(cigar);
+    std::vector<uint32_t> ret(std::size(parsed));
+    for (size_t i = 0; i < std::size(parsed); ++i) {
+        ret[i] = bam_cigar_gen(parsed[i].len, static_cast<int8_t>(parsed[i].op));
+    }
+    return ret;
+}
+
+// Writes a sorted and indexed BAM file with all records aligned to a single target.
+void write_bam(const std::filesystem::path& out_fn,
+               const std::pair<std::string, std::string>& target,
+               const std::span<const BamRecord> records) {
+    dorado::utils::HtsFile hts_file(out_fn.string(), dorado::utils::HtsFile::OutputMode::BAM, 1,
+                                    true);
+    const std::string text = "@HD\tVN:1.6\tSO:unknown\n@SQ\tSN:" + target.first +
+                             "\tLN:" + std::to_string(std::size(target.second)) + "\n";
+    dorado::SamHdrPtr header{sam_hdr_parse(std::size(text), text.c_str())};
+    hts_file.set_header(header.get());
+    for (const BamRecord& r : records) {
+        const std::vector<uint32_t> cigar = parse_cigar_from_string_hts(r.cigar);
+        dorado::BamPtr record{bam_init1()};
+        bam_set1(record.get(), std::size(r.qname), std::data(r.qname), r.flag, 0, r.pos, 60,
+                 std::size(cigar), std::data(cigar), -1, -1, 0, std::size(r.seq), std::data(r.seq),
+                 std::empty(r.qual) ? nullptr : std::data(r.qual), 0);
+        hts_file.write(record.get());
+    }
+    hts_file.finalise([](size_t) { /* noop */ });
+}
+
+// Produces random alignments with a mix of all CIGAR operations counted by the pileup,
+// including the corner cases: leading insertions, insertions after deletions and after
+// reference skips, consecutive insertions and clipping.
+std::vector<BamRecord> make_random_records(std::mt19937& rng,
+                                           const int32_t num_records,
+                                           const int32_t ref_len,
+                                           const int32_t num_ops) {
+    static constexpr std::string_view BASES{"ACGTACGTACGTN"};
+    static constexpr std::string_view OPS{"MMMM=XIIDDN"};
+
+    const auto random_seq = [&rng](const int32_t len) {
+        std::string seq(len, 'A');
+        for (char& c : seq) {
+            c = BASES[rng() % std::size(BASES)];
+        }
+        return seq;
+    };
+
+    std::vector<BamRecord> records;
+    for (int32_t i = 0; i < num_records; ++i) {
+        BamRecord record;
+        record.qname = "read_" + std::to_string(i);
+        record.pos = static_cast<int32_t>(rng() % (ref_len / 2));
+        record.flag = (rng() % 2) ? 16 : 0;
+
+        int32_t qlen = 0;
+        int32_t rlen = 0;
+        const auto add_op = [&](const char op, const int32_t len) {
+            record.cigar += std::to_string(len) + op;
+            if ((op == 'M') || (op == '=') || (op == 'X') || (op == 'I') || (op == 'S')) {
+                qlen += len;
+            }
+            if ((op == 'M') || (op == '=') || (op == 'X') || (op == 'D') || (op == 'N')) {
+                rlen += len;
+            }
+        };
+
+        if (rng() % 4 == 0) {
+            add_op('H', 5);
+        }
+        if (rng() % 4 == 0) {
+            add_op('S', 1 + rng() % 4);
+        }
+        if (rng() % 4 == 0) {
+            add_op('I', 1 + rng() % 3);
+        }
+        for (int32_t j = 0; j < num_ops; ++j) {
+            const char op = OPS[rng() % std::size(OPS)];
+            add_op(op, 1 + rng() % 6);
+            if ((record.pos + rlen + 20) >= ref_len) {
+                break;
+            }
+        }
+        add_op('M', 3);
+        if (rng() % 4 == 0) {
+            add_op('S', 2);
+        }
+
+        record.seq = random_seq(qlen);
+        if (rng() % 2) {
+            record.qual.resize(qlen);
+            for (char& q : record.qual) {
+                q = static_cast<char>(rng() % 10);
+            }
+        }
+        records.emplace_back(std::move(record));
+    }
+
+    std::stable_sort(std::begin(records), std::end(records),
+                     [](const BamRecord& a, const BamRecord& b) { return a.pos < b.pos; });
+
+    return records;
+}
+
+dorado::secondary::PileupData compute_pileup(dorado::secondary::BamFile& bam_file,
+                                             const int64_t start,
+                                             const int64_t end,
+                                             const int64_t num_homop,
+                                             const bool force_mpileup) {
+    return dorado::secondary::calculate_pileup(bam_file, "contig_1", start, end, 1, {}, num_homop,
+                                               "", 0, false, false, "", 0, force_mpileup);
+}
+
+void check_equal(const dorado::secondary::PileupData& expected,
+                 const dorado::secondary::PileupData& result) {
+    const int64_t featlen = dorado::secondary::PILEUP_BASES_SIZE * expected.num_homop;
+    CATCH_REQUIRE(result.n_cols == expected.n_cols);
+    CATCH_CHECK(result.major == expected.major);
+    CATCH_CHECK(result.minor == expected.minor);
+    CATCH_CHECK(std::equal(std::begin(expected.matrix),
+                           std::begin(expected.matrix) + expected.n_cols * featlen,
+                           std::begin(result.matrix)));
+}
+
+}  // namespace
+
+namespace dorado::secondary::tests {
+
+CATCH_TEST_CASE("calculate_pileup counts bases, deletions and insertions", TEST_GROUP) {
+    const auto temp_dir = make_temp_dir("medaka_counts_test");
+    const auto in_bam_fn = temp_dir.m_path / "in.aln.bam";
+
+    // clang-format off
+    const std::vector<BamRecord> records{
+        {"read_01", 0, 0,  "4M2I4M",  "ACGTTTACGT", ""},
+        {"read_02", 2, 16, "2M1D3M",  "GTCGT",      ""},
+    };
+    // clang-format on
+    write_bam(in_bam_fn, {"contig_1", "ACGTACGTAC"}, records);
+
+    // Base indices: "acgtACGTdD".
+    // clang-format off
+    const std::vector<std::vector<uint32_t>> expected_counts{
+        {0, 0, 0, 0, 1, 0, 0, 0, 0, 0},
+        {0, 0, 0, 0, 0, 1, 0, 0, 0, 0},
+        {0, 0, 1, 0, 0, 0, 1, 0, 0, 0},
+        {0, 0, 0, 1, 0, 0, 0, 1, 0, 0},
+        {0, 0, 0, 0, 0, 0, 0, 1, 0, 0},
+        {0, 0, 0, 0, 0, 0, 0, 1, 0, 0},
+        {0, 0, 0, 0, 1, 0, 0, 0, 1, 0},
+        {0, 1, 0, 0, 0, 1, 0, 0, 0, 0},
+        {0, 0, 1, 0, 0, 0, 1, 0, 0, 0},
+        {0, 0, 0, 1, 0, 0, 0, 1, 0, 0},
+    };
+    // clang-format on
+    const std::vector<int64_t> expected_major{0, 1, 2, 3, 3, 3, 4, 5, 6, 7};
+    const std::vector<int64_t> expected_minor{0, 0, 0, 0, 1, 2, 0, 0, 0, 0};
+
+    for (const bool force_mpileup : {false, true}) {
+        CATCH_CAPTURE(force_mpileup);
+
+        BamFile bam_file(in_bam_fn);
+        const PileupData result = compute_pileup(bam_file, 0, 10, 1, force_mpileup);
+
+        CATCH_REQUIRE(result.n_cols == 10);
+        CATCH_CHECK(result.major == expected_major);
+        CATCH_CHECK(result.minor == expected_minor);
+        for (int64_t col = 0; col < result.n_cols; ++col) {
+            CATCH_CAPTURE(col);
+            const std::vector<uint32_t> counts(
+                    std::begin(result.matrix) + col * PILEUP_BASES_SIZE,
+                    std::begin(result.matrix) + (col + 1) * PILEUP_BASES_SIZE);
+            CATCH_CHECK(counts == expected_counts[col]);
+        }
+    }
+}
+
+CATCH_TEST_CASE("calculate_pileup from CIGARs matches the mpileup", TEST_GROUP) {
+    const auto temp_dir = make_temp_dir("medaka_counts_test");
+    const auto in_bam_fn = temp_dir.m_path / "in.aln.bam";
+
+    std::mt19937 rng(42);
+    const int32_t ref_len = 300;
+    const std::vector<BamRecord> records = make_random_records(rng, 200, ref_len, 40);
+    write_bam(in_bam_fn, {"contig_1", std::string(ref_len, 'A')}, records);
+
+    BamFile bam_file(in_bam_fn);
+
+    // Regions which start and end inside alignments, and a region past all of them.
+    const std::vector<std::pair<int64_t, int64_t>> regions{
+            {0, ref_len}, {17, 123}, {150, 151}, {250, ref_len}, {ref_len - 1, ref_len}};
+
+    for (const auto& [start, end] : regions) {
+        for (const int64_t num_homop : {1, 3}) {
+            CATCH_CAPTURE(start, end, num_homop);
+            const PileupData expected = compute_pileup(bam_file, start, end, num_homop, true);
+            const PileupData result = compute_pileup(bam_file, start, end, num_homop, false);
+            check_equal(expected, result);
+        }
+    }
+}
+
+CATCH_TEST_CASE("calculate_pileup matches the mpileup at its depth cap", TEST_GROUP) {
+    const auto temp_dir = make_temp_dir("medaka_counts_test");
+    const auto in_bam_fn = temp_dir.m_path / "in.aln.bam";
+
+    // More alignments than the mpileup's depth cap spread out at a low depth, followed by a
+    // stack which is deeper than the cap, where the mpileup drops alignments.
+    const int32_t ref_len = 100'000;
+    const int32_t stack_pos = 95'000;
+    std::vector<BamRecord> records;
+    for (int32_t i = 0; i < 9000; ++i) {
+        records.push_back(
+                {"tiled_" + std::to_string(i), i * 10, 0, "20M", std::string(20, 'C'), ""});
+    }
+    for (int32_t i = 0; i < 8100; ++i) {
+        records.push_back(
+                {"stacked_" + std::to_string(i), stack_pos, 0, "20M", std::string(20, 'G'), ""});
+    }
+    write_bam(in_bam_fn, {"contig_1", std::string(ref_len, 'A')}, records);
+
+    BamFile bam_file(in_bam_fn);
+
+    const std::vector<std::pair<int64_t, int64_t>> regions{{0, 90'010},
+                                                           {stack_pos - 10, stack_pos + 30}};
+
+    for (const auto& [start, end] : regions) {
+        CATCH_CAPTURE(start, end);
+        const PileupData expected = compute_pileup(bam_file, start, end, 1, true);
+        const PileupData result = compute_pileup(bam_file, start, end, 1, false);
+        check_equal(expected, result);
+    }
+}
+
+#if DORADO_ENABLE_BENCHMARK_TESTS
+CATCH_TEST_CASE("calculate_pileup benchmark", TEST_GROUP) {
+    const auto temp_dir = make_temp_dir("medaka_counts_test");
+    const auto in_bam_fn = temp_dir.m_path / "in.aln.bam";
+
+    // A high-depth region: 2000 alignments of around 5kbp on a 20kbp reference.
+    std::mt19937 rng(42);
+    const int32_t ref_len = 20'000;
+    const std::vector<BamRecord> records = make_random_records(rng, 2000, ref_len, 2000);
+    write_bam(in_bam_fn, {"contig_1", std::string(ref_len, 'A')}, records);
+
+    BamFile bam_file(in_bam_fn);
+
+    CATCH_BENCHMARK("mpileup") { return compute_pileup(bam_file, 0, ref_len, 1, true); };
+    CATCH_BENCHMARK("CIGAR") { return compute_pileup(bam_file, 0, ref_len, 1, false); };
+}
+#endif  // DORADO_ENABLE_BENCHMARK_TESTS
+
+}  // namespace dorado::secondary::tests
@@ -0,0 +1,172 @@
+#include "utils/signal_stats.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#if DORADO_ENABLE_BENCHMARK_TESTS
+#include <catch2/benchmark/catch_benchmark.hpp>
+#endif
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#define TEST_GROUP "[SignalStats]"
+
+using namespace dorado::utils;
+
+namespace {
+
+std::vector<int16_t> random_signal(std::mt19937& rng, size_t size, int32_t lo, int32_t hi) {
+    std::uniform_int_distribution<int32_t> dist(lo, hi);
+    std::vector<int16_t> signal(size);
+    for (auto& sample : signal) {
+        sample = static_cast<int16_t>(dist(rng));
+    }
+    return signal;
+}
+
+template <typename T>
+T sorted_value(std::vector<T> values, size_t rank) {
+    std::nth_element(std::begin(values), std::begin(values) + rank, std::end(values));
+    return values[rank];
+}
+
+}  // namespace
+
+CATCH_TEST_CASE(TEST_GROUP " signal_minmax", TEST_GROUP) {
+    // Sizes around the SIMD block sizes, so that the remainder loop is covered.
+    const size_t size = GENERATE(1, 7, 8, 15, 16, 17, 33, 1000);
+    CATCH_CAPTURE(size);
+
+    std::mt19937 rng(static_cast<uint32_t>(size));
+    const auto signal = random_signal(rng, size, std::numeric_limits<int16_t>::min(),
+                                      std::numeric_limits<int16_t>::max());
+    const auto [min_value, max_value] = signal_minmax(signal.data(), size);
+    CATCH_CHECK(min_value == *std::min_element(std::begin(signal), std::end(signal)));
+    CATCH_CHECK(max_value == *std::max_element(std::begin(signal), std::end(signal)));
+}
+
+CATCH_TEST_CASE(TEST_GROUP " SignalHistogram order statistics", TEST_GROUP) {
+    const size_t size = GENERATE(1, 2, 999, 1000);
+    const int32_t range = GENERATE(10, 3000, 65535);
+    CATCH_CAPTURE(size, range);
+
+    std::mt19937 rng(static_cast<uint32_t>(size + range));
+    const auto signal = random_signal(rng, size, std::numeric_limits<int16_t>::min(),
+                                      std::numeric_limits<int16_t>::min() + range);
+    const SignalHistogram histogram(signal.data(), size);
+    CATCH_REQUIRE(histogram.size() == size);
+
+    const int16_t median = sorted_value(signal, (size - 1) / 2);
+    CATCH_CHECK(histogram.median() == median);
+    for (const float q : {0.0f, 0.2f, 0.5f, 0.9f, 1.0f}) {
+        CATCH_CAPTURE(q);
+        const auto rank = static_cast<size_t>(q * static_cast<float>(size - 1));
+        CATCH_CHECK(histogram.quantile(q) == sorted_value(signal, rank));
+    }
+
+    std::vector<int32_t> deviations;
+    for (const int16_t sample : signal) {
+        deviations.push_back(std::abs(sample - median));
+    }
+    CATCH_CHECK(histogram.median_abs_deviation(median) == sorted_value(deviations, (size - 1) / 2));
+
+    // Adding the samples one by one, which grows the range as it goes, gives the same counts.
+    SignalHistogram incremental;
+    for (const int16_t sample : signal) {
+        incremental.add(sample);
+    }
+    CATCH_CHECK(incremental.size() == size);
+    CATCH_CHECK(incremental.median() == median);
+
+    CATCH_CHECK_THROWS_AS(histogram.value_at_rank(size), std::out_of_range);
+    CATCH_CHECK_THROWS_AS(SignalHistogram().median(), std::out_of_range);
+}
+
+CATCH_TEST_CASE(TEST_GROUP " SignalStats can be reused for signals of different ranges",
+                TEST_GROUP) {
+    std::mt19937 rng(42);
+    SignalStats stats;
+    for (const auto& [lo, hi] : {std::pair{400, 1200}, std::pair{-5000, 20000}, std::pair{0, 3}}) {
+        CATCH_CAPTURE(lo, hi);
+        const auto signal = random_signal(rng, 4000, lo, hi);
+        stats.compute(signal.data(), std::size(signal));
+
+        const int16_t median = sorted_value(signal, (std::size(signal) - 1) / 2);
+        std::vector<int32_t> deviations;
+        for (const int16_t sample : signal) {
+            deviations.push_back(std::abs(sample - median));
+        }
+
+        CATCH_CHECK(stats.size() == std::size(signal));
+        CATCH_CHECK(stats.minimum() == *std::min_element(std::begin(signal), std::end(signal)));
+        CATCH_CHECK(stats.maximum() == *std::max_element(std::begin(signal), std::end(signal)));
+        CATCH_CHECK(stats.median() == median);
+        CATCH_CHECK(stats.quantile(0.2f) == sorted_value(signal, 799));
+        CATCH_CHECK(stats.quantile(0.9f) == sorted_value(signal, 3599));
+        CATCH_CHECK(stats.median_abs_deviation() ==
+                    sorted_value(deviations, (std::size(deviations) - 1) / 2));
+    }
+
+    stats.compute(nullptr, 0);
+    CATCH_CHECK(stats.size() == 0);
+    CATCH_CHECK_THROWS_AS(stats.median(), std::out_of_range);
+}
+
+CATCH_TEST_CASE(TEST_GROUP " SlidingMedian matches the median of each window", TEST_GROUP) {
+    const size_t window_size = GENERATE(1, 250, 1000);
+    const size_t stride = GENERATE(1, 50, 2000);
+    CATCH_CAPTURE(window_size, stride);
+
+    // A stepped signal, like the adapter to RNA transition, with noise.
+    std::mt19937 rng(42);
+    auto signal = random_signal(rng, 5000, 0, 200);
+    for (size_t i = 2500; i < std::size(signal); ++i) {
+        signal[i] += 700;
+    }
+
+    SlidingMedian sliding_median(signal.data(), std::size(signal), window_size);
+    for (size_t start = 0; start < std::size(signal); start += stride) {
+        CATCH_CAPTURE(start);
+        const size_t end = std::min(start + window_size, std::size(signal));
+        const std::vector<int16_t> window(std::begin(signal) + start, std::begin(signal) + end);
+        CATCH_CHECK(sliding_median.median_at(start) == sorted_value(window, (end - start - 1) / 2));
+    }
+
+    CATCH_CHECK_THROWS_AS(sliding_median.median_at(0), std::invalid_argument);
+    CATCH_CHECK_THROWS_AS(sliding_median.median_at(std::size(signal)), std::out_of_range);
+}
+
+#if DORADO_ENABLE_BENCHMARK_TESTS
+CATCH_TEST_CASE(TEST_GROUP " SlidingMedian benchmark", TEST_GROUP) {
+    constexpr size_t kWindowSize = 250;
+    constexpr size_t kStride = 50;
+
+    std::mt19937 rng(42);
+    const auto signal = random_signal(rng, 100'000, 400, 1200);
+
+    CATCH_BENCHMARK("nth_element per window") {
+        int64_t sum = 0;
+        std::vector<int16_t> window;
+        for (size_t start = 0; start + kWindowSize <= std::size(signal); start += kStride) {
+            window.assign(std::begin(signal) + start, std::begin(signal) + start + kWindowSize);
+            sum += sorted_value(window, (kWindowSize - 1) / 2);
+        }
+        return sum;
+    };
+    CATCH_BENCHMARK("SlidingMedian") {
+        int64_t sum = 0;
+        SlidingMedian sliding_median(signal.data(), std::size(signal), kWindowSize);
+        for (size_t start = 0; start + kWindowSize <= std::size(signal); start += kStride) {
+            sum += sliding_median.median_at(start);
+        }
+        return sum;
+    };
+}
+#endif  // DORADO_ENABLE_BENCHMARK_TESTS
@@ -0,0 +1,73 @@
+#include "TestUtils.h"
+#include "read_pipeline/base/SignalStore.h"
+
+#include <ATen/Functions.h>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <cstddef>
+#include <filesystem>
+#include <iterator>
+#include <vector>
+
+#define TEST_GROUP "[SignalStoreTest]"
+
+namespace {
+
+size_t num_files(const std::filesystem::path& dir) {
+    return static_cast<size_t>(std::distance(std::filesystem::directory_iterator(dir),
+                                             std::filesystem::directory_iterator{}));
+}
+
+// A random walk, which looks more like real signal than uniform noise does.
+at::Tensor make_signal(int64_t num_samples, at::ScalarType dtype) {
+    auto steps = at::randint(-20, 21, {num_samples}, at::kInt);
+    return (steps.cumsum(0) + 500).to(dtype);
+}
+
+}  // namespace
+
+CATCH_TEST_CASE(TEST_GROUP ": Parked signal is restored exactly", TEST_GROUP) {
+    const auto mode = GENERATE(dorado::SignalStore::Mode::COMPRESSED,
+                               dorado::SignalStore::Mode::SPILL);
+    const auto dtype = GENERATE(at::kShort, at::kHalf, at::kFloat);
+    auto tmp_dir = make_temp_dir("signal_store");
+
+    dorado::SignalStore store(mode, tmp_dir.m_path);
+    CATCH_CHECK(store.mode() == mode);
+
+    std::vector<at::Tensor> signals;
+    std::vector<dorado::SignalStore::ParkedSignal> parked;
+    for (int64_t num_samples : {0, 1, 7, 4000, 123457}) {
+        signals.push_back(make_signal(num_samples, dtype));
+        parked.push_back(store.park(signals.back()));
+    }
+
+    // Restoring doesn't release the signal, so do it twice.
+    for (int pass = 0; pass < 2; ++pass) {
+        for (size_t i = 0; i < signals.size(); ++i) {
+            const auto restored = store.restore(*parked[i]);
+            CATCH_CHECK(restored.scalar_type() == dtype);
+            CATCH_CHECK(restored.sizes() == signals[i].sizes());
+            CATCH_CHECK(at::equal(restored, signals[i]));
+        }
+    }
+}
+
+CATCH_TEST_CASE(TEST_GROUP ": Compressed signal is smaller", TEST_GROUP) {
+    dorado::SignalStore store(dorado::SignalStore::Mode::COMPRESSED, {});
+    const auto signal = make_signal(100000, at::kShort);
+    const auto parked = store.park(signal);
+    CATCH_CHECK(parked->stored_bytes() < signal.nbytes());
+}
+
+CATCH_TEST_CASE(TEST_GROUP ": Spill files are removed", TEST_GROUP) {
+    auto tmp_dir = make_temp_dir("signal_store");
+    {
+        dorado::SignalStore store(dorado::SignalStore::Mode::SPILL, tmp_dir.m_path);
+        const auto parked = store.park(make_signal(1000, at::kShort));
+        CATCH_CHECK(num_files(tmp_dir.m_path) == 1);
+        CATCH_CHECK(parked->stored_bytes() > 0);
+    }
+    CATCH_CHECK(num_files(tmp_dir.m_path) == 0);
+}
@@ -5,6 +5,10 @@
 
 #include <catch2/catch_test_macros.hpp>
 
+#include <algorithm>
+#include <string>
+#include <vector>
+
 #define TEST_GROUP "[utils]"
 
 // clang-format off
@@ -86,3 +90,44 @@ CATCH_TEST_CASE("Test stitch_chunks", TEST_GROUP) {
     CATCH_REQUIRE(read_common.qstring == expected_qstring);
     CATCH_REQUIRE(read_common.moves == expected_moves);
 }
+
+CATCH_TEST_CASE("Test stitch_chunks trims to the raw signal", TEST_GROUP) {
+    constexpr size_t CHUNK_SIZE = 8;
+    constexpr int STRIDE = 2;
+
+    const auto make_chunk = [](size_t offset, std::string seq, std::vector<uint8_t> moves) {
+        dorado::utils::Chunk chunk(offset, CHUNK_SIZE);
+        chunk.qstring = seq;
+        std::transform(chunk.qstring.begin(), chunk.qstring.end(), chunk.qstring.begin(),
+                       [](char c) { return char(c + 1); });
+        chunk.seq = std::move(seq);
+        chunk.moves = std::move(moves);
+        return chunk;
+    };
+
+    dorado::ReadCommon read_common;
+    read_common.attributes.model_stride = STRIDE;
+
+    CATCH_SECTION("Single chunk longer than the read") {
+        read_common.raw_data = at::zeros(5);
+        const auto chunk = make_chunk(0, "GAT", {1, 1, 0, 1});
+        std::vector<const dorado::utils::Chunk *> chunks{&chunk};
+        dorado::utils::stitch_chunks(read_common, chunks);
+
+        CATCH_CHECK(read_common.seq == "GA");
+        CATCH_CHECK(read_common.qstring == "HB");
+        CATCH_CHECK(read_common.moves == std::vector<uint8_t>{1, 1});
+    }
+
+    CATCH_SECTION("Last chunk overhanging the read by part of a stride") {
+        read_common.raw_data = at::zeros(11);
+        const auto first_chunk = make_chunk(0, "ACG", {1, 0, 1, 1});
+        const auto last_chunk = make_chunk(4, "TTA", {1, 1, 0, 1});
+        std::vector<const dorado::utils::Chunk *> chunks{&first_chunk, &last_chunk};
+        dorado::utils::stitch_chunks(read_common, chunks);
+
+        CATCH_CHECK(read_common.seq == "ACT");
+        CATCH_CHECK(read_common.qstring == "BDU");
+        CATCH_CHECK(read_common.moves == std::vector<uint8_t>{1, 0, 1, 1, 0});
+    }
+}
@@ -6,8 +6,12 @@
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/generators/catch_generators.hpp>
 
+#include <algorithm>
+#include <cstdint>
+#include <random>
 #include <sstream>
 #include <string>
+#include <vector>
 
 #define CUT_TAG "[dorado::alignment::BedFile]"
 
@@ -286,4 +290,67 @@ CATCH_TEST_CASE(CUT_TAG " load from stream. Parameterised testing.", CUT_TAG) {
     CATCH_CHECK(entries[0] == BedFile::Entry{line, start, end, strand});
 }
 
-}  // namespace dorado::alignment::bed_file::test
\ No newline at end of file
+CATCH_TEST_CASE(CUT_TAG " overlaps are found on the matching strand.", CUT_TAG) {
+    dorado::alignment::BedFile cut{};
+    std::istringstream input_stream{LAMBDA_1.bed_line + "\n" + LAMBDA_2.bed_line + "\n" +
+                                    "Lambda\t2000\t4000\tcomment\t100\t.\n" + RANDOM_1.bed_line};
+    CATCH_REQUIRE(cut.load(input_stream));
+
+    std::vector<size_t> hits;
+    CATCH_CHECK(cut.find_overlaps("Lambda", 2300, 3500, '+', hits) == 2);
+    CATCH_CHECK(hits == std::vector<size_t>{0, 2});
+    CATCH_CHECK(cut.find_overlaps("Lambda", 2300, 3500, '-', hits) == 2);
+    CATCH_CHECK(hits == std::vector<size_t>{1, 2});
+
+    // Regions are half-open, so touching entries don't overlap.
+    CATCH_CHECK(cut.count_overlaps("Lambda", 2345, 3456, '+') == 1);
+    CATCH_CHECK(cut.count_overlaps("Lambda", 0, 1234, '+') == 0);
+    CATCH_CHECK(cut.count_overlaps("Lambda", 4567, 5000, '-') == 0);
+
+    CATCH_CHECK(cut.count_overlaps("Random", 0, 10000, '-') == 1);
+    CATCH_CHECK(cut.count_overlaps("Unknown", 0, 10000, '-') == 0);
+    CATCH_CHECK(cut.find_overlaps("Unknown", 0, 10000, '-', hits) == 0);
+    CATCH_CHECK(hits.empty());
+}
+
+CATCH_TEST_CASE(CUT_TAG " overlaps match a scan of all entries.", CUT_TAG) {
+    // Vary the number of entries to cover index trees of different depths which are not full.
+    const int32_t num_entries = GENERATE(1, 2, 7, 16, 33, 1000);
+    CATCH_CAPTURE(num_entries);
+
+    std::mt19937 rng(num_entries);
+    std::ostringstream oss;
+    for (int32_t i = 0; i < num_entries; ++i) {
+        const size_t start = rng() % 10000;
+        const size_t end = start + rng() % ((i % 10 == 0) ? 2000 : 100);
+        oss << "chr1\t" << start << "\t" << end << "\tname\t0\t" << "+-."[rng() % 3] << "\n";
+    }
+    dorado::alignment::BedFile cut{};
+    std::istringstream input_stream{oss.str()};
+    CATCH_REQUIRE(cut.load(input_stream));
+    const auto& entries = cut.entries("chr1");
+
+    std::vector<size_t> hits;
+    for (int32_t i = 0; i < 200; ++i) {
+        const int64_t start = rng() % 11000;
+        const int64_t end = start + 1 + rng() % 500;
+        const char strand = (rng() % 2) ? '+' : '-';
+        CATCH_CAPTURE(start, end, strand);
+
+        std::vector<size_t> expected;
+        for (size_t j = 0; j < entries.size(); ++j) {
+            const auto& entry = entries[j];
+            if ((static_cast<int64_t>(entry.start) < end) &&
+                (static_cast<int64_t>(entry.end) > start) &&
+                ((entry.strand == strand) || (entry.strand == '.'))) {
+                expected.push_back(j);
+            }
+        }
+
+        CATCH_CHECK(cut.find_overlaps("chr1", start, end, strand, hits) == expected.size());
+        CATCH_CHECK(hits == expected);
+        CATCH_CHECK(cut.count_overlaps("chr1", start, end, strand) == expected.size());
+    }
+}
+
+}  // namespace dorado::alignment::bed_file::test
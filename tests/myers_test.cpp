@@ -3,11 +3,52 @@
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/generators/catch_generators.hpp>
 
+#if DORADO_ENABLE_BENCHMARK_TESTS
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <edlib.h>
+#endif
+
+#include <algorithm>
+#include <cstddef>
+#include <random>
+#include <string>
+#include <vector>
+
 #define CUT_TAG "[myers]"
 #define DEFINE_TEST(name) CATCH_TEST_CASE(CUT_TAG " " name, CUT_TAG)
 
 using dorado::splitter::EdistResult;
 using dorado::splitter::myers_align;
+using dorado::splitter::myers_best_match;
+using dorado::splitter::myers_edists;
+using dorado::splitter::MyersPattern;
+
+namespace {
+
+std::string random_sequence(std::mt19937& rng, std::size_t len) {
+    std::string seq(len, 'A');
+    for (auto& c : seq) {
+        c = "ACGT"[rng() % 4];
+    }
+    return seq;
+}
+
+// Reference implementation of myers_edists(), without the cut-off.
+std::vector<std::size_t> naive_edists(std::string_view pattern, std::string_view seq) {
+    std::vector<std::size_t> prev(seq.size() + 1, 0);
+    std::vector<std::size_t> curr(seq.size() + 1, 0);
+    for (std::size_t i = 1; i <= pattern.size(); i++) {
+        curr[0] = i;
+        for (std::size_t j = 1; j <= seq.size(); j++) {
+            curr[j] = std::min({prev[j] + 1, curr[j - 1] + 1,
+                                prev[j - 1] + (pattern[i - 1] != seq[j - 1] ? 1 : 0)});
+        }
+        std::swap(prev, curr);
+    }
+    return prev;
+}
+
+}  // namespace
 
 DEFINE_TEST("Basic alignment, single hit") {
     const std::string_view query = "AAA";
@@ -94,3 +135,94 @@ DEFINE_TEST("Complex alignment, doesn't crash when high edist near start") {
     const auto alignments = myers_align(query, seq, max_edist);
     CATCH_CHECK(!alignments.empty());
 }
+
+DEFINE_TEST("Edit distances of patterns spanning multiple blocks") {
+    const auto pattern_len = GENERATE(1, 13, 63, 64, 65, 128, 200, 300);
+    const auto max_edist = GENERATE(0, 5, 40, 70, 1000);
+    CATCH_CAPTURE(pattern_len, max_edist);
+
+    std::mt19937 rng(pattern_len);
+    const auto pattern = random_sequence(rng, pattern_len);
+    // Plant a copy of the pattern with some substitutions in the sequence.
+    auto seq = random_sequence(rng, 100) + pattern + random_sequence(rng, 100);
+    for (std::size_t i = 100; i < 100 + pattern.size(); i += 7) {
+        seq[i] = 'N';
+    }
+
+    const auto edists = myers_edists(MyersPattern(pattern), seq, max_edist);
+    auto expected = naive_edists(pattern, seq);
+    for (auto& edist : expected) {
+        edist = std::min<std::size_t>(edist, max_edist + 1);
+    }
+    CATCH_CHECK(edists == expected);
+}
+
+DEFINE_TEST("Best match of a long pattern") {
+    std::mt19937 rng(42);
+    const auto pattern = random_sequence(rng, 150);
+    auto seq = random_sequence(rng, 1000) + pattern + random_sequence(rng, 1000);
+    // Substitutions which don't touch the ends of the match.
+    seq[1000 + 20] = 'N';
+    seq[1000 + 75] = 'N';
+    seq[1000 + 130] = 'N';
+    const MyersPattern myers_pattern(pattern);
+
+    const auto match = myers_best_match(myers_pattern, seq, 10);
+    CATCH_REQUIRE(match.has_value());
+    CATCH_CHECK(match->begin == 1000);
+    CATCH_CHECK(match->end == 1150);
+    CATCH_CHECK(match->edist == 3);
+
+    // Too many edits.
+    CATCH_CHECK(!myers_best_match(myers_pattern, seq, 2).has_value());
+
+    // The pattern is reusable, and the search stops at the first exact match.
+    const auto exact = myers_best_match(myers_pattern, pattern + seq + pattern, 10);
+    CATCH_REQUIRE(exact.has_value());
+    CATCH_CHECK(exact->begin == 0);
+    CATCH_CHECK(exact->end == 150);
+    CATCH_CHECK(exact->edist == 0);
+}
+
+DEFINE_TEST("Long pattern, multiple hits") {
+    std::mt19937 rng(42);
+    const auto pattern = random_sequence(rng, 100);
+    auto mutated = pattern;
+    mutated[50] = 'N';
+    const auto seq = random_sequence(rng, 500) + pattern + random_sequence(rng, 500) + mutated +
+                     random_sequence(rng, 500);
+
+    const auto alignments = myers_align(pattern, seq, 5);
+    CATCH_REQUIRE(alignments.size() == 2);
+    CATCH_CHECK(alignments[0].begin == 500);
+    CATCH_CHECK(alignments[0].end == 600);
+    CATCH_CHECK(alignments[0].edist == 0);
+    CATCH_CHECK(alignments[1].begin == 1100);
+    CATCH_CHECK(alignments[1].end == 1200);
+    CATCH_CHECK(alignments[1].edist == 1);
+}
+
+#if DORADO_ENABLE_BENCHMARK_TESTS
+DEFINE_TEST("Benchmark") {
+    const auto pattern_len = GENERATE(24, 1000);
+    const std::size_t max_edist = pattern_len / 5;
+
+    std::mt19937 rng(42);
+    const auto pattern = random_sequence(rng, pattern_len);
+    const auto seq = random_sequence(rng, 50'000);
+    const MyersPattern myers_pattern(pattern);
+
+    CATCH_BENCHMARK("edlib " + std::to_string(pattern_len)) {
+        auto cfg = edlibNewAlignConfig(static_cast<int>(max_edist), EDLIB_MODE_HW, EDLIB_TASK_LOC,
+                                       nullptr, 0);
+        auto result = edlibAlign(pattern.data(), static_cast<int>(pattern.size()), seq.data(),
+                                 static_cast<int>(seq.size()), cfg);
+        const int edist = result.editDistance;
+        edlibFreeAlignResult(result);
+        return edist;
+    };
+    CATCH_BENCHMARK("myers_best_match " + std::to_string(pattern_len)) {
+        return myers_best_match(myers_pattern, seq, max_edist);
+    };
+}
+#endif  // DORADO_ENABLE_BENCHMARK_TESTS
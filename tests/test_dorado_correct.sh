@@ -141,6 +141,22 @@ if [[ -z "$SAMTOOLS_UNAVAILABLE" ]]; then
         exit 1
     fi
 fi
+#
+# Run separate stages through an overlap store.
+$dorado_bin correct $data_dir/read_correction/reads.fq -v --to-overlap-store $output_dir_correct/separate.dovl
+$dorado_bin correct $data_dir/read_correction/reads.fq -v --from-paf $output_dir_correct/separate.dovl > $output_dir_correct/separate_store.fasta
+if [[ -z "$SAMTOOLS_UNAVAILABLE" ]]; then
+    samtools faidx $output_dir_correct/separate_store.fasta
+    cut -f 1-2 $output_dir_correct/separate_store.fasta.fai | sort > $output_dir_correct/separate_store.fasta.seqs
+    set +e
+    result=$(diff $output_dir_correct/joined.fasta.seqs $output_dir_correct/separate_store.fasta.seqs | wc -l | awk '{ print $1 }')
+    set -e
+    if [[ $result -ne "0" ]]; then
+        echo "Dorado Correct decoupled map/inference run through an overlap store does not generate the same output as the complete pipeline."
+        diff $output_dir_correct/joined.fasta.seqs $output_dir_correct/separate_store.fasta.seqs
+        exit 1
+    fi
+fi
 
 # Test if nonexistent user-specified input PAF file will fail gracefully. This test _should_ fail, that's why we deactivate the -e.
 #